@@ -0,0 +1,166 @@
+#include "Benchmark.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "AsyncComputeScheduler.h"
+#include "FrameScheduler.h"
+#include "ManualGPUQueue.h"
+#include "SimulatedGPUQueue.h"
+
+// 模擬GPUで、パーティクルの更新（1ms）と描画（1.5ms）を一つのキューに順に積む以前の方式と、
+// コンピュートキューでフレームN+1を更新しながらフレームNを描画する方式のフレーム時間を比べる
+// 最初に、描画が更新の終わる前のバッファを読まないこと、更新が描画中のバッファに書かないこと、
+// 待ち合わせがフレームN+1の更新とフレームNの描画を互いに待たせないことを確認して標準エラーに出す（時間は数値だけ出す）
+
+namespace {
+
+	using namespace std::chrono_literals;
+
+	constexpr std::chrono::nanoseconds kSimulationTime = 1ms;
+	constexpr std::chrono::nanoseconds kRenderTime = 1500us;
+	constexpr uint32_t kBufferCount = 2;
+
+	// GPUのスレッドから読み書きを記録して、重なりを数える
+	struct ParticleBuffers {
+		// 最後に更新を書き終えたフレーム番号
+		std::atomic<uint64_t> frame[kBufferCount]{};
+		std::atomic<uint32_t> readers[kBufferCount]{};
+		std::atomic<bool> isWriting[kBufferCount]{};
+		std::atomic<uint32_t> hazardCount{ 0 };
+	};
+
+	// 更新と描画を積む（開始と終了で読み書きを記録する）
+	void SubmitSimulation(Engine::SimulatedGPUQueue& queue, ParticleBuffers& buffers, uint32_t index, uint64_t frame) {
+		queue.Submit([&buffers, index] {
+			if (buffers.readers[index].load() != 0) { ++buffers.hazardCount; }
+			buffers.isWriting[index] = true;
+		});
+		queue.Submit(kSimulationTime);
+		queue.Submit([&buffers, index, frame] {
+			buffers.frame[index] = frame;
+			buffers.isWriting[index] = false;
+		});
+	}
+	void SubmitRender(Engine::SimulatedGPUQueue& queue, ParticleBuffers& buffers, uint32_t index, uint64_t frame) {
+		queue.Submit([&buffers, index, frame] {
+			if (buffers.isWriting[index].load() || buffers.frame[index].load() != frame) { ++buffers.hazardCount; }
+			++buffers.readers[index];
+		});
+		queue.Submit(kRenderTime);
+		queue.Submit([&buffers, index] { --buffers.readers[index]; });
+	}
+
+	struct Result {
+		double frameMilliseconds;
+		uint32_t hazardCount;
+		Engine::AsyncComputeScheduler::Statistics statistics;
+	};
+
+	// frames分を積む（asyncがfalseなら両方をグラフィックスキューに積む）
+	Result Run(bool async, int frames) {
+		Engine::SimulatedGPUQueue graphicsQueue;
+		Engine::SimulatedGPUQueue computeQueue;
+		Engine::SimulatedGPUQueue& simulationQueue = async ? computeQueue : graphicsQueue;
+		ParticleBuffers buffers;
+		Engine::AsyncComputeScheduler scheduler;
+		scheduler.Initalize(&graphicsQueue, &simulationQueue, kBufferCount);
+		// CPUが先に進みすぎないようにグラフィックスキューでフレームを区切る
+		Engine::FrameScheduler frameScheduler;
+		frameScheduler.Initalize(&graphicsQueue, 2);
+
+		// 最初のフレームの分を更新しておく
+		SubmitSimulation(simulationQueue, buffers, scheduler.BeginSimulation(), 0);
+		scheduler.EndSimulation();
+		auto begin = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < frames; ++frame) {
+			frameScheduler.BeginFrame();
+			// フレームN+1の更新
+			SubmitSimulation(simulationQueue, buffers, scheduler.BeginSimulation(), frame + 1);
+			scheduler.EndSimulation();
+			// フレームNの描画
+			SubmitRender(graphicsQueue, buffers, scheduler.BeginRender(), frame);
+			scheduler.EndRender();
+			frameScheduler.EndFrame();
+		}
+		scheduler.WaitForIdle();
+		auto elapsed = std::chrono::steady_clock::now() - begin;
+		Result result{};
+		result.frameMilliseconds = std::chrono::duration<double, std::milli>(elapsed).count() / frames;
+		result.hazardCount = buffers.hazardCount.load();
+		result.statistics = scheduler.GetStatistics();
+		return result;
+	}
+
+	// 最後に待たされた値を記録するキュー（手で進めるので、待ちが省かれることはない）
+	class RecordingQueue :
+		public Benchmark::ManualGPUQueue {
+	public:
+		bool WaitOnQueue(Engine::GPUQueue&, uint64_t value) override {
+			waitedValue = value;
+			return true;
+		}
+		uint64_t waitedValue{ 0 };
+	};
+
+	// 待ち合わせの構造を確かめる
+	// ・フレームNの描画はフレームNの更新だけを待つ（N+1の更新は待たない）
+	// ・フレームN+1の更新はフレームN-1の描画だけを待つ（Nの描画は待たない）
+	// よって、N+1の更新とNの描画はどちらの順にも並べられ、コンピュートのフレームは最大2つ先行する
+	bool CheckOrdering(int frames) {
+		RecordingQueue graphicsQueue;
+		RecordingQueue computeQueue;
+		Engine::AsyncComputeScheduler scheduler;
+		scheduler.Initalize(&graphicsQueue, &computeQueue, kBufferCount);
+		std::vector<uint64_t> simulatedValues;
+		std::vector<uint64_t> renderedValues;
+		scheduler.BeginSimulation();
+		simulatedValues.push_back(scheduler.EndSimulation());
+		bool passed = true;
+		for (int frame = 0; frame < frames; ++frame) {
+			computeQueue.waitedValue = 0;
+			scheduler.BeginSimulation();
+			simulatedValues.push_back(scheduler.EndSimulation());
+			// 書くバッファを前に読んだのはフレームN-1の描画
+			uint64_t expectedComputeWait = frame >= 1 ? renderedValues[frame - 1] : 0;
+			passed = passed && computeQueue.waitedValue == expectedComputeWait;
+			graphicsQueue.waitedValue = 0;
+			scheduler.BeginRender();
+			renderedValues.push_back(scheduler.EndRender());
+			passed = passed && graphicsQueue.waitedValue == simulatedValues[frame] && graphicsQueue.waitedValue < simulatedValues[frame + 1];
+		}
+		return passed;
+	}
+
+	bool Initalize() {
+		static const bool initialized = [] {
+			bool ordered = CheckOrdering(8);
+			Result serial = Run(false, 40);
+			Result async = Run(true, 40);
+			char detail[160];
+			std::snprintf(detail, sizeof(detail), "%.2f ms/frame serial, %.2f ms async, %u hazards, %llu graphics / %llu compute waits",
+				serial.frameMilliseconds, async.frameMilliseconds, serial.hazardCount + async.hazardCount,
+				static_cast<unsigned long long>(async.statistics.graphicsWaitCount), static_cast<unsigned long long>(async.statistics.computeWaitCount));
+			// 重なりは待ち合わせの構造で確かめる（時間はマシンの負荷で変わるので数値だけ出す）
+			Benchmark::Check("AsyncCompute", ordered && serial.hazardCount == 0 && async.hazardCount == 0, detail);
+			return true;
+		}();
+		return initialized;
+	}
+
+}
+
+BENCHMARK("AsyncCompute/Serial on one queue (8 frames)", [](size_t iterationCount) {
+	Initalize();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		Benchmark::DoNotOptimize(Run(false, 8));
+	}
+});
+BENCHMARK("AsyncCompute/Compute queue overlap (8 frames)", [](size_t iterationCount) {
+	Initalize();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		Benchmark::DoNotOptimize(Run(true, 8));
+	}
+});
@@ -0,0 +1,210 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsyncLogger.h"
+
+// Engine::AsyncLogger の呼び出し側の時間を、1行ごとにstd::endlで書き出す以前のLoggerと比べる
+// 最初に複数のスレッドから積んだログが欠けず、スレッドごとの順番が保たれること、一杯のときに捨てた数が出ることを確認して標準エラーに出す
+
+namespace {
+
+	using Engine::AsyncLogger;
+	using Engine::LogSeverity;
+
+	// 書き出した内容をメモリに残す
+	class MemoryLogSink :
+		public Engine::LogSink {
+	public:
+		void Write(const char* data, size_t size) override {
+			text.append(data, size);
+			++writeCount;
+		}
+		void Flush() override {}
+
+		std::string text;
+		size_t writeCount{ 0 };
+	};
+
+	// 捨てる（呼び出し側だけを計測する）
+	class NullLogSink :
+		public Engine::LogSink {
+	public:
+		void Write(const char*, size_t) override {}
+		void Flush() override {}
+	};
+
+	std::filesystem::path GetLogPath(const char* name) {
+		return std::filesystem::temp_directory_path() / name;
+	}
+
+	// 4スレッドから積んだログがすべて、スレッドごとの順番で書き出されるか
+	void VerifyOrder() {
+		constexpr int kThreadCount = 4;
+		constexpr int kLineCount = 20000;
+		MemoryLogSink sink;
+		AsyncLogger logger;
+		// 書き出しスレッドが動けなくてもすべて入る大きさにする
+		logger.Initalize(&sink, 1 << 17);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < kThreadCount; ++t) {
+			threads.emplace_back([&logger, t] {
+				char message[64];
+				for (int n = 0; n < kLineCount; ++n) {
+					int length = std::snprintf(message, sizeof(message), "thread %d line %d", t, n);
+					logger.Log(LogSeverity::Info, std::string_view(message, static_cast<size_t>(length)));
+				}
+			});
+		}
+		for (auto& thread : threads) { thread.join(); }
+		logger.Flush();
+
+		int next[kThreadCount]{};
+		size_t lines = 0, outOfOrder = 0, malformed = 0;
+		std::istringstream stream(sink.text);
+		std::string line;
+		while (std::getline(stream, line)) {
+			int t = -1, n = -1;
+			size_t body = line.find("thread ");
+			if (body == std::string::npos || std::sscanf(line.c_str() + body, "thread %d line %d", &t, &n) != 2 || t < 0 || t >= kThreadCount
+				|| line.find("] Info      : ") == std::string::npos) {
+				++malformed;
+				continue;
+			}
+			if (n != next[t]) { ++outOfOrder; }
+			next[t] = n + 1;
+			++lines;
+		}
+		uint64_t dropped = logger.GetDroppedCount();
+		logger.Finalize();
+
+		char detail[160];
+		std::snprintf(detail, sizeof(detail), "%zu lines in %zu writes, %zu out of order, %zu malformed, %llu dropped",
+			lines, sink.writeCount, outOfOrder, malformed, static_cast<unsigned long long>(dropped));
+		Benchmark::Check("AsyncLogger", lines == kThreadCount * kLineCount && outOfOrder == 0 && malformed == 0 && dropped == 0, detail);
+	}
+
+	// リングが一杯なら待たずに捨て、捨てた数を出すか。重要度の絞り込み
+	void VerifyFilter() {
+		MemoryLogSink sink;
+		AsyncLogger logger;
+		// 書き出しスレッドがしばらく起きないようにして一杯にする
+		logger.Initalize(&sink, 16, std::chrono::milliseconds(10000));
+		size_t accepted = 0;
+		for (int n = 0; n < 100; ++n) {
+			if (logger.Log(LogSeverity::Warning, "fill")) { ++accepted; }
+		}
+		logger.SetMinSeverity(LogSeverity::Warning);
+		bool runtimeFiltered = !logger.Log(LogSeverity::Info, "filtered");
+		int evaluated = 0;
+		auto message = [&evaluated](const char* text) {
+			++evaluated;
+			return std::string_view(text);
+		};
+		// 実行時の下限より低いのでmessageは評価されない
+		ENGINE_LOG(logger, LogSeverity::Info, message("runtime"));
+		// コンパイル時の下限より低い（_DEBUGでなければTraceは消える）
+		ENGINE_LOG(logger, LogSeverity::Trace, message("compile time"));
+		logger.Flush();
+		bool reported = sink.text.find("84 log records dropped") != std::string::npos;
+		uint64_t written = logger.GetWrittenCount();
+		logger.Finalize();
+
+		char detail[160];
+		std::snprintf(detail, sizeof(detail), "%zu/100 accepted, %llu written, drop %s, %d filtered messages evaluated",
+			accepted, static_cast<unsigned long long>(written), reported ? "reported" : "not reported", evaluated);
+		Benchmark::Check("AsyncLogger", accepted == 16 && written == 16 && reported && runtimeFiltered && evaluated == 0, detail);
+	}
+
+	// 以前のLogger（std::ofstreamに1行ごとにstd::endl）
+	class LegacyLogger {
+	public:
+		explicit LegacyLogger(const std::filesystem::path& path) : stream_(path) {}
+		void Info(const std::string& str) {
+			stream_ << "Info      : " + str << std::endl;
+		}
+
+	private:
+		std::ofstream stream_;
+	};
+
+	struct Inputs {
+		std::vector<std::string> messages;
+	};
+
+	const Inputs& GetInputs() {
+		static const Inputs inputs = [] {
+			VerifyOrder();
+			VerifyFilter();
+			Inputs result;
+			for (int i = 0; i < 256; ++i) {
+				result.messages.push_back("Created resource " + std::to_string(i * 7919) + " (StructuredBuffer, 65536 bytes)");
+			}
+			return result;
+		}();
+		return inputs;
+	}
+
+}
+
+BENCHMARK("Logger/Info x256/Legacy ofstream endl", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	std::filesystem::path path = GetLogPath("LegacyLoggerBenchmark.log");
+	{
+		LegacyLogger logger(path);
+		for (size_t n = 0; n < iterationCount; ++n) {
+			for (const std::string& message : in.messages) { logger.Info(message); }
+		}
+	}
+	std::filesystem::remove(path);
+});
+BENCHMARK("Logger/Info x256/AsyncLogger file", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	std::filesystem::path path = GetLogPath("AsyncLoggerBenchmark.log");
+	{
+		Engine::FileLogSink sink;
+		sink.Open(path.string().c_str());
+		AsyncLogger logger;
+		logger.Initalize(&sink, 1 << 16);
+		for (size_t n = 0; n < iterationCount; ++n) {
+			for (const std::string& message : in.messages) { Benchmark::DoNotOptimize(logger.Log(LogSeverity::Info, message)); }
+			// 計測が書き出しより速い場合に一杯にならないように、繰り返しの区切りで待つ
+			if ((n & 63) == 63) { logger.Flush(); }
+		}
+	}
+	std::filesystem::remove(path);
+});
+BENCHMARK("Logger/Info x256 4 threads/AsyncLogger", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	NullLogSink sink;
+	AsyncLogger logger;
+	logger.Initalize(&sink, 1 << 16);
+	for (size_t n = 0; n < iterationCount; ++n) {
+		std::thread threads[4];
+		for (size_t t = 0; t < 4; ++t) {
+			threads[t] = std::thread([&, t] {
+				for (size_t i = t; i < in.messages.size(); i += 4) { Benchmark::DoNotOptimize(logger.Log(LogSeverity::Info, in.messages[i])); }
+			});
+		}
+		for (auto& thread : threads) { thread.join(); }
+		if ((n & 63) == 63) { logger.Flush(); }
+	}
+});
+// 実行時に絞り込まれる場合
+BENCHMARK("Logger/Info x256/AsyncLogger filtered", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	NullLogSink sink;
+	AsyncLogger logger;
+	logger.Initalize(&sink);
+	logger.SetMinSeverity(LogSeverity::Error);
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (const std::string& message : in.messages) { ENGINE_LOG(logger, LogSeverity::Info, message); }
+		Benchmark::ClobberMemory();
+	}
+});
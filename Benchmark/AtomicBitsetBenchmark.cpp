@@ -0,0 +1,164 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "AtomicBitset.h"
+#include "Bitset.h"
+
+// Engine::AtomicBitset を複数スレッドから使った場合を計測する
+// 最初に複数スレッドで確保と解放を繰り返し、同じスロットが二重に確保されないことを確認して標準エラーに出す
+// 比較対象はstd::mutexで保護したEngine::Bitset
+
+namespace {
+
+	constexpr size_t kSlotCount = 4096;
+	// 1スレッドが同時に持つスロット数
+	constexpr size_t kHoldCount = 16;
+
+	size_t GetStressThreadCount() {
+		return std::max<size_t>(4, std::thread::hardware_concurrency());
+	}
+
+	// 確保と解放を繰り返し、確保中のスロットを他のスレッドが確保していないかを数える
+	void VerifyAcquireRelease() {
+		// 端数のワードも確認するため64の倍数にしない
+		static Engine::AtomicBitset<kSlotCount + 37> bitset;
+		std::vector<std::atomic<int>> owners(kSlotCount + 37);
+		std::atomic<size_t> violations{ 0 };
+		std::atomic<size_t> acquired{ 0 };
+		const size_t threadCount = GetStressThreadCount();
+
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < threadCount; ++t) {
+			threads.emplace_back([&, t] {
+				std::mt19937 engine(static_cast<uint32_t>(t));
+				std::vector<size_t> held;
+				for (size_t n = 0; n < 200000; ++n) {
+					if (held.size() < 64 && (engine() & 1) != 0) {
+						size_t slot = bitset.TryAcquire();
+						if (slot == bitset.kNotFound) { continue; }
+						if (owners[slot].fetch_add(1, std::memory_order_relaxed) != 0) { violations.fetch_add(1); }
+						held.emplace_back(slot);
+						acquired.fetch_add(1, std::memory_order_relaxed);
+					}
+					else if (!held.empty()) {
+						size_t i = engine() % held.size();
+						size_t slot = held[i];
+						held[i] = held.back();
+						held.pop_back();
+						if (owners[slot].fetch_sub(1, std::memory_order_relaxed) != 1) { violations.fetch_add(1); }
+						bitset.Release(slot);
+					}
+				}
+				for (size_t slot : held) {
+					owners[slot].fetch_sub(1, std::memory_order_relaxed);
+					bitset.Release(slot);
+				}
+			});
+		}
+		for (auto& thread : threads) { thread.join(); }
+
+		char detail[128];
+		std::snprintf(detail, sizeof(detail), "%zu threads, %zu acquires, %zu double owned, %zu left set",
+			threadCount, acquired.load(), violations.load(), bitset.Count());
+		Benchmark::Check("AtomicBitset", violations == 0 && bitset.Count() == 0, detail);
+	}
+
+	// 全スレッドで空きが無くなるまで確保し、全スロットが一度ずつ確保されたかを確認する
+	void VerifyFill() {
+		static Engine::AtomicBitset<kSlotCount + 37> bitset;
+		const size_t threadCount = GetStressThreadCount();
+		std::vector<std::vector<size_t>> results(threadCount);
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < threadCount; ++t) {
+			threads.emplace_back([&, t] {
+				for (size_t slot = bitset.TryAcquire(); slot != bitset.kNotFound; slot = bitset.TryAcquire()) {
+					results[t].emplace_back(slot);
+				}
+			});
+		}
+		for (auto& thread : threads) { thread.join(); }
+
+		std::vector<size_t> all;
+		for (auto& result : results) { all.insert(all.end(), result.begin(), result.end()); }
+		std::sort(all.begin(), all.end());
+		bool unique = std::adjacent_find(all.begin(), all.end()) == all.end();
+		bool passed = unique && all.size() == kSlotCount + 37 && all.back() == kSlotCount + 36 && !bitset.TryAcquireAt(0);
+		char detail[128];
+		std::snprintf(detail, sizeof(detail), "filled %zu of %zu slots, %s", all.size(), kSlotCount + 37, unique ? "unique" : "duplicated");
+		Benchmark::Check("AtomicBitset(fill)", passed, detail);
+	}
+
+	void VerifyOnce() {
+		static const bool verified = [] {
+			VerifyAcquireRelease();
+			VerifyFill();
+			return true;
+		}();
+		Benchmark::DoNotOptimize(verified);
+	}
+
+	// スレッドごとにkHoldCount個を持ったまま、一番古いものを解放して新しく確保する
+	template<class AcquireFunction, class ReleaseFunction>
+	void RunThreads(size_t threadCount, size_t iterationCount, AcquireFunction acquire, ReleaseFunction release) {
+		std::atomic<bool> start{ false };
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < threadCount; ++t) {
+			threads.emplace_back([&] {
+				size_t held[kHoldCount];
+				for (auto& slot : held) { slot = acquire(); }
+				while (!start.load(std::memory_order_acquire)) { std::this_thread::yield(); }
+				for (size_t n = 0; n < iterationCount; ++n) {
+					size_t& slot = held[n % kHoldCount];
+					release(slot);
+					slot = acquire();
+				}
+				for (auto& slot : held) { release(slot); }
+			});
+		}
+		start.store(true, std::memory_order_release);
+		for (auto& thread : threads) { thread.join(); }
+	}
+
+	void AtomicAcquireRelease(size_t threadCount, size_t iterationCount) {
+		VerifyOnce();
+		static Engine::AtomicBitset<kSlotCount> bitset;
+		RunThreads(threadCount, iterationCount,
+			[] { return bitset.TryAcquire(); },
+			[](size_t slot) { bitset.Release(slot); });
+	}
+
+	void MutexAcquireRelease(size_t threadCount, size_t iterationCount) {
+		VerifyOnce();
+		static Engine::Bitset<kSlotCount> bitset;
+		static std::mutex mutex;
+		RunThreads(threadCount, iterationCount,
+			[] {
+				std::lock_guard<std::mutex> lock(mutex);
+				size_t slot = bitset.FindFirst(false);
+				bitset.Set(slot);
+				return slot;
+			},
+			[](size_t slot) {
+				std::lock_guard<std::mutex> lock(mutex);
+				bitset.Reset(slot);
+			});
+	}
+
+}
+
+// 1回の計測で各スレッドが解放と確保を1回ずつ行う
+BENCHMARK("AtomicBitset/AcquireRelease 1 thread/Mutex", [](size_t iterationCount) { MutexAcquireRelease(1, iterationCount); });
+BENCHMARK("AtomicBitset/AcquireRelease 1 thread/Atomic", [](size_t iterationCount) { AtomicAcquireRelease(1, iterationCount); });
+BENCHMARK("AtomicBitset/AcquireRelease 2 threads/Mutex", [](size_t iterationCount) { MutexAcquireRelease(2, iterationCount); });
+BENCHMARK("AtomicBitset/AcquireRelease 2 threads/Atomic", [](size_t iterationCount) { AtomicAcquireRelease(2, iterationCount); });
+BENCHMARK("AtomicBitset/AcquireRelease 4 threads/Mutex", [](size_t iterationCount) { MutexAcquireRelease(4, iterationCount); });
+BENCHMARK("AtomicBitset/AcquireRelease 4 threads/Atomic", [](size_t iterationCount) { AtomicAcquireRelease(4, iterationCount); });
+BENCHMARK("AtomicBitset/AcquireRelease 8 threads/Mutex", [](size_t iterationCount) { MutexAcquireRelease(8, iterationCount); });
+BENCHMARK("AtomicBitset/AcquireRelease 8 threads/Atomic", [](size_t iterationCount) { AtomicAcquireRelease(8, iterationCount); });
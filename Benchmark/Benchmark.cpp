@@ -0,0 +1,265 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <system_error>
+#include <vector>
+
+namespace Benchmark {
+
+	namespace Internal {
+		const void* volatile sink = nullptr;
+	}
+
+	namespace {
+
+		struct Entry {
+			std::string name;
+			Function function;
+		};
+
+		struct Result {
+			std::string name;
+			size_t iterationCount;
+			size_t repetitionCount;
+			double nsPerOp;
+			double minNsPerOp;
+			double maxNsPerOp;
+		};
+
+		struct Options {
+			std::string filter;
+			std::string jsonPath;
+			double minTimeMs = 20.0;
+			size_t repetitionCount = 5;
+			bool list = false;
+		};
+
+		std::vector<Entry>& GetEntries() {
+			static std::vector<Entry> entries;
+			return entries;
+		}
+
+		// 失敗した検証の数（検証はワーカースレッドから呼ばれることもある）
+		std::atomic<size_t> failedCheckCount{ 0 };
+
+		using Clock = std::chrono::steady_clock;
+
+		double Measure(const Function& function, size_t iterationCount) {
+			auto start = Clock::now();
+			function(iterationCount);
+			auto end = Clock::now();
+			return std::chrono::duration<double, std::nano>(end - start).count();
+		}
+
+		// minTimeMsに届く反復回数を求める
+		size_t Calibrate(const Function& function, double minTimeMs) {
+			const double targetNs = minTimeMs * 1.0e6;
+			size_t iterationCount = 1;
+			for (;;) {
+				double elapsed = Measure(function, iterationCount);
+				if (elapsed >= targetNs || iterationCount >= (size_t(1) << 40)) {
+					return iterationCount;
+				}
+				// 見積もりが小さすぎる時は10倍ずつ増やす
+				double scale = elapsed > 0.0 ? targetNs * 1.2 / elapsed : 10.0;
+				scale = std::clamp(scale, 2.0, 10.0);
+				iterationCount = static_cast<size_t>(static_cast<double>(iterationCount) * scale);
+			}
+		}
+
+		Result Run(const Entry& entry, const Options& options) {
+			Result result{};
+			result.name = entry.name;
+			// 入力データの遅延初期化が反復回数の見積もりに入らないように一度空回しする
+			entry.function(1);
+			result.iterationCount = Calibrate(entry.function, options.minTimeMs);
+			result.repetitionCount = options.repetitionCount;
+
+			std::vector<double> samples;
+			samples.reserve(options.repetitionCount);
+			for (size_t i = 0; i < options.repetitionCount; ++i) {
+				samples.emplace_back(Measure(entry.function, result.iterationCount) / static_cast<double>(result.iterationCount));
+			}
+			std::sort(samples.begin(), samples.end());
+			result.nsPerOp = samples[samples.size() / 2];
+			result.minNsPerOp = samples.front();
+			result.maxNsPerOp = samples.back();
+			return result;
+		}
+
+		std::string EscapeJson(const std::string& str) {
+			std::string result;
+			result.reserve(str.size());
+			for (char c : str) {
+				switch (c) {
+				case '"':	result += "\\\""; break;
+				case '\\':	result += "\\\\"; break;
+				case '\n':	result += "\\n"; break;
+				case '\t':	result += "\\t"; break;
+				default:	result += c; break;
+				}
+			}
+			return result;
+		}
+
+		void WriteJson(std::ostream& os, const std::vector<Result>& results, const Options& options) {
+			os << "{\n";
+			os << "  \"context\": {\n";
+#if defined(__clang__)
+			os << "    \"compiler\": \"clang " << __clang_major__ << "." << __clang_minor__ << "\",\n";
+#elif defined(__GNUC__)
+			os << "    \"compiler\": \"gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "\",\n";
+#elif defined(_MSC_VER)
+			os << "    \"compiler\": \"msvc " << _MSC_VER << "\",\n";
+#endif
+#ifdef NDEBUG
+			os << "    \"build_type\": \"release\",\n";
+#else
+			os << "    \"build_type\": \"debug\",\n";
+#endif
+			os << "    \"min_time_ms\": " << options.minTimeMs << ",\n";
+			os << "    \"repetitions\": " << options.repetitionCount << "\n";
+			os << "  },\n";
+			os << "  \"benchmarks\": [\n";
+			for (size_t i = 0; i < results.size(); ++i) {
+				const auto& result = results[i];
+				os << "    {";
+				os << "\"name\": \"" << EscapeJson(result.name) << "\", ";
+				os << "\"iterations\": " << result.iterationCount << ", ";
+				os << "\"ns_per_op\": " << result.nsPerOp << ", ";
+				os << "\"min_ns_per_op\": " << result.minNsPerOp << ", ";
+				os << "\"max_ns_per_op\": " << result.maxNsPerOp;
+				os << (i + 1 < results.size() ? "},\n" : "}\n");
+			}
+			os << "  ]\n";
+			os << "}\n";
+		}
+
+		void PrintUsage(const char* program) {
+			std::cout
+				<< "Usage: " << program << " [options]\n"
+				<< "  --filter=<text>      run only benchmarks whose name contains <text>\n"
+				<< "  --json=<path>        write results as JSON (\"-\" for stdout)\n"
+				<< "  --min-time=<ms>      minimum time per repetition (default 20)\n"
+				<< "  --repetitions=<n>    repetitions per benchmark (default 5)\n"
+				<< "  --list               list benchmark names and exit\n";
+		}
+
+		bool ParseOptions(int argc, char** argv, Options& options) {
+			for (int i = 1; i < argc; ++i) {
+				std::string arg = argv[i];
+				auto value = [&](const char* prefix) -> const char* {
+					size_t length = std::char_traits<char>::length(prefix);
+					return arg.compare(0, length, prefix) == 0 ? argv[i] + length : nullptr;
+				};
+				if (const char* v = value("--filter=")) { options.filter = v; }
+				else if (const char* v = value("--json=")) { options.jsonPath = v; }
+				else if (const char* v = value("--min-time=")) { options.minTimeMs = std::atof(v); }
+				else if (const char* v = value("--repetitions=")) { options.repetitionCount = std::max<size_t>(1, std::strtoull(v, nullptr, 10)); }
+				else if (arg == "--list") { options.list = true; }
+				else {
+					PrintUsage(argv[0]);
+					return false;
+				}
+			}
+			return true;
+		}
+
+	}
+
+	bool Register(const std::string& name, Function function) {
+		GetEntries().push_back({ name, std::move(function) });
+		return true;
+	}
+
+	void Check(const char* name, bool passed, const char* detail) {
+		if (!passed) {
+			failedCheckCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		std::fprintf(stderr, "%-24s %s %s\n", name, detail, passed ? "ok" : "FAILED");
+	}
+
+	TemporaryDirectory::TemporaryDirectory(const std::string& prefix) {
+		std::random_device device;
+		std::mt19937_64 engine((static_cast<uint64_t>(device()) << 32) ^ device() ^ static_cast<uint64_t>(Clock::now().time_since_epoch().count()));
+		std::filesystem::path parent = std::filesystem::temp_directory_path();
+		// 既にある名前は使わない（create_directoryは作った場合だけtrue）
+		for (;;) {
+			char suffix[24];
+			std::snprintf(suffix, sizeof(suffix), "-%016llx", static_cast<unsigned long long>(engine()));
+			std::filesystem::path path = parent / (prefix + suffix);
+			std::error_code error;
+			if (std::filesystem::create_directory(path, error)) {
+				path_ = std::move(path);
+				return;
+			}
+			if (error) {
+				std::cerr << "Failed to create " << path.string() << ": " << error.message() << "\n";
+				std::abort();
+			}
+		}
+	}
+
+	TemporaryDirectory::~TemporaryDirectory() {
+		std::error_code error;
+		std::filesystem::remove_all(path_, error);
+	}
+
+}
+
+int main(int argc, char** argv) {
+	using namespace Benchmark;
+
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		return 1;
+	}
+
+	auto entries = GetEntries();
+	std::stable_sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.name < rhs.name; });
+
+	std::vector<Result> results;
+	// JSONを標準出力に出す時は表を標準エラーに回す
+	std::ostream& log = options.jsonPath == "-" ? std::cerr : std::cout;
+	for (const auto& entry : entries) {
+		if (!options.filter.empty() && entry.name.find(options.filter) == std::string::npos) {
+			continue;
+		}
+		if (options.list) {
+			std::cout << entry.name << "\n";
+			continue;
+		}
+		results.emplace_back(Run(entry, options));
+		char line[256];
+		std::snprintf(line, sizeof(line), "%-56s %12.3f ns/op %14zu it\n", results.back().name.c_str(), results.back().nsPerOp, results.back().iterationCount);
+		log << line << std::flush;
+	}
+
+	if (!options.jsonPath.empty() && !options.list) {
+		if (options.jsonPath == "-") {
+			WriteJson(std::cout, results, options);
+		}
+		else {
+			std::ofstream file(options.jsonPath);
+			if (!file) {
+				std::cerr << "Failed to open " << options.jsonPath << "\n";
+				return 1;
+			}
+			WriteJson(file, results, options);
+		}
+	}
+
+	size_t failedCount = failedCheckCount.load(std::memory_order_relaxed);
+	if (failedCount != 0) {
+		std::cerr << failedCount << " check(s) FAILED\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Benchmark {
+
+	// 計測対象の処理
+	// 引数の回数だけ処理を繰り返す
+	using Function = std::function<void(size_t iterationCount)>;
+
+	/// <summary>
+	/// ベンチマークを登録
+	/// </summary>
+	/// <param name="name">名前（"グループ/項目"の形式）</param>
+	/// <param name="function">計測対象の処理</param>
+	/// <returns>静的変数の初期化に使うためのダミー</returns>
+	bool Register(const std::string& name, Function function);
+
+	/// <summary>
+	/// 計測の前に行う検証の結果を標準エラーに出す
+	/// 1つでも失敗していればmainは0以外を返す
+	/// </summary>
+	/// <param name="name">検証の名前</param>
+	/// <param name="passed">成功したか</param>
+	/// <param name="detail">結果の詳細</param>
+	void Check(const char* name, bool passed, const char* detail);
+
+	// 一時ディレクトリ
+	// 同時に走らせても重ならない名前で作り、破棄する時に中身ごと消す
+	class TemporaryDirectory {
+	public:
+		/// <summary>
+		/// temp_directory_path()の下に作る
+		/// </summary>
+		/// <param name="prefix">名前の先頭（後ろにランダムな文字列を付ける）</param>
+		explicit TemporaryDirectory(const std::string& prefix);
+		~TemporaryDirectory();
+		TemporaryDirectory(const TemporaryDirectory&) = delete;
+		TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+		const std::filesystem::path& GetPath() const { return path_; }
+
+	private:
+		std::filesystem::path path_;
+	};
+
+	namespace Internal {
+		extern const void* volatile sink;
+	}
+
+	/// <summary>
+	/// 値が最適化で消されないようにする
+	/// </summary>
+	/// <param name="value"></param>
+	template<class T>
+	inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+		if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*)) {
+			asm volatile("" : : "r,m"(value) : "memory");
+		}
+		else {
+			asm volatile("" : : "m"(value) : "memory");
+		}
+#else
+		Internal::sink = static_cast<const void*>(&value);
+		_ReadWriteBarrier();
+#endif
+	}
+
+	/// <summary>
+	/// メモリへの書き込みが最適化で消されないようにする
+	/// </summary>
+	inline void ClobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : : "memory");
+#else
+		_ReadWriteBarrier();
+#endif
+	}
+
+}
+
+#define BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_IMPL(a, b)
+// ベンチマークを静的に登録する
+#define BENCHMARK(name, function) \
+	static const bool BENCHMARK_CONCAT(benchmarkRegistered, __LINE__) = ::Benchmark::Register(name, function)
@@ -0,0 +1,304 @@
+#include "Benchmark.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Bitset.h"
+
+// Engine::Bitset を以前の線形探索の実装と比べる
+// 最初にstd::vector<bool>と同じ操作をして結果が一致するかを確認して標準エラーに出す
+
+namespace {
+
+	// 階層化する前のBitset（FindNextは空だったので同じ線形探索で補っている）
+	template<size_t kBitCount>
+	class LegacyBitset {
+	public:
+		LegacyBitset() { Reset(); }
+
+		size_t FindFirst(bool value = false) const {
+			for (size_t i = 0; i < kWordCount; ++i) {
+				if (words_[i] != (value ? 0 : ~static_cast<uint64_t>(0))) {
+					size_t bitIndex = static_cast<size_t>(value ? std::countr_zero(words_[i]) : std::countr_one(words_[i]));
+					if (bitIndex < kWordSize) {
+						return i * kWordSize + bitIndex;
+					}
+				}
+			}
+			return kWordCount * kWordSize;
+		}
+		size_t FindNext(size_t index, bool value = false) const {
+			for (size_t i = index + 1; i < kBitCount; ++i) {
+				if (Test(i) == value) { return i; }
+			}
+			return kWordCount * kWordSize;
+		}
+		void Set(bool value = true) { std::memset(words_, value ? ~0 : 0, sizeof(words_)); }
+		void Set(size_t bitIndex, bool value = true) {
+			uint64_t& word = words_[bitIndex >> 6];
+			if (value) {
+				word |= static_cast<uint64_t>(1) << (bitIndex & kWordMask);
+			}
+			else {
+				word &= ~(static_cast<uint64_t>(1) << (bitIndex & kWordMask));
+			}
+		}
+		void Reset() { Set(false); }
+		void Reset(size_t bitIndex) { Set(bitIndex, false); }
+		bool Test(size_t bitIndex) const { return (words_[bitIndex >> 6] & (static_cast<uint64_t>(1) << (bitIndex & kWordMask))) != 0; }
+
+	private:
+		static constexpr size_t kWordSize = 64;
+		static constexpr size_t kWordCount = (kBitCount - 1) / kWordSize + 1;
+		static constexpr size_t kWordMask = kWordSize - 1;
+
+		uint64_t words_[kWordCount];
+	};
+
+	// 空きを探して確保、解放を繰り返す回数
+	constexpr size_t kOperationCount = 256;
+
+	// 参照実装で検索する
+	size_t ReferenceFind(const std::vector<bool>& reference, size_t begin, bool value) {
+		for (size_t i = begin; i < reference.size(); ++i) {
+			if (reference[i] == value) { return i; }
+		}
+		return reference.size();
+	}
+	size_t ReferenceFindReverse(const std::vector<bool>& reference, size_t end, bool value) {
+		for (size_t i = end; i > 0; --i) {
+			if (reference[i - 1] == value) { return i - 1; }
+		}
+		return reference.size();
+	}
+
+	template<size_t kBitCount>
+	size_t VerifyBitset(uint32_t seed) {
+		using Bitset = Engine::Bitset<kBitCount>;
+		static Bitset bitset, other;
+		std::vector<bool> reference(kBitCount), otherReference(kBitCount);
+		std::mt19937 engine(seed);
+		std::uniform_int_distribution<size_t> index(0, kBitCount - 1);
+		size_t mismatch = 0;
+
+		auto check = [&]() {
+			size_t count = 0;
+			for (bool bit : reference) { count += bit ? 1 : 0; }
+			if (bitset.Count() != count || bitset.Count(false) != kBitCount - count) { ++mismatch; }
+			for (bool value : { false, true }) {
+				if (bitset.FindFirst(value) != ReferenceFind(reference, 0, value)) { ++mismatch; }
+				if (bitset.FindLast(value) != ReferenceFindReverse(reference, kBitCount, value)) { ++mismatch; }
+				if (bitset.Any(value) != (ReferenceFind(reference, 0, value) != kBitCount)) { ++mismatch; }
+				for (size_t n = 0; n < 8; ++n) {
+					size_t i = index(engine);
+					if (bitset.FindNext(i, value) != ReferenceFind(reference, i + 1, value)) { ++mismatch; }
+					if (bitset.FindPrev(i, value) != ReferenceFindReverse(reference, i, value)) { ++mismatch; }
+				}
+			}
+			size_t iterated = 0;
+			for (size_t i : bitset) {
+				if (!reference[i]) { ++mismatch; }
+				++iterated;
+			}
+			if (iterated != count) { ++mismatch; }
+		};
+
+		bitset.Reset();
+		check();
+		bitset.Set();
+		reference.assign(kBitCount, true);
+		check();
+		for (size_t n = 0; n < 2000; ++n) {
+			size_t i = index(engine);
+			size_t j = index(engine);
+			size_t first = i < j ? i : j;
+			size_t count = (i < j ? j : i) - first;
+			bool value = (n & 1) != 0;
+			switch (n % 5) {
+			case 0:
+				bitset.SetRange(first, count, value);
+				for (size_t k = first; k < first + count; ++k) { reference[k] = value; }
+				break;
+			case 1:
+				bitset.ResetRange(first, count / 8);
+				for (size_t k = first; k < first + count / 8; ++k) { reference[k] = false; }
+				break;
+			case 2:
+				bitset.Flip(i);
+				reference[i] = !reference[i];
+				break;
+			case 3:
+				bitset.Set(i, value);
+				reference[i] = value;
+				break;
+			default:
+				bitset.Reset(i);
+				reference[i] = false;
+				break;
+			}
+			check();
+		}
+
+		// ワード単位の演算
+		other.Reset();
+		otherReference.assign(kBitCount, false);
+		for (size_t n = 0; n < kBitCount / 3; ++n) {
+			size_t i = index(engine);
+			other.Set(i);
+			otherReference[i] = true;
+		}
+		Bitset saved = bitset;
+		std::vector<bool> savedReference = reference;
+		bitset &= other;
+		for (size_t k = 0; k < kBitCount; ++k) { reference[k] = reference[k] && otherReference[k]; }
+		check();
+		bitset |= saved;
+		for (size_t k = 0; k < kBitCount; ++k) { reference[k] = reference[k] || savedReference[k]; }
+		check();
+		bitset ^= other;
+		for (size_t k = 0; k < kBitCount; ++k) { reference[k] = reference[k] != otherReference[k]; }
+		check();
+		bitset = ~bitset;
+		reference.flip();
+		check();
+		if ((bitset ^ bitset).Any() || !(bitset == Bitset(bitset))) { ++mismatch; }
+		return mismatch;
+	}
+
+	void Verify() {
+		char detail[128];
+		size_t mismatch = VerifyBitset<1>(1) + VerifyBitset<64>(2) + VerifyBitset<1000>(3) + VerifyBitset<4096>(4) + VerifyBitset<70001>(5);
+		std::snprintf(detail, sizeof(detail), "matches std::vector<bool>, %zu mismatch", mismatch);
+		Benchmark::Check("Bitset", mismatch == 0, detail);
+	}
+
+	// どのベンチマークから始めても最初に一度だけ確認する
+	void VerifyOnce() {
+		static const bool verified = [] {
+			Verify();
+			return true;
+		}();
+		Benchmark::DoNotOptimize(verified);
+	}
+
+	// 確保と解放を繰り返すときの位置（スロット確保で空きを探す使い方）
+	template<size_t kBitCount>
+	const std::vector<size_t>& GetSlots() {
+		static const std::vector<size_t> slots = [] {
+			std::mt19937 engine(static_cast<uint32_t>(kBitCount));
+			std::uniform_int_distribution<size_t> index(0, kBitCount - 1);
+			std::vector<size_t> result;
+			for (size_t i = 0; i < kOperationCount; ++i) {
+				result.emplace_back(index(engine));
+			}
+			return result;
+		}();
+		return slots;
+	}
+
+	// ほぼ埋まった状態で1つ解放し、空きを探して確保し直す
+	template<template<size_t> class BitsetType, size_t kBitCount>
+	void AllocateFree(size_t iterationCount) {
+		VerifyOnce();
+		static BitsetType<kBitCount> bitset;
+		const std::vector<size_t>& slots = GetSlots<kBitCount>();
+		bitset.Set();
+		for (size_t n = 0; n < iterationCount; ++n) {
+			for (size_t slot : slots) {
+				bitset.Reset(slot);
+				size_t found = bitset.FindFirst(false);
+				bitset.Set(found);
+				Benchmark::DoNotOptimize(found);
+			}
+		}
+	}
+
+	// 1/256の密度で立っているビットを順に列挙する
+	template<template<size_t> class BitsetType, size_t kBitCount>
+	void IterateSparse(size_t iterationCount) {
+		VerifyOnce();
+		static BitsetType<kBitCount> bitset;
+		static bool initialized = false;
+		if (!initialized) {
+			initialized = true;
+			bitset.Reset();
+			std::mt19937 engine(17);
+			std::uniform_int_distribution<size_t> index(0, kBitCount - 1);
+			for (size_t i = 0; i < kBitCount / 256 + 1; ++i) {
+				bitset.Set(index(engine));
+			}
+		}
+		for (size_t n = 0; n < iterationCount; ++n) {
+			size_t sum = 0;
+			for (size_t i = bitset.FindFirst(true); i < kBitCount; i = bitset.FindNext(i, true)) {
+				sum += i;
+			}
+			Benchmark::DoNotOptimize(sum);
+		}
+	}
+
+	// 半分の範囲を1にしてから0に戻す
+	template<size_t kBitCount>
+	void SetRangeLegacy(size_t iterationCount) {
+		VerifyOnce();
+		static LegacyBitset<kBitCount> bitset;
+		for (size_t n = 0; n < iterationCount; ++n) {
+			for (size_t i = kBitCount / 4; i < kBitCount / 4 * 3; ++i) { bitset.Set(i); }
+			Benchmark::ClobberMemory();
+			for (size_t i = kBitCount / 4; i < kBitCount / 4 * 3; ++i) { bitset.Reset(i); }
+			Benchmark::ClobberMemory();
+		}
+	}
+	template<size_t kBitCount>
+	void SetRangeHierarchical(size_t iterationCount) {
+		VerifyOnce();
+		static Engine::Bitset<kBitCount> bitset;
+		for (size_t n = 0; n < iterationCount; ++n) {
+			bitset.SetRange(kBitCount / 4, kBitCount / 2);
+			Benchmark::ClobberMemory();
+			bitset.ResetRange(kBitCount / 4, kBitCount / 2);
+			Benchmark::ClobberMemory();
+		}
+	}
+
+	template<size_t kBitCount>
+	void Count(size_t iterationCount) {
+		VerifyOnce();
+		static Engine::Bitset<kBitCount> bitset;
+		bitset.SetRange(kBitCount / 3, kBitCount / 3);
+		for (size_t n = 0; n < iterationCount; ++n) {
+			Benchmark::DoNotOptimize(bitset.Count());
+		}
+	}
+
+	constexpr size_t k1K = 1024;
+	constexpr size_t k64K = 65536;
+	constexpr size_t k1M = 1048576;
+
+}
+
+BENCHMARK("Bitset/AllocateFree x256 1K/Legacy", (AllocateFree<LegacyBitset, k1K>));
+BENCHMARK("Bitset/AllocateFree x256 1K/Hierarchical", (AllocateFree<Engine::Bitset, k1K>));
+BENCHMARK("Bitset/AllocateFree x256 64K/Legacy", (AllocateFree<LegacyBitset, k64K>));
+BENCHMARK("Bitset/AllocateFree x256 64K/Hierarchical", (AllocateFree<Engine::Bitset, k64K>));
+BENCHMARK("Bitset/AllocateFree x256 1M/Legacy", (AllocateFree<LegacyBitset, k1M>));
+BENCHMARK("Bitset/AllocateFree x256 1M/Hierarchical", (AllocateFree<Engine::Bitset, k1M>));
+BENCHMARK("Bitset/IterateSparse 1K/Legacy", (IterateSparse<LegacyBitset, k1K>));
+BENCHMARK("Bitset/IterateSparse 1K/Hierarchical", (IterateSparse<Engine::Bitset, k1K>));
+BENCHMARK("Bitset/IterateSparse 64K/Legacy", (IterateSparse<LegacyBitset, k64K>));
+BENCHMARK("Bitset/IterateSparse 64K/Hierarchical", (IterateSparse<Engine::Bitset, k64K>));
+BENCHMARK("Bitset/IterateSparse 1M/Legacy", (IterateSparse<LegacyBitset, k1M>));
+BENCHMARK("Bitset/IterateSparse 1M/Hierarchical", (IterateSparse<Engine::Bitset, k1M>));
+BENCHMARK("Bitset/SetRange 1K/Legacy", SetRangeLegacy<k1K>);
+BENCHMARK("Bitset/SetRange 1K/Hierarchical", SetRangeHierarchical<k1K>);
+BENCHMARK("Bitset/SetRange 64K/Legacy", SetRangeLegacy<k64K>);
+BENCHMARK("Bitset/SetRange 64K/Hierarchical", SetRangeHierarchical<k64K>);
+BENCHMARK("Bitset/SetRange 1M/Legacy", SetRangeLegacy<k1M>);
+BENCHMARK("Bitset/SetRange 1M/Hierarchical", SetRangeHierarchical<k1M>);
+BENCHMARK("Bitset/Count 1K", Count<k1K>);
+BENCHMARK("Bitset/Count 64K", Count<k64K>);
+BENCHMARK("Bitset/Count 1M", Count<k1M>);
@@ -0,0 +1,156 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "MathUtils.h"
+
+// BoundingVolume の一括処理とスカラー処理を比較する
+// 1回の計測でkCount個をまとめて処理する
+// 一括処理の結果はスカラー処理と一致するか最初に確認する
+
+namespace {
+
+	constexpr size_t kCount = 4096;
+
+	struct Scene {
+		std::vector<Vector3> points;
+		std::vector<AABB> aabbs;
+		std::vector<BoundingSphere> spheres;
+		std::vector<OBB> obbs;
+		Matrix4x4 transform;
+		Frustum frustum;
+		BoundingSphere sphere;
+	};
+
+	void Verify(const char* name, bool succeeded) {
+		Benchmark::Check(name, succeeded, "batch result matches scalar result");
+	}
+
+	const Scene& GetScene() {
+		static const Scene scene = [] {
+			Scene s;
+			std::mt19937 engine(54321);
+			std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+			std::uniform_real_distribution<float> size(0.1f, 5.0f);
+			std::uniform_real_distribution<float> angle(-Math::Pi, Math::Pi);
+			auto randomVector3 = [&] { return Vector3(position(engine), position(engine), position(engine)); };
+			for (size_t i = 0; i < kCount; ++i) {
+				Vector3 center = randomVector3();
+				Vector3 extents(size(engine), size(engine), size(engine));
+				s.points.emplace_back(center);
+				s.aabbs.emplace_back(center - extents, center + extents);
+				s.spheres.emplace_back(center, extents.x);
+				s.obbs.emplace_back(center, extents, Quaternion::MakeFromEulerAngle(Vector3(angle(engine), angle(engine), angle(engine))));
+			}
+			s.transform = Matrix4x4::MakeAffine(Vector3(1.0f, 2.0f, 0.5f), Quaternion::MakeFromEulerAngle(Vector3(0.3f, 1.2f, -0.4f)), Vector3(10.0f, -5.0f, 3.0f));
+			Matrix4x4 view = (Matrix4x4::MakeLookRotation(Vector3(0.2f, -0.1f, 1.0f).Normalized()) * Matrix4x4::MakeTranslation(Vector3(0.0f, 0.0f, -120.0f))).GetInverse();
+			s.frustum = Frustum::MakeFromMatrix(view * Matrix4x4::MakePerspectiveProjection(Math::ToRadian * 60.0f, 16.0f / 9.0f, 0.1f, 200.0f));
+			s.sphere = BoundingSphere(Vector3(10.0f, 0.0f, -20.0f), 60.0f);
+
+			// 一括処理の検証
+			std::vector<uint8_t> results(kCount);
+			bool matched = true;
+			s.frustum.IntersectsBatch(s.aabbs.data(), kCount, results.data());
+			for (size_t i = 0; i < kCount; ++i) { matched &= (results[i] != 0) == s.frustum.Intersects(s.aabbs[i]); }
+			Verify("Frustum::IntersectsBatch(AABB)", matched);
+			matched = true;
+			s.frustum.IntersectsBatch(s.spheres.data(), kCount, results.data());
+			for (size_t i = 0; i < kCount; ++i) { matched &= (results[i] != 0) == s.frustum.Intersects(s.spheres[i]); }
+			Verify("Frustum::IntersectsBatch(BoundingSphere)", matched);
+			matched = true;
+			s.sphere.ContainsBatch(s.points.data(), kCount, results.data());
+			for (size_t i = 0; i < kCount; ++i) { matched &= (results[i] != 0) == s.sphere.Contains(s.points[i]); }
+			Verify("BoundingSphere::ContainsBatch", matched);
+			std::vector<AABB> transformed(kCount);
+			AABB::TransformBatch(s.aabbs.data(), kCount, s.transform, transformed.data());
+			matched = true;
+			for (size_t i = 0; i < kCount; ++i) {
+				AABB expected = s.aabbs[i].Transformed(s.transform);
+				matched &= (transformed[i].min - expected.min).LengthSquare() < 1.0e-6f && (transformed[i].max - expected.max).LengthSquare() < 1.0e-6f;
+			}
+			Verify("AABB::TransformBatch", matched);
+			AABB merged = AABB::Merge(s.aabbs.data(), kCount);
+			AABB expectedMerged = AABB::empty;
+			for (const auto& aabb : s.aabbs) { expectedMerged = AABB::Merge(expectedMerged, aabb); }
+			Verify("AABB::Merge(array)", merged.min == expectedMerged.min && merged.max == expectedMerged.max);
+			AABB bounds = AABB::MakeFromPoints(s.points.data(), kCount);
+			AABB expectedBounds = AABB::empty;
+			for (const auto& point : s.points) { expectedBounds.Expand(point); }
+			Verify("AABB::MakeFromPoints", bounds.min == expectedBounds.min && bounds.max == expectedBounds.max);
+			return s;
+		}();
+		return scene;
+	}
+
+	template<class Function>
+	Benchmark::Function MakeBenchmark(Function function) {
+		return [function](size_t iterationCount) {
+			const Scene& s = GetScene();
+			for (size_t n = 0; n < iterationCount; ++n) {
+				function(s);
+				Benchmark::ClobberMemory();
+			}
+		};
+	}
+
+	std::vector<uint8_t> g_results(kCount);
+	std::vector<AABB> g_aabbs(kCount);
+
+}
+
+#define BOUNDING_VOLUME_BENCHMARK(name, ...) BENCHMARK(name, MakeBenchmark([](const Scene& s) { __VA_ARGS__ }))
+
+#pragma region Frustum
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/Frustum::Intersects(AABB)x4096/Scalar",
+	for (size_t i = 0; i < kCount; ++i) { g_results[i] = s.frustum.Intersects(s.aabbs[i]) ? 1 : 0; });
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/Frustum::Intersects(AABB)x4096/Batch",
+	Benchmark::DoNotOptimize(s.frustum.IntersectsBatch(s.aabbs.data(), kCount, g_results.data())););
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/Frustum::Intersects(Sphere)x4096/Scalar",
+	for (size_t i = 0; i < kCount; ++i) { g_results[i] = s.frustum.Intersects(s.spheres[i]) ? 1 : 0; });
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/Frustum::Intersects(Sphere)x4096/Batch",
+	Benchmark::DoNotOptimize(s.frustum.IntersectsBatch(s.spheres.data(), kCount, g_results.data())););
+BENCHMARK("BoundingVolume/Frustum::MakeFromMatrix", [](size_t iterationCount) {
+	Matrix4x4 viewProjection = Matrix4x4::MakePerspectiveProjection(1.0f, 1.777f, 0.1f, 1000.0f);
+	for (size_t n = 0; n < iterationCount; ++n) {
+		Benchmark::DoNotOptimize(viewProjection);
+		Benchmark::DoNotOptimize(Frustum::MakeFromMatrix(viewProjection));
+	}
+});
+#pragma endregion
+
+#pragma region BoundingSphere
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/BoundingSphere::Contains x4096/Scalar",
+	for (size_t i = 0; i < kCount; ++i) { g_results[i] = s.sphere.Contains(s.points[i]) ? 1 : 0; });
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/BoundingSphere::Contains x4096/Batch",
+	Benchmark::DoNotOptimize(s.sphere.ContainsBatch(s.points.data(), kCount, g_results.data())););
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/BoundingSphere::MakeFromPoints x4096",
+	Benchmark::DoNotOptimize(BoundingSphere::MakeFromPoints(s.points.data(), kCount)););
+#pragma endregion
+
+#pragma region AABB
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/AABB::Transformed x4096/Scalar",
+	for (size_t i = 0; i < kCount; ++i) { g_aabbs[i] = s.aabbs[i].Transformed(s.transform); });
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/AABB::Transformed x4096/Batch",
+	AABB::TransformBatch(s.aabbs.data(), kCount, s.transform, g_aabbs.data()););
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/AABB::Merge x4096/Scalar",
+	AABB result = AABB::empty;
+	for (const auto& aabb : s.aabbs) { result = AABB::Merge(result, aabb); }
+	Benchmark::DoNotOptimize(result););
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/AABB::Merge x4096/Batch",
+	Benchmark::DoNotOptimize(AABB::Merge(s.aabbs.data(), kCount)););
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/AABB::MakeFromPoints x4096/Scalar",
+	AABB result = AABB::empty;
+	for (const auto& point : s.points) { result.Expand(point); }
+	Benchmark::DoNotOptimize(result););
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/AABB::MakeFromPoints x4096/Batch",
+	Benchmark::DoNotOptimize(AABB::MakeFromPoints(s.points.data(), kCount)););
+#pragma endregion
+
+#pragma region OBB
+BOUNDING_VOLUME_BENCHMARK("BoundingVolume/OBB::Intersects x4096",
+	size_t count = 0;
+	for (size_t i = 0; i < kCount; ++i) { count += s.obbs[i].Intersects(s.obbs[(i + 1) % kCount]) ? 1 : 0; }
+	Benchmark::DoNotOptimize(count););
+#pragma endregion
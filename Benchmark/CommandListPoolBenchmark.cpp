@@ -0,0 +1,182 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "CommandListPool.h"
+#include "FrameScheduler.h"
+#include "ParallelCommandRecorder.h"
+#include "SimulatedGPUQueue.h"
+
+// 模擬のアロケータとリストで、毎回作って破棄する以前の方式とプールから使い回す方式、1スレッドと複数スレッドでの記録を比べる
+// 最初にフェンスを待ってからアロケータを使い回すこと、数が積まれたフレームの分で止まること、複数スレッドで記録したリストが番号の順に1回で積まれることを確認して標準エラーに出す
+
+namespace {
+
+	using namespace std::chrono_literals;
+	using Engine::CommandListPool;
+	using Engine::SimulatedCommandListBackend;
+
+	// エミッター一つ分の記録のつもり
+	constexpr uint32_t kCommandsPerJob = 256;
+
+	void RecordJob(uint32_t jobIndex, void* commandList) {
+		for (uint32_t n = 0; n < kCommandsPerJob; ++n) {
+			SimulatedCommandListBackend::RecordCommand(commandList, jobIndex * kCommandsPerJob + n);
+		}
+	}
+
+	// 3フレームを並行して積み、フレームごとに8個のリストを取って積む
+	void VerifyRecycling() {
+		constexpr uint32_t kFrameCount = 3;
+		constexpr uint32_t kListsPerFrame = 8;
+		Engine::SimulatedGPUQueue queue;
+		SimulatedCommandListBackend backend(&queue, 1us);
+		CommandListPool::Statistics statistics{};
+		bool discardReused = false;
+		{
+			CommandListPool pool;
+			pool.Initalize(&backend, &queue);
+			Engine::FrameScheduler scheduler;
+			scheduler.Initalize(&queue, kFrameCount);
+			CommandListPool::CommandContext contexts[kListsPerFrame];
+			for (int frame = 0; frame < 100; ++frame) {
+				scheduler.BeginFrame();
+				for (uint32_t i = 0; i < kListsPerFrame; ++i) {
+					contexts[i] = pool.Acquire();
+					RecordJob(i, contexts[i].commandList);
+				}
+				pool.Submit(contexts, kListsPerFrame);
+				scheduler.EndFrame();
+				backend.ClearExecutedCommands();
+			}
+			// 積まずに返したアロケータはすぐに使われる
+			CommandListPool::CommandContext discarded = pool.Acquire();
+			void* discardedAllocator = discarded.allocator;
+			pool.Discard(discarded);
+			CommandListPool::CommandContext reused = pool.Acquire();
+			discardReused = reused.allocator == discardedAllocator;
+			pool.Discard(reused);
+			statistics = pool.GetStatistics();
+			// Finalizeは積んだリストが終わるまで待ってから破棄する
+		}
+		// GPUを待つフレームと、プールが待たずに新しく作るフレームがあるので、アロケータは(フレーム数+1)フレーム分まで
+		bool bounded = statistics.allocatorCount <= kListsPerFrame * (kFrameCount + 1) && statistics.commandListCount == kListsPerFrame;
+		bool released = backend.GetAllocatorCount() == 0 && backend.GetCommandListCount() == 0;
+		char detail[160];
+		std::snprintf(detail, sizeof(detail), "%u allocators, %u lists for 800 recordings, %llu allocator reuses, %u misuse",
+			statistics.allocatorCount, statistics.commandListCount, static_cast<unsigned long long>(statistics.allocatorReuseCount), backend.GetErrorCount());
+		Benchmark::Check("CommandListPool", bounded && released && discardReused && backend.GetErrorCount() == 0, detail);
+	}
+
+	// 複数スレッドで記録しても番号の順に1回で積まれるか
+	void VerifyParallelOrder() {
+		constexpr uint32_t kJobCount = 64;
+		Engine::SimulatedGPUQueue queue;
+		SimulatedCommandListBackend backend(&queue);
+		size_t mismatched = 0;
+		uint32_t executeCount = 0;
+		{
+			CommandListPool pool;
+			pool.Initalize(&backend, &queue);
+			Engine::ParallelCommandRecorder recorder;
+			recorder.Initalize(&pool, 3);
+			for (int frame = 0; frame < 20; ++frame) {
+				uint32_t executeCountBefore = backend.GetExecuteCount();
+				recorder.Record(kJobCount, RecordJob);
+				uint64_t fenceValue = recorder.Submit();
+				executeCount = std::max(executeCount, backend.GetExecuteCount() - executeCountBefore);
+				const std::vector<uint32_t>& executed = backend.GetExecutedCommands();
+				if (executed.size() != kJobCount * kCommandsPerJob) { ++mismatched; }
+				for (size_t i = 0; i < executed.size(); ++i) {
+					if (executed[i] != i) { ++mismatched; break; }
+				}
+				backend.ClearExecutedCommands();
+				queue.WaitForValue(fenceValue);
+			}
+		}
+		char detail[128];
+		std::snprintf(detail, sizeof(detail), "%u jobs on 4 threads, %zu out of order, %u execute calls per submit, %u misuse",
+			kJobCount, mismatched, executeCount, backend.GetErrorCount());
+		Benchmark::Check("CommandListPool", mismatched == 0 && executeCount == 1 && backend.GetErrorCount() == 0, detail);
+	}
+
+	bool Initalize() {
+		static const bool initialized = [] {
+			VerifyRecycling();
+			VerifyParallelOrder();
+			return true;
+		}();
+		return initialized;
+	}
+
+	// 以前の方式（CommandListのように、記録ごとにアロケータとリストを作って待ってから破棄する）
+	void RecordCreateEveryTime(SimulatedCommandListBackend& backend, Engine::SimulatedGPUQueue& queue, uint32_t listCount) {
+		std::vector<void*> allocators(listCount), commandLists(listCount);
+		for (uint32_t i = 0; i < listCount; ++i) {
+			allocators[i] = backend.CreateAllocator();
+			commandLists[i] = backend.CreateCommandList(allocators[i]);
+			RecordJob(i, commandLists[i]);
+			backend.CloseCommandList(commandLists[i]);
+		}
+		backend.ExecuteCommandLists(commandLists.data(), listCount);
+		queue.WaitForValue(queue.Signal());
+		for (uint32_t i = 0; i < listCount; ++i) {
+			backend.DestroyCommandList(commandLists[i]);
+			backend.DestroyAllocator(allocators[i]);
+		}
+		backend.ClearExecutedCommands();
+	}
+
+	void RecordParallel(uint32_t workerCount, size_t iterationCount) {
+		Engine::SimulatedGPUQueue queue;
+		SimulatedCommandListBackend backend(&queue);
+		CommandListPool pool;
+		pool.Initalize(&backend, &queue);
+		Engine::ParallelCommandRecorder recorder;
+		recorder.Initalize(&pool, workerCount);
+		for (size_t n = 0; n < iterationCount; ++n) {
+			recorder.Record(64, RecordJob);
+			recorder.Submit();
+			backend.ClearExecutedCommands();
+		}
+		recorder.Finalize();
+	}
+
+}
+
+BENCHMARK("CommandListPool/8 lists/Create every time", [](size_t iterationCount) {
+	Initalize();
+	Engine::SimulatedGPUQueue queue;
+	SimulatedCommandListBackend backend(&queue);
+	for (size_t n = 0; n < iterationCount; ++n) {
+		RecordCreateEveryTime(backend, queue, 8);
+	}
+});
+BENCHMARK("CommandListPool/8 lists/Pooled", [](size_t iterationCount) {
+	Initalize();
+	Engine::SimulatedGPUQueue queue;
+	SimulatedCommandListBackend backend(&queue);
+	CommandListPool pool;
+	pool.Initalize(&backend, &queue);
+	CommandListPool::CommandContext contexts[8];
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (uint32_t i = 0; i < 8; ++i) {
+			contexts[i] = pool.Acquire();
+			RecordJob(i, contexts[i].commandList);
+		}
+		pool.Submit(contexts, 8);
+		backend.ClearExecutedCommands();
+	}
+	pool.Finalize();
+});
+BENCHMARK("CommandListPool/64 jobs/Record on 1 thread", [](size_t iterationCount) {
+	Initalize();
+	RecordParallel(0, iterationCount);
+});
+BENCHMARK("CommandListPool/64 jobs/Record on 4 threads", [](size_t iterationCount) {
+	Initalize();
+	RecordParallel(3, iterationCount);
+});
@@ -0,0 +1,146 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "DeferredReleaseQueue.h"
+#include "ManualGPUQueue.h"
+
+// 手で進めるGPU（Benchmark::ManualGPUQueue）で、預けたオブジェクトがGPUの通過前に破棄されないこと（フレームの途中のシグナルでは破棄しない）、
+// 上限を決めると破棄がフレームに分散されることを確認して標準エラーに出し、預けて破棄するコストを測る
+
+namespace {
+
+	// 破棄された順に番号を記録するオブジェクト
+	struct Object {
+		uint32_t id;
+		std::vector<uint32_t>* destroyed;
+	};
+	void DestroyObject(void* object) {
+		Object* o = static_cast<Object*>(object);
+		o->destroyed->push_back(o->id);
+	}
+
+	void CheckFence() {
+		Benchmark::ManualGPUQueue queue;
+		Engine::DeferredReleaseQueue releaseQueue;
+		releaseQueue.Initalize(&queue);
+		std::vector<uint32_t> destroyed;
+		Object objects[4] = { { 0, &destroyed }, { 1, &destroyed }, { 2, &destroyed }, { 3, &destroyed } };
+		// フレーム1で0と1、フレーム2で2を預ける
+		releaseQueue.Release(&objects[0], DestroyObject);
+		// フレームの途中で別のリストを積んでシグナルしても、記録中のリストはまだ積まれていない
+		uint64_t midFrame = queue.Signal();
+		releaseQueue.Release(&objects[1], DestroyObject);
+		uint64_t frame1Value = queue.Signal();
+		releaseQueue.EndFrame(frame1Value);
+		releaseQueue.Release(&objects[2], DestroyObject);
+		uint64_t frame2Value = queue.Signal();
+		releaseQueue.EndFrame(frame2Value);
+		// 前の値を指定しても、順を保つためにフレーム2まで待つ
+		releaseQueue.Release(&objects[3], DestroyObject, 1);
+		uint32_t beforeGPU = releaseQueue.Process();
+		queue.Complete(midFrame);
+		uint32_t midFrameCount = releaseQueue.Process();
+		queue.Complete(frame1Value);
+		uint32_t frame1 = releaseQueue.Process();
+		queue.Complete(frame2Value);
+		uint32_t frame2 = releaseQueue.Process();
+		std::vector<uint32_t> expected = { 0, 1, 2, 3 };
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "destroyed %u / %u / %u / %u after gpu 0 / mid-frame / 1 / 2", beforeGPU, midFrameCount, frame1, frame2);
+		Benchmark::Check("DeferredRelease", beforeGPU == 0 && midFrameCount == 0 && frame1 == 2 && frame2 == 2 && destroyed == expected, detail);
+	}
+
+	void CheckBudget() {
+		Benchmark::ManualGPUQueue queue;
+		Engine::DeferredReleaseQueue releaseQueue;
+		releaseQueue.Initalize(&queue, 16);
+		std::vector<uint32_t> destroyed;
+		std::vector<Object> objects(100);
+		for (uint32_t i = 0; i < 100; ++i) {
+			objects[i] = Object{ i, &destroyed };
+			releaseQueue.Release(&objects[i], DestroyObject);
+		}
+		uint64_t fenceValue = queue.Signal();
+		releaseQueue.EndFrame(fenceValue);
+		queue.Complete(fenceValue);
+		uint32_t frames = 0;
+		while (releaseQueue.Process() != 0) { ++frames; }
+		// 通過していないものはFlushで待ってから破棄する
+		releaseQueue.Release(&objects[0], DestroyObject);
+		releaseQueue.Flush();
+		Engine::DeferredReleaseQueue::Statistics statistics = releaseQueue.GetStatistics();
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "100 objects over %u frames, max %u per frame, flushed %u", frames, statistics.maxDestroyCount, statistics.pendingCount);
+		Benchmark::Check("DeferredRelease", frames == 7 && statistics.maxDestroyCount == 16 && destroyed.size() == 101 && statistics.pendingCount == 0, detail);
+	}
+
+	// グラフィックスとコンピュートの両方で使うものは、両方が通過するまで破棄しない
+	void CheckQueues() {
+		Benchmark::ManualGPUQueue graphicsQueue;
+		Benchmark::ManualGPUQueue computeQueue;
+		Engine::DeferredReleaseQueue releaseQueue;
+		releaseQueue.Initalize({ &graphicsQueue, &computeQueue });
+		std::vector<uint32_t> destroyed;
+		Object objects[2] = { { 0, &destroyed }, { 1, &destroyed } };
+		releaseQueue.Release(&objects[0], DestroyObject);
+		uint64_t graphicsValue = graphicsQueue.Signal();
+		releaseQueue.EndFrame(graphicsValue);
+		uint64_t computeValue = computeQueue.Signal();
+		graphicsQueue.Complete(graphicsValue);
+		uint32_t graphicsOnly = releaseQueue.Process();
+		computeQueue.Complete(computeValue);
+		uint32_t both = releaseQueue.Process();
+		// Flushはどちらのキューも待つ
+		releaseQueue.Release(&objects[1], DestroyObject);
+		releaseQueue.Flush();
+		bool flushed = graphicsQueue.GetCompletedValue() > graphicsValue && computeQueue.GetCompletedValue() > computeValue;
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "2 queues: destroyed %u after graphics, %u after compute", graphicsOnly, both);
+		Benchmark::Check("DeferredRelease", graphicsOnly == 0 && both == 1 && flushed && destroyed.size() == 2, detail);
+	}
+
+	bool Initalize() {
+		static const bool initialized = [] {
+			CheckFence();
+			CheckBudget();
+			CheckQueues();
+			return true;
+		}();
+		return initialized;
+	}
+
+	void DestroyNothing(void*) {}
+
+}
+
+BENCHMARK("DeferredRelease/Release and process (64 per frame)", [](size_t iterationCount) {
+	Initalize();
+	Benchmark::ManualGPUQueue queue;
+	Engine::DeferredReleaseQueue releaseQueue;
+	releaseQueue.Initalize(&queue);
+	static int object;
+	for (size_t n = 0; n < iterationCount; ++n) {
+		releaseQueue.Release(&object, DestroyNothing);
+		if ((n & 63) == 63) {
+			uint64_t fenceValue = queue.Signal();
+			releaseQueue.EndFrame(fenceValue);
+			queue.Complete(fenceValue);
+			releaseQueue.Process();
+		}
+	}
+	releaseQueue.Flush();
+});
+BENCHMARK("DeferredRelease/Process with nothing completed", [](size_t iterationCount) {
+	Initalize();
+	Benchmark::ManualGPUQueue queue;
+	Engine::DeferredReleaseQueue releaseQueue;
+	releaseQueue.Initalize(&queue);
+	static int object;
+	releaseQueue.Release(&object, DestroyNothing);
+	for (size_t n = 0; n < iterationCount; ++n) {
+		Benchmark::DoNotOptimize(releaseQueue.Process());
+	}
+	releaseQueue.Flush();
+});
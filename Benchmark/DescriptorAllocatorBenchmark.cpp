@@ -0,0 +1,130 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "DescriptorAllocator.h"
+
+// Engine::DescriptorAllocator の確保と解放を計測する
+// 最初にランダムな確保と解放を繰り返して範囲が重ならないこと、すべて解放すると一つの空きに戻ることを確認して標準エラーに出す
+
+namespace {
+
+	using Engine::DescriptorAllocator;
+
+	constexpr uint32_t kCapacity = 65536;
+	// 1回の計測で確保、解放する数
+	constexpr size_t kOperationCount = 1024;
+
+	void Verify() {
+		DescriptorAllocator allocator;
+		allocator.Initalize(1000);
+		std::vector<int> owners(1000, 0);
+		std::vector<uint32_t> live;
+		std::mt19937 engine(11);
+		std::uniform_int_distribution<uint32_t> sizeDistribution(1, 40);
+		size_t overlaps = 0, failures = 0, sizeMismatch = 0;
+		DescriptorAllocator::Statistics worst{};
+
+		for (size_t n = 0; n < 200000; ++n) {
+			if (live.empty() || (engine() % 3) != 0) {
+				// 単体と範囲を混ぜる
+				uint32_t count = (engine() & 1) != 0 ? 1 : sizeDistribution(engine);
+				uint32_t index = allocator.Allocate(count);
+				if (index == DescriptorAllocator::kInvalidIndex) {
+					++failures;
+					// 空きが足りているのに確保できないのは断片化のせいなので、半分解放する
+					for (size_t i = 0; i < live.size() / 2; ++i) {
+						uint32_t victim = live[i];
+						for (uint32_t k = 0; k < allocator.GetAllocationSize(victim); ++k) { --owners[victim + k]; }
+						if (!allocator.Deallocate(victim)) { ++overlaps; }
+					}
+					live.erase(live.begin(), live.begin() + live.size() / 2);
+					continue;
+				}
+				if (allocator.GetAllocationSize(index) != count) { ++sizeMismatch; }
+				for (uint32_t k = 0; k < count; ++k) {
+					if (owners[index + k]++ != 0) { ++overlaps; }
+				}
+				live.emplace_back(index);
+			}
+			else {
+				size_t i = engine() % live.size();
+				uint32_t index = live[i];
+				live[i] = live.back();
+				live.pop_back();
+				for (uint32_t k = 0; k < allocator.GetAllocationSize(index); ++k) { --owners[index + k]; }
+				if (!allocator.Deallocate(index)) { ++overlaps; }
+			}
+			if (n % 1000 == 0) {
+				DescriptorAllocator::Statistics statistics = allocator.GetStatistics();
+				if (statistics.fragmentation > worst.fragmentation) { worst = statistics; }
+			}
+		}
+		for (uint32_t index : live) { allocator.Deallocate(index); }
+		DescriptorAllocator::Statistics statistics = allocator.GetStatistics();
+		bool merged = statistics.usedCount == 0 && statistics.freeBlockCount == 1 && statistics.largestFreeBlock == 1000;
+
+		char detail[192];
+		std::snprintf(detail, sizeof(detail), "%zu overlaps, %zu size mismatch, %zu full, worst fragmentation %.2f (%u blocks), merged back %s",
+			overlaps, sizeMismatch, failures, worst.fragmentation, worst.freeBlockCount, merged ? "yes" : "no");
+		Benchmark::Check("DescriptorAllocator", overlaps == 0 && sizeMismatch == 0 && merged, detail);
+
+#ifdef NDEBUG
+		// デバッグビルドではassertで止まるので、リリースビルドでのみ戻り値を確認する
+		uint32_t index = allocator.Allocate(4);
+		bool detected = allocator.Deallocate(index) && !allocator.Deallocate(index) && !allocator.Deallocate(index + 1) && !allocator.Deallocate(5000);
+		Benchmark::Check("DescriptorAllocator", detected, "double free and invalid index rejected");
+#endif
+	}
+
+	struct Inputs {
+		DescriptorAllocator allocator;
+		std::vector<uint32_t> counts;
+		std::vector<uint32_t> indices;
+	};
+
+	Inputs& GetInputs() {
+		static Inputs inputs = [] {
+			Inputs in;
+			Verify();
+			in.allocator.Initalize(kCapacity);
+			std::mt19937 engine(3);
+			std::uniform_int_distribution<uint32_t> sizeDistribution(1, 32);
+			for (size_t i = 0; i < kOperationCount; ++i) {
+				in.counts.emplace_back(sizeDistribution(engine));
+			}
+			in.indices.resize(kOperationCount);
+			// 半分ほど埋めて断片化させておく
+			std::vector<uint32_t> filler;
+			for (size_t i = 0; i < kCapacity / 32; ++i) {
+				filler.emplace_back(in.allocator.Allocate(in.counts[i % kOperationCount]));
+			}
+			for (size_t i = 0; i < filler.size(); i += 2) {
+				in.allocator.Deallocate(filler[i]);
+			}
+			return in;
+		}();
+		return inputs;
+	}
+
+}
+
+// 1回の計測でkOperationCount個を確保してから全部解放する
+BENCHMARK("DescriptorAllocator/Allocate+Deallocate x1024/Single", [](size_t iterationCount) {
+	Inputs& in = GetInputs();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (size_t i = 0; i < kOperationCount; ++i) { in.indices[i] = in.allocator.Allocate(1); }
+		for (size_t i = 0; i < kOperationCount; ++i) { in.allocator.Deallocate(in.indices[i]); }
+		Benchmark::ClobberMemory();
+	}
+});
+BENCHMARK("DescriptorAllocator/Allocate+Deallocate x1024/Range 1-32", [](size_t iterationCount) {
+	Inputs& in = GetInputs();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (size_t i = 0; i < kOperationCount; ++i) { in.indices[i] = in.allocator.Allocate(in.counts[i]); }
+		for (size_t i = kOperationCount; i > 0; --i) { in.allocator.Deallocate(in.indices[i - 1]); }
+		Benchmark::ClobberMemory();
+	}
+});
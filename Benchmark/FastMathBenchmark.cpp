@@ -0,0 +1,153 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "MathUtils.h"
+
+// FastMath.h の近似関数と std:: を比較する
+// 最初に密にサンプリングした範囲で倍精度の std:: との誤差を測り、
+// コメントに書いた最大誤差を超えていないか、配列版とスカラー版が一致するかを標準エラーに出す
+
+namespace {
+
+	constexpr size_t kCount = 4096;
+	constexpr size_t kSampleCount = size_t(1) << 22;
+
+	struct Inputs {
+		// -π~π
+		std::vector<float> angle;
+		// -1~1
+		std::vector<float> cosine;
+		std::vector<float> y, x;
+		// 1e-3~1e3
+		std::vector<float> positive;
+		// -10~10
+		std::vector<float> exponent;
+		std::vector<float> results, results2;
+	};
+
+	// 絶対誤差と相対誤差の大きい方を測る
+	template<class Fast, class Reference>
+	void CheckAccuracy(const char* name, float maxError, bool relative, float begin, float end, Fast fast, Reference reference) {
+		double measured = 0.0;
+		float worstInput = begin;
+		for (size_t i = 0; i <= kSampleCount; ++i) {
+			float x = begin + (end - begin) * static_cast<float>(static_cast<double>(i) / kSampleCount);
+			double expected = reference(static_cast<double>(x));
+			double error = std::abs(static_cast<double>(fast(x)) - expected);
+			if (relative) { error /= std::abs(expected); }
+			if (!(error <= measured)) {
+				measured = error;
+				worstInput = x;
+			}
+		}
+		char detail[128];
+		std::snprintf(detail, sizeof(detail), "%s error %.3g (documented %.3g, worst x = %.9g)",
+			relative ? "relative" : "absolute", measured, static_cast<double>(maxError), static_cast<double>(worstInput));
+		Benchmark::Check(name, measured <= maxError, detail);
+	}
+
+	// 配列版がスカラー版とビット単位で一致するか
+	template<class Batch, class Scalar>
+	void CheckBatch(const char* name, const std::vector<float>& input, std::vector<float>& output, Batch batch, Scalar scalar) {
+		batch(input.data(), output.data(), input.size());
+		size_t mismatch = 0;
+		for (size_t i = 0; i < input.size(); ++i) {
+			if (output[i] != scalar(input[i])) { ++mismatch; }
+		}
+		char detail[128];
+		std::snprintf(detail, sizeof(detail), "batch mismatch %zu / %zu", mismatch, input.size());
+		Benchmark::Check((std::string(name) + "(array)").c_str(), mismatch == 0, detail);
+	}
+
+	Inputs& GetInputs() {
+		static Inputs inputs = [] {
+			using namespace Math;
+			Inputs in;
+			std::mt19937 engine(777);
+			std::uniform_real_distribution<float> angle(-Pi, Pi);
+			std::uniform_real_distribution<float> signedUnit(-1.0f, 1.0f);
+			std::uniform_real_distribution<float> logScale(-3.0f, 3.0f);
+			std::uniform_real_distribution<float> exponent(-10.0f, 10.0f);
+			for (size_t i = 0; i < kCount; ++i) {
+				in.angle.emplace_back(angle(engine));
+				in.cosine.emplace_back(signedUnit(engine));
+				in.y.emplace_back(signedUnit(engine) * 100.0f);
+				in.x.emplace_back(signedUnit(engine) * 100.0f);
+				in.positive.emplace_back(std::pow(10.0f, logScale(engine)));
+				in.exponent.emplace_back(exponent(engine));
+			}
+			in.results.resize(kCount);
+			in.results2.resize(kCount);
+
+			CheckAccuracy("FastSin", FastTrigMaxError, false, -FastTrigRange, FastTrigRange,
+				[](float x) { return FastSin(x); }, [](double x) { return std::sin(x); });
+			CheckAccuracy("FastCos", FastTrigMaxError, false, -FastTrigRange, FastTrigRange,
+				[](float x) { return FastCos(x); }, [](double x) { return std::cos(x); });
+			// 単位円上の点と、原点を通る直線上の点
+			CheckAccuracy("FastAtan2", FastAtan2MaxError, false, -Pi, Pi,
+				[](float t) { return FastAtan2(std::sin(t), std::cos(t)); }, [](double t) { return std::atan2(static_cast<double>(std::sin(static_cast<float>(t))), static_cast<double>(std::cos(static_cast<float>(t)))); });
+			CheckAccuracy("FastAtan2", FastAtan2MaxError, false, -1000.0f, 1000.0f,
+				[](float t) { return FastAtan2(t, 3.0f); }, [](double t) { return std::atan2(t, 3.0); });
+			CheckAccuracy("FastAcos", FastAcosMaxError, false, -1.0f, 1.0f,
+				[](float x) { return FastAcos(x); }, [](double x) { return std::acos(x); });
+			CheckAccuracy("FastRsqrt", FastRsqrtMaxError, true, -30.0f, 30.0f,
+				[](float e) { return FastRsqrt(std::pow(2.0f, e)); }, [](double e) { return 1.0 / std::sqrt(static_cast<double>(std::pow(2.0f, static_cast<float>(e)))); });
+			CheckAccuracy("FastExp", FastExpMaxError, true, FastExpMin, FastExpMax,
+				[](float x) { return FastExp(x); }, [](double x) { return std::exp(x); });
+
+			CheckBatch("FastSin", in.angle, in.results, [](const float* x, float* r, size_t n) { FastSin(x, r, n); }, [](float x) { return FastSin(x); });
+			CheckBatch("FastCos", in.angle, in.results, [](const float* x, float* r, size_t n) { FastCos(x, r, n); }, [](float x) { return FastCos(x); });
+			CheckBatch("FastAcos", in.cosine, in.results, [](const float* x, float* r, size_t n) { FastAcos(x, r, n); }, [](float x) { return FastAcos(x); });
+			CheckBatch("FastRsqrt", in.positive, in.results, [](const float* x, float* r, size_t n) { FastRsqrt(x, r, n); }, [](float x) { return FastRsqrt(x); });
+			CheckBatch("FastExp", in.exponent, in.results, [](const float* x, float* r, size_t n) { FastExp(x, r, n); }, [](float x) { return FastExp(x); });
+			FastAtan2(in.y.data(), in.x.data(), in.results.data(), kCount);
+			size_t atan2Mismatch = 0;
+			for (size_t i = 0; i < kCount; ++i) {
+				if (in.results[i] != FastAtan2(in.y[i], in.x[i])) { ++atan2Mismatch; }
+			}
+			char detail[128];
+			std::snprintf(detail, sizeof(detail), "batch mismatch %zu / %zu", atan2Mismatch, kCount);
+			Benchmark::Check("FastAtan2(array)", atan2Mismatch == 0, detail);
+			return in;
+		}();
+		return inputs;
+	}
+
+}
+
+// 1回の計測でkCount個を処理する
+#define FAST_MATH_BENCHMARK(name, ...) \
+	BENCHMARK(name, [](size_t iterationCount) { \
+		Inputs& in = GetInputs(); \
+		for (size_t n = 0; n < iterationCount; ++n) { \
+			__VA_ARGS__; \
+			Benchmark::ClobberMemory(); \
+		} \
+	})
+#define FAST_MATH_BENCHMARK_EACH(name, expression) \
+	FAST_MATH_BENCHMARK(name, for (size_t i = 0; i < kCount; ++i) { in.results[i] = expression; })
+
+FAST_MATH_BENCHMARK_EACH("FastMath/sin x4096/std", std::sin(in.angle[i]));
+FAST_MATH_BENCHMARK_EACH("FastMath/sin x4096/Scalar", Math::FastSin(in.angle[i]));
+FAST_MATH_BENCHMARK("FastMath/sin x4096/Batch", Math::FastSin(in.angle.data(), in.results.data(), kCount));
+FAST_MATH_BENCHMARK("FastMath/sincos x4096/std", for (size_t i = 0; i < kCount; ++i) { in.results[i] = std::sin(in.angle[i]); in.results2[i] = std::cos(in.angle[i]); });
+FAST_MATH_BENCHMARK("FastMath/sincos x4096/Scalar", for (size_t i = 0; i < kCount; ++i) { Math::FastSinCos(in.angle[i], in.results[i], in.results2[i]); });
+FAST_MATH_BENCHMARK("FastMath/sincos x4096/Batch", Math::FastSinCos(in.angle.data(), in.results.data(), in.results2.data(), kCount));
+FAST_MATH_BENCHMARK_EACH("FastMath/atan2 x4096/std", std::atan2(in.y[i], in.x[i]));
+FAST_MATH_BENCHMARK_EACH("FastMath/atan2 x4096/Scalar", Math::FastAtan2(in.y[i], in.x[i]));
+FAST_MATH_BENCHMARK("FastMath/atan2 x4096/Batch", Math::FastAtan2(in.y.data(), in.x.data(), in.results.data(), kCount));
+FAST_MATH_BENCHMARK_EACH("FastMath/acos x4096/std", std::acos(in.cosine[i]));
+FAST_MATH_BENCHMARK_EACH("FastMath/acos x4096/Scalar", Math::FastAcos(in.cosine[i]));
+FAST_MATH_BENCHMARK("FastMath/acos x4096/Batch", Math::FastAcos(in.cosine.data(), in.results.data(), kCount));
+FAST_MATH_BENCHMARK_EACH("FastMath/rsqrt x4096/std", 1.0f / std::sqrt(in.positive[i]));
+FAST_MATH_BENCHMARK_EACH("FastMath/rsqrt x4096/Scalar", Math::FastRsqrt(in.positive[i]));
+FAST_MATH_BENCHMARK("FastMath/rsqrt x4096/Batch", Math::FastRsqrt(in.positive.data(), in.results.data(), kCount));
+FAST_MATH_BENCHMARK_EACH("FastMath/exp x4096/std", std::exp(in.exponent[i]));
+FAST_MATH_BENCHMARK_EACH("FastMath/exp x4096/Scalar", Math::FastExp(in.exponent[i]));
+FAST_MATH_BENCHMARK("FastMath/exp x4096/Batch", Math::FastExp(in.exponent.data(), in.results.data(), kCount));
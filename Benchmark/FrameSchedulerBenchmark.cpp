@@ -0,0 +1,145 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "FrameScheduler.h"
+#include "SimulatedGPUQueue.h"
+
+// 模擬GPUにCPU 1ms、GPU 1.5msのフレームを積み、1フレームごとにGPUを待つ以前の方式と、2～3フレームを並行して積む方式のフレーム時間を比べる
+// 最初にGPUに積まれているフレームがフレーム数を超えないこと、最後のフレームが待てることを確認し、フレーム時間、待ち時間と遅延を標準エラーに出す
+// （時間はマシンの負荷で変わるので、確認には使わず数値だけ出す）
+
+namespace {
+
+	using namespace std::chrono_literals;
+
+	constexpr std::chrono::nanoseconds kCPUFrameTime = 1ms;
+	constexpr std::chrono::nanoseconds kGPUFrameTime = 1500us;
+
+	// 記録の代わりにCPUを回す
+	void SpinFor(std::chrono::nanoseconds duration) {
+		auto end = std::chrono::steady_clock::now() + duration;
+		while (std::chrono::steady_clock::now() < end) {
+			Benchmark::ClobberMemory();
+		}
+	}
+
+	// 以前の方式（積んだらすぐにGPUを待つ）
+	void RunSynchronousFrame(Engine::SimulatedGPUQueue& queue) {
+		SpinFor(kCPUFrameTime);
+		queue.Submit(kGPUFrameTime);
+		queue.WaitForIdle();
+	}
+
+	// 1フレーム分（BeginFrameからEndFrameまで）
+	// 返すのはBeginFrameの後でGPUに積まれたまま終わっていないフレームの数
+	uint64_t RunFrame(Engine::FrameScheduler& scheduler, Engine::SimulatedGPUQueue& queue) {
+		scheduler.BeginFrame();
+		uint64_t inFlight = queue.GetLastSignaledValue() - queue.GetCompletedValue();
+		SpinFor(kCPUFrameTime);
+		queue.Submit(kGPUFrameTime);
+		scheduler.EndFrame();
+		return inFlight;
+	}
+
+	struct Result {
+		double frameMilliseconds;
+		double waitMilliseconds;
+		uint64_t maxInFlight;
+	};
+
+	Result Measure(uint32_t frameCount, int frames) {
+		Engine::SimulatedGPUQueue queue;
+		Result result{};
+		auto begin = std::chrono::steady_clock::now();
+		if (frameCount == 0) {
+			for (int n = 0; n < frames; ++n) { RunSynchronousFrame(queue); }
+		}
+		else {
+			Engine::FrameScheduler scheduler;
+			scheduler.Initalize(&queue, frameCount);
+			for (int n = 0; n < frames; ++n) {
+				result.maxInFlight = std::max(result.maxInFlight, RunFrame(scheduler, queue));
+			}
+			scheduler.WaitForIdle();
+			result.waitMilliseconds = std::chrono::duration<double, std::milli>(scheduler.GetWaitTime()).count() / frames;
+		}
+		result.frameMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count() / frames;
+		return result;
+	}
+
+	// 積まれたフレームはframeCount未満に収まるか（並行して積むとフレーム時間がCPUとGPUの長い方に近づく）
+	void VerifyFramesInFlight() {
+		constexpr int kFrames = 60;
+		Result synchronous = Measure(0, kFrames);
+		for (uint32_t frameCount = 2; frameCount <= 3; ++frameCount) {
+			Result pipelined = Measure(frameCount, kFrames);
+			// BeginFrameの後は、そのコンテキストを前に使ったフレームまで終わっている
+			bool bounded = pipelined.maxInFlight < frameCount;
+			char detail[160];
+			std::snprintf(detail, sizeof(detail), "%u frames: %.2f ms/frame (sync %.2f), wait %.2f ms/frame, max %llu in flight",
+				frameCount, pipelined.frameMilliseconds, synchronous.frameMilliseconds, pipelined.waitMilliseconds,
+				static_cast<unsigned long long>(pipelined.maxInFlight));
+			Benchmark::Check("FrameScheduler", bounded, detail);
+		}
+	}
+
+	// EndFrameから、そのフレームをGPUが終えるまでの遅延は積まれたフレームの分だけ伸びる
+	void VerifyLatency() {
+		Engine::SimulatedGPUQueue queue;
+		Engine::FrameScheduler scheduler;
+		scheduler.Initalize(&queue, 3);
+		uint64_t lastFenceValue = 0;
+		auto lastEnd = std::chrono::steady_clock::now();
+		for (int n = 0; n < 30; ++n) {
+			RunFrame(scheduler, queue);
+			lastFenceValue = scheduler.GetFenceValue(scheduler.GetFrameIndex());
+			lastEnd = std::chrono::steady_clock::now();
+		}
+		queue.WaitForValue(lastFenceValue);
+		double latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - lastEnd).count();
+		bool completed = queue.IsCompleted(lastFenceValue) && !queue.WaitForValue(queue.GetLastSignaledValue() + 1);
+		// 最大で3フレーム分のGPU時間（4.5ms）ほど
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "last frame latency %.2f ms, %llu waits", latency, static_cast<unsigned long long>(scheduler.GetWaitCount()));
+		Benchmark::Check("FrameScheduler", completed, detail);
+	}
+
+	bool Initalize() {
+		static const bool initialized = [] {
+			VerifyFramesInFlight();
+			VerifyLatency();
+			return true;
+		}();
+		return initialized;
+	}
+
+	void RunPipelined(uint32_t frameCount, size_t iterationCount) {
+		Engine::SimulatedGPUQueue queue;
+		Engine::FrameScheduler scheduler;
+		scheduler.Initalize(&queue, frameCount);
+		for (size_t n = 0; n < iterationCount; ++n) {
+			RunFrame(scheduler, queue);
+		}
+		scheduler.WaitForIdle();
+	}
+
+}
+
+BENCHMARK("FrameScheduler/CPU 1ms GPU 1.5ms/Wait every frame", [](size_t iterationCount) {
+	Initalize();
+	Engine::SimulatedGPUQueue queue;
+	for (size_t n = 0; n < iterationCount; ++n) {
+		RunSynchronousFrame(queue);
+	}
+});
+BENCHMARK("FrameScheduler/CPU 1ms GPU 1.5ms/2 frames in flight", [](size_t iterationCount) {
+	Initalize();
+	RunPipelined(2, iterationCount);
+});
+BENCHMARK("FrameScheduler/CPU 1ms GPU 1.5ms/3 frames in flight", [](size_t iterationCount) {
+	Initalize();
+	RunPipelined(3, iterationCount);
+});
@@ -0,0 +1,206 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "GPUMemoryAllocator.h"
+
+// Engine::MemoryBlockAllocator と Engine::GPUMemoryAllocator を計測する
+// 最初にCPUのメモリをヒープの代わりにして、範囲が揃っていて重ならないこと、予算を超えないことを確認して標準エラーに出す
+// 計測は、リソースごとにヒープを作る場合（CreateCommittedResource相当）と比べる
+
+namespace {
+
+	using Engine::GPUMemoryAllocator;
+	using Engine::MemoryBlockAllocator;
+	using Engine::MemoryCategory;
+
+	constexpr uint64_t kKiB = 1024;
+	constexpr uint64_t kMiB = 1024 * kKiB;
+	// 1回の計測で確保、解放する数
+	constexpr size_t kOperationCount = 256;
+
+	// ランダムな大きさとアライメントで確保と解放を繰り返し、範囲が重ならないか
+	void VerifyBlocks() {
+		constexpr uint64_t kCapacity = 16 * kMiB;
+		MemoryBlockAllocator allocator;
+		allocator.Initalize(kCapacity);
+		struct Live {
+			MemoryBlockAllocator::Allocation allocation;
+			uint64_t size;
+		};
+		std::vector<Live> live;
+		std::mt19937 engine(36);
+		const uint64_t alignments[] = { 256, 4 * kKiB, 64 * kKiB };
+		size_t overlaps = 0, misaligned = 0, failures = 0, usedMismatch = 0;
+		uint64_t usedSize = 0;
+
+		auto checkOverlaps = [&] {
+			std::vector<std::pair<uint64_t, uint64_t>> ranges;
+			for (const Live& entry : live) { ranges.emplace_back(entry.allocation.offset, entry.allocation.offset + entry.size); }
+			std::sort(ranges.begin(), ranges.end());
+			for (size_t i = 1; i < ranges.size(); ++i) {
+				if (ranges[i].first < ranges[i - 1].second) { ++overlaps; }
+			}
+			if (!ranges.empty() && ranges.back().second > kCapacity) { ++overlaps; }
+		};
+
+		for (size_t n = 0; n < 100000; ++n) {
+			if (live.empty() || (engine() % 3) != 0) {
+				uint64_t alignment = alignments[engine() % 3];
+				// 64KBの倍数（バッファ）と半端な大きさを混ぜる
+				uint64_t size = (engine() & 1) != 0 ? 64 * kKiB * (1 + engine() % 8) : 256 + engine() % (200 * kKiB);
+				MemoryBlockAllocator::Allocation allocation = allocator.Allocate(size, alignment);
+				if (!allocation.IsEnabled()) {
+					++failures;
+					for (size_t i = 0; i < live.size() / 2; ++i) {
+						usedSize -= live[i].size;
+						if (!allocator.Deallocate(live[i].allocation.handle)) { ++overlaps; }
+					}
+					live.erase(live.begin(), live.begin() + live.size() / 2);
+					continue;
+				}
+				if (allocation.offset % alignment != 0) { ++misaligned; }
+				usedSize += size;
+				live.push_back({ allocation, size });
+			}
+			else {
+				size_t i = engine() % live.size();
+				usedSize -= live[i].size;
+				if (!allocator.Deallocate(live[i].allocation.handle)) { ++overlaps; }
+				live[i] = live.back();
+				live.pop_back();
+			}
+			if (allocator.GetUsedSize() != usedSize) { ++usedMismatch; }
+			if (n % 1000 == 0) { checkOverlaps(); }
+		}
+		checkOverlaps();
+		MemoryBlockAllocator::Statistics before = allocator.GetStatistics();
+		for (const Live& entry : live) { allocator.Deallocate(entry.allocation.handle); }
+		MemoryBlockAllocator::Statistics after = allocator.GetStatistics();
+		bool allReleased = !live.empty() && !allocator.IsAllocated(live.front().allocation.handle);
+		bool coalesced = after.freeBlockCount == 1 && after.largestFreeBlock == kCapacity && after.usedSize == 0;
+
+		char detail[256];
+		std::snprintf(detail, sizeof(detail), "%zu full, %zu overlaps, %zu misaligned, %zu used mismatch, fragmentation %.2f, movable %llu KB, %s",
+			failures, overlaps, misaligned, usedMismatch, before.fragmentation, static_cast<unsigned long long>(before.movableSize / kKiB), coalesced ? "coalesced" : "not coalesced");
+		Benchmark::Check("MemoryBlockAllocator", overlaps == 0 && misaligned == 0 && usedMismatch == 0 && coalesced && allReleased, detail);
+	}
+
+	// ヒープに書き込んだ内容が他の確保で壊れないか、予算と専用ヒープ、空のヒープの破棄
+	void VerifyHeaps() {
+		Engine::CPUHeapBackingStore backingStore;
+		GPUMemoryAllocator allocator;
+		allocator.Initalize(&backingStore, 4 * kMiB);
+		allocator.SetBudget(MemoryCategory::Texture, 16 * kMiB);
+		struct Live {
+			GPUMemoryAllocator::Allocation allocation;
+			uint8_t pattern;
+		};
+		std::vector<Live> live;
+		std::mt19937 engine(360);
+		size_t corrupted = 0, budgetFailures = 0, overBudget = 0;
+
+		auto verifyPattern = [&](const Live& entry) {
+			const uint8_t* data = static_cast<const uint8_t*>(entry.allocation.heap) + entry.allocation.offset;
+			for (uint64_t k = 0; k < entry.allocation.size; k += 997) {
+				if (data[k] != entry.pattern) { return false; }
+			}
+			return data[entry.allocation.size - 1] == entry.pattern;
+		};
+
+		for (size_t n = 0; n < 20000; ++n) {
+			if (live.empty() || (engine() % 5) < 3) {
+				MemoryCategory category = (engine() & 1) != 0 ? MemoryCategory::Buffer : MemoryCategory::Texture;
+				uint64_t size = 64 * kKiB * (1 + engine() % 16);
+				GPUMemoryAllocator::Allocation allocation = allocator.Allocate(category, size);
+				if (!allocation.IsEnabled()) {
+					if (category == MemoryCategory::Texture) { ++budgetFailures; }
+					continue;
+				}
+				uint8_t pattern = static_cast<uint8_t>(1 + engine() % 255);
+				std::memset(static_cast<uint8_t*>(allocation.heap) + allocation.offset, pattern, static_cast<size_t>(size));
+				live.push_back({ allocation, pattern });
+			}
+			else {
+				size_t i = engine() % live.size();
+				if (!verifyPattern(live[i])) { ++corrupted; }
+				allocator.Deallocate(live[i].allocation);
+				live[i] = live.back();
+				live.pop_back();
+			}
+			if (allocator.GetStatistics(MemoryCategory::Texture).reservedSize > 16 * kMiB) { ++overBudget; }
+		}
+		for (const Live& entry : live) {
+			if (!verifyPattern(entry)) { ++corrupted; }
+		}
+
+		// ヒープより大きいリソースは専用のヒープになる
+		GPUMemoryAllocator::Allocation large = allocator.Allocate(MemoryCategory::RenderTarget, 10 * kMiB, 4 * kMiB);
+		bool dedicated = large.IsEnabled() && large.offset == 0 && allocator.GetStatistics(MemoryCategory::RenderTarget).reservedSize == 10 * kMiB;
+		allocator.Deallocate(large);
+
+		GPUMemoryAllocator::Statistics bufferStatistics = allocator.GetStatistics(MemoryCategory::Buffer);
+		for (Live& entry : live) { allocator.Deallocate(entry.allocation); }
+		uint32_t heapCount = backingStore.GetHeapCount();
+		uint32_t releasedCount = allocator.ReleaseEmptyHeaps();
+		bool released = releasedCount == heapCount && backingStore.GetHeapCount() == 0;
+
+		char detail[256];
+		std::snprintf(detail, sizeof(detail), "%zu corrupted, %zu over budget (%zu refused), buffer heaps %u, fragmentation %.2f, movable %llu KB, %s, released %u/%u",
+			corrupted, overBudget, budgetFailures, bufferStatistics.heapCount, bufferStatistics.fragmentation,
+			static_cast<unsigned long long>(bufferStatistics.movableSize / kKiB), dedicated ? "dedicated" : "not dedicated", releasedCount, heapCount);
+		Benchmark::Check("GPUMemoryAllocator", corrupted == 0 && overBudget == 0 && budgetFailures > 0 && dedicated && released, detail);
+	}
+
+	struct Inputs {
+		// 確保する大きさ（64KBから1MB）
+		std::vector<uint64_t> sizes;
+		// 解放する順番
+		std::vector<size_t> order;
+	};
+
+	const Inputs& GetInputs() {
+		static const Inputs inputs = [] {
+			VerifyBlocks();
+			VerifyHeaps();
+			Inputs result;
+			std::mt19937 engine(3600);
+			for (size_t i = 0; i < kOperationCount; ++i) {
+				result.sizes.push_back(64 * kKiB * (1 + engine() % 16));
+				result.order.push_back(i);
+			}
+			std::shuffle(result.order.begin(), result.order.end(), engine);
+			return result;
+		}();
+		return inputs;
+	}
+
+}
+
+// リソースごとにヒープを作る（CreateCommittedResource相当）
+BENCHMARK("GPUMemory/Allocate+Deallocate x256/Heap per resource", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	Engine::CPUHeapBackingStore backingStore;
+	std::vector<void*> heaps(kOperationCount);
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (size_t i = 0; i < kOperationCount; ++i) { heaps[i] = backingStore.CreateHeap(MemoryCategory::Buffer, in.sizes[i]); }
+		Benchmark::ClobberMemory();
+		for (size_t i : in.order) { backingStore.DestroyHeap(MemoryCategory::Buffer, heaps[i]); }
+	}
+});
+BENCHMARK("GPUMemory/Allocate+Deallocate x256/Suballocate", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	Engine::CPUHeapBackingStore backingStore;
+	GPUMemoryAllocator allocator;
+	allocator.Initalize(&backingStore);
+	std::vector<GPUMemoryAllocator::Allocation> allocations(kOperationCount);
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (size_t i = 0; i < kOperationCount; ++i) { allocations[i] = allocator.Allocate(MemoryCategory::Buffer, in.sizes[i]); }
+		Benchmark::ClobberMemory();
+		for (size_t i : in.order) { allocator.Deallocate(allocations[i]); }
+	}
+});
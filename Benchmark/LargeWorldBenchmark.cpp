@@ -0,0 +1,114 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Camera.h"
+
+// Vector3d とカメラ相対への変換を計測する
+// 最初に原点から1e5~1e7離れた場所で、単精度のワールド座標で計算した場合とカメラ相対で計算した場合の誤差を標準エラーに出す
+
+namespace {
+
+	constexpr size_t kCount = 4096;
+	// カメラの周りに置くエミッターの範囲
+	constexpr double kSpread = 100.0;
+
+	struct Inputs {
+		std::vector<Vector3d> positions;
+		std::vector<Vector3> results;
+		Vector3d origin;
+	};
+
+	std::vector<Vector3d> MakePositions(const Vector3d& center, size_t count, uint32_t seed) {
+		std::mt19937 engine(seed);
+		std::uniform_real_distribution<double> offset(-kSpread, kSpread);
+		std::vector<Vector3d> positions;
+		for (size_t i = 0; i < count; ++i) {
+			positions.emplace_back(center + Vector3d(offset(engine), offset(engine), offset(engine)));
+		}
+		return positions;
+	}
+
+	void ReportPrecision() {
+		std::fprintf(stderr, "%-10s %-26s %-26s\n", "distance", "float world max error", "camera relative max error");
+		for (double distance : { 1.0e5, 1.0e6, 1.0e7 }) {
+			Camera camera;
+			Vector3d cameraPosition(distance, distance * 0.25, -distance);
+			camera.SetPosition(cameraPosition);
+			camera.SetRotate(Quaternion::MakeFromEulerAngle(Vector3(0.3f, 1.1f, 0.0f)));
+			camera.UpdateMatrix();
+
+			std::vector<Vector3d> positions = MakePositions(cameraPosition, kCount, 5);
+			std::vector<Vector3> relative(kCount);
+			camera.ToCameraRelative(positions.data(), kCount, relative.data());
+
+			// ビュー空間の位置を倍精度で求めたものと比べる
+			const Matrix4x4& rotation = camera.GetRelativeViewMatrix();
+			double worldError = 0.0, relativeError = 0.0;
+			for (size_t i = 0; i < kCount; ++i) {
+				Vector3d exactOffset = positions[i] - cameraPosition;
+				double exact[3]{};
+				for (size_t j = 0; j < 3; ++j) {
+					for (size_t k = 0; k < 3; ++k) {
+						exact[j] += exactOffset[k] * static_cast<double>(rotation.m[k][j]);
+					}
+				}
+				Vector3 viaWorld = positions[i].ToVector3() * camera.GetViewMatrix();
+				Vector3 viaRelative = relative[i] * rotation;
+				for (size_t j = 0; j < 3; ++j) {
+					worldError = std::max(worldError, std::abs(static_cast<double>(viaWorld[j]) - exact[j]));
+					relativeError = std::max(relativeError, std::abs(static_cast<double>(viaRelative[j]) - exact[j]));
+				}
+			}
+			std::fprintf(stderr, "%-10.0e %-26.6g %-26.6g\n", distance, worldError, relativeError);
+		}
+	}
+
+	Inputs& GetInputs() {
+		static Inputs inputs = [] {
+			Inputs in;
+			in.origin = Vector3d(1.0e6, 2.0e5, -3.0e6);
+			in.positions = MakePositions(in.origin, kCount, 7);
+			in.results.resize(kCount);
+
+			std::vector<Vector3> batch(kCount);
+			Vector3d::RelativeToBatch(in.positions.data(), kCount, in.origin, batch.data());
+			size_t mismatch = 0;
+			for (size_t i = 0; i < kCount; ++i) {
+				if (batch[i] != in.positions[i].RelativeTo(in.origin)) { ++mismatch; }
+			}
+			char detail[128];
+			std::snprintf(detail, sizeof(detail), "batch mismatch %zu / %zu", mismatch, kCount);
+			Benchmark::Check("Vector3d::RelativeToBatch", mismatch == 0, detail);
+			ReportPrecision();
+			return in;
+		}();
+		return inputs;
+	}
+
+}
+
+// 1回の計測でkCount個を処理する
+#define LARGE_WORLD_BENCHMARK(name, ...) \
+	BENCHMARK(name, [](size_t iterationCount) { \
+		Inputs& in = GetInputs(); \
+		for (size_t n = 0; n < iterationCount; ++n) { \
+			__VA_ARGS__; \
+			Benchmark::ClobberMemory(); \
+		} \
+	})
+
+LARGE_WORLD_BENCHMARK("LargeWorld/ToVector3 x4096", for (size_t i = 0; i < kCount; ++i) { in.results[i] = in.positions[i].ToVector3(); });
+LARGE_WORLD_BENCHMARK("LargeWorld/RelativeTo x4096/Scalar", for (size_t i = 0; i < kCount; ++i) { in.results[i] = in.positions[i].RelativeTo(in.origin); });
+LARGE_WORLD_BENCHMARK("LargeWorld/RelativeTo x4096/Batch", Vector3d::RelativeToBatch(in.positions.data(), kCount, in.origin, in.results.data()));
+BENCHMARK("LargeWorld/Camera::UpdateMatrix", [](size_t iterationCount) {
+	Camera camera;
+	camera.SetPosition(Vector3d(1.0e6, 2.0e5, -3.0e6));
+	for (size_t n = 0; n < iterationCount; ++n) {
+		camera.UpdateMatrix();
+		Benchmark::DoNotOptimize(camera.GetViewProjectionMatrix());
+	}
+});
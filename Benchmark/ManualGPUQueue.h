@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+
+#include "GPUQueue.h"
+#include "TimelineFence.h"
+
+namespace Benchmark {
+
+	// 手で進めるGPUの代わり
+	// Signalは値を積むだけで、CompleteかWaitForValueを呼ぶまで完了しない
+	class ManualGPUQueue :
+		public Engine::GPUQueue {
+	public:
+		uint64_t Signal() override { return ++lastSignaledValue_; }
+		uint64_t GetCompletedValue() override { return fence_.GetCompletedValue(); }
+		bool WaitForValue(uint64_t value) override {
+			if (value > lastSignaledValue_) { return false; }
+			Complete(value);
+			return true;
+		}
+		uint64_t GetLastSignaledValue() const override { return lastSignaledValue_; }
+		bool WaitOnQueue(Engine::GPUQueue&, uint64_t) override { return true; }
+		Engine::TimelineFence& GetTimelineFence() override { return fence_; }
+
+		/// <summary>
+		/// フェンス値まで完了させる（戻ることはない）
+		/// </summary>
+		void Complete(uint64_t value) { fence_.Signal(value); }
+		/// <summary>
+		/// 1フレーム進める
+		/// シグナルしてからframeLatencyフレーム後に完了するGPUとして、最後にシグナルした値のframeLatency - 1前まで完了させる
+		/// </summary>
+		void AdvanceFrame(uint32_t frameLatency) {
+			if (lastSignaledValue_ >= frameLatency) {
+				Complete(lastSignaledValue_ - (frameLatency - 1));
+			}
+		}
+
+	private:
+		Engine::SimulatedTimelineFence fence_;
+		uint64_t lastSignaledValue_{ 0 };
+	};
+
+}
@@ -0,0 +1,204 @@
+#include "Benchmark.h"
+
+#include <array>
+#include <random>
+
+#include "MathUtils.h"
+
+// Vector3_inline.h、Quaternion_inline.h、Matrix4x4_inline.h の演算子と生成関数を計測する
+// 入力は定数畳み込みされないように乱数で作ったプールから読む
+// 結果にはプールの読み込みとループの分が含まれるので Math/Baseline を引いて比較する
+
+namespace {
+
+	constexpr size_t kPoolSize = 1024;
+	constexpr size_t kPoolMask = kPoolSize - 1;
+
+	struct Pools {
+		std::array<float, kPoolSize> sa, sb, sc;
+		// 0~1
+		std::array<float, kPoolSize> t;
+		// -π~π
+		std::array<float, kPoolSize> angle;
+		std::array<Vector2, kPoolSize> v2;
+		std::array<Vector3, kPoolSize> v3a, v3b;
+		// 正規化済み
+		std::array<Vector3, kPoolSize> unitA, unitB;
+		std::array<Vector4, kPoolSize> v4;
+		// 正規化済み
+		std::array<Quaternion, kPoolSize> qa, qb;
+		// 逆行列を持つアフィン行列
+		std::array<Matrix4x4, kPoolSize> ma, mb;
+	};
+
+	const Pools& GetPools() {
+		static const Pools pools = [] {
+			Pools p{};
+			std::mt19937 engine(12345);
+			std::uniform_real_distribution<float> signedUnit(-1.0f, 1.0f);
+			std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+			std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+			auto randomVector3 = [&] { return Vector3(signedUnit(engine), signedUnit(engine), signedUnit(engine)) * 10.0f; };
+			auto randomUnit = [&] {
+				Vector3 v;
+				do { v = randomVector3(); } while (v.LengthSquare() < 1.0e-2f);
+				return v.Normalized();
+			};
+			for (size_t i = 0; i < kPoolSize; ++i) {
+				p.sa[i] = signedUnit(engine) * 10.0f;
+				p.sb[i] = signedUnit(engine) * 10.0f;
+				p.sc[i] = signedUnit(engine) * 10.0f;
+				p.t[i] = unit(engine);
+				p.angle[i] = signedUnit(engine) * Math::Pi;
+				p.v2[i] = Vector2(signedUnit(engine), signedUnit(engine));
+				p.v3a[i] = randomVector3();
+				p.v3b[i] = randomVector3();
+				p.unitA[i] = randomUnit();
+				do { p.unitB[i] = randomUnit(); } while (std::abs(Vector3::Dot(p.unitA[i], p.unitB[i])) > 0.99f);
+				p.v4[i] = Vector4(randomVector3(), 1.0f);
+				p.qa[i] = Quaternion::MakeFromAngleAxis(p.angle[i], p.unitA[i]);
+				p.qb[i] = Quaternion::MakeFromAngleAxis(signedUnit(engine) * Math::Pi, p.unitB[i]);
+				p.ma[i] = Matrix4x4::MakeAffine(Vector3(scale(engine), scale(engine), scale(engine)), p.qa[i], randomVector3());
+				p.mb[i] = Matrix4x4::MakeAffine(Vector3(scale(engine), scale(engine), scale(engine)), p.qb[i], randomVector3());
+			}
+			return p;
+		}();
+		return pools;
+	}
+
+}
+
+// expressionの中ではプールをp、インデックスをiで参照する
+#define MATH_BENCHMARK(name, expression) \
+	BENCHMARK(name, [](size_t iterationCount) { \
+		const Pools& p = GetPools(); \
+		/* Quaternion()のようにp、iを使わない式でも未使用警告を出さない */ \
+		Benchmark::DoNotOptimize(p); \
+		for (size_t n = 0; n < iterationCount; ++n) { \
+			const size_t i = n & kPoolMask; \
+			Benchmark::DoNotOptimize(i); \
+			Benchmark::DoNotOptimize(expression); \
+		} \
+	})
+
+MATH_BENCHMARK("Math/Baseline", p.sa[i]);
+
+#pragma region Vector3
+MATH_BENCHMARK("Vector3/Construct(x,y,z)", Vector3(p.sa[i], p.sb[i], p.sc[i]));
+MATH_BENCHMARK("Vector3/Construct(xyz)", Vector3(p.sa[i]));
+MATH_BENCHMARK("Vector3/Construct(Vector2,z)", Vector3(p.v2[i], p.sa[i]));
+MATH_BENCHMARK("Vector3/operator[]", p.v3a[i][i % 3]);
+MATH_BENCHMARK("Vector3/operator+(v)", +p.v3a[i]);
+MATH_BENCHMARK("Vector3/operator-(v)", -p.v3a[i]);
+MATH_BENCHMARK("Vector3/operator+(v,v)", p.v3a[i] + p.v3b[i]);
+MATH_BENCHMARK("Vector3/operator-(v,v)", p.v3a[i] - p.v3b[i]);
+MATH_BENCHMARK("Vector3/operator*(v,s)", p.v3a[i] * p.sa[i]);
+MATH_BENCHMARK("Vector3/operator*(s,v)", p.sa[i] * p.v3a[i]);
+MATH_BENCHMARK("Vector3/operator+=", [&] { Vector3 v = p.v3a[i]; v += p.v3b[i]; return v; }());
+MATH_BENCHMARK("Vector3/operator-=", [&] { Vector3 v = p.v3a[i]; v -= p.v3b[i]; return v; }());
+MATH_BENCHMARK("Vector3/operator*=", [&] { Vector3 v = p.v3a[i]; v *= p.sa[i]; return v; }());
+MATH_BENCHMARK("Vector3/operator==", p.v3a[i] == p.v3b[i]);
+MATH_BENCHMARK("Vector3/operator!=", p.v3a[i] != p.v3b[i]);
+MATH_BENCHMARK("Vector3/SetXY", [&] { Vector3 v = p.v3a[i]; return v.SetXY(p.v2[i]); }());
+MATH_BENCHMARK("Vector3/GetXY", p.v3a[i].GetXY());
+MATH_BENCHMARK("Vector3/SetXZ", [&] { Vector3 v = p.v3a[i]; return v.SetXZ(p.v2[i]); }());
+MATH_BENCHMARK("Vector3/GetXZ", p.v3a[i].GetXZ());
+MATH_BENCHMARK("Vector3/SetYZ", [&] { Vector3 v = p.v3a[i]; return v.SetYZ(p.v2[i]); }());
+MATH_BENCHMARK("Vector3/GetYZ", p.v3a[i].GetYZ());
+MATH_BENCHMARK("Vector3/LengthSquare", p.v3a[i].LengthSquare());
+MATH_BENCHMARK("Vector3/Length", p.v3a[i].Length());
+MATH_BENCHMARK("Vector3/Normalized", p.v3a[i].Normalized());
+MATH_BENCHMARK("Vector3/Angle", Vector3::Angle(p.v3a[i], p.v3b[i]));
+MATH_BENCHMARK("Vector3/SignedAngle", Vector3::SignedAngle(p.v3a[i], p.v3b[i], p.unitA[i]));
+MATH_BENCHMARK("Vector3/Distance", Vector3::Distance(p.v3a[i], p.v3b[i]));
+MATH_BENCHMARK("Vector3/Dot", Vector3::Dot(p.v3a[i], p.v3b[i]));
+MATH_BENCHMARK("Vector3/Cross", Vector3::Cross(p.v3a[i], p.v3b[i]));
+MATH_BENCHMARK("Vector3/Scale", Vector3::Scale(p.v3a[i], p.v3b[i]));
+MATH_BENCHMARK("Vector3/Project", Vector3::Project(p.v3a[i], p.v3b[i]));
+MATH_BENCHMARK("Vector3/ProjectOnPlane", Vector3::ProjectOnPlane(p.v3a[i], p.unitA[i]));
+MATH_BENCHMARK("Vector3/Reflecte", Vector3::Reflecte(p.v3a[i], p.unitA[i]));
+MATH_BENCHMARK("Vector3/Min", Vector3::Min(p.v3a[i], p.v3b[i]));
+MATH_BENCHMARK("Vector3/Max", Vector3::Max(p.v3a[i], p.v3b[i]));
+MATH_BENCHMARK("Vector3/Lerp", Vector3::Lerp(p.t[i], p.v3a[i], p.v3b[i]));
+MATH_BENCHMARK("Vector3/Slerp", Vector3::Slerp(p.t[i], p.v3a[i], p.v3b[i]));
+#pragma endregion
+
+#pragma region Quaternion
+MATH_BENCHMARK("Quaternion/Construct()", Quaternion());
+MATH_BENCHMARK("Quaternion/Construct(x,y,z,w)", Quaternion(p.sa[i], p.sb[i], p.sc[i], p.t[i]));
+MATH_BENCHMARK("Quaternion/operator[]", p.qa[i][i & 3]);
+MATH_BENCHMARK("Quaternion/operator+(q,q)", p.qa[i] + p.qb[i]);
+MATH_BENCHMARK("Quaternion/operator*(q,s)", p.qa[i] * p.sa[i]);
+MATH_BENCHMARK("Quaternion/operator*(s,q)", p.sa[i] * p.qa[i]);
+MATH_BENCHMARK("Quaternion/operator*(q,v)", p.qa[i] * p.v3a[i]);
+MATH_BENCHMARK("Quaternion/operator*(q,q)", p.qa[i] * p.qb[i]);
+MATH_BENCHMARK("Quaternion/operator+=", [&] { Quaternion q = p.qa[i]; q += p.qb[i]; return q; }());
+MATH_BENCHMARK("Quaternion/operator*=(s)", [&] { Quaternion q = p.qa[i]; q *= p.sa[i]; return q; }());
+MATH_BENCHMARK("Quaternion/operator*=(q)", [&] { Quaternion q = p.qa[i]; q *= p.qb[i]; return q; }());
+MATH_BENCHMARK("Quaternion/operator==", p.qa[i] == p.qb[i]);
+MATH_BENCHMARK("Quaternion/operator!=", p.qa[i] != p.qb[i]);
+MATH_BENCHMARK("Quaternion/SetEulerAngle", [&] { Quaternion q; return q.SetEulerAngle(p.v3a[i]); }());
+MATH_BENCHMARK("Quaternion/GetEulerAngle", p.qa[i].GetEulerAngle());
+MATH_BENCHMARK("Quaternion/Normalized", p.qa[i].Normalized());
+MATH_BENCHMARK("Quaternion/GetXYZ", p.qa[i].GetXYZ());
+MATH_BENCHMARK("Quaternion/SetAngle", [&] { Quaternion q = p.qa[i]; return q.SetAngle(p.angle[i]); }());
+MATH_BENCHMARK("Quaternion/GetAngle", p.qa[i].GetAngle());
+MATH_BENCHMARK("Quaternion/SetAxis", [&] { Quaternion q = p.qa[i]; return q.SetAxis(p.unitB[i]); }());
+MATH_BENCHMARK("Quaternion/GetAxis", p.qa[i].GetAxis());
+MATH_BENCHMARK("Quaternion/GetConjugate", p.qa[i].GetConjugate());
+MATH_BENCHMARK("Quaternion/GetInverse", p.qa[i].GetInverse());
+MATH_BENCHMARK("Quaternion/Dot", Quaternion::Dot(p.qa[i], p.qb[i]));
+MATH_BENCHMARK("Quaternion/Lerp", Quaternion::Lerp(p.t[i], p.qa[i], p.qb[i]));
+MATH_BENCHMARK("Quaternion/Slerp", Quaternion::Slerp(p.t[i], p.qa[i], p.qb[i]));
+MATH_BENCHMARK("Quaternion/MakeFromAngleAxis", Quaternion::MakeFromAngleAxis(p.angle[i], p.unitA[i]));
+MATH_BENCHMARK("Quaternion/MakeFromEulerAngle", Quaternion::MakeFromEulerAngle(p.v3a[i]));
+MATH_BENCHMARK("Quaternion/MakeForXAxis", Quaternion::MakeForXAxis(p.angle[i]));
+MATH_BENCHMARK("Quaternion/MakeForYAxis", Quaternion::MakeForYAxis(p.angle[i]));
+MATH_BENCHMARK("Quaternion/MakeForZAxis", Quaternion::MakeForZAxis(p.angle[i]));
+MATH_BENCHMARK("Quaternion/MakeFromTwoVector", Quaternion::MakeFromTwoVector(p.unitA[i], p.unitB[i]));
+MATH_BENCHMARK("Quaternion/MakeFromOrthonormal", Quaternion::MakeFromOrthonormal(p.ma[i].GetXAxis(), p.ma[i].GetYAxis(), p.ma[i].GetZAxis()));
+MATH_BENCHMARK("Quaternion/MakeLookRotation", Quaternion::MakeLookRotation(p.unitA[i]));
+MATH_BENCHMARK("Quaternion/MakeFromMatrix", Quaternion::MakeFromMatrix(p.ma[i]));
+#pragma endregion
+
+#pragma region Matrix4x4
+MATH_BENCHMARK("Matrix4x4/Construct()", Matrix4x4());
+MATH_BENCHMARK("Matrix4x4/Construct(16 floats)", Matrix4x4(
+	p.sa[i], p.sb[i], p.sc[i], 0.0f,
+	p.sb[i], p.sc[i], p.sa[i], 0.0f,
+	p.sc[i], p.sa[i], p.sb[i], 0.0f,
+	p.sa[i], p.sa[i], p.sa[i], 1.0f));
+MATH_BENCHMARK("Matrix4x4/operator*(m,m)", p.ma[i] * p.mb[i]);
+MATH_BENCHMARK("Matrix4x4/operator*=", [&] { Matrix4x4 m = p.ma[i]; m *= p.mb[i]; return m; }());
+MATH_BENCHMARK("Matrix4x4/operator*(v3,m)", p.v3a[i] * p.ma[i]);
+MATH_BENCHMARK("Matrix4x4/operator*(v4,m)", p.v4[i] * p.ma[i]);
+MATH_BENCHMARK("Matrix4x4/operator*(s,m)", p.sa[i] * p.ma[i]);
+MATH_BENCHMARK("Matrix4x4/operator*(m,s)", p.ma[i] * p.sa[i]);
+MATH_BENCHMARK("Matrix4x4/ApplyRotation", p.ma[i].ApplyRotation(p.v3a[i]));
+MATH_BENCHMARK("Matrix4x4/ApplyTransformWDivide", p.ma[i].ApplyTransformWDivide(p.v3a[i]));
+MATH_BENCHMARK("Matrix4x4/SetRow", [&] { Matrix4x4 m = p.ma[i]; return m.SetRow(i & 3, p.v4[i]); }());
+MATH_BENCHMARK("Matrix4x4/GetRow", p.ma[i].GetRow(i & 3));
+MATH_BENCHMARK("Matrix4x4/SetColumn", [&] { Matrix4x4 m = p.ma[i]; return m.SetColumn(i & 3, p.v4[i]); }());
+MATH_BENCHMARK("Matrix4x4/GetColumn", p.ma[i].GetColumn(i & 3));
+MATH_BENCHMARK("Matrix4x4/GetXAxis", p.ma[i].GetXAxis());
+MATH_BENCHMARK("Matrix4x4/GetYAxis", p.ma[i].GetYAxis());
+MATH_BENCHMARK("Matrix4x4/GetZAxis", p.ma[i].GetZAxis());
+MATH_BENCHMARK("Matrix4x4/GetTranslate", p.ma[i].GetTranslate());
+MATH_BENCHMARK("Matrix4x4/GetDeterminant", p.ma[i].GetDeterminant());
+MATH_BENCHMARK("Matrix4x4/GetAdjugate", p.ma[i].GetAdjugate());
+MATH_BENCHMARK("Matrix4x4/GetInverse", p.ma[i].GetInverse());
+MATH_BENCHMARK("Matrix4x4/GetTranspose", p.ma[i].GetTranspose());
+MATH_BENCHMARK("Matrix4x4/MakeScaling", Matrix4x4::MakeScaling(p.v3a[i]));
+MATH_BENCHMARK("Matrix4x4/MakeRotationX", Matrix4x4::MakeRotationX(p.angle[i]));
+MATH_BENCHMARK("Matrix4x4/MakeRotationY", Matrix4x4::MakeRotationY(p.angle[i]));
+MATH_BENCHMARK("Matrix4x4/MakeRotationZ", Matrix4x4::MakeRotationZ(p.angle[i]));
+MATH_BENCHMARK("Matrix4x4/MakeRotationXYZ", Matrix4x4::MakeRotationXYZ(p.v3a[i]));
+MATH_BENCHMARK("Matrix4x4/MakeRotationFromQuaternion", Matrix4x4::MakeRotationFromQuaternion(p.qa[i]));
+MATH_BENCHMARK("Matrix4x4/MakeLookRotation", Matrix4x4::MakeLookRotation(p.unitA[i]));
+MATH_BENCHMARK("Matrix4x4/MakeTranslation", Matrix4x4::MakeTranslation(p.v3a[i]));
+MATH_BENCHMARK("Matrix4x4/MakeAffine(euler)", Matrix4x4::MakeAffine(p.v3a[i], p.v3b[i], p.v3a[i]));
+MATH_BENCHMARK("Matrix4x4/MakeAffine(quaternion)", Matrix4x4::MakeAffine(p.v3a[i], p.qa[i], p.v3b[i]));
+MATH_BENCHMARK("Matrix4x4/MakePerspectiveProjection", Matrix4x4::MakePerspectiveProjection(0.5f + p.t[i], 1.777f, 0.1f, 1000.0f));
+MATH_BENCHMARK("Matrix4x4/MakeOrthographicProjection", Matrix4x4::MakeOrthographicProjection(1280.0f + p.sa[i], 720.0f, 0.1f, 1000.0f));
+MATH_BENCHMARK("Matrix4x4/MakeViewport", Matrix4x4::MakeViewport(p.sa[i], p.sb[i], 1280.0f, 720.0f));
+#pragma endregion
@@ -0,0 +1,156 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "MathUtils.h"
+#include "Packing.h"
+
+// Packing.h の変換を計測する
+// 最初に半精度の全ビットパターンの往復、配列版とスカラー版の一致、各形式の誤差を確認して標準エラーに出す
+
+namespace {
+
+	constexpr size_t kCount = 4096;
+
+	struct Inputs {
+		std::vector<float> floats;
+		std::vector<uint16_t> halves;
+		std::vector<Vector4> colors;
+		std::vector<Vector3> normals;
+		std::vector<uint32_t> octahedrals;
+		std::vector<uint32_t> packed;
+		std::vector<float> floatResults;
+		std::vector<uint16_t> halfResults;
+	};
+
+	void Verify(const std::vector<float>& floats) {
+		using namespace Math;
+		char detail[128];
+
+		// 半精度の全パターンが往復で変わらないか（NaNはquiet NaNになればよい）
+		size_t roundTripMismatch = 0;
+		std::vector<uint16_t> allHalves(65536);
+		std::vector<float> allFloats(65536);
+		for (uint32_t h = 0; h < 65536; ++h) {
+			allHalves[h] = static_cast<uint16_t>(h);
+			uint16_t back = FloatToHalf(HalfToFloat(static_cast<uint16_t>(h)));
+			bool isNaN = (h & 0x7C00u) == 0x7C00u && (h & 0x03FFu) != 0;
+			if (isNaN ? (back & 0x7E00u) != 0x7E00u : back != h) { ++roundTripMismatch; }
+		}
+		std::snprintf(detail, sizeof(detail), "all 65536 patterns round trip, %zu mismatch", roundTripMismatch);
+		Benchmark::Check("HalfToFloat", roundTripMismatch == 0, detail);
+
+		// 配列版とスカラー版
+		size_t batchMismatch = 0;
+		HalfToFloat(allHalves.data(), allFloats.data(), allHalves.size());
+		for (size_t i = 0; i < allHalves.size(); ++i) {
+			float expected = HalfToFloat(allHalves[i]);
+			if (std::isnan(expected) ? !std::isnan(allFloats[i]) : allFloats[i] != expected) { ++batchMismatch; }
+		}
+		// 無限大、NaN（仮数部あり、符号付き）、非正規化数、範囲外もビットまで一致する
+		std::vector<float> batchFloats = floats;
+		for (uint32_t bits : { 0x7F800000u, 0xFF800000u, 0x7FC00000u, 0xFFC00000u, 0x7F812345u, 0xFFBFFFFFu, 0x7FFFE000u,
+			0x00000001u, 0x80000001u, 0x33800000u, 0x477FE000u, 0x477FF000u, 0x7F7FFFFFu, 0x00000000u, 0x80000000u, 0x38800000u }) {
+			batchFloats.push_back(std::bit_cast<float>(bits));
+		}
+		std::vector<uint16_t> halves(batchFloats.size());
+		FloatToHalf(batchFloats.data(), halves.data(), batchFloats.size());
+		for (size_t i = 0; i < batchFloats.size(); ++i) {
+			if (halves[i] != FloatToHalf(batchFloats[i])) { ++batchMismatch; }
+		}
+		std::snprintf(detail, sizeof(detail), "batch matches scalar, %zu mismatch", batchMismatch);
+		Benchmark::Check("FloatToHalf(array)", batchMismatch == 0, detail);
+
+		// 偶数丸めの相対誤差は2^-11以下
+		double maxRelative = 0.0;
+		for (float f : floats) {
+			if (std::abs(f) < 6.103515625e-05f || std::abs(f) > 65504.0f) { continue; }
+			double error = std::abs(static_cast<double>(HalfToFloat(FloatToHalf(f))) - f) / std::abs(static_cast<double>(f));
+			maxRelative = std::max(maxRelative, error);
+		}
+		std::snprintf(detail, sizeof(detail), "normal range relative error %.3g (limit %.3g)", maxRelative, std::ldexp(1.0, -11));
+		Benchmark::Check("FloatToHalf", maxRelative <= std::ldexp(1.0, -11), detail);
+
+		// 正規化整数の往復誤差は半ステップ以下
+		double unorm8 = 0.0, snorm16 = 0.0, r10 = 0.0;
+		for (size_t i = 0; i <= 100000; ++i) {
+			float t = static_cast<float>(i) / 100000.0f;
+			unorm8 = std::max(unorm8, static_cast<double>(std::abs(UnpackUnorm8(PackUnorm8(t)) - t)));
+			snorm16 = std::max(snorm16, static_cast<double>(std::abs(UnpackSnorm16(PackSnorm16(t * 2.0f - 1.0f)) - (t * 2.0f - 1.0f))));
+			Vector4 rgba = UnpackR10G10B10A2(PackR10G10B10A2(Vector4(t, 1.0f - t, t, 1.0f)));
+			r10 = std::max({ r10, static_cast<double>(std::abs(rgba.x - t)), static_cast<double>(std::abs(rgba.y - (1.0f - t))) });
+		}
+		std::snprintf(detail, sizeof(detail), "unorm8 %.3g, snorm16 %.3g, r10 %.3g", unorm8, snorm16, r10);
+		Benchmark::Check("Unorm/Snorm", unorm8 <= 0.5 / 255.0 + 1e-6 && snorm16 <= 0.5 / 32767.0 + 1e-6 && r10 <= 0.5 / 1023.0 + 1e-6, detail);
+
+		// 八面体エンコードの角度誤差
+		std::mt19937 engine(99);
+		std::normal_distribution<float> normal;
+		double maxAngle = 0.0;
+		for (size_t i = 0; i < 1000000; ++i) {
+			Vector3 n = Vector3(normal(engine), normal(engine), normal(engine)).Normalized();
+			Vector3 decoded = UnpackOctahedral(PackOctahedral(n));
+			// 小さい角度を単精度のacosで測ると誤差に埋もれるので倍精度のatan2で測る
+			double cx = static_cast<double>(n.y) * decoded.z - static_cast<double>(n.z) * decoded.y;
+			double cy = static_cast<double>(n.z) * decoded.x - static_cast<double>(n.x) * decoded.z;
+			double cz = static_cast<double>(n.x) * decoded.y - static_cast<double>(n.y) * decoded.x;
+			double dot = static_cast<double>(n.x) * decoded.x + static_cast<double>(n.y) * decoded.y + static_cast<double>(n.z) * decoded.z;
+			maxAngle = std::max(maxAngle, std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), dot) * 180.0 / 3.141592653589793);
+		}
+		std::snprintf(detail, sizeof(detail), "max angle error %.4f degree", maxAngle);
+		Benchmark::Check("PackOctahedral", maxAngle <= 0.01, detail);
+	}
+
+	Inputs& GetInputs() {
+		static Inputs inputs = [] {
+			Inputs in;
+			std::mt19937 engine(1234);
+			std::uniform_real_distribution<float> exponent(-20.0f, 20.0f);
+			std::uniform_real_distribution<float> signedUnit(-1.0f, 1.0f);
+			std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+			std::vector<float> verifyFloats;
+			for (size_t i = 0; i < (size_t(1) << 20); ++i) {
+				verifyFloats.emplace_back(signedUnit(engine) * std::exp2(exponent(engine)));
+			}
+			for (size_t i = 0; i < kCount; ++i) {
+				in.floats.emplace_back(signedUnit(engine) * 100.0f);
+				in.colors.emplace_back(unit(engine), unit(engine), unit(engine), unit(engine));
+				in.normals.emplace_back(Vector3(signedUnit(engine), signedUnit(engine), signedUnit(engine) + 0.01f).Normalized());
+				in.octahedrals.emplace_back(Math::PackOctahedral(in.normals.back()));
+			}
+			in.halves.resize(kCount);
+			Math::FloatToHalf(in.floats.data(), in.halves.data(), kCount);
+			in.packed.resize(kCount);
+			in.floatResults.resize(kCount);
+			in.halfResults.resize(kCount);
+			Verify(verifyFloats);
+			return in;
+		}();
+		return inputs;
+	}
+
+}
+
+// 1回の計測でkCount個を処理する
+#define PACKING_BENCHMARK(name, ...) \
+	BENCHMARK(name, [](size_t iterationCount) { \
+		Inputs& in = GetInputs(); \
+		for (size_t n = 0; n < iterationCount; ++n) { \
+			__VA_ARGS__; \
+			Benchmark::ClobberMemory(); \
+		} \
+	})
+
+PACKING_BENCHMARK("Packing/FloatToHalf x4096/Scalar", for (size_t i = 0; i < kCount; ++i) { in.halfResults[i] = Math::FloatToHalf(in.floats[i]); });
+PACKING_BENCHMARK("Packing/FloatToHalf x4096/Batch", Math::FloatToHalf(in.floats.data(), in.halfResults.data(), kCount));
+PACKING_BENCHMARK("Packing/HalfToFloat x4096/Scalar", for (size_t i = 0; i < kCount; ++i) { in.floatResults[i] = Math::HalfToFloat(in.halves[i]); });
+PACKING_BENCHMARK("Packing/HalfToFloat x4096/Batch", Math::HalfToFloat(in.halves.data(), in.floatResults.data(), kCount));
+PACKING_BENCHMARK("Packing/PackUnorm8x4 x4096", for (size_t i = 0; i < kCount; ++i) { in.packed[i] = Math::PackUnorm8x4(in.colors[i]); });
+PACKING_BENCHMARK("Packing/PackR10G10B10A2 x4096", for (size_t i = 0; i < kCount; ++i) { in.packed[i] = Math::PackR10G10B10A2(in.colors[i]); });
+PACKING_BENCHMARK("Packing/PackOctahedral x4096", for (size_t i = 0; i < kCount; ++i) { in.packed[i] = Math::PackOctahedral(in.normals[i]); });
+PACKING_BENCHMARK("Packing/UnpackOctahedral x4096", for (size_t i = 0; i < kCount; ++i) { Benchmark::DoNotOptimize(Math::UnpackOctahedral(in.octahedrals[i])); });
@@ -0,0 +1,216 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Profiler.h"
+
+// PROFILE_SCOPEの1回あたりの時間と、EndFrameの集計の時間を測る
+// 最初に統計（最小、平均、最大、99パーセンタイル）、複数スレッドからの記録、入れ子の深さ、Chromeのトレースの出力、一杯のときに捨てること、
+// ハッシュが衝突した別の名前を混ぜないことを確認して標準エラーに出す
+
+namespace {
+
+	using Engine::Profiler;
+
+	const Profiler::ZoneStatistics* FindStatistics(const char* name) {
+		for (const Profiler::ZoneStatistics& statistics : Profiler::GetInstance().GetStatistics()) {
+			if (std::string_view(statistics.name) == name) { return &statistics; }
+		}
+		return nullptr;
+	}
+
+	bool IsNear(double a, double b) {
+		return std::abs(a - b) < 1e-9;
+	}
+
+	// 時間を決めて記録した区間の統計が合うか
+	void VerifyStatistics() {
+		static constexpr Engine::ProfileZone kZone{ "Synthetic", Engine::HashProfileZoneName("Synthetic") };
+		Profiler& profiler = Profiler::GetInstance();
+		profiler.Reset();
+		// フレームfでは(f+1)マイクロ秒を2回に分けて記録する
+		for (uint64_t f = 0; f < 100; ++f) {
+			profiler.BeginFrame();
+			profiler.Record(&kZone, 0, (f + 1) * 400, 0);
+			profiler.Record(&kZone, 0, (f + 1) * 600, 0);
+			profiler.EndFrame();
+		}
+		const Profiler::ZoneStatistics* statistics = FindStatistics("Synthetic");
+		bool passed = statistics && statistics->sampleCount == 100 && statistics->callCount == 2
+			&& IsNear(statistics->minMilliseconds, 0.001) && IsNear(statistics->maxMilliseconds, 0.1)
+			&& IsNear(statistics->averageMilliseconds, 0.0505) && IsNear(statistics->p99Milliseconds, 0.099)
+			&& IsNear(statistics->lastMilliseconds, 0.1) && profiler.GetFrameStatistics().sampleCount == 100;
+
+		char detail[128];
+		if (statistics) {
+			std::snprintf(detail, sizeof(detail), "min %.4f avg %.4f max %.4f p99 %.4f ms over %u frames",
+				statistics->minMilliseconds, statistics->averageMilliseconds, statistics->maxMilliseconds, statistics->p99Milliseconds, statistics->sampleCount);
+		}
+		else {
+			std::snprintf(detail, sizeof(detail), "zone not found");
+		}
+		Benchmark::Check("Profiler", passed, detail);
+	}
+
+	// 4スレッドから記録した区間がすべて集まり、入れ子の深さとトレースが合うか
+	// 同じハッシュで名前が違う区間は別に、同じ名前で別の場所の区間はまとめて集計する
+	void VerifyHashCollision() {
+		static constexpr Engine::ProfileZone kFirst{ "CollisionA", 1 };
+		static constexpr Engine::ProfileZone kSecond{ "CollisionB", 1 };
+		static constexpr char kSameName[] = "CollisionA";
+		static constexpr Engine::ProfileZone kFirstElsewhere{ kSameName, 1 };
+		Profiler& profiler = Profiler::GetInstance();
+		profiler.Reset();
+		profiler.BeginFrame();
+		profiler.Record(&kFirst, 0, 1000, 0);
+		profiler.Record(&kSecond, 0, 3000, 0);
+		profiler.Record(&kFirstElsewhere, 0, 1000, 0);
+		profiler.EndFrame();
+		const Profiler::ZoneStatistics* first = FindStatistics("CollisionA");
+		const Profiler::ZoneStatistics* second = FindStatistics("CollisionB");
+		bool passed = first && second && first != second && first->callCount == 2 && second->callCount == 1 &&
+			IsNear(first->lastMilliseconds, 0.002) && IsNear(second->lastMilliseconds, 0.003);
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "colliding hash: %u / %u calls", first ? first->callCount : 0, second ? second->callCount : 0);
+		Benchmark::Check("Profiler", passed, detail);
+	}
+
+	void VerifyThreads() {
+		constexpr int kThreadCount = 4;
+		constexpr int kScopeCount = 1000;
+		Profiler& profiler = Profiler::GetInstance();
+		profiler.Reset();
+		profiler.BeginCapture();
+		profiler.BeginFrame();
+		std::vector<std::thread> threads;
+		for (int t = 0; t < kThreadCount; ++t) {
+			threads.emplace_back([t] {
+				char name[32];
+				std::snprintf(name, sizeof(name), "Worker %d", t);
+				Profiler::GetInstance().SetThreadName(name);
+				for (int n = 0; n < kScopeCount; ++n) {
+					PROFILE_SCOPE("Outer");
+					PROFILE_SCOPE("Inner");
+					Benchmark::ClobberMemory();
+				}
+			});
+		}
+		for (auto& thread : threads) { thread.join(); }
+		profiler.EndFrame();
+		profiler.EndCapture();
+
+		const Profiler::ZoneStatistics* outer = FindStatistics("Outer");
+		const Profiler::ZoneStatistics* inner = FindStatistics("Inner");
+		bool counted = outer && inner && outer->callCount == kThreadCount * kScopeCount && inner->callCount == kThreadCount * kScopeCount
+			&& outer->depth == 0 && inner->depth == 1 && inner->lastMilliseconds <= outer->lastMilliseconds;
+
+		std::string json;
+		profiler.AppendChromeTrace(json);
+		size_t completeEvents = 0, threadNames = 0;
+		for (size_t position = json.find("\"ph\":\"X\""); position != std::string::npos; position = json.find("\"ph\":\"X\"", position + 1)) { ++completeEvents; }
+		for (size_t position = json.find("\"thread_name\""); position != std::string::npos; position = json.find("\"thread_name\"", position + 1)) { ++threadNames; }
+		bool balanced = std::count(json.begin(), json.end(), '{') == std::count(json.begin(), json.end(), '}')
+			&& json.starts_with("{\"traceEvents\":[") && json.find("\"name\":\"Worker 3\"") != std::string::npos;
+		// 区間が2×4000、フレームが1
+		bool traced = completeEvents == 2 * kThreadCount * kScopeCount + 1 && threadNames == kThreadCount && balanced;
+
+		char detail[160];
+		std::snprintf(detail, sizeof(detail), "%u outer, %u inner calls, %zu trace events, %zu thread names, %llu dropped",
+			outer ? outer->callCount : 0, inner ? inner->callCount : 0, completeEvents, threadNames, static_cast<unsigned long long>(profiler.GetDroppedCount()));
+		Benchmark::Check("Profiler", counted && traced && profiler.GetDroppedCount() == 0, detail);
+	}
+
+	// 集計しないままバッファを超えたら捨てるか。実行時に止められるか
+	void VerifyOverflow() {
+		Profiler& profiler = Profiler::GetInstance();
+		profiler.Reset();
+		uint64_t droppedBefore = profiler.GetDroppedCount();
+		for (uint32_t n = 0; n < Profiler::kThreadBufferCapacity + 100; ++n) {
+			PROFILE_SCOPE("Overflow");
+		}
+		uint64_t dropped = profiler.GetDroppedCount() - droppedBefore;
+		profiler.EndFrame();
+		const Profiler::ZoneStatistics* overflow = FindStatistics("Overflow");
+		bool passed = dropped == 100 && overflow && overflow->callCount == Profiler::kThreadBufferCapacity;
+
+		profiler.SetEnabled(false);
+		for (int n = 0; n < 10; ++n) {
+			PROFILE_SCOPE("Disabled");
+		}
+		profiler.SetEnabled(true);
+		profiler.EndFrame();
+		passed = passed && FindStatistics("Disabled") == nullptr;
+
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "%llu dropped, %u recorded", static_cast<unsigned long long>(dropped), overflow ? overflow->callCount : 0);
+		Benchmark::Check("Profiler", passed, detail);
+	}
+
+	bool Initalize() {
+		static const bool initialized = [] {
+			VerifyStatistics();
+			VerifyHashCollision();
+			VerifyThreads();
+			VerifyOverflow();
+			Profiler::GetInstance().Reset();
+			return true;
+		}();
+		return initialized;
+	}
+
+}
+
+BENCHMARK("Profiler/x1000/Empty loop", [](size_t iterationCount) {
+	Initalize();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (int i = 0; i < 1000; ++i) {
+			Benchmark::ClobberMemory();
+		}
+	}
+});
+BENCHMARK("Profiler/x1000/PROFILE_SCOPE", [](size_t iterationCount) {
+	Initalize();
+	Profiler& profiler = Profiler::GetInstance();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (int i = 0; i < 1000; ++i) {
+			PROFILE_SCOPE("Benchmark");
+			Benchmark::ClobberMemory();
+		}
+		// バッファが一杯にならないように空ける（1000回に1回なので影響は小さい）
+		profiler.Reset();
+	}
+});
+BENCHMARK("Profiler/x1000/PROFILE_SCOPE disabled", [](size_t iterationCount) {
+	Initalize();
+	Profiler& profiler = Profiler::GetInstance();
+	profiler.SetEnabled(false);
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (int i = 0; i < 1000; ++i) {
+			PROFILE_SCOPE("Benchmark");
+			Benchmark::ClobberMemory();
+		}
+	}
+	profiler.SetEnabled(true);
+});
+BENCHMARK("Profiler/x1000/PROFILE_SCOPE + EndFrame", [](size_t iterationCount) {
+	Initalize();
+	Profiler& profiler = Profiler::GetInstance();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (int i = 0; i < 1000; ++i) {
+			if (i & 1) {
+				PROFILE_SCOPE("Odd");
+				Benchmark::ClobberMemory();
+			}
+			else {
+				PROFILE_SCOPE("Even");
+				Benchmark::ClobberMemory();
+			}
+		}
+		profiler.EndFrame();
+	}
+});
@@ -0,0 +1,290 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "RenderGraph.h"
+
+// パーティクルの更新と描画、ブルーム、合成、ImGuiのフレームをRenderGraphで組み、コンパイルにかかる時間を計る
+// 最初に不要なパスを除くこと、透過リソースの寿命を短くする並べ方、同じメモリに置いて減る量、
+// 模擬のメモリで実行して状態と中身が壊れないことを確認して標準エラーに出す
+
+namespace {
+
+	using Engine::MemoryCategory;
+	using Engine::RenderGraph;
+	using Engine::ResourceBarrier;
+	using Engine::ResourceState;
+
+	// 模擬のリソース（状態とメモリの位置を持つ）
+	struct SimulatedResource {
+		uint8_t* memory;
+		uint64_t size;
+		ResourceState state;
+		// 最後に書いたパスが埋めた値
+		uint8_t tag;
+	};
+
+	// CPUのメモリに透過リソースを置き、バリアの前の状態が合っているかを数える
+	class SimulatedBackend :
+		public Engine::RenderGraphBackend {
+	public:
+		bool ReserveTransientMemory(MemoryCategory category, uint64_t size) override {
+			memory_[static_cast<uint32_t>(category)].assign(size, 0);
+			return true;
+		}
+		void* CreateTransientResource(const Engine::TransientResourceDesc& desc, uint64_t offset, ResourceState initialState) override {
+			std::vector<uint8_t>& memory = memory_[static_cast<uint32_t>(desc.category)];
+			if (offset + desc.size > memory.size()) { ++errorCount; return nullptr; }
+			++resourceCount;
+			return new SimulatedResource{ memory.data() + offset, desc.size, initialState, 0 };
+		}
+		void DestroyTransientResource(void* resource) override {
+			delete static_cast<SimulatedResource*>(resource);
+			--resourceCount;
+		}
+		void ResourceBarriers(const ResourceBarrier* barriers, uint32_t count) override {
+			++barrierCallCount;
+			for (uint32_t i = 0; i < count; ++i) {
+				SimulatedResource* resource = static_cast<SimulatedResource*>(barriers[i].resource);
+				if (barriers[i].type != ResourceBarrier::Type::Transition) { continue; }
+				if (resource->state != barriers[i].before) { ++errorCount; }
+				resource->state = barriers[i].after;
+			}
+		}
+
+		uint32_t errorCount{ 0 };
+		uint32_t resourceCount{ 0 };
+		uint32_t barrierCallCount{ 0 };
+
+	private:
+		std::vector<uint8_t> memory_[static_cast<uint32_t>(MemoryCategory::Count)];
+	};
+
+	struct AccessDesc {
+		RenderGraph::ResourceHandle resource;
+		ResourceState state;
+	};
+
+	// 読むリソースは状態と、最後に書いたパスの値が残っているか、書くリソースは状態を確かめてから埋める
+	RenderGraph::PassHandle AddCheckedPass(RenderGraph& graph, const char* name, std::vector<AccessDesc> reads, std::vector<AccessDesc> writes, uint32_t* errorCount, bool hasSideEffect = false) {
+		static uint8_t nextTag = 0;
+		uint8_t tag = ++nextTag;
+		RenderGraph::PassHandle pass = graph.AddPass(name, [reads, writes, errorCount, tag](const RenderGraph& graph) {
+			for (const AccessDesc& read : reads) {
+				const SimulatedResource* resource = static_cast<const SimulatedResource*>(graph.GetResource(read.resource));
+				if (!Engine::ContainsState(resource->state, read.state)) { ++*errorCount; }
+				for (uint64_t i = 0; i < resource->size; ++i) {
+					if (resource->memory[i] != resource->tag) { ++*errorCount; break; }
+				}
+			}
+			for (const AccessDesc& write : writes) {
+				SimulatedResource* resource = static_cast<SimulatedResource*>(graph.GetResource(write.resource));
+				if (resource->state != write.state) { ++*errorCount; }
+				std::memset(resource->memory, tag, resource->size);
+				resource->tag = tag;
+			}
+		}, hasSideEffect);
+		for (const AccessDesc& read : reads) { graph.Read(pass, read.resource, read.state); }
+		for (const AccessDesc& write : writes) { graph.Write(pass, write.resource, write.state); }
+		return pass;
+	}
+
+	Engine::TransientResourceDesc MakeDesc(uint64_t size, MemoryCategory category = MemoryCategory::RenderTarget) {
+		Engine::TransientResourceDesc desc{};
+		desc.size = size;
+		desc.alignment = 256;
+		desc.category = category;
+		return desc;
+	}
+
+	// 外から渡すリソースの模擬
+	struct ImportedResources {
+		std::vector<uint8_t> particleMemory = std::vector<uint8_t>(4096);
+		std::vector<uint8_t> backBufferMemory = std::vector<uint8_t>(4096);
+		SimulatedResource particles{ particleMemory.data(), 4096, ResourceState::GenericRead, 0 };
+		SimulatedResource backBuffer{ backBufferMemory.data(), 4096, ResourceState::Present, 0 };
+	};
+
+	// main.cppのフレームにブルームとデバッグ表示を足したもの
+	struct FramePasses {
+		RenderGraph::PassHandle debugOverlay;
+	};
+	FramePasses BuildFrame(RenderGraph& graph, ImportedResources& imported, uint32_t* errorCount) {
+		RenderGraph::ResourceHandle particles = graph.Import("Particles", &imported.particles, ResourceState::GenericRead, ResourceState::GenericRead);
+		RenderGraph::ResourceHandle backBuffer = graph.Import("BackBuffer", &imported.backBuffer, ResourceState::Present, ResourceState::Present);
+		RenderGraph::ResourceHandle sceneColor = graph.CreateTransient("SceneColor", MakeDesc(64 * 1024));
+		RenderGraph::ResourceHandle depth = graph.CreateTransient("Depth", MakeDesc(32 * 1024));
+		RenderGraph::ResourceHandle bloomA = graph.CreateTransient("BloomA", MakeDesc(16 * 1024));
+		RenderGraph::ResourceHandle bloomB = graph.CreateTransient("BloomB", MakeDesc(16 * 1024));
+		RenderGraph::ResourceHandle overlay = graph.CreateTransient("Overlay", MakeDesc(16 * 1024));
+
+		FramePasses passes{};
+		AddCheckedPass(graph, "Update", {}, { { particles, ResourceState::UnorderedAccess } }, errorCount);
+		AddCheckedPass(graph, "Draw particles", { { particles, ResourceState::NonPixelShaderResource } },
+			{ { sceneColor, ResourceState::RenderTarget }, { depth, ResourceState::DepthWrite } }, errorCount);
+		// 結果を誰も読まない
+		passes.debugOverlay = AddCheckedPass(graph, "Debug overlay", {}, { { overlay, ResourceState::RenderTarget } }, errorCount);
+		AddCheckedPass(graph, "Bloom downsample", { { sceneColor, ResourceState::PixelShaderResource } }, { { bloomA, ResourceState::RenderTarget } }, errorCount);
+		AddCheckedPass(graph, "Bloom blur", { { bloomA, ResourceState::PixelShaderResource } }, { { bloomB, ResourceState::RenderTarget } }, errorCount);
+		AddCheckedPass(graph, "Composite", { { sceneColor, ResourceState::PixelShaderResource }, { bloomB, ResourceState::PixelShaderResource } },
+			{ { backBuffer, ResourceState::RenderTarget } }, errorCount);
+		AddCheckedPass(graph, "ImGui", {}, { { backBuffer, ResourceState::RenderTarget } }, errorCount, true);
+		return passes;
+	}
+
+	bool HasTransition(const std::vector<ResourceBarrier>& barriers, ResourceState before, ResourceState after) {
+		for (const ResourceBarrier& barrier : barriers) {
+			if (barrier.type == ResourceBarrier::Type::Transition && barrier.before == before && barrier.after == after) { return true; }
+		}
+		return false;
+	}
+
+	void VerifyFrame() {
+		uint32_t errorCount = 0;
+		ImportedResources imported;
+		SimulatedBackend backend;
+		RenderGraph graph;
+		FramePasses passes = BuildFrame(graph, imported, &errorCount);
+		bool compiled = graph.Compile();
+		const RenderGraph::Statistics& statistics = graph.GetStatistics();
+
+		// デバッグ表示だけを除き、Depthの後にBloomA、BloomBを同じメモリに置く
+		bool culled = graph.IsPassCulled(passes.debugOverlay) && statistics.culledPassCount == 1 && graph.GetExecutionOrder().size() == 6;
+		bool aliased = statistics.transientMemorySize == 96 * 1024 && statistics.unaliasedMemorySize == 128 * 1024 && statistics.aliasedResourceCount == 2;
+		// 更新の前にUAVへ、描画の前に読み取りへ遷移し、最後に元の状態に戻す
+		const std::vector<RenderGraph::PassHandle>& order = graph.GetExecutionOrder();
+		bool barriers = compiled
+			&& HasTransition(graph.GetPassBarriers(order[0]), ResourceState::GenericRead, ResourceState::UnorderedAccess)
+			&& HasTransition(graph.GetPassBarriers(order[1]), ResourceState::UnorderedAccess, ResourceState::NonPixelShaderResource)
+			&& HasTransition(graph.GetFinalBarriers(), ResourceState::NonPixelShaderResource, ResourceState::GenericRead)
+			&& HasTransition(graph.GetFinalBarriers(), ResourceState::RenderTarget, ResourceState::Present);
+
+		// 3フレーム実行しても状態が合い、同じメモリに置いたリソースが生きている間に壊されない
+		bool executed = true;
+		for (int frame = 0; frame < 3; ++frame) {
+			executed = graph.Execute(backend) && executed;
+		}
+		bool restored = imported.particles.state == ResourceState::GenericRead && imported.backBuffer.state == ResourceState::Present;
+		uint32_t createdCount = backend.resourceCount;
+		graph.ReleaseTransientResources(backend);
+
+		std::string dump = graph.Dump();
+		std::string graphviz = graph.DumpGraphviz();
+		bool dumped = dump.find("culled Debug overlay") != std::string::npos && dump.find("aliasing BloomA") != std::string::npos
+			&& graphviz.compare(0, 7, "digraph") == 0;
+
+		char detail[160];
+		std::snprintf(detail, sizeof(detail), "%u of %u passes, %u barriers, %llu KB transient (unaliased %llu KB), %u errors",
+			static_cast<uint32_t>(order.size()), statistics.passCount, statistics.barrierCount,
+			static_cast<unsigned long long>(statistics.transientMemorySize / 1024), static_cast<unsigned long long>(statistics.unaliasedMemorySize / 1024),
+			errorCount + backend.errorCount);
+		Benchmark::Check("RenderGraph", culled && aliased && barriers && executed && restored && dumped && createdCount == 4
+			&& backend.resourceCount == 0 && errorCount == 0 && backend.errorCount == 0, detail);
+	}
+
+	// 独立した2つの流れは、作ったものをすぐに読むように並べ替えて同じメモリに置く
+	void VerifySort() {
+		uint32_t errorCount = 0;
+		ImportedResources imported;
+		SimulatedBackend backend;
+		RenderGraph graph;
+		RenderGraph::ResourceHandle output = graph.Import("Output", &imported.backBuffer, ResourceState::Present, ResourceState::Present);
+		RenderGraph::ResourceHandle first = graph.CreateTransient("First", MakeDesc(8 * 1024));
+		RenderGraph::ResourceHandle second = graph.CreateTransient("Second", MakeDesc(8 * 1024));
+		RenderGraph::PassHandle produceFirst = AddCheckedPass(graph, "Produce first", {}, { { first, ResourceState::RenderTarget } }, &errorCount);
+		RenderGraph::PassHandle produceSecond = AddCheckedPass(graph, "Produce second", {}, { { second, ResourceState::RenderTarget } }, &errorCount);
+		RenderGraph::PassHandle consumeFirst = AddCheckedPass(graph, "Consume first", { { first, ResourceState::PixelShaderResource } },
+			{ { output, ResourceState::RenderTarget } }, &errorCount);
+		RenderGraph::PassHandle consumeSecond = AddCheckedPass(graph, "Consume second", { { second, ResourceState::PixelShaderResource } },
+			{ { output, ResourceState::RenderTarget } }, &errorCount);
+		graph.Compile();
+		const std::vector<RenderGraph::PassHandle>& order = graph.GetExecutionOrder();
+		bool sorted = order.size() == 4 && order[0] == produceFirst && order[1] == consumeFirst && order[2] == produceSecond && order[3] == consumeSecond;
+		bool shared = graph.GetStatistics().transientMemorySize == 8 * 1024 && graph.GetTransientOffset(first) == graph.GetTransientOffset(second);
+		graph.Execute(backend);
+		graph.ReleaseTransientResources(backend);
+		Benchmark::Check("RenderGraph", sorted && shared && errorCount == 0 && backend.errorCount == 0,
+			sorted ? "consumer-first order, 2 lifetimes share 8 KB" : "unexpected pass order");
+	}
+
+	uint32_t CountUAVBarriers(const std::vector<ResourceBarrier>& barriers) {
+		uint32_t count = 0;
+		for (const ResourceBarrier& barrier : barriers) {
+			if (barrier.type == ResourceBarrier::Type::UAV) { ++count; }
+		}
+		return count;
+	}
+
+	// UAVに書く、読む、また書く場合は、読む前と書く前の両方でUAVバリアを出す
+	void VerifyUAVHazards() {
+		uint32_t errorCount = 0;
+		ImportedResources imported;
+		SimulatedBackend backend;
+		RenderGraph graph;
+		RenderGraph::ResourceHandle particles = graph.Import("Particles", &imported.particles, ResourceState::GenericRead, ResourceState::GenericRead);
+		RenderGraph::PassHandle write = AddCheckedPass(graph, "Emit", {}, { { particles, ResourceState::UnorderedAccess } }, &errorCount);
+		RenderGraph::PassHandle read = AddCheckedPass(graph, "Count", { { particles, ResourceState::UnorderedAccess } }, {}, &errorCount, true);
+		RenderGraph::PassHandle rewrite = AddCheckedPass(graph, "Update", {}, { { particles, ResourceState::UnorderedAccess } }, &errorCount);
+		bool compiled = graph.Compile();
+		const std::vector<RenderGraph::PassHandle>& order = graph.GetExecutionOrder();
+		bool ordered = order.size() == 3 && order[0] == write && order[1] == read && order[2] == rewrite;
+		uint32_t readBarriers = compiled ? CountUAVBarriers(graph.GetPassBarriers(read)) : 0;
+		uint32_t rewriteBarriers = compiled ? CountUAVBarriers(graph.GetPassBarriers(rewrite)) : 0;
+		graph.Execute(backend);
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "write/read/write: %u UAV barrier before read, %u before write", readBarriers, rewriteBarriers);
+		Benchmark::Check("RenderGraph", compiled && ordered && readBarriers == 1 && rewriteBarriers == 1 && errorCount == 0 && backend.errorCount == 0, detail);
+	}
+
+	bool Initalize() {
+		static const bool initialized = [] {
+			VerifyFrame();
+			VerifyUAVHazards();
+			VerifySort();
+			return true;
+		}();
+		return initialized;
+	}
+
+	// ブルームの段数を増やした大きなフレーム
+	void BuildLargeFrame(RenderGraph& graph, ImportedResources& imported, uint32_t stageCount) {
+		RenderGraph::ResourceHandle backBuffer = graph.Import("BackBuffer", &imported.backBuffer, ResourceState::Present, ResourceState::Present);
+		RenderGraph::ResourceHandle previous = graph.CreateTransient("SceneColor", MakeDesc(64 * 1024));
+		RenderGraph::PassHandle draw = graph.AddPass("Draw", nullptr);
+		graph.Write(draw, previous, ResourceState::RenderTarget);
+		for (uint32_t i = 0; i < stageCount; ++i) {
+			RenderGraph::ResourceHandle next = graph.CreateTransient("Stage", MakeDesc(16 * 1024));
+			RenderGraph::PassHandle pass = graph.AddPass("Stage", nullptr);
+			graph.Read(pass, previous, ResourceState::PixelShaderResource);
+			graph.Write(pass, next, ResourceState::RenderTarget);
+			previous = next;
+		}
+		RenderGraph::PassHandle composite = graph.AddPass("Composite", nullptr);
+		graph.Read(composite, previous, ResourceState::PixelShaderResource);
+		graph.Write(composite, backBuffer, ResourceState::RenderTarget);
+	}
+
+}
+
+BENCHMARK("RenderGraph/64 passes/Declare and compile", [](size_t iterationCount) {
+	Initalize();
+	ImportedResources imported;
+	RenderGraph graph;
+	for (size_t n = 0; n < iterationCount; ++n) {
+		graph.Reset();
+		BuildLargeFrame(graph, imported, 62);
+		Benchmark::DoNotOptimize(graph.Compile());
+	}
+});
+BENCHMARK("RenderGraph/64 passes/Compile only", [](size_t iterationCount) {
+	Initalize();
+	ImportedResources imported;
+	RenderGraph graph;
+	BuildLargeFrame(graph, imported, 62);
+	for (size_t n = 0; n < iterationCount; ++n) {
+		Benchmark::DoNotOptimize(graph.Compile());
+	}
+});
@@ -0,0 +1,195 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "ResourceStateTracker.h"
+
+// パーティクルの更新と描画の1フレーム分の状態遷移を、呼ぶたびにバリアを出す以前の方式とResourceStateTrackerでまとめる方式で比べる
+// 最初に遷移のまとめ方（往復の打ち消し、続けた遷移、読み取り同士、UAVバリアの省略、分割バリア）と、1フレームで出すバリアとResourceBarrierの回数を確認して標準エラーに出す
+
+namespace {
+
+	using Engine::ResourceBarrier;
+	using Engine::ResourceState;
+	using Engine::ResourceStateTracker;
+
+	// リソースの代わり（アドレスだけを使う）
+	struct Resource {
+		ResourceState state{ ResourceState::GenericRead };
+	};
+
+	bool IsBarrier(const ResourceBarrier& barrier, const Resource& resource, ResourceState before, ResourceState after, ResourceBarrier::Flag flag = ResourceBarrier::Flag::None) {
+		return barrier.type == ResourceBarrier::Type::Transition && barrier.resource == &resource
+			&& barrier.before == before && barrier.after == after && barrier.flag == flag;
+	}
+
+	void VerifyMerging() {
+		int passed = 0, total = 0;
+		ResourceStateTracker tracker;
+		Resource a, b;
+
+		// A→B→Aは出さない
+		++total;
+		a.state = tracker.Transition(&a, a.state, ResourceState::UnorderedAccess);
+		a.state = tracker.Transition(&a, a.state, ResourceState::GenericRead);
+		if (!tracker.HasPendingBarriers() && a.state == ResourceState::GenericRead) { ++passed; }
+
+		// A→B→CはA→C
+		++total;
+		a.state = tracker.Transition(&a, a.state, ResourceState::UnorderedAccess);
+		a.state = tracker.Transition(&a, a.state, ResourceState::CopyDest);
+		if (tracker.GetPendingBarriers().size() == 1 && IsBarrier(tracker.GetPendingBarriers()[0], a, ResourceState::GenericRead, ResourceState::CopyDest)) { ++passed; }
+		tracker.ClearPendingBarriers();
+
+		// 読み取り同士はまとめて、後から含まれる読み取りを要求しても出さない
+		++total;
+		b.state = ResourceState::UnorderedAccess;
+		b.state = tracker.Transition(&b, b.state, ResourceState::NonPixelShaderResource);
+		b.state = tracker.Transition(&b, b.state, ResourceState::VertexAndConstantBuffer);
+		tracker.ClearPendingBarriers();
+		b.state = tracker.Transition(&b, b.state, ResourceState::NonPixelShaderResource);
+		ResourceState combined = ResourceState::NonPixelShaderResource | ResourceState::VertexAndConstantBuffer;
+		if (b.state == combined && !tracker.HasPendingBarriers()) { ++passed; }
+
+		// UAVバリアは重ねず、遷移があれば出さない
+		++total;
+		b.state = tracker.Transition(&b, b.state, ResourceState::UnorderedAccess);
+		tracker.ClearPendingBarriers();
+		tracker.UAVBarrier(&b);
+		tracker.UAVBarrier(&b);
+		bool singleUAV = tracker.GetPendingBarriers().size() == 1 && tracker.GetPendingBarriers()[0].type == ResourceBarrier::Type::UAV;
+		b.state = tracker.Transition(&b, b.state, ResourceState::PixelShaderResource);
+		if (singleUAV && tracker.GetPendingBarriers().size() == 1 && IsBarrier(tracker.GetPendingBarriers()[0], b, ResourceState::UnorderedAccess, ResourceState::PixelShaderResource)) { ++passed; }
+		tracker.ClearPendingBarriers();
+
+		// UAVバリアの後にUAV→B→UAVと戻っても、書き込みの間のUAVバリアは残す
+		++total;
+		b.state = tracker.Transition(&b, b.state, ResourceState::UnorderedAccess);
+		tracker.ClearPendingBarriers();
+		tracker.UAVBarrier(&b);
+		b.state = tracker.Transition(&b, b.state, ResourceState::NonPixelShaderResource);
+		b.state = tracker.Transition(&b, b.state, ResourceState::UnorderedAccess);
+		if (b.state == ResourceState::UnorderedAccess && tracker.GetPendingBarriers().size() == 1 && tracker.GetPendingBarriers()[0].type == ResourceBarrier::Type::UAV) { ++passed; }
+		tracker.ClearPendingBarriers();
+		// UAVバリアを要求していなくても、UAV→B→UAVは前後の書き込みを待つ
+		++total;
+		b.state = tracker.Transition(&b, b.state, ResourceState::CopySource);
+		b.state = tracker.Transition(&b, b.state, ResourceState::UnorderedAccess);
+		if (b.state == ResourceState::UnorderedAccess && tracker.GetPendingBarriers().size() == 1 && tracker.GetPendingBarriers()[0].type == ResourceBarrier::Type::UAV) { ++passed; }
+		tracker.ClearPendingBarriers();
+		b.state = tracker.Transition(&b, b.state, ResourceState::PixelShaderResource);
+		tracker.ClearPendingBarriers();
+
+		// 分割バリアは開始と終了を別々に出し、開始を出す前に終われば一つにする
+		++total;
+		a.state = tracker.BeginTransition(&a, a.state, ResourceState::PixelShaderResource);
+		bool begun = tracker.GetPendingBarriers().size() == 1 && IsBarrier(tracker.GetPendingBarriers()[0], a, ResourceState::CopyDest, ResourceState::PixelShaderResource, ResourceBarrier::Flag::BeginOnly);
+		tracker.ClearPendingBarriers();
+		a.state = tracker.Transition(&a, a.state, ResourceState::PixelShaderResource);
+		bool ended = tracker.GetPendingBarriers().size() == 1 && IsBarrier(tracker.GetPendingBarriers()[0], a, ResourceState::CopyDest, ResourceState::PixelShaderResource, ResourceBarrier::Flag::EndOnly);
+		tracker.ClearPendingBarriers();
+		a.state = tracker.BeginTransition(&a, a.state, ResourceState::CopySource);
+		a.state = tracker.Transition(&a, a.state, ResourceState::CopySource);
+		bool collapsed = tracker.GetPendingBarriers().size() == 1 && IsBarrier(tracker.GetPendingBarriers()[0], a, ResourceState::PixelShaderResource, ResourceState::CopySource);
+		tracker.ClearPendingBarriers();
+		if (begun && ended && collapsed && tracker.GetSplitTransitionCount() == 0) { ++passed; }
+
+		char detail[64];
+		std::snprintf(detail, sizeof(detail), "%d/%d merge rules", passed, total);
+		Benchmark::Check("ResourceState", passed == total, detail);
+	}
+
+	// 以前の方式と同じ数のバリアを出したことにする
+	struct ImmediateBarriers {
+		std::vector<ResourceBarrier> barriers;
+		uint64_t barrierCount{ 0 };
+		uint64_t callCount{ 0 };
+
+		void Emit() {
+			barrierCount += barriers.size();
+			++callCount;
+			Benchmark::DoNotOptimize(barriers.data());
+			barriers.clear();
+		}
+	};
+
+	constexpr size_t kEmitterCount = 64;
+
+	// main.cppと同じ順（エミッターごとにUAVへ遷移してディスパッチ、UAVバリアと読み取りへの遷移、最後に描画）
+	void RecordImmediate(std::vector<Resource>& emitters, ImmediateBarriers& immediate) {
+		for (Resource& emitter : emitters) {
+			immediate.barriers.push_back(ResourceBarrier{ &emitter, ResourceState::GenericRead, ResourceState::UnorderedAccess, ResourceBarrier::Type::Transition, ResourceBarrier::Flag::None });
+			immediate.Emit();
+			// Dispatch
+			immediate.barriers.push_back(ResourceBarrier{ &emitter, ResourceState::UnorderedAccess, ResourceState::UnorderedAccess, ResourceBarrier::Type::UAV, ResourceBarrier::Flag::None });
+			immediate.barriers.push_back(ResourceBarrier{ &emitter, ResourceState::UnorderedAccess, ResourceState::GenericRead, ResourceBarrier::Type::Transition, ResourceBarrier::Flag::None });
+			immediate.Emit();
+		}
+		// Draw
+	}
+
+	void RecordTracked(std::vector<Resource>& emitters, ResourceStateTracker& tracker) {
+		// 遷移をまとめて出してから、すべてのエミッターをディスパッチする
+		for (Resource& emitter : emitters) {
+			emitter.state = tracker.Transition(&emitter, emitter.state, ResourceState::UnorderedAccess);
+		}
+		for (size_t i = 0; i < emitters.size(); ++i) {
+			// Dispatchの直前
+			Benchmark::DoNotOptimize(tracker.GetPendingBarriers().data());
+			tracker.ClearPendingBarriers();
+		}
+		for (Resource& emitter : emitters) {
+			tracker.UAVBarrier(&emitter);
+			emitter.state = tracker.Transition(&emitter, emitter.state, ResourceState::GenericRead);
+		}
+		// Drawの直前
+		Benchmark::DoNotOptimize(tracker.GetPendingBarriers().data());
+		tracker.ClearPendingBarriers();
+	}
+
+	void VerifyFrame() {
+		std::vector<Resource> emitters(kEmitterCount);
+		ImmediateBarriers immediate;
+		RecordImmediate(emitters, immediate);
+		ResourceStateTracker tracker;
+		RecordTracked(emitters, tracker);
+		const ResourceStateTracker::Statistics& statistics = tracker.GetStatistics();
+		bool restored = true;
+		for (const Resource& emitter : emitters) { restored = restored && emitter.state == ResourceState::GenericRead; }
+		// 遷移はエミッターごとに2回、ResourceBarrierはディスパッチ前と描画前の2回
+		bool passed = restored && statistics.emittedCount == 2 * kEmitterCount && statistics.flushCount == 2;
+		char detail[160];
+		std::snprintf(detail, sizeof(detail), "%zu emitters: %llu barriers in %llu calls (immediate %llu in %llu calls)", kEmitterCount,
+			static_cast<unsigned long long>(statistics.emittedCount), static_cast<unsigned long long>(statistics.flushCount),
+			static_cast<unsigned long long>(immediate.barrierCount), static_cast<unsigned long long>(immediate.callCount));
+		Benchmark::Check("ResourceState", passed, detail);
+	}
+
+	bool Initalize() {
+		static const bool initialized = [] {
+			VerifyMerging();
+			VerifyFrame();
+			return true;
+		}();
+		return initialized;
+	}
+
+}
+
+BENCHMARK("ResourceStateTracker/64 emitters/Immediate barriers", [](size_t iterationCount) {
+	Initalize();
+	std::vector<Resource> emitters(kEmitterCount);
+	ImmediateBarriers immediate;
+	for (size_t n = 0; n < iterationCount; ++n) {
+		RecordImmediate(emitters, immediate);
+	}
+});
+BENCHMARK("ResourceStateTracker/64 emitters/Tracked and batched", [](size_t iterationCount) {
+	Initalize();
+	std::vector<Resource> emitters(kEmitterCount);
+	ResourceStateTracker tracker;
+	for (size_t n = 0; n < iterationCount; ++n) {
+		RecordTracked(emitters, tracker);
+	}
+});
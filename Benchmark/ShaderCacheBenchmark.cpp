@@ -0,0 +1,157 @@
+#include "Benchmark.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#include "ShaderCache.h"
+#include "SimulatedShaderCompiler.h"
+
+// 模擬のコンパイラ（1回2ms）で、キャッシュの無い起動と有る起動のコンパイル時間を比べる
+// 最初に、#includeの先を書き換えるとキーが変わること、壊れたファイルを使わないこと、一時ファイルが残らないことを確認して標準エラーに出す
+
+namespace {
+
+	using namespace std::chrono_literals;
+
+	constexpr std::chrono::nanoseconds kCompileTime = 2ms;
+
+	void WriteFile(const std::filesystem::path& path, const char* content) {
+		FILE* file = std::fopen(path.string().c_str(), "wb");
+		if (!file) { return; }
+		std::fwrite(content, 1, std::strlen(content), file);
+		std::fclose(file);
+	}
+
+	// シェーダーのディレクトリと同じ形の#includeを持つソースを作る
+	void CreateSources(const std::filesystem::path& directory) {
+		std::filesystem::create_directories(directory / "Shader");
+		WriteFile(directory / "Shader" / "HLSLCompat.h", "#ifdef HLSL\n#define uint32_t uint\n#else\n#include \"MathUtils.h\"\n#endif\n");
+		WriteFile(directory / "Shader" / "ParticleCompute_HLSLCompat.h", "#include \"HLSLCompat.h\"\nstruct Particle { float3 position; };\n");
+		WriteFile(directory / "Shader" / "ParticleUpdate.CS.hlsl", "#define HLSL\n#include \"ParticleCompute_HLSLCompat.h\"\n#include \"HLSLCompat.h\"\n[numthreads(16, 1, 1)]\nvoid main() {}\n");
+	}
+
+	Engine::ShaderCompileDesc MakeDesc(const std::filesystem::path& directory) {
+		Engine::ShaderCompileDesc desc;
+		desc.fileName = (directory / "Shader" / "ParticleUpdate.CS.hlsl").string();
+		desc.entryPoint = "main";
+		desc.profile = "cs_6_0";
+		desc.arguments = { "-Od", "-Zpr" };
+		return desc;
+	}
+
+	bool IsSame(const Engine::ShaderBytecodePtr& a, const Engine::ShaderBytecodePtr& b) {
+		return a && b && a->GetSize() == b->GetSize() && std::memcmp(a->GetData(), b->GetData(), a->GetSize()) == 0;
+	}
+
+	void CheckKey(const std::filesystem::path& directory) {
+		Engine::ShaderCompileDesc desc = MakeDesc(directory);
+		uint64_t original = 0;
+		Engine::ShaderCache::ComputeKey(desc, original);
+		uint64_t same = 0;
+		Engine::ShaderCache::ComputeKey(desc, same);
+		// 二段目の#includeの先を書き換える
+		WriteFile(directory / "Shader" / "HLSLCompat.h", "#ifdef HLSL\n#define uint32_t uint\n#define HLSL_COMPAT 2\n#endif\n");
+		uint64_t nestedChanged = 0;
+		Engine::ShaderCache::ComputeKey(desc, nestedChanged);
+		Engine::ShaderCompileDesc optimized = desc;
+		optimized.arguments = { "-O3", "-Zpr" };
+		uint64_t argumentChanged = 0;
+		Engine::ShaderCache::ComputeKey(optimized, argumentChanged);
+		Engine::ShaderCompileDesc missing = desc;
+		missing.fileName += ".missing";
+		uint64_t missingKey = 0;
+		bool missingRead = Engine::ShaderCache::ComputeKey(missing, missingKey);
+		bool passed = original == same && original != nestedChanged && nestedChanged != argumentChanged && !missingRead;
+		Benchmark::Check("ShaderCache", passed, "key follows nested include and arguments");
+	}
+
+	void CheckCache(const std::filesystem::path& directory) {
+		Engine::ShaderCompileDesc desc = MakeDesc(directory);
+		Engine::SimulatedShaderCompiler compiler;
+		Engine::ShaderBytecodePtr cold;
+		{
+			Engine::ShaderCache cache;
+			cache.Initalize(directory / "Cache");
+			cold = cache.GetOrCompile(desc, compiler);
+		}
+		// 次の起動
+		Engine::ShaderCache cache;
+		cache.Initalize(directory / "Cache");
+		Engine::ShaderBytecodePtr warm = cache.GetOrCompile(desc, compiler);
+		bool warmHit = compiler.GetCompileCount() == 1 && warm && warm->IsMapped() && IsSame(cold, warm);
+
+		// 途中で切れたファイルは使わずにコンパイルし直す
+		uint64_t key = 0;
+		Engine::ShaderCache::ComputeKey(desc, key);
+		warm.reset();
+		std::filesystem::resize_file(cache.GetPath(key), 20);
+		Engine::ShaderBytecodePtr repaired = cache.GetOrCompile(desc, compiler);
+		Engine::ShaderBytecodePtr reloaded = cache.Load(key);
+		bool recovered = compiler.GetCompileCount() == 2 && IsSame(cold, repaired) && IsSame(cold, reloaded) && cache.GetStatistics().invalidCount == 1;
+
+		uint32_t temporaryCount = 0;
+		for (const auto& entry : std::filesystem::directory_iterator(directory / "Cache")) {
+			if (entry.path().extension() == ".tmp") { ++temporaryCount; }
+		}
+		Engine::ShaderCache::Statistics statistics = cache.GetStatistics();
+		char detail[128];
+		std::snprintf(detail, sizeof(detail), "%llu hits, %llu misses, %llu invalid, %u temporary files",
+			static_cast<unsigned long long>(statistics.hitCount), static_cast<unsigned long long>(statistics.missCount),
+			static_cast<unsigned long long>(statistics.invalidCount), temporaryCount);
+		Benchmark::Check("ShaderCache", warmHit && recovered && temporaryCount == 0, detail);
+	}
+
+	// シェーダーを1つ読むかコンパイルする時間
+	double Run(const std::filesystem::path& directory, bool warm) {
+		Engine::ShaderCompileDesc desc = MakeDesc(directory);
+		Engine::SimulatedShaderCompiler compiler(kCompileTime);
+		if (!warm) { std::filesystem::remove_all(directory / "Timing"); }
+		Engine::ShaderCache cache;
+		cache.Initalize(directory / "Timing");
+		auto begin = std::chrono::steady_clock::now();
+		Benchmark::DoNotOptimize(cache.GetOrCompile(desc, compiler));
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+	}
+
+	const std::filesystem::path& Initalize() {
+		// 終了時に中身ごと消す
+		static const Benchmark::TemporaryDirectory temporaryDirectory("GPUParticleShaderCacheBenchmark");
+		static const bool initialized = [] {
+			const std::filesystem::path& directory = temporaryDirectory.GetPath();
+			CreateSources(directory);
+			CheckKey(directory);
+			CheckCache(directory);
+			double cold = Run(directory, false);
+			double warm = Run(directory, true);
+			char detail[96];
+			std::snprintf(detail, sizeof(detail), "cold %.3f ms, warm %.3f ms per shader", cold, warm);
+			Benchmark::Check("ShaderCache", warm * 10.0 < cold, detail);
+			return true;
+		}();
+		(void)initialized;
+		return temporaryDirectory.GetPath();
+	}
+
+}
+
+BENCHMARK("ShaderCache/Compute key (source + 2 includes)", [](size_t iterationCount) {
+	Engine::ShaderCompileDesc desc = MakeDesc(Initalize());
+	for (size_t n = 0; n < iterationCount; ++n) {
+		uint64_t key = 0;
+		Engine::ShaderCache::ComputeKey(desc, key);
+		Benchmark::DoNotOptimize(key);
+	}
+});
+BENCHMARK("ShaderCache/Warm load (mapped)", [](size_t iterationCount) {
+	const std::filesystem::path& directory = Initalize();
+	Engine::ShaderCompileDesc desc = MakeDesc(directory);
+	Engine::SimulatedShaderCompiler compiler;
+	Engine::ShaderCache cache;
+	cache.Initalize(directory / "Timing");
+	for (size_t n = 0; n < iterationCount; ++n) {
+		Benchmark::DoNotOptimize(cache.GetOrCompile(desc, compiler));
+	}
+});
@@ -0,0 +1,155 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ShaderCompileOptions.h"
+#include "SimulatedShaderCompiler.h"
+
+// 構成ごとの引数と、パーティクルの更新シェーダーの組み合わせ（4 x 2 x 2）、組み合わせごとのDispatchの数を確認して標準エラーに出す
+// すべての組み合わせを模擬のコンパイラで積み、キーごとに別のバイトコードとキャッシュのキーになることを確かめる
+
+namespace {
+
+	bool Contains(const std::vector<std::string>& arguments, const char* argument) {
+		return std::find(arguments.begin(), arguments.end(), argument) != arguments.end();
+	}
+
+	void CheckOptions() {
+		std::vector<std::string> debug;
+		Engine::ShaderCompileOptions::GetDebug().AppendArguments(debug);
+		std::vector<std::string> release;
+		Engine::ShaderCompileOptions::GetRelease().AppendArguments(release);
+		bool debugPassed = Contains(debug, "-Od") && Contains(debug, "-Qembed_debug") && Contains(debug, "-Zpr");
+		bool releasePassed = Contains(release, "-O3") && Contains(release, "-Qstrip_debug") && Contains(release, "-Fd") &&
+			!Contains(release, "-Od") && !Contains(release, "-Qembed_debug");
+		std::string detail = "debug:";
+		for (const std::string& argument : debug) { detail += " " + argument; }
+		detail += " / release:";
+		for (const std::string& argument : release) { detail += " " + argument; }
+		Benchmark::Check("ShaderOptions", debugPassed && releasePassed, detail.c_str());
+	}
+
+	void CheckPermutationSpace() {
+		Engine::ShaderPermutationSpace space = Engine::MakeParticleUpdatePermutationSpace();
+		// キーと次元ごとの値の番号が行き来できるか
+		bool roundTrip = true;
+		std::set<std::string> names;
+		for (Engine::ShaderPermutationSpace::Key key = 0; key < space.GetPermutationCount(); ++key) {
+			Engine::ShaderPermutationSpace::Key rebuilt = space.MakeKey({ space.GetValueIndex(key, 0), space.GetValueIndex(key, 1), space.GetValueIndex(key, 2) });
+			roundTrip = roundTrip && rebuilt == key;
+			names.insert(space.ToString(key));
+		}
+		Engine::ShaderPermutationSpace::Key key = space.SetValue(0, "THREAD_GROUP_SIZE", "256");
+		key = space.SetValue(key, "PACKED_LAYOUT", "1");
+		std::vector<std::string> defines;
+		space.AppendDefines(key, defines);
+		bool setValue = space.ToString(key) == "THREAD_GROUP_SIZE=256,INTEGRATOR=0,PACKED_LAYOUT=1" &&
+			Contains(defines, "THREAD_GROUP_SIZE=256") && space.SetValue(key, "INTEGRATOR", "2") == Engine::ShaderPermutationSpace::kInvalidKey &&
+			space.MakeKey({ 4 }) == Engine::ShaderPermutationSpace::kInvalidKey;
+		char detail[128];
+		std::snprintf(detail, sizeof(detail), "%u permutations, %zu distinct, key %u = %s",
+			space.GetPermutationCount(), names.size(), key, space.ToString(key).c_str());
+		Benchmark::Check("ShaderPermutation", space.GetPermutationCount() == 16 && names.size() == 16 && roundTrip && setValue, detail);
+	}
+
+	// キーのスレッドグループの大きさでDispatchの数を決め、割り切れない数でも足りるか
+	void CheckDispatchCount() {
+		Engine::ShaderPermutationSpace space = Engine::MakeParticleUpdatePermutationSpace();
+		static const uint32_t kParticleCounts[] = { 0, 1, 1000, 65536, UINT32_MAX };
+		bool passed = true;
+		for (Engine::ShaderPermutationSpace::Key key = 0; key < space.GetPermutationCount(); ++key) {
+			uint32_t threadGroupSize = Engine::GetParticleUpdateThreadGroupSize(space, key);
+			passed = passed && std::to_string(threadGroupSize) == space.GetValue(key, space.FindDimension("THREAD_GROUP_SIZE"));
+			for (uint32_t particleCount : kParticleCounts) {
+				uint64_t threadCount = static_cast<uint64_t>(Engine::GetParticleUpdateDispatchCount(space, key, particleCount)) * threadGroupSize;
+				// すべてを覆い、余りは1グループより少ない
+				passed = passed && threadCount >= particleCount && threadCount < static_cast<uint64_t>(particleCount) + threadGroupSize;
+			}
+		}
+		// 次元が無ければシェーダーの既定
+		Engine::ShaderPermutationSpace empty;
+		passed = passed && Engine::GetParticleUpdateThreadGroupSize(empty, 0) == 16;
+		Engine::ShaderPermutationSpace::Key key = space.SetValue(0, "THREAD_GROUP_SIZE", "256");
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "1000 particles: %u groups of 16, %u groups of 256",
+			Engine::GetParticleUpdateDispatchCount(space, 0, 1000), Engine::GetParticleUpdateDispatchCount(space, key, 1000));
+		Benchmark::Check("ShaderDispatch", passed, detail);
+	}
+
+	std::filesystem::path CreateSource(const std::filesystem::path& directory) {
+		std::filesystem::path path = directory / "ParticleUpdate.CS.hlsl";
+		FILE* file = std::fopen(path.string().c_str(), "wb");
+		if (file) {
+			std::fputs("[numthreads(THREAD_GROUP_SIZE, 1, 1)]\nvoid main() {}\n", file);
+			std::fclose(file);
+		}
+		return path;
+	}
+
+	// すべての組み合わせをデバッグとリリースで積む
+	void CheckPrecompile() {
+		// キューより後に消す
+		Benchmark::TemporaryDirectory directory("GPUParticleShaderCompileOptionsBenchmark");
+		Engine::ShaderCompileDesc base;
+		base.fileName = CreateSource(directory.GetPath()).string();
+		base.entryPoint = "main";
+		base.profile = "cs_6_0";
+		Engine::ShaderPermutationSpace space = Engine::MakeParticleUpdatePermutationSpace();
+		Engine::ShaderCompileQueue queue;
+		queue.Initalize([] { return std::make_unique<Engine::SimulatedShaderCompiler>(); }, 2);
+
+		std::set<std::string> bytecodes;
+		std::set<uint64_t> keys;
+		bool succeeded = true;
+		for (const Engine::ShaderCompileOptions& options : { Engine::ShaderCompileOptions::GetDebug(), Engine::ShaderCompileOptions::GetRelease() }) {
+			std::vector<Engine::ShaderCompileFuture> futures = Engine::SubmitAllPermutations(queue, base, options, space);
+			for (Engine::ShaderPermutationSpace::Key key = 0; key < futures.size(); ++key) {
+				const Engine::ShaderCompileResult& result = futures[key].get();
+				succeeded = succeeded && result.IsSucceeded();
+				if (result.IsSucceeded()) {
+					bytecodes.emplace(reinterpret_cast<const char*>(result.bytecode->GetData()), result.bytecode->GetSize());
+				}
+				uint64_t cacheKey = 0;
+				Engine::ShaderCache::ComputeKey(Engine::MakeShaderCompileDesc(base, options, space, key), cacheKey);
+				keys.insert(cacheKey);
+			}
+		}
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "%zu distinct bytecodes, %zu distinct cache keys (2 configs x 16)", bytecodes.size(), keys.size());
+		Benchmark::Check("ShaderPermutation", succeeded && bytecodes.size() == 32 && keys.size() == 32, detail);
+	}
+
+	bool Initalize() {
+		static const bool initialized = [] {
+			CheckOptions();
+			CheckPermutationSpace();
+			CheckDispatchCount();
+			CheckPrecompile();
+			return true;
+		}();
+		return initialized;
+	}
+
+}
+
+BENCHMARK("ShaderPermutation/Make desc for every permutation (16)", [](size_t iterationCount) {
+	Initalize();
+	Engine::ShaderCompileDesc base;
+	base.fileName = "Resource/Shader/ParticleUpdate.CS.hlsl";
+	base.entryPoint = "main";
+	base.profile = "cs_6_0";
+	Engine::ShaderPermutationSpace space = Engine::MakeParticleUpdatePermutationSpace();
+	Engine::ShaderCompileOptions options = Engine::ShaderCompileOptions::GetRelease();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (Engine::ShaderPermutationSpace::Key key = 0; key < space.GetPermutationCount(); ++key) {
+			Engine::ShaderCompileDesc desc = Engine::MakeShaderCompileDesc(base, options, space, key);
+			Benchmark::DoNotOptimize(desc.arguments.data());
+		}
+	}
+});
@@ -0,0 +1,198 @@
+#include "Benchmark.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ShaderCompileQueue.h"
+#include "SimulatedShaderCompiler.h"
+
+// 模擬のコンパイラ（1回3ms）で、12個のシェーダーを順にコンパイルする場合とワーカー4つで並行してコンパイルする場合を比べる
+// 最初に、同じ内容を積んでも一度しかコンパイルしないこと、コンパイラをスレッドをまたいで使わないこと、
+// 失敗がfutureに返り、その結果だけを忘れられることを確認して標準エラーに出す
+
+namespace {
+
+	using namespace std::chrono_literals;
+
+	constexpr std::chrono::nanoseconds kCompileTime = 3ms;
+	constexpr uint32_t kShaderCount = 12;
+	constexpr uint32_t kWorkerCount = 4;
+
+	// 別のスレッドから使われたら数える
+	class CheckedCompiler :
+		public Engine::SimulatedShaderCompiler {
+	public:
+		CheckedCompiler(std::atomic<uint32_t>& crossThreadCount) :
+			SimulatedShaderCompiler(kCompileTime), crossThreadCount_(crossThreadCount) {}
+
+		bool Compile(const Engine::ShaderCompileDesc& desc, std::vector<uint8_t>& bytecode, std::string& errors) override {
+			if (owner_ == std::thread::id()) { owner_ = std::this_thread::get_id(); }
+			if (owner_ != std::this_thread::get_id()) { ++crossThreadCount_; }
+			return SimulatedShaderCompiler::Compile(desc, bytecode, errors);
+		}
+
+	private:
+		std::atomic<uint32_t>& crossThreadCount_;
+		std::thread::id owner_;
+	};
+
+	void CreateSources(const std::filesystem::path& directory) {
+		for (uint32_t i = 0; i < kShaderCount / 2; ++i) {
+			FILE* file = std::fopen((directory / (std::to_string(i) + ".hlsl")).string().c_str(), "wb");
+			if (!file) { continue; }
+			std::fprintf(file, "[numthreads(%u, 1, 1)]\nvoid main() {}\nvoid other() {}\n", 16u << i);
+			std::fclose(file);
+		}
+	}
+
+	// ファイルごとにエントリを2つ
+	std::vector<Engine::ShaderCompileDesc> MakeDescs(const std::filesystem::path& directory) {
+		std::vector<Engine::ShaderCompileDesc> descs;
+		for (uint32_t i = 0; i < kShaderCount; ++i) {
+			Engine::ShaderCompileDesc& desc = descs.emplace_back();
+			desc.fileName = (directory / (std::to_string(i / 2) + ".hlsl")).string();
+			desc.entryPoint = (i % 2) ? "other" : "main";
+			desc.profile = "cs_6_0";
+			desc.arguments = { "-O3" };
+		}
+		return descs;
+	}
+
+	double CompileSerial(const std::vector<Engine::ShaderCompileDesc>& descs) {
+		Engine::SimulatedShaderCompiler compiler(kCompileTime);
+		auto begin = std::chrono::steady_clock::now();
+		for (const Engine::ShaderCompileDesc& desc : descs) {
+			std::vector<uint8_t> bytecode;
+			std::string errors;
+			compiler.Compile(desc, bytecode, errors);
+			Benchmark::DoNotOptimize(bytecode.data());
+		}
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+	}
+
+	double CompileParallel(const std::vector<Engine::ShaderCompileDesc>& descs) {
+		Engine::ShaderCompileQueue queue;
+		queue.Initalize([] { return std::make_unique<Engine::SimulatedShaderCompiler>(kCompileTime); }, kWorkerCount);
+		auto begin = std::chrono::steady_clock::now();
+		std::vector<Engine::ShaderCompileFuture> futures;
+		for (const Engine::ShaderCompileDesc& desc : descs) {
+			futures.push_back(queue.Submit(desc));
+		}
+		for (const Engine::ShaderCompileFuture& future : futures) {
+			Benchmark::DoNotOptimize(future.get().bytecode.get());
+		}
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+	}
+
+	void CheckQueue(const std::filesystem::path& directory) {
+		std::vector<Engine::ShaderCompileDesc> descs = MakeDescs(directory);
+		std::atomic<uint32_t> crossThreadCount{ 0 };
+		std::atomic<uint32_t> backendCount{ 0 };
+		uint64_t compileCountBefore = Engine::SimulatedShaderCompiler::GetTotalCompileCount();
+		Engine::ShaderCompileQueue queue;
+		queue.Initalize([&] {
+			++backendCount;
+			return std::make_unique<CheckedCompiler>(crossThreadCount);
+		}, kWorkerCount);
+		// すべてを2回ずつ積む
+		std::vector<Engine::ShaderCompileFuture> futures;
+		for (int pass = 0; pass < 2; ++pass) {
+			for (const Engine::ShaderCompileDesc& desc : descs) {
+				futures.push_back(queue.Submit(desc));
+			}
+		}
+		Engine::ShaderCompileDesc missing = descs[0];
+		missing.fileName += ".missing";
+		Engine::ShaderCompileFuture failed = queue.Submit(missing);
+		queue.WaitForIdle();
+
+		bool allSucceeded = true;
+		bool sameResult = true;
+		for (size_t i = 0; i < kShaderCount; ++i) {
+			const Engine::ShaderCompileResult& first = futures[i].get();
+			const Engine::ShaderCompileResult& second = futures[i + kShaderCount].get();
+			allSucceeded = allSucceeded && first.IsSucceeded();
+			sameResult = sameResult && first.bytecode == second.bytecode;
+		}
+		uint64_t compileCount = Engine::SimulatedShaderCompiler::GetTotalCompileCount() - compileCountBefore;
+		Engine::ShaderCompileQueue::Statistics statistics = queue.GetStatistics();
+		char detail[128];
+		std::snprintf(detail, sizeof(detail), "%llu submitted, %llu compiled, %llu deduplicated, %u backends, %u cross-thread uses",
+			static_cast<unsigned long long>(statistics.submitCount), static_cast<unsigned long long>(compileCount),
+			static_cast<unsigned long long>(statistics.deduplicatedCount), backendCount.load(), crossThreadCount.load());
+		// 失敗したものだけを忘れると、積み直せばコンパイルし直し、他は前の結果を使う
+		bool forgotten = queue.Forget(failed.get().identity);
+		Engine::ShaderCompileFuture retried = queue.Submit(missing);
+		Engine::ShaderCompileFuture kept = queue.Submit(descs[0]);
+		queue.WaitForIdle();
+		Engine::ShaderCompileQueue::Statistics retriedStatistics = queue.GetStatistics();
+		bool forgetPassed = forgotten && !retried.get().IsSucceeded() && retriedStatistics.failedCount == 2 &&
+			retriedStatistics.deduplicatedCount == statistics.deduplicatedCount + 1 && kept.get().bytecode == futures[0].get().bytecode;
+		bool passed = allSucceeded && sameResult && compileCount == kShaderCount + 1 && statistics.deduplicatedCount == kShaderCount &&
+			backendCount == kWorkerCount && crossThreadCount == 0 &&
+			!failed.get().IsSucceeded() && !failed.get().errors.empty() && statistics.failedCount == 1 && forgetPassed;
+		Benchmark::Check("ShaderCompileQueue", passed, detail);
+	}
+
+	// キャッシュがあれば、次の起動ではコンパイルしない
+	void CheckCache(const std::filesystem::path& directory) {
+		std::vector<Engine::ShaderCompileDesc> descs = MakeDescs(directory);
+		uint64_t compileCounts[2]{};
+		for (int run = 0; run < 2; ++run) {
+			uint64_t before = Engine::SimulatedShaderCompiler::GetTotalCompileCount();
+			Engine::ShaderCache cache;
+			cache.Initalize(directory / "Cache");
+			Engine::ShaderCompileQueue queue;
+			queue.Initalize([] { return std::make_unique<Engine::SimulatedShaderCompiler>(); }, kWorkerCount, &cache);
+			for (const Engine::ShaderCompileDesc& desc : descs) {
+				queue.Submit(desc);
+			}
+			queue.WaitForIdle();
+			compileCounts[run] = Engine::SimulatedShaderCompiler::GetTotalCompileCount() - before;
+		}
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "cold %llu compiles, warm %llu compiles",
+			static_cast<unsigned long long>(compileCounts[0]), static_cast<unsigned long long>(compileCounts[1]));
+		Benchmark::Check("ShaderCompileQueue", compileCounts[0] == kShaderCount && compileCounts[1] == 0, detail);
+	}
+
+	const std::filesystem::path& Initalize() {
+		// 終了時に中身ごと消す
+		static const Benchmark::TemporaryDirectory temporaryDirectory("GPUParticleShaderCompileQueueBenchmark");
+		static const bool initialized = [] {
+			const std::filesystem::path& directory = temporaryDirectory.GetPath();
+			CreateSources(directory);
+			CheckQueue(directory);
+			CheckCache(directory);
+			std::vector<Engine::ShaderCompileDesc> descs = MakeDescs(directory);
+			double serial = CompileSerial(descs);
+			double parallel = CompileParallel(descs);
+			char detail[96];
+			std::snprintf(detail, sizeof(detail), "%u shaders: serial %.2f ms, %u workers %.2f ms", kShaderCount, serial, kWorkerCount, parallel);
+			Benchmark::Check("ShaderCompileQueue", parallel < serial * 0.5, detail);
+			return true;
+		}();
+		(void)initialized;
+		return temporaryDirectory.GetPath();
+	}
+
+}
+
+BENCHMARK("ShaderCompileQueue/Serial (12 shaders)", [](size_t iterationCount) {
+	std::vector<Engine::ShaderCompileDesc> descs = MakeDescs(Initalize());
+	for (size_t n = 0; n < iterationCount; ++n) {
+		Benchmark::DoNotOptimize(CompileSerial(descs));
+	}
+});
+BENCHMARK("ShaderCompileQueue/4 workers (12 shaders)", [](size_t iterationCount) {
+	std::vector<Engine::ShaderCompileDesc> descs = MakeDescs(Initalize());
+	for (size_t n = 0; n < iterationCount; ++n) {
+		Benchmark::DoNotOptimize(CompileParallel(descs));
+	}
+});
@@ -0,0 +1,259 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "StringUtils.h"
+
+// String::ConvertTo / ToWide を、長さを数えてから毎回std::wstringを確保して1文字ずつ変換する以前の方式と比べる
+// 最初に乱数の文字列が1文字ずつの素直な変換と一致して往復できること、不正なバイト列の置き換え、切り捨て、SmallStringを確認して標準エラーに出す
+
+namespace {
+
+	// 素直な変換（コードポイントの列を経由する、正しいUTF-8のみ）
+	std::u32string DecodeReference(const std::string& utf8) {
+		std::u32string result;
+		for (size_t i = 0; i < utf8.size();) {
+			unsigned char c = static_cast<unsigned char>(utf8[i]);
+			size_t length = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+			char32_t codePoint = length == 1 ? c : length == 2 ? (c & 0x1F) : length == 3 ? (c & 0x0F) : (c & 0x07);
+			for (size_t n = 1; n < length; ++n) { codePoint = (codePoint << 6) | (static_cast<unsigned char>(utf8[i + n]) & 0x3F); }
+			result.push_back(codePoint);
+			i += length;
+		}
+		return result;
+	}
+
+	std::u16string EncodeUtf16Reference(const std::u32string& codePoints) {
+		std::u16string result;
+		for (char32_t c : codePoints) {
+			if (c >= 0x10000) {
+				result.push_back(static_cast<char16_t>(0xD800 + ((c - 0x10000) >> 10)));
+				result.push_back(static_cast<char16_t>(0xDC00 + ((c - 0x10000) & 0x3FF)));
+			}
+			else {
+				result.push_back(static_cast<char16_t>(c));
+			}
+		}
+		return result;
+	}
+
+	// 以前の方式（長さを数えてから毎回確保して、1文字ずつ変換する）
+	std::wstring LegacyConvert(const std::string& str) {
+		std::u32string codePoints = DecodeReference(str);
+		size_t length = 0;
+		for (char32_t c : codePoints) { length += (sizeof(wchar_t) == 2 && c >= 0x10000) ? 2 : 1; }
+		std::wstring result(length, 0);
+		size_t i = 0;
+		for (char32_t c : codePoints) {
+			if (sizeof(wchar_t) == 2 && c >= 0x10000) {
+				result[i++] = static_cast<wchar_t>(0xD800 + ((c - 0x10000) >> 10));
+				result[i++] = static_cast<wchar_t>(0xDC00 + ((c - 0x10000) & 0x3FF));
+			}
+			else {
+				result[i++] = static_cast<wchar_t>(c);
+			}
+		}
+		return result;
+	}
+
+	// ASCIIが多めで、2～4バイトの文字が混ざる文字列
+	std::string MakeRandomUtf8(std::mt19937& random, size_t codePointCount) {
+		std::string result;
+		std::uniform_int_distribution<int> kind(0, 15);
+		for (size_t i = 0; i < codePointCount; ++i) {
+			int k = kind(random);
+			char32_t c = k < 10 ? 0x20 + random() % 0x5F : k < 12 ? 0x80 + random() % 0x780 : k < 15 ? 0x800 + random() % 0xD000 : 0x10000 + random() % 0xFFFFF;
+			char buffer[8];
+			std::u32string single(1, c);
+			std::u16string utf16 = EncodeUtf16Reference(single);
+			size_t length = String::Convert(std::u16string_view(utf16), buffer, sizeof(buffer));
+			result.append(buffer, length);
+		}
+		return result;
+	}
+
+	void VerifyRoundTrip(const std::vector<std::string>& texts) {
+		size_t mismatched = 0, lengthMismatched = 0, bytes = 0;
+		std::u16string utf16;
+		std::wstring wide;
+		std::string utf8;
+		for (const std::string& text : texts) {
+			bytes += text.size();
+			std::u32string codePoints = DecodeReference(text);
+			std::u16string expected = EncodeUtf16Reference(codePoints);
+			String::ConvertTo(text, utf16);
+			String::ConvertTo(text, wide);
+			if (utf16 != expected || wide != LegacyConvert(text) || String::Convert(text) != wide) { ++mismatched; }
+			String::ConvertTo(utf16, utf8);
+			if (utf8 != text) { ++mismatched; }
+			String::ConvertTo(wide, utf8);
+			if (utf8 != text || String::Convert(wide) != text) { ++mismatched; }
+			if (String::GetUtf16Length(text) != expected.size() || String::GetWideLength(text) != wide.size()
+				|| String::GetUtf8Length(std::u16string_view(utf16)) != text.size() || String::GetUtf8Length(std::wstring_view(wide)) != text.size()) {
+				++lengthMismatched;
+			}
+		}
+		char detail[128];
+		std::snprintf(detail, sizeof(detail), "%zu strings (%zu bytes), %zu mismatched, %zu length mismatched", texts.size(), bytes, mismatched, lengthMismatched);
+		Benchmark::Check("StringConvert", mismatched == 0 && lengthMismatched == 0, detail);
+	}
+
+	// 不正なバイト列はU+FFFDになるか
+	void VerifyInvalid() {
+		struct Case {
+			const char* utf8;
+			std::u16string expected;
+		};
+		const Case cases[] = {
+			{ "a\xC0\x80z", u"a��z" },
+			{ "\xE0\x80", u"��" },
+			{ "\xED\xA0\x80", u"���" },
+			{ "\xF0\x9F\x98", u"�" },
+			{ "\xF0\x9F\x98\x80\xFF", u"\U0001F600�" },
+			{ "\xE3\x81z", u"�z" },
+		};
+		size_t passed = 0;
+		std::u16string utf16;
+		for (const Case& c : cases) {
+			String::ConvertTo(c.utf8, utf16);
+			if (utf16 == c.expected && String::GetUtf16Length(c.utf8) == c.expected.size()) { ++passed; }
+		}
+		std::string utf8;
+		const char16_t loneSurrogate[] = { 0xD800, u'a', 0xDC00 };
+		String::ConvertTo(std::u16string_view(loneSurrogate, 3), utf8);
+		if (utf8 == "\xEF\xBF\xBD" "a" "\xEF\xBF\xBD") { ++passed; }
+
+		char detail[64];
+		std::snprintf(detail, sizeof(detail), "%zu/%zu invalid sequences replaced", passed, std::size(cases) + 1);
+		Benchmark::Check("StringConvert", passed == std::size(cases) + 1, detail);
+	}
+
+	// 切り捨てで文字を分けないか、SmallStringが短い場合だけ配列に置くか
+	void VerifyBuffers() {
+		char16_t small[4];
+		// "ab😀c"：3文字目は2単位で収まらない
+		size_t required = String::Convert("ab\xF0\x9F\x98\x80" "c", small, std::size(small));
+		bool truncated = required == 5 && std::u16string_view(small) == u"ab";
+		char narrow[6];
+		required = String::Convert(std::u16string_view(u"xあい"), narrow, sizeof(narrow));
+		bool narrowTruncated = required == 7 && std::strcmp(narrow, "x\xE3\x81\x82") == 0;
+
+		String::SmallString<wchar_t, String::kSmallStringSize> shortName = String::ToWide("ParticleBuffer");
+		bool local = shortName.IsLocal() && shortName.GetView() == L"ParticleBuffer" && shortName.GetCString()[shortName.GetLength()] == 0;
+		std::string longText(300, 'a');
+		auto longName = String::ToWide(longText);
+		bool heap = !longName.IsLocal() && longName.GetLength() == 300 && std::wstring_view(longName.GetCString()) == std::wstring(300, L'a');
+		// 元は128バイト以上だが、変換後は128文字に収まる
+		std::string japanese;
+		for (int i = 0; i < 60; ++i) { japanese += "\xE3\x81\x82"; }
+		auto japaneseName = String::ToWide(japanese);
+		bool fits = japaneseName.IsLocal() && japaneseName.GetLength() == 60;
+		auto utf8Name = String::ToUtf8(L"Adapter あ");
+		bool narrowed = utf8Name.IsLocal() && utf8Name.GetView() == "Adapter \xE3\x81\x82";
+
+		char detail[128];
+		std::snprintf(detail, sizeof(detail), "truncate %s/%s, local %s, heap %s, fits %s, narrow %s",
+			truncated ? "yes" : "no", narrowTruncated ? "yes" : "no", local ? "yes" : "no", heap ? "yes" : "no", fits ? "yes" : "no", narrowed ? "yes" : "no");
+		Benchmark::Check("StringConvert", truncated && narrowTruncated && local && heap && fits && narrowed, detail);
+	}
+
+	struct Inputs {
+		// リソース名のようなASCIIの短い文字列
+		std::vector<std::string> names;
+		// 日本語などが混ざる長い文字列
+		std::vector<std::string> texts;
+		std::vector<std::wstring> wideNames;
+	};
+
+	const Inputs& GetInputs() {
+		static const Inputs inputs = [] {
+			static const char* const kKinds[] = { "StructuredBuffer", "Texture2D", "DescriptorHeap", "RenderTarget" };
+			Inputs result;
+			std::mt19937 random(5678);
+			for (int i = 0; i < 1024; ++i) {
+				result.names.push_back(std::string(kKinds[i % 4]) + " Particle_" + std::to_string(random() % 100000));
+				result.wideNames.push_back(String::Convert(result.names.back()));
+			}
+			for (int i = 0; i < 64; ++i) {
+				result.texts.push_back(MakeRandomUtf8(random, 16 + random() % 512));
+			}
+			VerifyRoundTrip(result.texts);
+			VerifyRoundTrip(result.names);
+			VerifyInvalid();
+			VerifyBuffers();
+			return result;
+		}();
+		return inputs;
+	}
+
+}
+
+BENCHMARK("StringConvert/names x1024/Legacy two-pass alloc", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (const std::string& name : in.names) {
+			std::wstring wide = LegacyConvert(name);
+			Benchmark::DoNotOptimize(wide.data());
+		}
+	}
+});
+BENCHMARK("StringConvert/names x1024/String::Convert", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (const std::string& name : in.names) {
+			std::wstring wide = String::Convert(name);
+			Benchmark::DoNotOptimize(wide.data());
+		}
+	}
+});
+BENCHMARK("StringConvert/names x1024/String::ToWide", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (const std::string& name : in.names) {
+			auto wide = String::ToWide(name);
+			Benchmark::DoNotOptimize(wide.GetCString());
+		}
+	}
+});
+BENCHMARK("StringConvert/names x1024/String::ConvertTo reuse", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	std::wstring wide;
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (const std::string& name : in.names) {
+			String::ConvertTo(name, wide);
+			Benchmark::DoNotOptimize(wide.data());
+		}
+	}
+});
+BENCHMARK("StringConvert/names x1024 to UTF-8/String::ToUtf8", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (const std::wstring& name : in.wideNames) {
+			auto utf8 = String::ToUtf8(name);
+			Benchmark::DoNotOptimize(utf8.GetCString());
+		}
+	}
+});
+BENCHMARK("StringConvert/mixed text/Legacy two-pass alloc", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (const std::string& text : in.texts) {
+			std::wstring wide = LegacyConvert(text);
+			Benchmark::DoNotOptimize(wide.data());
+		}
+	}
+});
+BENCHMARK("StringConvert/mixed text/String::ConvertTo reuse", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	std::u16string utf16;
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (const std::string& text : in.texts) {
+			String::ConvertTo(text, utf16);
+			Benchmark::DoNotOptimize(utf16.data());
+		}
+	}
+});
@@ -0,0 +1,155 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "StringFormat.h"
+
+// String::FormatTo / FormatTemporary / Format を、以前のsnprintfで2回書くString::Formatとスタックへのsnprintfと比べる
+// 最初に乱数の整数、浮動小数点数、16進数、幅の指定の結果がsnprintfと一致すること、切り捨てとFixedStringを確認して標準エラーに出す
+
+namespace {
+
+	// 以前のString::Format（長さを測ってからvectorに書いてstringにコピーする）
+	template<typename ... Args>
+	std::string LegacyFormat(const std::string& format, Args ... args) {
+		size_t len = static_cast<size_t>(std::snprintf(nullptr, 0, format.c_str(), args ...));
+		std::vector<char> buffer(len + 1);
+		std::snprintf(buffer.data(), len + 1, format.c_str(), args ...);
+		return std::string(buffer.data(), buffer.data() + len);
+	}
+
+	struct Entry {
+		int32_t index;
+		uint32_t id;
+		float value;
+		double time;
+		const char* name;
+	};
+
+	// snprintfと同じ結果になるか。既定の浮動小数点数は元の値に戻せるか
+	void VerifyAgainstSnprintf(const std::vector<Entry>& entries) {
+		size_t mismatched = 0, notRoundTripped = 0;
+		char actual[256], expected[256];
+		for (const Entry& e : entries) {
+			String::FormatTo(actual, "{} {:8} {:08} {:x} {:X} {:.3} {:e} {:g} {:.1f} [{:12}] {{{}}} {} {}",
+				e.index, e.index, e.index, e.id, e.id, e.time, e.time, e.time, e.value, e.name, e.id, 'c', e.index < 0);
+			std::snprintf(expected, sizeof(expected), "%d %8d %08d %x %X %.3f %e %g %.1f [%-12s] {%u} %c %s",
+				e.index, e.index, e.index, e.id, e.id, e.time, e.time, e.time, e.value, e.name, e.id, 'c', e.index < 0 ? "true" : "false");
+			if (std::strcmp(actual, expected) != 0) {
+				if (mismatched == 0) { std::fprintf(stderr, "  expected \"%s\"\n  actual   \"%s\"\n", expected, actual); }
+				++mismatched;
+			}
+			std::string shortest = String::Format("{} {}", e.value, e.time);
+			float value = 0.0f;
+			double time = 0.0;
+			if (std::sscanf(shortest.c_str(), "%f %lf", &value, &time) != 2 || value != e.value || time != e.time) { ++notRoundTripped; }
+		}
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "%zu/%zu match snprintf, %zu not round-tripped", entries.size() - mismatched, entries.size(), notRoundTripped);
+		Benchmark::Check("StringFormat", mismatched == 0 && notRoundTripped == 0, detail);
+	}
+
+	// 収まらない場合に切り捨てて終端し、必要な長さを返すか
+	void VerifyTruncation() {
+		char small[8];
+		size_t required = String::FormatTo(small, "value={}", 123456789);
+		bool truncated = required == 15 && std::strcmp(small, "value=1") == 0;
+
+		String::FixedString<24> fixed("frame {}", 42);
+		fixed.Append(" {:.2f}ms", 16.6667);
+		bool appended = fixed.GetView() == "frame 42 16.67ms" && !fixed.IsTruncated();
+		fixed.Append(" {}", "overflow");
+		bool overflowed = fixed.IsTruncated() && fixed.GetLength() == fixed.GetCapacity() && std::strlen(fixed.GetCString()) == fixed.GetLength();
+
+		std::string longText(2000, 'a');
+		std::string large = String::Format("<{}>", longText);
+		bool spilled = large.size() == longText.size() + 2 && large.front() == '<' && large.back() == '>';
+		std::string_view temporary = String::FormatTemporary("<{}>", longText);
+		bool clipped = temporary.size() == String::Internal::kThreadBufferSize - 1 && temporary.data()[temporary.size()] == '\0';
+
+		char detail[128];
+		std::snprintf(detail, sizeof(detail), "truncate %s, fixed %s/%s, large %s, temporary %s",
+			truncated ? "yes" : "no", appended ? "yes" : "no", overflowed ? "yes" : "no", spilled ? "yes" : "no", clipped ? "yes" : "no");
+		Benchmark::Check("StringFormat", truncated && appended && overflowed && spilled && clipped, detail);
+	}
+
+	struct Inputs {
+		std::vector<Entry> entries;
+	};
+
+	const Inputs& GetInputs() {
+		static const Inputs inputs = [] {
+			static const char* const kNames[] = { "Particle", "StructuredBuffer", "DepthStencil", "SwapChain" };
+			Inputs result;
+			std::mt19937 random(1234);
+			std::uniform_int_distribution<int32_t> integer(-1000000, 1000000);
+			std::uniform_real_distribution<double> real(-10000.0, 10000.0);
+			for (int i = 0; i < 256; ++i) {
+				Entry e;
+				e.index = integer(random);
+				e.id = static_cast<uint32_t>(random());
+				e.value = static_cast<float>(real(random));
+				e.time = real(random) * 0.001;
+				e.name = kNames[i % 4];
+				result.entries.push_back(e);
+			}
+			VerifyAgainstSnprintf(result.entries);
+			VerifyTruncation();
+			return result;
+		}();
+		return inputs;
+	}
+
+}
+
+BENCHMARK("StringFormat/x256/Legacy String::Format", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (const Entry& e : in.entries) {
+			std::string text = LegacyFormat("Entry %d id %08x value %.3f name %s", e.index, e.id, e.value, e.name);
+			Benchmark::DoNotOptimize(text.data());
+		}
+	}
+});
+BENCHMARK("StringFormat/x256/snprintf stack", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	char buffer[128];
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (const Entry& e : in.entries) {
+			std::snprintf(buffer, sizeof(buffer), "Entry %d id %08x value %.3f name %s", e.index, e.id, e.value, e.name);
+			Benchmark::DoNotOptimize(buffer);
+		}
+	}
+});
+BENCHMARK("StringFormat/x256/String::FormatTo stack", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	char buffer[128];
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (const Entry& e : in.entries) {
+			String::FormatTo(buffer, "Entry {} id {:08x} value {:.3} name {}", e.index, e.id, e.value, e.name);
+			Benchmark::DoNotOptimize(buffer);
+		}
+	}
+});
+BENCHMARK("StringFormat/x256/String::FormatTemporary", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (const Entry& e : in.entries) {
+			std::string_view text = String::FormatTemporary("Entry {} id {:08x} value {:.3} name {}", e.index, e.id, e.value, e.name);
+			Benchmark::DoNotOptimize(text.data());
+		}
+	}
+});
+BENCHMARK("StringFormat/x256/String::Format", [](size_t iterationCount) {
+	const Inputs& in = GetInputs();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		for (const Entry& e : in.entries) {
+			std::string text = String::Format("Entry {} id {:08x} value {:.3} name {}", e.index, e.id, e.value, e.name);
+			Benchmark::DoNotOptimize(text.data());
+		}
+	}
+});
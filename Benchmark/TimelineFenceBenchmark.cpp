@@ -0,0 +1,132 @@
+#include "Benchmark.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "SimulatedGPUQueue.h"
+#include "TimelineFence.h"
+
+// 模擬のフェンスで、完了の問い合わせ（ポーリング）と待機のコストを測る
+// 最初に、時間切れ、WaitAny/WaitAll、完了したら呼ぶ関数の順番を確認して標準エラーに出す
+
+namespace {
+
+	using namespace std::chrono_literals;
+
+	double ToMilliseconds(std::chrono::steady_clock::duration duration) {
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	// 届かない値を待って、時間切れで戻るか
+	void CheckTimeout() {
+		Engine::SimulatedTimelineFence fence;
+		auto begin = std::chrono::steady_clock::now();
+		bool waited = fence.Wait(1, 5ms);
+		double elapsed = ToMilliseconds(std::chrono::steady_clock::now() - begin);
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "timed out after %.2f ms (5 ms)", elapsed);
+		Benchmark::Check("Fence/Timeout", !waited && elapsed >= 5.0, detail);
+	}
+
+	// 二つのキューのうち先に終わる方が返るか、すべてを待つと遅い方まで待つか
+	void CheckMultiWait() {
+		Engine::SimulatedGPUQueue fastQueue;
+		Engine::SimulatedGPUQueue slowQueue;
+		slowQueue.Submit(20ms);
+		uint64_t slowValue = slowQueue.Signal();
+		fastQueue.Submit(2ms);
+		uint64_t fastValue = fastQueue.Signal();
+		Engine::TimelineFence::WaitDesc waits[] = {
+			{ &slowQueue.GetTimelineFence(), slowValue },
+			{ &fastQueue.GetTimelineFence(), fastValue },
+		};
+		int32_t first = Engine::TimelineFence::WaitAny(waits, 2);
+		bool slowPending = !slowQueue.IsCompleted(slowValue);
+		bool allTimedOut = !Engine::TimelineFence::WaitAll(waits, 2, 1ms);
+		bool all = Engine::TimelineFence::WaitAll(waits, 2);
+		// 積んでいない値は、どれも届かずに時間切れになる
+		Engine::TimelineFence::WaitDesc never[] = {
+			{ &slowQueue.GetTimelineFence(), slowValue + 1 },
+			{ &fastQueue.GetTimelineFence(), fastValue + 1 },
+		};
+		int32_t none = Engine::TimelineFence::WaitAny(never, 2, 2ms);
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "WaitAny -> %d, WaitAll timeout %s, none -> %d", first, allTimedOut ? "yes" : "no", none);
+		Benchmark::Check("Fence/WaitAny/All", first == 1 && slowPending && allTimedOut && all && none == -1, detail);
+	}
+
+	// 完了したら呼ぶ関数が、届いた値の分だけ値の順に呼ばれるか
+	void CheckCallbacks() {
+		Engine::SimulatedTimelineFence fence;
+		std::vector<uint64_t> called;
+		// 順不同に足す
+		for (uint64_t value : { 3, 1, 4, 2, 5 }) {
+			fence.AddCompletionCallback(value, [&called, value] { called.push_back(value); });
+		}
+		fence.Signal(3);
+		uint32_t first = fence.ProcessCompletionCallbacks();
+		// 呼ばれた関数の中から足してもよい
+		fence.AddCompletionCallback(4, [&] { fence.AddCompletionCallback(6, [&called] { called.push_back(6); }); });
+		fence.Signal(6);
+		uint32_t second = fence.ProcessCompletionCallbacks();
+		uint32_t third = fence.ProcessCompletionCallbacks();
+		std::vector<uint64_t> expected = { 1, 2, 3, 4, 5, 6 };
+		char detail[96];
+		std::snprintf(detail, sizeof(detail), "called %u + %u + %u, %u pending", first, second, third, fence.GetPendingCallbackCount());
+		Benchmark::Check("Fence/Callbacks", first == 3 && second == 3 && third == 1 && called == expected && fence.GetPendingCallbackCount() == 0, detail);
+	}
+
+	bool Initalize() {
+		static const bool initialized = [] {
+			CheckTimeout();
+			CheckMultiWait();
+			CheckCallbacks();
+			return true;
+		}();
+		return initialized;
+	}
+
+}
+
+BENCHMARK("TimelineFence/IsCompleted poll", [](size_t iterationCount) {
+	Initalize();
+	Engine::SimulatedTimelineFence fence;
+	fence.Signal(1);
+	for (size_t n = 0; n < iterationCount; ++n) {
+		Benchmark::DoNotOptimize(fence.IsCompleted(n & 1));
+	}
+});
+BENCHMARK("TimelineFence/Wait (already completed)", [](size_t iterationCount) {
+	Initalize();
+	Engine::SimulatedTimelineFence fence;
+	fence.Signal(1);
+	for (size_t n = 0; n < iterationCount; ++n) {
+		Benchmark::DoNotOptimize(fence.Wait(1));
+	}
+});
+BENCHMARK("TimelineFence/Signal and Wait across threads", [](size_t iterationCount) {
+	Initalize();
+	Engine::SimulatedTimelineFence fence;
+	std::thread signaler([&] {
+		for (uint64_t value = 1; value <= iterationCount; ++value) {
+			fence.Signal(value);
+		}
+	});
+	for (size_t n = 1; n <= iterationCount; ++n) {
+		Benchmark::DoNotOptimize(fence.Wait(n));
+	}
+	signaler.join();
+});
+BENCHMARK("TimelineFence/Add and process callbacks", [](size_t iterationCount) {
+	Initalize();
+	Engine::SimulatedTimelineFence fence;
+	uint64_t sum = 0;
+	for (size_t n = 0; n < iterationCount; ++n) {
+		fence.AddCompletionCallback(n + 1, [&sum] { ++sum; });
+		fence.Signal(n + 1);
+		fence.ProcessCompletionCallbacks();
+	}
+	Benchmark::DoNotOptimize(sum);
+});
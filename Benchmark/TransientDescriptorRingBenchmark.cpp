@@ -0,0 +1,173 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "TransientDescriptorRing.h"
+#include "ManualGPUQueue.h"
+
+// Engine::TransientDescriptorRing を計測する
+// 最初に数フレーム遅れて完了するGPUをフェンス値で模擬し、処理中のフレームの領域を上書きしないことを確認して標準エラーに出す
+
+namespace {
+
+	using Engine::TransientDescriptorRing;
+
+	// 処理中のフレーム数（DirectXDevice::kSwapChainBufferCountと同じ）
+	constexpr uint32_t kFrameLatency = 2;
+	// 1フレームで確保する数
+	constexpr size_t kAllocationCount = 4096;
+
+	// 確保した位置が、GPUがまだ読んでいるフレームの位置と重ならないか
+	void VerifyFrames() {
+		constexpr uint32_t kBase = 100;
+		constexpr uint32_t kCapacity = 1000;
+		TransientDescriptorRing ring;
+		ring.Initalize(kBase, kCapacity, 16);
+		Benchmark::ManualGPUQueue gpu;
+		// スロットを最後に使ったフレームのフェンス値（0は未使用）
+		std::vector<uint64_t> lastFence(kCapacity, 0);
+		std::vector<uint64_t> usedInFrame(kCapacity, 0);
+		TransientDescriptorRing::ThreadBlock blocks[3];
+		std::mt19937 engine(21);
+		size_t hazards = 0, outOfRange = 0, failures = 0, allocated = 0;
+
+		for (uint64_t frame = 1; frame <= 5000; ++frame) {
+			// 途中でGPUが止まった場合は確保に失敗するだけで上書きしない
+			bool stall = frame % 500 > 480;
+			if (!stall) { gpu.AdvanceFrame(kFrameLatency); }
+			uint64_t completed = gpu.GetCompletedValue();
+			ring.BeginFrame(completed);
+			uint64_t fenceValue = frame;
+			size_t requests = engine() % 120;
+			for (size_t n = 0; n < requests; ++n) {
+				uint32_t count = (engine() % 4) == 0 ? 1 + engine() % 24 : 1;
+				uint32_t index = (n % 4) == 3 ? ring.Allocate(count) : blocks[n % 3].Allocate(ring, count);
+				if (index == TransientDescriptorRing::kInvalidIndex) {
+					++failures;
+					continue;
+				}
+				if (index < kBase || index + count > kBase + kCapacity) {
+					++outOfRange;
+					continue;
+				}
+				for (uint32_t k = 0; k < count; ++k) {
+					uint32_t slot = index - kBase + k;
+					// 同じフレームで二重に渡した、またはGPUがまだ完了していないフレームの位置
+					if (usedInFrame[slot] == fenceValue || lastFence[slot] > completed) { ++hazards; }
+					usedInFrame[slot] = fenceValue;
+					lastFence[slot] = fenceValue;
+				}
+				++allocated;
+			}
+			uint64_t signaled = gpu.Signal();
+			if (signaled != fenceValue) { ++hazards; }
+			ring.EndFrame(signaled);
+		}
+
+		char detail[160];
+		std::snprintf(detail, sizeof(detail), "%zu allocations, %zu full during stalls, %zu hazards, %zu out of range", allocated, failures, hazards, outOfRange);
+		Benchmark::Check("TransientDescriptorRing", hazards == 0 && outOfRange == 0 && failures > 0, detail);
+	}
+
+	// 複数のスレッドが同じフレームで確保しても重ならないか
+	void VerifyThreads() {
+		constexpr uint32_t kCapacity = 1 << 16;
+		TransientDescriptorRing ring;
+		ring.Initalize(0, kCapacity, 64);
+		std::vector<std::atomic<int>> owners(kCapacity);
+		std::atomic<size_t> overlaps{ 0 };
+		std::vector<std::thread> threads;
+		ring.BeginFrame(0);
+		for (size_t t = 0; t < 4; ++t) {
+			threads.emplace_back([&, t] {
+				TransientDescriptorRing::ThreadBlock block;
+				for (size_t n = 0; n < 3000; ++n) {
+					uint32_t count = 1 + static_cast<uint32_t>((n + t) % 3);
+					uint32_t index = (n % 10) == 0 ? ring.Allocate(count) : block.Allocate(ring, count);
+					if (index == TransientDescriptorRing::kInvalidIndex) { continue; }
+					for (uint32_t k = 0; k < count; ++k) {
+						if (owners[index + k].fetch_add(1, std::memory_order_relaxed) != 0) { overlaps.fetch_add(1); }
+					}
+				}
+			});
+		}
+		for (auto& thread : threads) { thread.join(); }
+		ring.EndFrame(1);
+
+		char detail[128];
+		std::snprintf(detail, sizeof(detail), "4 threads, %u used, %zu overlaps", ring.GetUsedCount(), overlaps.load());
+		Benchmark::Check("TransientDescriptorRing", overlaps == 0, detail);
+	}
+
+	struct Inputs {
+		TransientDescriptorRing ring;
+		Benchmark::ManualGPUQueue gpu;
+	};
+
+	Inputs& GetInputs() {
+		static Inputs inputs;
+		static const bool initialized = [] {
+			VerifyFrames();
+			VerifyThreads();
+			inputs.ring.Initalize(0, kAllocationCount * (kFrameLatency + 1), 64);
+			return true;
+		}();
+		Benchmark::DoNotOptimize(initialized);
+		return inputs;
+	}
+
+	// 1フレーム分（kAllocationCount個）を確保する
+	template<class AllocateFunction>
+	void RunFrames(size_t iterationCount, AllocateFunction allocate) {
+		Inputs& in = GetInputs();
+		for (size_t n = 0; n < iterationCount; ++n) {
+			in.gpu.AdvanceFrame(kFrameLatency);
+			in.ring.BeginFrame(in.gpu.GetCompletedValue());
+			allocate(in.ring);
+			in.ring.EndFrame(in.gpu.Signal());
+			Benchmark::ClobberMemory();
+		}
+	}
+
+}
+
+BENCHMARK("TransientDescriptorRing/Frame x4096/Allocate", [](size_t iterationCount) {
+	RunFrames(iterationCount, [](TransientDescriptorRing& ring) {
+		for (size_t i = 0; i < kAllocationCount; ++i) { Benchmark::DoNotOptimize(ring.Allocate(1)); }
+	});
+});
+BENCHMARK("TransientDescriptorRing/Frame x4096/ThreadBlock", [](size_t iterationCount) {
+	RunFrames(iterationCount, [](TransientDescriptorRing& ring) {
+		TransientDescriptorRing::ThreadBlock block;
+		for (size_t i = 0; i < kAllocationCount; ++i) { Benchmark::DoNotOptimize(block.Allocate(ring, 1)); }
+	});
+});
+// 4スレッドでkAllocationCount個を分けて確保する
+BENCHMARK("TransientDescriptorRing/Frame x4096 4 threads/Allocate", [](size_t iterationCount) {
+	RunFrames(iterationCount, [](TransientDescriptorRing& ring) {
+		std::thread threads[4];
+		for (auto& thread : threads) {
+			thread = std::thread([&ring] {
+				for (size_t i = 0; i < kAllocationCount / 4; ++i) { Benchmark::DoNotOptimize(ring.Allocate(1)); }
+			});
+		}
+		for (auto& thread : threads) { thread.join(); }
+	});
+});
+BENCHMARK("TransientDescriptorRing/Frame x4096 4 threads/ThreadBlock", [](size_t iterationCount) {
+	RunFrames(iterationCount, [](TransientDescriptorRing& ring) {
+		std::thread threads[4];
+		for (auto& thread : threads) {
+			thread = std::thread([&ring] {
+				TransientDescriptorRing::ThreadBlock block;
+				for (size_t i = 0; i < kAllocationCount / 4; ++i) { Benchmark::DoNotOptimize(block.Allocate(ring, 1)); }
+			});
+		}
+		for (auto& thread : threads) { thread.join(); }
+	});
+});
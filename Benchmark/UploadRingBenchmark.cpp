@@ -0,0 +1,133 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "UploadRing.h"
+#include "ManualGPUQueue.h"
+
+// Engine::UploadRing を計測する
+// 最初に数フレーム遅れて完了するGPUをフェンス値で模擬し、アライメントと処理中のフレームの領域を上書きしないことを確認して標準エラーに出す
+
+namespace {
+
+	using Engine::UploadRing;
+
+	// 処理中のフレーム数（DirectXDevice::kSwapChainBufferCountと同じ）
+	constexpr uint32_t kFrameLatency = 2;
+	// 1フレームで確保する定数バッファの数
+	constexpr size_t kAllocationCount = 4096;
+	// 確認で使うバイト単位の粒度（最小のアライメント）
+	constexpr uint64_t kGranularity = 16;
+
+	// 切り出した領域が揃っていて、GPUがまだ読んでいるフレームの領域と重ならないか
+	void VerifyFrames() {
+		constexpr uint64_t kCapacity = 64 * 1024;
+		UploadRing ring;
+		ring.Initalize(kCapacity);
+		Benchmark::ManualGPUQueue gpu;
+		// kGranularityバイトごとに最後に使ったフレームのフェンス値（0は未使用）
+		std::vector<uint64_t> lastFence(kCapacity / kGranularity, 0);
+		std::mt19937 engine(35);
+		size_t hazards = 0, misaligned = 0, outOfRange = 0, failures = 0, allocated = 0;
+
+		for (uint64_t frame = 1; frame <= 5000; ++frame) {
+			// 途中でGPUが止まった場合は確保に失敗するだけで上書きしない
+			bool stall = frame % 500 > 480;
+			if (!stall) { gpu.AdvanceFrame(kFrameLatency); }
+			uint64_t completed = gpu.GetCompletedValue();
+			ring.BeginFrame(completed);
+			uint64_t fenceValue = frame;
+			size_t requests = engine() % 80;
+			for (size_t n = 0; n < requests; ++n) {
+				// 定数バッファ（256）と構造化バッファ（16）を混ぜる
+				uint64_t alignment = (engine() % 3) == 0 ? kGranularity : UploadRing::kDefaultAlignment;
+				uint64_t size = kGranularity * (1 + engine() % 64);
+				uint64_t offset = ring.Allocate(size, alignment);
+				if (offset == UploadRing::kInvalidOffset) {
+					++failures;
+					continue;
+				}
+				if (offset % alignment != 0) { ++misaligned; }
+				if (offset + size > kCapacity) {
+					++outOfRange;
+					continue;
+				}
+				for (uint64_t k = offset / kGranularity; k < (offset + size) / kGranularity; ++k) {
+					// 同じフレームで二重に渡した、またはGPUがまだ完了していないフレームの領域
+					if (lastFence[k] == fenceValue || lastFence[k] > completed) { ++hazards; }
+					lastFence[k] = fenceValue;
+				}
+				++allocated;
+			}
+			ring.EndFrame(gpu.Signal());
+		}
+
+		char detail[192];
+		std::snprintf(detail, sizeof(detail), "%zu allocations, %zu full during stalls, %zu hazards, %zu misaligned, %zu out of range", allocated, failures, hazards, misaligned, outOfRange);
+		Benchmark::Check("UploadRing", hazards == 0 && misaligned == 0 && outOfRange == 0 && failures > 0, detail);
+	}
+
+	// 複数のスレッドが同じフレームで切り出しても重ならないか
+	void VerifyThreads() {
+		constexpr uint64_t kCapacity = 4 * 1024 * 1024;
+		UploadRing ring;
+		ring.Initalize(kCapacity);
+		std::vector<std::atomic<int>> owners(kCapacity / UploadRing::kDefaultAlignment);
+		std::atomic<size_t> overlaps{ 0 };
+		std::vector<std::thread> threads;
+		ring.BeginFrame(0);
+		for (size_t t = 0; t < 4; ++t) {
+			threads.emplace_back([&, t] {
+				for (size_t n = 0; n < 3000; ++n) {
+					uint64_t size = UploadRing::kDefaultAlignment * (1 + (n + t) % 3);
+					uint64_t offset = ring.Allocate(size);
+					if (offset == UploadRing::kInvalidOffset) { continue; }
+					for (uint64_t k = offset / UploadRing::kDefaultAlignment; k < (offset + size) / UploadRing::kDefaultAlignment; ++k) {
+						if (owners[k].fetch_add(1, std::memory_order_relaxed) != 0) { overlaps.fetch_add(1); }
+					}
+				}
+			});
+		}
+		for (auto& thread : threads) { thread.join(); }
+		ring.EndFrame(1);
+
+		char detail[128];
+		std::snprintf(detail, sizeof(detail), "4 threads, %llu bytes used, %zu overlaps", static_cast<unsigned long long>(ring.GetUsedSize()), overlaps.load());
+		Benchmark::Check("UploadRing", overlaps == 0, detail);
+	}
+
+	struct Inputs {
+		UploadRing ring;
+		Benchmark::ManualGPUQueue gpu;
+	};
+
+	Inputs& GetInputs() {
+		static Inputs inputs;
+		static const bool initialized = [] {
+			VerifyFrames();
+			VerifyThreads();
+			inputs.ring.Initalize(kAllocationCount * UploadRing::kDefaultAlignment * (kFrameLatency + 1));
+			return true;
+		}();
+		Benchmark::DoNotOptimize(initialized);
+		return inputs;
+	}
+
+}
+
+// 1フレーム分（定数バッファkAllocationCount個）を切り出す
+BENCHMARK("UploadRing/Frame x4096/Allocate", [](size_t iterationCount) {
+	Inputs& in = GetInputs();
+	for (size_t n = 0; n < iterationCount; ++n) {
+		in.gpu.AdvanceFrame(kFrameLatency);
+		in.ring.BeginFrame(in.gpu.GetCompletedValue());
+		for (size_t i = 0; i < kAllocationCount; ++i) { Benchmark::DoNotOptimize(in.ring.Allocate(sizeof(float) * 16)); }
+		in.ring.EndFrame(in.gpu.Signal());
+		Benchmark::ClobberMemory();
+	}
+});
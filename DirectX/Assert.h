@@ -4,6 +4,9 @@
 
 #ifdef NDEBUG 
 #define ASSERT_MSG(expression, message) (static_cast<void>(0))
+#elif !defined(_MSC_VER)
+// _wassertが無い環境では通常のassertにメッセージを含める
+#define ASSERT_MSG(expression, message) assert((expression) && (message))
 #else
 static const std::wstring _assertMessagePrefix(L"\nMessage:");
 // メッセージを表示できるassert
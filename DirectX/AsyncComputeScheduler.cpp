@@ -0,0 +1,92 @@
+#include "AsyncComputeScheduler.h"
+
+#include "Assert.h"
+
+namespace Engine {
+
+	bool AsyncComputeScheduler::Initalize(GPUQueue* graphicsQueue, GPUQueue* computeQueue, uint32_t bufferCount) {
+		if (!graphicsQueue || !computeQueue || bufferCount < 2 || bufferCount > kMaxBufferCount) {
+			ASSERT_MSG(false, "Buffer count must be between 2 and kMaxBufferCount");
+			return false;
+		}
+		graphicsQueue_ = graphicsQueue;
+		computeQueue_ = computeQueue;
+		bufferCount_ = bufferCount;
+		for (uint32_t i = 0; i < kMaxBufferCount; ++i) {
+			simulatedValues_[i] = 0;
+			renderedValues_[i] = 0;
+		}
+		computeWaitedValue_ = 0;
+		graphicsWaitedValue_ = 0;
+		isSimulating_ = false;
+		isRendering_ = false;
+		statistics_ = {};
+		return true;
+	}
+
+	uint32_t AsyncComputeScheduler::BeginSimulation() {
+		ASSERT_MSG(!isSimulating_, "BeginSimulation called twice without EndSimulation");
+		// 書くバッファは、前に書いた内容を描画に積んでからでないと使えない
+		ASSERT_MSG(statistics_.simulationCount - statistics_.renderCount < bufferCount_, "Simulation is too far ahead of rendering");
+		uint32_t index = static_cast<uint32_t>(statistics_.simulationCount % bufferCount_);
+		// 前に読んだ描画が終わるまで書かない
+		Wait(computeQueue_, graphicsQueue_, renderedValues_[index], computeWaitedValue_, statistics_.computeWaitCount);
+		isSimulating_ = true;
+		return index;
+	}
+
+	uint64_t AsyncComputeScheduler::EndSimulation() {
+		ASSERT_MSG(isSimulating_, "EndSimulation called without BeginSimulation");
+		uint32_t index = static_cast<uint32_t>(statistics_.simulationCount % bufferCount_);
+		uint64_t fenceValue = computeQueue_->Signal();
+		simulatedValues_[index] = fenceValue;
+		++statistics_.simulationCount;
+		isSimulating_ = false;
+		return fenceValue;
+	}
+
+	uint32_t AsyncComputeScheduler::BeginRender() {
+		ASSERT_MSG(!isRendering_, "BeginRender called twice without EndRender");
+		ASSERT_MSG(statistics_.renderCount < statistics_.simulationCount, "No simulated buffer to render");
+		uint32_t index = static_cast<uint32_t>(statistics_.renderCount % bufferCount_);
+		// 更新が終わるまで読まない
+		Wait(graphicsQueue_, computeQueue_, simulatedValues_[index], graphicsWaitedValue_, statistics_.graphicsWaitCount);
+		isRendering_ = true;
+		return index;
+	}
+
+	uint64_t AsyncComputeScheduler::EndRender() {
+		ASSERT_MSG(isRendering_, "EndRender called without BeginRender");
+		uint32_t index = static_cast<uint32_t>(statistics_.renderCount % bufferCount_);
+		uint64_t fenceValue = graphicsQueue_->Signal();
+		renderedValues_[index] = fenceValue;
+		++statistics_.renderCount;
+		isRendering_ = false;
+		return fenceValue;
+	}
+
+	void AsyncComputeScheduler::WaitForIdle() {
+		if (!graphicsQueue_) { return; }
+		computeQueue_->WaitForIdle();
+		if (IsAsync()) { graphicsQueue_->WaitForIdle(); }
+	}
+
+	uint32_t AsyncComputeScheduler::GetSimulationSourceIndex() const {
+		if (statistics_.simulationCount == 0) { return 0; }
+		return static_cast<uint32_t>((statistics_.simulationCount - 1) % bufferCount_);
+	}
+
+	bool AsyncComputeScheduler::Wait(GPUQueue* queue, GPUQueue* waitQueue, uint64_t value, uint64_t& waitedValue, uint64_t& waitCount) {
+		// 同じキューなら積んだ順に実行される
+		if (queue == waitQueue || value == 0) { return true; }
+		if (value <= waitedValue || waitQueue->IsCompleted(value)) {
+			++statistics_.skippedWaitCount;
+			return true;
+		}
+		if (!queue->WaitOnQueue(*waitQueue, value)) { return false; }
+		waitedValue = value;
+		++waitCount;
+		return true;
+	}
+
+}
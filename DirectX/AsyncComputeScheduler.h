@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+
+#include "GPUQueue.h"
+
+namespace Engine {
+
+	// パーティクルの更新をコンピュートキューで、描画をグラフィックスキューで並行して行うための順序の管理
+	// パーティクルのバッファをbufferCount個持ち、フレームN+1の更新が別のバッファに書いている間にフレームNを描画する
+	// ・描画は、読むバッファを更新したコンピュートのシグナルをGPU上で待つ
+	// ・更新は、書くバッファを前に読んだ描画のシグナルをGPU上で待つ
+	// 待つ値がもう終わっている場合と、同じ相手のより大きい値を既に待たせている場合は待たせない
+	// 二つのキューが同じなら積んだ順に実行されるので、待たずに同じ順で使える（非同期コンピュートの無い環境）
+	// 呼び出しは BeginSimulation → 更新を積む → EndSimulation → BeginRender → 描画を積む → EndRender の順で、
+	// 最初のフレームの前に一度だけ更新を積んでおく
+	// 待ちとシグナルはBegin/Endを呼んだ時点でキューに積まれるので、「積む」はExecuteCommandListsまで済ませること
+	// DirectXDeviceのフレームのリストはFinishScreenRenderingでまとめて積まれるため、そこに記録した描画はEndRenderの
+	// シグナルより後になる（描画中のバッファに次の更新が書く）。描画はCommandListAllocatorなどの別のリストで積む
+	class AsyncComputeScheduler {
+	public:
+		static constexpr uint32_t kMaxBufferCount = 4;
+
+		struct Statistics {
+			uint64_t simulationCount;
+			uint64_t renderCount;
+			// 積んだGPU上の待ち
+			uint64_t computeWaitCount;
+			uint64_t graphicsWaitCount;
+			// 終わっていた、または既に待たせていたので省いた待ち
+			uint64_t skippedWaitCount;
+		};
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="graphicsQueue">描画を積むキュー</param>
+		/// <param name="computeQueue">更新を積むキュー（graphicsQueueと同じでもよい）</param>
+		/// <param name="bufferCount">パーティクルのバッファの数（2以上）</param>
+		/// <returns></returns>
+		bool Initalize(GPUQueue* graphicsQueue, GPUQueue* computeQueue, uint32_t bufferCount = 2);
+
+		/// <summary>
+		/// 更新の開始（書くバッファを前に読んだ描画をコンピュートキューに待たせる）
+		/// </summary>
+		/// <returns>書くバッファの番号（読むのはGetSimulationSourceIndex）</returns>
+		uint32_t BeginSimulation();
+		/// <summary>
+		/// 更新の終了（更新を積んだ後に呼ぶ）
+		/// </summary>
+		/// <returns>コンピュートキューのフェンス値</returns>
+		uint64_t EndSimulation();
+		/// <summary>
+		/// 描画の開始（読むバッファの更新をグラフィックスキューに待たせる）
+		/// </summary>
+		/// <returns>読むバッファの番号</returns>
+		uint32_t BeginRender();
+		/// <summary>
+		/// 描画の終了（描画を積んだ後に呼ぶ）
+		/// </summary>
+		/// <returns>グラフィックスキューのフェンス値</returns>
+		uint64_t EndRender();
+		/// <summary>
+		/// 両方のキューが終わるまで待つ
+		/// </summary>
+		void WaitForIdle();
+
+		// 更新が前の状態として読むバッファ（最後に更新したもの、まだ無ければ書くバッファと同じ）
+		uint32_t GetSimulationSourceIndex() const;
+		bool IsAsync() const { return graphicsQueue_ != computeQueue_; }
+		uint32_t GetBufferCount() const { return bufferCount_; }
+		const Statistics& GetStatistics() const { return statistics_; }
+
+	private:
+		// 待つ値が終わっていなければ、queueをwaitQueueに待たせる
+		bool Wait(GPUQueue* queue, GPUQueue* waitQueue, uint64_t value, uint64_t& waitedValue, uint64_t& waitCount);
+
+		GPUQueue* graphicsQueue_{ nullptr };
+		GPUQueue* computeQueue_{ nullptr };
+		uint32_t bufferCount_{ 0 };
+		// バッファごとの、書いた更新と読んだ描画のフェンス値
+		uint64_t simulatedValues_[kMaxBufferCount]{};
+		uint64_t renderedValues_[kMaxBufferCount]{};
+		// 相手のキューのどの値まで待たせたか
+		uint64_t computeWaitedValue_{ 0 };
+		uint64_t graphicsWaitedValue_{ 0 };
+		bool isSimulating_{ false };
+		bool isRendering_{ false };
+		Statistics statistics_{};
+	};
+
+}
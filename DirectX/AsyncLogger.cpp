@@ -0,0 +1,214 @@
+#include "AsyncLogger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "Assert.h"
+
+namespace Engine {
+
+	namespace {
+		// これを超えたら途中でも書き出し先に渡す
+		constexpr size_t kBatchSize = 64 * 1024;
+
+		const char* const kSeverityLabels[] = {
+			"Trace     : ",
+			"Info      : ",
+			"Warning   : ",
+			"Error     : ",
+		};
+		static_assert(std::size(kSeverityLabels) == static_cast<size_t>(LogSeverity::Count));
+	}
+
+	FileLogSink::~FileLogSink() {
+		Close();
+	}
+
+	bool FileLogSink::Open(const char* path) {
+		Close();
+#ifdef _MSC_VER
+		if (fopen_s(&file_, path, "wb") != 0) { file_ = nullptr; }
+#else
+		file_ = std::fopen(path, "wb");
+#endif // _MSC_VER
+		return file_ != nullptr;
+	}
+
+	void FileLogSink::Close() {
+		if (file_) {
+			std::fclose(file_);
+			file_ = nullptr;
+		}
+	}
+
+	void FileLogSink::Write(const char* data, size_t size) {
+		if (file_) {
+			std::fwrite(data, 1, size, file_);
+		}
+	}
+
+	void FileLogSink::Flush() {
+		if (file_) {
+			std::fflush(file_);
+		}
+	}
+
+	AsyncLogger::~AsyncLogger() {
+		Finalize();
+	}
+
+	bool AsyncLogger::Initalize(LogSink* sink, uint32_t capacity, std::chrono::milliseconds flushInterval) {
+		if (!sink || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+			ASSERT_MSG(false, "Capacity must be a power of two");
+			return false;
+		}
+		Finalize();
+
+		records_ = std::make_unique<Record[]>(capacity);
+		for (uint32_t i = 0; i < capacity; ++i) {
+			records_[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		mask_ = capacity - 1;
+		enqueuePosition_.store(0, std::memory_order_relaxed);
+		droppedCount_.store(0, std::memory_order_relaxed);
+		writtenCount_.store(0, std::memory_order_relaxed);
+		dequeuePosition_ = 0;
+		reportedDroppedCount_ = 0;
+		flushedPosition_ = 0;
+		flushRequested_ = false;
+		stopRequested_ = false;
+		batch_.clear();
+		batch_.reserve(kBatchSize + kMaxMessageLength + 64);
+		sink_ = sink;
+		flushInterval_ = flushInterval;
+		startTime_ = std::chrono::steady_clock::now();
+		thread_ = std::thread(&AsyncLogger::WriterThread, this);
+		return true;
+	}
+
+	void AsyncLogger::Finalize() {
+		if (!thread_.joinable()) { return; }
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopRequested_ = true;
+		}
+		wakeCondition_.notify_one();
+		thread_.join();
+		// 止める直前に積まれた分
+		Drain();
+		sink_ = nullptr;
+	}
+
+	bool AsyncLogger::Log(LogSeverity severity, std::string_view message) {
+		if (!IsEnabled(severity) || !records_) { return false; }
+
+		uint64_t position = enqueuePosition_.load(std::memory_order_relaxed);
+		Record* record = nullptr;
+		for (;;) {
+			record = &records_[position & mask_];
+			uint64_t sequence = record->sequence.load(std::memory_order_acquire);
+			int64_t difference = static_cast<int64_t>(sequence - position);
+			if (difference == 0) {
+				if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) { break; }
+			}
+			else if (difference < 0) {
+				// 一周前のレコードがまだ書き出されていない
+				droppedCount_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else {
+				position = enqueuePosition_.load(std::memory_order_relaxed);
+			}
+		}
+
+		record->timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime_).count());
+		record->threadId = GetThreadId();
+		record->severity = severity;
+		size_t length = std::min(message.size(), kMaxMessageLength);
+		// UTF-8の文字の途中で切らない
+		if (length < message.size()) {
+			while (length > 0 && (static_cast<unsigned char>(message[length]) & 0xC0) == 0x80) { --length; }
+		}
+		record->length = static_cast<uint16_t>(length);
+		std::memcpy(record->text, message.data(), length);
+		record->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	void AsyncLogger::Flush() {
+		if (!thread_.joinable()) { return; }
+		uint64_t target = enqueuePosition_.load(std::memory_order_acquire);
+		std::unique_lock<std::mutex> lock(mutex_);
+		flushRequested_ = true;
+		wakeCondition_.notify_one();
+		flushedCondition_.wait(lock, [&] { return flushedPosition_ >= target || stopRequested_; });
+	}
+
+	uint32_t AsyncLogger::GetThreadId() {
+		static std::atomic<uint32_t> counter{ 0 };
+		thread_local uint32_t threadId = ++counter;
+		return threadId;
+	}
+
+	void AsyncLogger::WriterThread() {
+		std::unique_lock<std::mutex> lock(mutex_);
+		for (;;) {
+			wakeCondition_.wait_for(lock, flushInterval_, [&] { return flushRequested_ || stopRequested_; });
+			bool stop = stopRequested_;
+			flushRequested_ = false;
+			lock.unlock();
+			Drain();
+			lock.lock();
+			flushedPosition_ = dequeuePosition_;
+			flushedCondition_.notify_all();
+			if (stop) { break; }
+		}
+	}
+
+	void AsyncLogger::Drain() {
+		uint64_t count = 0;
+		for (;;) {
+			Record& record = records_[dequeuePosition_ & mask_];
+			// 書き込み途中のレコードがあればそこで止めて、次に起きたときに続きを読む
+			if (record.sequence.load(std::memory_order_acquire) != dequeuePosition_ + 1) { break; }
+			AppendRecord(record);
+			record.sequence.store(dequeuePosition_ + mask_ + 1, std::memory_order_release);
+			++dequeuePosition_;
+			++count;
+			if (batch_.size() >= kBatchSize) { WriteBatch(); }
+		}
+
+		uint64_t droppedCount = droppedCount_.load(std::memory_order_relaxed);
+		if (droppedCount != reportedDroppedCount_) {
+			char line[96];
+			int length = std::snprintf(line, sizeof(line), "%s%llu log records dropped (ring full)\n",
+				kSeverityLabels[static_cast<size_t>(LogSeverity::Warning)], static_cast<unsigned long long>(droppedCount - reportedDroppedCount_));
+			batch_.append(line, static_cast<size_t>(length));
+			reportedDroppedCount_ = droppedCount;
+		}
+		if (!batch_.empty()) {
+			WriteBatch();
+			sink_->Flush();
+		}
+		writtenCount_.fetch_add(count, std::memory_order_relaxed);
+	}
+
+	void AsyncLogger::AppendRecord(const Record& record) {
+		// 経過秒 [スレッド番号] 重要度 : 本文
+		char header[48];
+		uint64_t microseconds = record.timestamp / 1000;
+		int length = std::snprintf(header, sizeof(header), "%6llu.%06llu [%2u] ",
+			static_cast<unsigned long long>(microseconds / 1000000), static_cast<unsigned long long>(microseconds % 1000000), record.threadId);
+		batch_.append(header, static_cast<size_t>(length));
+		batch_.append(kSeverityLabels[static_cast<size_t>(record.severity)]);
+		batch_.append(record.text, record.length);
+		batch_.push_back('\n');
+	}
+
+	void AsyncLogger::WriteBatch() {
+		sink_->Write(batch_.data(), batch_.size());
+		batch_.clear();
+	}
+
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// この重要度より低いログはコンパイル時に消える（ENGINE_LOGを通した場合）
+// 0:Trace 1:Info 2:Warning 3:Error 4:すべて消す
+#ifndef LOG_COMPILE_SEVERITY
+#ifdef _DEBUG
+#define LOG_COMPILE_SEVERITY 0
+#else
+#define LOG_COMPILE_SEVERITY 1
+#endif // _DEBUG
+#endif // LOG_COMPILE_SEVERITY
+
+// 重要度がコンパイル時と実行時の両方の設定を満たす場合だけ、messageを評価してloggerに積む
+#define ENGINE_LOG(logger, severity, message) \
+	do { \
+		if constexpr (static_cast<int>(severity) >= LOG_COMPILE_SEVERITY) { \
+			if ((logger).IsEnabled(severity)) { (logger).Log((severity), (message)); } \
+		} \
+	} while (0)
+
+namespace Engine {
+
+	enum class LogSeverity : uint8_t {
+		Trace,
+		Info,
+		Warning,
+		Error,
+		Count
+	};
+
+	// ログの書き出し先（書き出しスレッドからだけ呼ばれる）
+	class LogSink {
+	public:
+		virtual ~LogSink() = default;
+		virtual void Write(const char* data, size_t size) = 0;
+		virtual void Flush() = 0;
+	};
+
+	// ファイルに書き出す
+	class FileLogSink :
+		public LogSink {
+	public:
+		FileLogSink() = default;
+		~FileLogSink();
+		FileLogSink(const FileLogSink&) = delete;
+		FileLogSink& operator=(const FileLogSink&) = delete;
+
+		bool Open(const char* path);
+		void Close();
+		void Write(const char* data, size_t size) override;
+		void Flush() override;
+
+		bool IsOpen() const { return file_ != nullptr; }
+
+	private:
+		std::FILE* file_{ nullptr };
+	};
+
+	// 呼び出したスレッドでは書式済みの文字列を固定長のレコードに詰めて積むだけで、ファイルへの書き出しは専用のスレッドがまとめて行う
+	// 積む側は複数のスレッドから呼べる（ロックを取らないMPSCのリングバッファ）
+	// リングが一杯の場合は待たずに捨てて数を数え、後で書き出しスレッドが件数を出す
+	class AsyncLogger {
+	public:
+		// 一つのレコードに入る文字数（超えた分は切り捨てる）
+		static constexpr size_t kMaxMessageLength = 224;
+		static constexpr uint32_t kDefaultCapacity = 4096;
+		// 書き出しスレッドが起きる間隔
+		static constexpr std::chrono::milliseconds kDefaultFlushInterval{ 5 };
+
+		AsyncLogger() = default;
+		~AsyncLogger();
+		AsyncLogger(const AsyncLogger&) = delete;
+		AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+		/// <summary>
+		/// 初期化して書き出しスレッドを始める
+		/// </summary>
+		/// <param name="sink">書き出し先（このクラスより長く生きること）</param>
+		/// <param name="capacity">レコードの数（2のべき乗）</param>
+		/// <param name="flushInterval">書き出しスレッドが起きる間隔</param>
+		/// <returns></returns>
+		bool Initalize(LogSink* sink, uint32_t capacity = kDefaultCapacity, std::chrono::milliseconds flushInterval = kDefaultFlushInterval);
+		/// <summary>
+		/// 残りを書き出してスレッドを止める
+		/// </summary>
+		void Finalize();
+
+		/// <summary>
+		/// ログを積む（書き出しは待たない）
+		/// </summary>
+		/// <param name="severity"></param>
+		/// <param name="message">書式済みの文字列</param>
+		/// <returns>リングが一杯で捨てた場合、または重要度が低い場合はfalse</returns>
+		bool Log(LogSeverity severity, std::string_view message);
+		/// <summary>
+		/// ここまでに積んだログが書き出し先に届くまで待つ
+		/// </summary>
+		void Flush();
+
+		// 実行時の重要度の下限
+		void SetMinSeverity(LogSeverity severity) { minSeverity_.store(severity, std::memory_order_relaxed); }
+		LogSeverity GetMinSeverity() const { return minSeverity_.load(std::memory_order_relaxed); }
+		bool IsEnabled(LogSeverity severity) const { return severity >= minSeverity_.load(std::memory_order_relaxed); }
+
+		// リングが一杯で捨てた数
+		uint64_t GetDroppedCount() const { return droppedCount_.load(std::memory_order_relaxed); }
+		// 書き出した数
+		uint64_t GetWrittenCount() const { return writtenCount_.load(std::memory_order_relaxed); }
+
+	private:
+		struct alignas(64) Record {
+			// 書き込みが終わったら位置+1、読み終わったら位置+容量になる
+			std::atomic<uint64_t> sequence;
+			// Initalizeからの経過時間
+			uint64_t timestamp;
+			uint32_t threadId;
+			uint16_t length;
+			LogSeverity severity;
+			char text[kMaxMessageLength];
+		};
+
+		// スレッドごとの短い番号
+		static uint32_t GetThreadId();
+
+		void WriterThread();
+		// 読めるレコードをすべて書き出す
+		void Drain();
+		void AppendRecord(const Record& record);
+		void WriteBatch();
+
+		std::unique_ptr<Record[]> records_;
+		uint64_t mask_{ 0 };
+		alignas(64) std::atomic<uint64_t> enqueuePosition_{ 0 };
+		alignas(64) std::atomic<uint64_t> droppedCount_{ 0 };
+		std::atomic<LogSeverity> minSeverity_{ LogSeverity::Trace };
+		std::chrono::steady_clock::time_point startTime_{};
+
+		// 以下は書き出しスレッドが使う
+		alignas(64) uint64_t dequeuePosition_{ 0 };
+		uint64_t reportedDroppedCount_{ 0 };
+		std::string batch_;
+		LogSink* sink_{ nullptr };
+		std::atomic<uint64_t> writtenCount_{ 0 };
+
+		std::thread thread_;
+		std::mutex mutex_;
+		std::condition_variable wakeCondition_;
+		std::condition_variable flushedCondition_;
+		std::chrono::milliseconds flushInterval_{ kDefaultFlushInterval };
+		// 書き出し先に届けた位置
+		uint64_t flushedPosition_{ 0 };
+		bool flushRequested_{ false };
+		bool stopRequested_{ false };
+	};
+
+}
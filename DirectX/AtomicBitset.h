@@ -0,0 +1,168 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include "Assert.h"
+
+
+namespace Engine {
+
+	// 複数のスレッドから同時に確保、解放できるビットセット
+	// 1が使用中のスロットで、空きを探して立てるところまでをワード単位のCASで行う（ロックしない）
+	// スレッドごとに探し始めるワードを覚えておき、同じワードの取り合いを減らす
+	template<size_t kBitCount>
+	class AtomicBitset {
+		static_assert(kBitCount > 0, "A bitset with 0 bits is not possible.");
+	public:
+		// 空きが無かった場合の戻り値
+		static constexpr size_t kNotFound = kBitCount;
+
+		AtomicBitset() {
+			Reset();
+		}
+		AtomicBitset(const AtomicBitset&) = delete;
+		AtomicBitset& operator=(const AtomicBitset&) = delete;
+
+		/// <summary>
+		/// 空いているビットを探して立てる
+		/// 前回確保できたワードから探し始める
+		/// </summary>
+		/// <returns>確保したビット、空きが無い場合はkNotFound</returns>
+		size_t TryAcquire() {
+			size_t& hint = GetThreadHint();
+			size_t bitIndex = TryAcquireFrom(hint);
+			if (bitIndex != kNotFound) {
+				hint = bitIndex;
+			}
+			return bitIndex;
+		}
+		/// <summary>
+		/// 指定したビットから後ろに向かって空きを探して立てる（末尾の次は先頭に戻る）
+		/// </summary>
+		/// <param name="hintBitIndex">探し始めるビット</param>
+		/// <returns>確保したビット、空きが無い場合はkNotFound</returns>
+		size_t TryAcquireFrom(size_t hintBitIndex) {
+			size_t startWord = (hintBitIndex < kBitCount ? hintBitIndex : 0) >> kBitIndexToWordIndex;
+			for (size_t n = 0; n < kWordCount; ++n) {
+				size_t wordIndex = startWord + n;
+				if (wordIndex >= kWordCount) { wordIndex -= kWordCount; }
+				size_t bitIndex = TryAcquireInWord(wordIndex);
+				if (bitIndex != kNotFound) { return bitIndex; }
+			}
+			return kNotFound;
+		}
+		/// <summary>
+		/// 指定したビットを立てる
+		/// </summary>
+		/// <param name="bitIndex"></param>
+		/// <returns>既に立っていた場合はfalse</returns>
+		bool TryAcquireAt(size_t bitIndex) {
+			ASSERT_MSG(bitIndex < kBitCount, "Out of range");
+			uint64_t bit = static_cast<uint64_t>(1) << (bitIndex & kWordMask);
+			return (GetWord(bitIndex).fetch_or(bit, std::memory_order_acq_rel) & bit) == 0;
+		}
+		/// <summary>
+		/// 確保したビットを戻す
+		/// </summary>
+		/// <param name="bitIndex"></param>
+		void Release(size_t bitIndex) {
+			ASSERT_MSG(bitIndex < kBitCount, "Out of range");
+			uint64_t bit = static_cast<uint64_t>(1) << (bitIndex & kWordMask);
+			[[maybe_unused]] uint64_t previous = GetWord(bitIndex).fetch_and(~bit, std::memory_order_release);
+			ASSERT_MSG((previous & bit) != 0, "Released twice");
+		}
+		/// <summary>
+		/// 指定したビットを判別
+		/// </summary>
+		/// <param name="bitIndex"></param>
+		/// <returns></returns>
+		bool Test(size_t bitIndex) const {
+			ASSERT_MSG(bitIndex < kBitCount, "Out of range");
+			return (GetWord(bitIndex).load(std::memory_order_acquire) & (static_cast<uint64_t>(1) << (bitIndex & kWordMask))) != 0;
+		}
+		/// <summary>
+		/// 立っているビットの数
+		/// 他のスレッドが操作中の場合はその瞬間の近似値
+		/// </summary>
+		/// <returns></returns>
+		size_t Count() const {
+			size_t count = 0;
+			for (const auto& word : words_) {
+				count += static_cast<size_t>(std::popcount(word.load(std::memory_order_relaxed)));
+			}
+			return count;
+		}
+		/// <summary>
+		/// すべてのビットを0にする
+		/// 他のスレッドが使っていない時に呼ぶ
+		/// </summary>
+		void Reset() {
+			for (auto& word : words_) {
+				word.store(0, std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_release);
+		}
+		/// <summary>
+		/// ビット数
+		/// </summary>
+		/// <returns></returns>
+		size_t GetBitCount() const { return kBitCount; }
+
+	private:
+		static constexpr size_t kWordSize = CHAR_BIT * sizeof(uint64_t);
+		static constexpr size_t kWordCount = (kBitCount - 1) / kWordSize + 1;
+		static constexpr size_t kWordMask = kWordSize - 1;
+		static constexpr size_t kBitIndexToWordIndex = 6;
+		// 最後のワードで使うビット
+		static constexpr uint64_t kLastWordMask = (kBitCount & kWordMask) == 0 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << (kBitCount & kWordMask)) - 1;
+		// キャッシュラインに入るワード数（スレッドごとの開始位置をこの単位でずらす）
+		static constexpr size_t kWordsPerCacheLine = 64 / sizeof(uint64_t);
+
+		std::atomic<uint64_t>& GetWord(size_t bitIndex) {
+			return words_[bitIndex >> kBitIndexToWordIndex];
+		}
+		const std::atomic<uint64_t>& GetWord(size_t bitIndex) const {
+			return words_[bitIndex >> kBitIndexToWordIndex];
+		}
+		static uint64_t GetValidMask(size_t wordIndex) {
+			return wordIndex == kWordCount - 1 ? kLastWordMask : ~static_cast<uint64_t>(0);
+		}
+
+		// ワードの中で空いている一番下のビットを立てる
+		size_t TryAcquireInWord(size_t wordIndex) {
+			std::atomic<uint64_t>& word = words_[wordIndex];
+			uint64_t validMask = GetValidMask(wordIndex);
+			uint64_t value = word.load(std::memory_order_relaxed);
+			while ((value & validMask) != validMask) {
+				uint64_t freeBits = ~value & validMask;
+				uint64_t bit = freeBits & (~freeBits + 1);
+				// 失敗した場合はvalueが最新の値になるのでそのまま次の空きを探す
+				if (word.compare_exchange_weak(value, value | bit, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+					return wordIndex * kWordSize + static_cast<size_t>(std::countr_zero(bit));
+				}
+			}
+			return kNotFound;
+		}
+
+		// スレッドごとに探し始めるビット（同じビット数のAtomicBitsetで共有するがヒントなので問題ない）
+		// 最初はスレッドIDから決めて、スレッドごとに別のキャッシュラインから探す
+		static size_t& GetThreadHint() {
+			thread_local size_t hint = [] {
+				size_t lineCount = (kWordCount - 1) / kWordsPerCacheLine + 1;
+				// スレッドIDのハッシュは下位ビットが偏ることがあるので混ぜてから使う
+				uint64_t hash = static_cast<uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) * 0x9E3779B97F4A7C15ull;
+				size_t line = static_cast<size_t>(hash >> 32) % lineCount;
+				return line * kWordsPerCacheLine * kWordSize % kBitCount;
+			}();
+			return hint;
+		}
+
+		alignas(64) std::atomic<uint64_t> words_[kWordCount];
+	};
+
+
+}
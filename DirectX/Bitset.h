@@ -1,58 +1,138 @@
 #pragma once
 #include <bit>
+#include <climits>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <ostream>
 #include "Assert.h"
 
 
 namespace Engine {
 
+	// 2段の階層を持つビットセット
+	// 64ビットのワードごとに「1を含むか」「0を含むか」を要約ワードに持ち、検索は要約から該当するワードへ直接飛ぶ
+	// 要約ワード1つで4096ビット分を表すので、100万ビットでも要約を256ワード見れば済む
+	// kBitCountを超える余りのビットは常に0にしておく
 	template<size_t kBitCount>
 	class Bitset {
 		static_assert(kBitCount > 0, "A bitset with 0 bits is not possible.");
 	public:
+		// 検索で見つからなかった場合の戻り値
+		static constexpr size_t kNotFound = kBitCount;
+
+		/// <summary>
+		/// 1のビットの位置を小さい順に返すイテレーター
+		/// </summary>
+		class Iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = size_t;
+			using difference_type = ptrdiff_t;
+			using pointer = const size_t*;
+			using reference = size_t;
+
+			Iterator() = default;
+			Iterator(const Bitset* bitset, size_t bitIndex) : bitset_(bitset), bitIndex_(bitIndex) {}
+
+			size_t operator*() const { return bitIndex_; }
+			Iterator& operator++() {
+				bitIndex_ = bitset_->FindNext(bitIndex_, true);
+				return *this;
+			}
+			Iterator operator++(int) {
+				Iterator result = *this;
+				++*this;
+				return result;
+			}
+			bool operator==(const Iterator& other) const { return bitIndex_ == other.bitIndex_; }
+			bool operator!=(const Iterator& other) const { return bitIndex_ != other.bitIndex_; }
+
+		private:
+			const Bitset* bitset_{ nullptr };
+			size_t bitIndex_{ kNotFound };
+		};
+
 		Bitset() {
 			Reset();
 		}
 
 		friend std::ostream& operator<<(std::ostream& os, const Bitset& bitset) {
 			for (size_t i = kBitCount; i > 0; --i) {
-				os << bitset.Test(i - 1) ? '1' : '0';
+				os << (bitset.Test(i - 1) ? '1' : '0');
 			}
 			return os;
 		}
+
+		Iterator begin() const { return Iterator(this, FindFirst(true)); }
+		Iterator end() const { return Iterator(this, kNotFound); }
+
 		/// <summary>
 		/// 先頭から探す
 		/// </summary>
 		/// <param name="value">値</param>
-		/// <returns></returns>
-		size_t FindFirst(bool value = false) {
-			for (size_t i = 0; i < kWordCount; ++i) {
-				if (words_[i] != (value ? 0 : ~0)) {
-					size_t bitIndex = static_cast<size_t>(value ? std::countr_zero(words_[i]) : std::countr_one(words_[i]));
-					if (bitIndex < kWordSize) {
-						return i * kWordSize + bitIndex;
-					}
-				}
-			}
-			return kWordCount * kWordSize;
+		/// <returns>見つからない場合はkNotFound</returns>
+		size_t FindFirst(bool value = false) const {
+			size_t wordIndex = FindWord(GetSummary(value), 0);
+			if (wordIndex >= kWordCount) { return kNotFound; }
+			return wordIndex * kWordSize + static_cast<size_t>(std::countr_zero(LoadWord(wordIndex, value)));
 		}
 		/// <summary>
 		/// 指定したビットの後ろから探す
 		/// </summary>
-		/// <param name="index"></param>
-		/// <param name="value"></param>
-		/// <returns></returns>
-		size_t FindNext(size_t index, bool value = false) {
-
+		/// <param name="bitIndex">このビットは含まない</param>
+		/// <param name="value">値</param>
+		/// <returns>見つからない場合はkNotFound</returns>
+		size_t FindNext(size_t bitIndex, bool value = false) const {
+			size_t start = bitIndex + 1;
+			if (start >= kBitCount) { return kNotFound; }
+			size_t wordIndex = start >> kBitIndexToWordIndex;
+			uint64_t word = LoadWord(wordIndex, value) & (~static_cast<uint64_t>(0) << (start & kWordMask));
+			if (word != 0) {
+				return wordIndex * kWordSize + static_cast<size_t>(std::countr_zero(word));
+			}
+			wordIndex = FindWord(GetSummary(value), wordIndex + 1);
+			if (wordIndex >= kWordCount) { return kNotFound; }
+			return wordIndex * kWordSize + static_cast<size_t>(std::countr_zero(LoadWord(wordIndex, value)));
+		}
+		/// <summary>
+		/// 末尾から探す
+		/// </summary>
+		/// <param name="value">値</param>
+		/// <returns>見つからない場合はkNotFound</returns>
+		size_t FindLast(bool value = false) const {
+			size_t wordIndex = FindWordReverse(GetSummary(value), kWordCount - 1);
+			if (wordIndex >= kWordCount) { return kNotFound; }
+			return wordIndex * kWordSize + kWordMask - static_cast<size_t>(std::countl_zero(LoadWord(wordIndex, value)));
+		}
+		/// <summary>
+		/// 指定したビットの前から探す
+		/// </summary>
+		/// <param name="bitIndex">このビットは含まない</param>
+		/// <param name="value">値</param>
+		/// <returns>見つからない場合はkNotFound</returns>
+		size_t FindPrev(size_t bitIndex, bool value = false) const {
+			if (bitIndex == 0 || bitIndex > kBitCount) { return kNotFound; }
+			size_t start = bitIndex - 1;
+			size_t wordIndex = start >> kBitIndexToWordIndex;
+			uint64_t word = LoadWord(wordIndex, value) & (~static_cast<uint64_t>(0) >> (kWordMask - (start & kWordMask)));
+			if (word != 0) {
+				return wordIndex * kWordSize + kWordMask - static_cast<size_t>(std::countl_zero(word));
+			}
+			if (wordIndex == 0) { return kNotFound; }
+			wordIndex = FindWordReverse(GetSummary(value), wordIndex - 1);
+			if (wordIndex >= kWordCount) { return kNotFound; }
+			return wordIndex * kWordSize + kWordMask - static_cast<size_t>(std::countl_zero(LoadWord(wordIndex, value)));
 		}
 		/// <summary>
 		/// すべて反転
 		/// </summary>
 		/// <returns></returns>
 		inline Bitset& Flip() {
-			for (auto& word : words_) {
-				word = ~word;
+			for (size_t i = 0; i < kWordCount; ++i) {
+				words_[i] = ~words_[i] & GetValidMask(i);
 			}
+			RebuildSummary();
 			return *this;
 		}
 		/// <summary>
@@ -61,8 +141,10 @@ namespace Engine {
 		/// <param name="bitIndex"></param>
 		/// <returns></returns>
 		inline Bitset& Flip(size_t bitIndex) {
+			ASSERT_MSG(bitIndex < kBitCount, "Out of range");
 			auto& word = GetWord(bitIndex);
 			word = word ^ static_cast<uint64_t>(1) << (bitIndex & kWordMask);
+			UpdateSummary(bitIndex >> kBitIndexToWordIndex);
 			return *this;
 		}
 		/// <summary>
@@ -71,8 +153,7 @@ namespace Engine {
 		/// <param name="value"></param>
 		/// <returns></returns>
 		inline Bitset& Set(bool value = true) {
-			memset(words_, value ? ~0 : 0, sizeof(words_));
-			return *this;
+			return SetRange(0, kBitCount, value);
 		}
 		/// <summary>
 		/// 指定したビットを変更
@@ -89,6 +170,31 @@ namespace Engine {
 			else {
 				word &= ~(static_cast<uint64_t>(1) << (bitIndex & kWordMask));
 			}
+			UpdateSummary(bitIndex >> kBitIndexToWordIndex);
+			return *this;
+		}
+		/// <summary>
+		/// 連続したビットをまとめて変更
+		/// 途中のワードは丸ごと書き換えるので、1ビットずつSetするより速い
+		/// </summary>
+		/// <param name="bitIndex">先頭のビット</param>
+		/// <param name="count">ビット数</param>
+		/// <param name="value"></param>
+		/// <returns></returns>
+		inline Bitset& SetRange(size_t bitIndex, size_t count, bool value = true) {
+			ASSERT_MSG(bitIndex <= kBitCount && count <= kBitCount - bitIndex, "Out of range");
+			if (count == 0) { return *this; }
+			size_t endIndex = bitIndex + count;
+			FillBits(words_, bitIndex, endIndex, value);
+			// 途中のワードは全ビットが同じ値になっている
+			size_t firstWord = bitIndex >> kBitIndexToWordIndex;
+			size_t lastWord = (endIndex - 1) >> kBitIndexToWordIndex;
+			if (lastWord - firstWord > 1) {
+				FillBits(setSummary_, firstWord + 1, lastWord, value);
+				FillBits(clearSummary_, firstWord + 1, lastWord, !value);
+			}
+			UpdateSummary(firstWord);
+			UpdateSummary(lastWord);
 			return *this;
 		}
 		/// <summary>
@@ -109,6 +215,15 @@ namespace Engine {
 			return *this;
 		}
 		/// <summary>
+		/// 連続したビットをまとめて0にする
+		/// </summary>
+		/// <param name="bitIndex">先頭のビット</param>
+		/// <param name="count">ビット数</param>
+		/// <returns></returns>
+		inline Bitset& ResetRange(size_t bitIndex, size_t count) {
+			return SetRange(bitIndex, count, false);
+		}
+		/// <summary>
 		/// 指定したビットを判別
 		/// </summary>
 		/// <param name="bitIndex"></param>
@@ -117,11 +232,37 @@ namespace Engine {
 			ASSERT_MSG(bitIndex < kBitCount, "Out of range");
 			return (GetWord(bitIndex) & (static_cast<uint64_t>(1) << (bitIndex & kWordMask))) != 0;
 		}
+		/// <summary>
+		/// すべてのビットが指定した値か
+		/// </summary>
+		/// <param name="value"></param>
+		/// <returns></returns>
 		inline bool All(bool value = true) const {
-			for (auto& word : words_) {
-				if (word != (value ? ~0 : 0)) { return false; }
+			return !Any(!value);
+		}
+		/// <summary>
+		/// 指定した値のビットが一つでもあるか
+		/// </summary>
+		/// <param name="value"></param>
+		/// <returns></returns>
+		inline bool Any(bool value = true) const {
+			const uint64_t* summary = GetSummary(value);
+			for (size_t i = 0; i < kSummaryCount; ++i) {
+				if (summary[i] != 0) { return true; }
 			}
-			return true;
+			return false;
+		}
+		/// <summary>
+		/// 指定した値のビットの数
+		/// </summary>
+		/// <param name="value"></param>
+		/// <returns></returns>
+		inline size_t Count(bool value = true) const {
+			size_t count = 0;
+			for (const auto& word : words_) {
+				count += static_cast<size_t>(std::popcount(word));
+			}
+			return value ? count : kBitCount - count;
 		}
 		/// <summary>
 		/// ビット数
@@ -129,20 +270,133 @@ namespace Engine {
 		/// <returns></returns>
 		inline size_t GetBitCount() const { return kBitCount; }
 
+		inline Bitset& operator&=(const Bitset& other) {
+			for (size_t i = 0; i < kWordCount; ++i) {
+				words_[i] &= other.words_[i];
+			}
+			RebuildSummary();
+			return *this;
+		}
+		inline Bitset& operator|=(const Bitset& other) {
+			for (size_t i = 0; i < kWordCount; ++i) {
+				words_[i] |= other.words_[i];
+			}
+			RebuildSummary();
+			return *this;
+		}
+		inline Bitset& operator^=(const Bitset& other) {
+			for (size_t i = 0; i < kWordCount; ++i) {
+				words_[i] ^= other.words_[i];
+			}
+			RebuildSummary();
+			return *this;
+		}
+		friend inline Bitset operator&(const Bitset& lhs, const Bitset& rhs) { return Bitset(lhs) &= rhs; }
+		friend inline Bitset operator|(const Bitset& lhs, const Bitset& rhs) { return Bitset(lhs) |= rhs; }
+		friend inline Bitset operator^(const Bitset& lhs, const Bitset& rhs) { return Bitset(lhs) ^= rhs; }
+		friend inline Bitset operator~(const Bitset& bitset) { return Bitset(bitset).Flip(); }
+		friend inline bool operator==(const Bitset& lhs, const Bitset& rhs) {
+			for (size_t i = 0; i < kWordCount; ++i) {
+				if (lhs.words_[i] != rhs.words_[i]) { return false; }
+			}
+			return true;
+		}
+		friend inline bool operator!=(const Bitset& lhs, const Bitset& rhs) { return !(lhs == rhs); }
+
 	private:
+		static constexpr size_t kWordSize = CHAR_BIT * sizeof(uint64_t);
+		static constexpr size_t kWordCount = (kBitCount - 1) / kWordSize + 1;
+		static constexpr size_t kWordMask = kWordSize - 1;
+		static constexpr size_t kBitIndexToWordIndex = 6;
+		// 要約ワードの数（要約の1ビットがワード1つに対応する）
+		static constexpr size_t kSummaryCount = (kWordCount - 1) / kWordSize + 1;
+		// 最後のワードで使うビット
+		static constexpr uint64_t kLastWordMask = (kBitCount & kWordMask) == 0 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << (kBitCount & kWordMask)) - 1;
+
 		inline uint64_t& GetWord(size_t bitIndex) {
 			return words_[bitIndex >> kBitIndexToWordIndex];
 		}
 		inline const uint64_t& GetWord(size_t bitIndex) const {
 			return words_[bitIndex >> kBitIndexToWordIndex];
 		}
+		static inline uint64_t GetValidMask(size_t wordIndex) {
+			return wordIndex == kWordCount - 1 ? kLastWordMask : ~static_cast<uint64_t>(0);
+		}
+		// 探す値が1になるようにしたワード
+		inline uint64_t LoadWord(size_t wordIndex, bool value) const {
+			return value ? words_[wordIndex] : ~words_[wordIndex] & GetValidMask(wordIndex);
+		}
+		inline const uint64_t* GetSummary(bool value) const {
+			return value ? setSummary_ : clearSummary_;
+		}
 
-		static constexpr size_t kWordSize = CHAR_BIT * sizeof(uint64_t);
-		static constexpr size_t kWordCount = (kBitCount - 1) / kWordSize + 1;
-		static constexpr size_t kWordMask = kWordSize - 1;
-		static constexpr size_t kBitIndexToWordIndex = 6;
+		// wordIndex以降で要約のビットが立っている最初のワード（無ければkWordCount）
+		static inline size_t FindWord(const uint64_t* summary, size_t wordIndex) {
+			if (wordIndex >= kWordCount) { return kWordCount; }
+			size_t summaryIndex = wordIndex >> kBitIndexToWordIndex;
+			uint64_t bits = summary[summaryIndex] & (~static_cast<uint64_t>(0) << (wordIndex & kWordMask));
+			while (bits == 0) {
+				if (++summaryIndex >= kSummaryCount) { return kWordCount; }
+				bits = summary[summaryIndex];
+			}
+			return summaryIndex * kWordSize + static_cast<size_t>(std::countr_zero(bits));
+		}
+		// wordIndex以前で要約のビットが立っている最後のワード（無ければkWordCount）
+		static inline size_t FindWordReverse(const uint64_t* summary, size_t wordIndex) {
+			size_t summaryIndex = wordIndex >> kBitIndexToWordIndex;
+			uint64_t bits = summary[summaryIndex] & (~static_cast<uint64_t>(0) >> (kWordMask - (wordIndex & kWordMask)));
+			while (bits == 0) {
+				if (summaryIndex == 0) { return kWordCount; }
+				bits = summary[--summaryIndex];
+			}
+			return summaryIndex * kWordSize + kWordMask - static_cast<size_t>(std::countl_zero(bits));
+		}
+		// [beginIndex, endIndex)のビットを変更する
+		static inline void FillBits(uint64_t* words, size_t beginIndex, size_t endIndex, bool value) {
+			size_t first = beginIndex >> kBitIndexToWordIndex;
+			size_t last = (endIndex - 1) >> kBitIndexToWordIndex;
+			uint64_t firstMask = ~static_cast<uint64_t>(0) << (beginIndex & kWordMask);
+			uint64_t lastMask = ~static_cast<uint64_t>(0) >> (kWordMask - ((endIndex - 1) & kWordMask));
+			uint64_t fill = value ? ~static_cast<uint64_t>(0) : 0;
+			if (first == last) {
+				uint64_t mask = firstMask & lastMask;
+				words[first] = (words[first] & ~mask) | (fill & mask);
+				return;
+			}
+			words[first] = (words[first] & ~firstMask) | (fill & firstMask);
+			for (size_t i = first + 1; i < last; ++i) {
+				words[i] = fill;
+			}
+			words[last] = (words[last] & ~lastMask) | (fill & lastMask);
+		}
+		// ワードを書き換えた後に要約を合わせる
+		inline void UpdateSummary(size_t wordIndex) {
+			size_t summaryIndex = wordIndex >> kBitIndexToWordIndex;
+			uint64_t bit = static_cast<uint64_t>(1) << (wordIndex & kWordMask);
+			uint64_t word = words_[wordIndex];
+			setSummary_[summaryIndex] = word != 0 ? setSummary_[summaryIndex] | bit : setSummary_[summaryIndex] & ~bit;
+			clearSummary_[summaryIndex] = word != GetValidMask(wordIndex) ? clearSummary_[summaryIndex] | bit : clearSummary_[summaryIndex] & ~bit;
+		}
+		// 全ワードから要約を作り直す
+		inline void RebuildSummary() {
+			for (size_t summaryIndex = 0; summaryIndex < kSummaryCount; ++summaryIndex) {
+				uint64_t set = 0, clear = 0;
+				size_t first = summaryIndex * kWordSize;
+				size_t last = first + kWordSize < kWordCount ? first + kWordSize : kWordCount;
+				for (size_t i = first; i < last; ++i) {
+					set |= static_cast<uint64_t>(words_[i] != 0) << (i & kWordMask);
+					clear |= static_cast<uint64_t>(words_[i] != GetValidMask(i)) << (i & kWordMask);
+				}
+				setSummary_[summaryIndex] = set;
+				clearSummary_[summaryIndex] = clear;
+			}
+		}
 
-		uint64_t words_[kWordCount];
+		uint64_t words_[kWordCount]{};
+		// ワードに1が含まれるか
+		uint64_t setSummary_[kSummaryCount]{};
+		// ワードに0が含まれるか
+		uint64_t clearSummary_[kSummaryCount]{};
 	};
 
 
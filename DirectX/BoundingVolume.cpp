@@ -0,0 +1,355 @@
+#include "BoundingVolume.h"
+
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#include "MathSIMD.h"
+
+const AABB AABB::empty{
+	Vector3(std::numeric_limits<float>::max()),
+	Vector3(-std::numeric_limits<float>::max()) };
+
+namespace {
+
+#ifdef MATH_SIMD_SSE2
+	inline __m128 Abs(__m128 v) {
+		return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)));
+	}
+
+	// 連続した4つのVector3をx, y, zのレジスタに並べ替える
+	inline void LoadTransposed(const Vector3* points, __m128& x, __m128& y, __m128& z) {
+		const float* f = &points[0].x;
+		__m128 a = _mm_loadu_ps(f + 0);	// x0 y0 z0 x1
+		__m128 b = _mm_loadu_ps(f + 4);	// y1 z1 x2 y2
+		__m128 c = _mm_loadu_ps(f + 8);	// z2 x3 y3 z3
+		x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+		y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+		z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+	}
+
+	inline float HorizontalMin(__m128 v) {
+		v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+		return _mm_cvtss_f32(v);
+	}
+
+	inline float HorizontalMax(__m128 v) {
+		v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+		return _mm_cvtss_f32(v);
+	}
+
+	// 6枚の平面を4枚ずつ2組のSoAにしたもの
+	// 足りない2枚は必ず内側になる平面で埋める
+	struct FrustumSoA {
+		__m128 nx[2], ny[2], nz[2], distance[2];
+		__m128 absNx[2], absNy[2], absNz[2];
+
+		explicit FrustumSoA(const Frustum& frustum) {
+			alignas(16) float x[8]{}, y[8]{}, z[8]{}, d[8]{};
+			for (size_t i = 0; i < 8; ++i) {
+				if (i < Frustum::PlaneCount) {
+					x[i] = frustum.planes[i].normal.x;
+					y[i] = frustum.planes[i].normal.y;
+					z[i] = frustum.planes[i].normal.z;
+					d[i] = frustum.planes[i].distance;
+				}
+				else {
+					d[i] = -std::numeric_limits<float>::max();
+				}
+			}
+			for (size_t i = 0; i < 2; ++i) {
+				nx[i] = _mm_load_ps(x + i * 4);
+				ny[i] = _mm_load_ps(y + i * 4);
+				nz[i] = _mm_load_ps(z + i * 4);
+				distance[i] = _mm_load_ps(d + i * 4);
+				absNx[i] = Abs(nx[i]);
+				absNy[i] = Abs(ny[i]);
+				absNz[i] = Abs(nz[i]);
+			}
+		}
+	};
+#endif // MATH_SIMD_SSE2
+
+}
+
+#pragma region AABB
+AABB AABB::Merge(const AABB* aabbs, size_t count) {
+	assert(aabbs || count == 0);
+	size_t i = 0;
+	AABB result = empty;
+#ifdef MATH_SIMD_SSE2
+	// minはmin.x~max.x、maxはmin.z~max.zを読んでAABBの外にはみ出さないようにする
+	__m128 minimum = _mm_set1_ps(std::numeric_limits<float>::max());
+	__m128 maximum = _mm_set1_ps(-std::numeric_limits<float>::max());
+	for (; i < count; ++i) {
+		minimum = _mm_min_ps(minimum, _mm_loadu_ps(&aabbs[i].min.x));
+		maximum = _mm_max_ps(maximum, _mm_loadu_ps(&aabbs[i].min.z));
+	}
+	alignas(16) float minValues[4], maxValues[4];
+	_mm_store_ps(minValues, minimum);
+	_mm_store_ps(maxValues, maximum);
+	result.min = { minValues[0], minValues[1], minValues[2] };
+	result.max = { maxValues[1], maxValues[2], maxValues[3] };
+#endif // MATH_SIMD_SSE2
+	for (; i < count; ++i) {
+		result = Merge(result, aabbs[i]);
+	}
+	return result;
+}
+
+AABB AABB::MakeFromPoints(const Vector3* points, size_t count) {
+	assert(points || count == 0);
+	size_t i = 0;
+	AABB result = empty;
+#ifdef MATH_SIMD_SSE2
+	if (count >= 4) {
+		__m128 minX = _mm_set1_ps(result.min.x), minY = minX, minZ = minX;
+		__m128 maxX = _mm_set1_ps(result.max.x), maxY = maxX, maxZ = maxX;
+		for (; i + 4 <= count; i += 4) {
+			__m128 x, y, z;
+			LoadTransposed(points + i, x, y, z);
+			minX = _mm_min_ps(minX, x), minY = _mm_min_ps(minY, y), minZ = _mm_min_ps(minZ, z);
+			maxX = _mm_max_ps(maxX, x), maxY = _mm_max_ps(maxY, y), maxZ = _mm_max_ps(maxZ, z);
+		}
+		result.min = { HorizontalMin(minX), HorizontalMin(minY), HorizontalMin(minZ) };
+		result.max = { HorizontalMax(maxX), HorizontalMax(maxY), HorizontalMax(maxZ) };
+	}
+#endif // MATH_SIMD_SSE2
+	for (; i < count; ++i) {
+		result.Expand(points[i]);
+	}
+	return result;
+}
+
+void AABB::TransformBatch(const AABB* aabbs, size_t count, const Matrix4x4& matrix, AABB* results) {
+	assert((aabbs && results) || count == 0);
+	size_t i = 0;
+#ifdef MATH_SIMD_SSE2
+	__m128 row0 = _mm_loadu_ps(matrix.m[0]);
+	__m128 row1 = _mm_loadu_ps(matrix.m[1]);
+	__m128 row2 = _mm_loadu_ps(matrix.m[2]);
+	__m128 row3 = _mm_loadu_ps(matrix.m[3]);
+	__m128 absRow0 = Abs(row0), absRow1 = Abs(row1), absRow2 = Abs(row2);
+	__m128 half = _mm_set1_ps(0.5f);
+	for (; i < count; ++i) {
+		__m128 minimum = _mm_setr_ps(aabbs[i].min.x, aabbs[i].min.y, aabbs[i].min.z, 0.0f);
+		__m128 maximum = _mm_setr_ps(aabbs[i].max.x, aabbs[i].max.y, aabbs[i].max.z, 0.0f);
+		__m128 center = _mm_mul_ps(_mm_add_ps(minimum, maximum), half);
+		__m128 extents = _mm_mul_ps(_mm_sub_ps(maximum, minimum), half);
+
+		__m128 newCenter = row3;
+		newCenter = _mm_add_ps(newCenter, _mm_mul_ps(_mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0)), row0));
+		newCenter = _mm_add_ps(newCenter, _mm_mul_ps(_mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1)), row1));
+		newCenter = _mm_add_ps(newCenter, _mm_mul_ps(_mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2)), row2));
+		__m128 newExtents = _mm_mul_ps(_mm_shuffle_ps(extents, extents, _MM_SHUFFLE(0, 0, 0, 0)), absRow0);
+		newExtents = _mm_add_ps(newExtents, _mm_mul_ps(_mm_shuffle_ps(extents, extents, _MM_SHUFFLE(1, 1, 1, 1)), absRow1));
+		newExtents = _mm_add_ps(newExtents, _mm_mul_ps(_mm_shuffle_ps(extents, extents, _MM_SHUFFLE(2, 2, 2, 2)), absRow2));
+
+		alignas(16) float newMin[4], newMax[4];
+		_mm_store_ps(newMin, _mm_sub_ps(newCenter, newExtents));
+		_mm_store_ps(newMax, _mm_add_ps(newCenter, newExtents));
+		results[i].min = { newMin[0], newMin[1], newMin[2] };
+		results[i].max = { newMax[0], newMax[1], newMax[2] };
+	}
+#endif // MATH_SIMD_SSE2
+	for (; i < count; ++i) {
+		results[i] = aabbs[i].Transformed(matrix);
+	}
+}
+#pragma endregion
+
+#pragma region BoundingSphere
+size_t BoundingSphere::ContainsBatch(const Vector3* points, size_t count, uint8_t* results) const {
+	assert((points && results) || count == 0);
+	size_t i = 0;
+	size_t containCount = 0;
+#ifdef MATH_SIMD_SSE2
+	__m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+	__m128 radiusSquare = _mm_set1_ps(radius * radius);
+	for (; i + 4 <= count; i += 4) {
+		__m128 x, y, z;
+		LoadTransposed(points + i, x, y, z);
+		x = _mm_sub_ps(x, cx), y = _mm_sub_ps(y, cy), z = _mm_sub_ps(z, cz);
+		__m128 lengthSquare = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		unsigned int mask = static_cast<unsigned int>(_mm_movemask_ps(_mm_cmple_ps(lengthSquare, radiusSquare)));
+		// 4ビットのマスクを1バイトずつに広げてまとめて書き込む
+		uint32_t bytes = (mask * 0x00204081u) & 0x01010101u;
+		std::memcpy(results + i, &bytes, sizeof(bytes));
+		containCount += static_cast<size_t>(std::popcount(mask));
+	}
+#endif // MATH_SIMD_SSE2
+	for (; i < count; ++i) {
+		bool contains = Contains(points[i]);
+		results[i] = contains ? 1 : 0;
+		containCount += contains ? 1 : 0;
+	}
+	return containCount;
+}
+
+BoundingSphere BoundingSphere::MakeFromPoints(const Vector3* points, size_t count) {
+	assert(points || count == 0);
+	if (count == 0) {
+		return {};
+	}
+	// 任意の点から一番遠い点、そこから一番遠い点を直径の初期値にする
+	auto farthest = [&](const Vector3& from) {
+		size_t index = 0;
+		float maxLengthSquare = -1.0f;
+		for (size_t i = 0; i < count; ++i) {
+			float lengthSquare = (points[i] - from).LengthSquare();
+			if (lengthSquare > maxLengthSquare) {
+				maxLengthSquare = lengthSquare;
+				index = i;
+			}
+		}
+		return points[index];
+	};
+	Vector3 a = farthest(points[0]);
+	Vector3 b = farthest(a);
+	BoundingSphere result{ (a + b) * 0.5f, Vector3::Distance(a, b) * 0.5f };
+	// はみ出た点を含むように広げる
+	for (size_t i = 0; i < count; ++i) {
+		Vector3 diff = points[i] - result.center;
+		float lengthSquare = diff.LengthSquare();
+		if (lengthSquare > result.radius * result.radius) {
+			float length = std::sqrt(lengthSquare);
+			float newRadius = (result.radius + length) * 0.5f;
+			result.center += diff * ((newRadius - result.radius) / length);
+			result.radius = newRadius;
+		}
+	}
+	return result;
+}
+#pragma endregion
+
+#pragma region OBB
+bool OBB::Intersects(const OBB& other) const {
+	// Gottschalkの分離軸判定（15軸）
+	constexpr float kEpsilon = 1.0e-6f;
+	Vector3 a[3], b[3];
+	GetAxes(a);
+	other.GetAxes(b);
+
+	float r[3][3]{}, absR[3][3]{};
+	for (size_t i = 0; i < 3; ++i) {
+		for (size_t j = 0; j < 3; ++j) {
+			r[i][j] = Vector3::Dot(a[i], b[j]);
+			// 平行な辺の外積が0になるのを防ぐ
+			absR[i][j] = std::abs(r[i][j]) + kEpsilon;
+		}
+	}
+	Vector3 diff = other.center - center;
+	float t[3] = { Vector3::Dot(diff, a[0]), Vector3::Dot(diff, a[1]), Vector3::Dot(diff, a[2]) };
+	const Vector3& ea = extents;
+	const Vector3& eb = other.extents;
+
+	// 自身の軸
+	for (size_t i = 0; i < 3; ++i) {
+		float ra = ea[i];
+		float rb = eb[0] * absR[i][0] + eb[1] * absR[i][1] + eb[2] * absR[i][2];
+		if (std::abs(t[i]) > ra + rb) { return false; }
+	}
+	// 相手の軸
+	for (size_t j = 0; j < 3; ++j) {
+		float ra = ea[0] * absR[0][j] + ea[1] * absR[1][j] + ea[2] * absR[2][j];
+		float rb = eb[j];
+		if (std::abs(t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j]) > ra + rb) { return false; }
+	}
+	// 辺同士の外積
+	for (size_t i = 0; i < 3; ++i) {
+		size_t i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+		for (size_t j = 0; j < 3; ++j) {
+			size_t j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+			float ra = ea[i1] * absR[i2][j] + ea[i2] * absR[i1][j];
+			float rb = eb[j1] * absR[i][j2] + eb[j2] * absR[i][j1];
+			if (std::abs(t[i2] * r[i1][j] - t[i1] * r[i2][j]) > ra + rb) { return false; }
+		}
+	}
+	return true;
+}
+#pragma endregion
+
+#pragma region Frustum
+size_t Frustum::IntersectsBatch(const AABB* aabbs, size_t count, uint8_t* results) const {
+	assert((aabbs && results) || count == 0);
+	size_t i = 0;
+	size_t intersectCount = 0;
+#ifdef MATH_SIMD_SSE2
+	// 平面の方向に並列化し、1つのAABBを6枚同時に判定する
+	FrustumSoA soa(*this);
+	__m128 zero = _mm_setzero_ps();
+	for (; i < count; ++i) {
+		Vector3 center = aabbs[i].GetCenter();
+		Vector3 extents = aabbs[i].GetExtents();
+		__m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+		__m128 ex = _mm_set1_ps(extents.x), ey = _mm_set1_ps(extents.y), ez = _mm_set1_ps(extents.z);
+		__m128 outside = zero;
+		for (size_t j = 0; j < 2; ++j) {
+			__m128 distance = _mm_sub_ps(
+				_mm_add_ps(_mm_add_ps(_mm_mul_ps(soa.nx[j], cx), _mm_mul_ps(soa.ny[j], cy)), _mm_mul_ps(soa.nz[j], cz)),
+				soa.distance[j]);
+			__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(soa.absNx[j], ex), _mm_mul_ps(soa.absNy[j], ey)), _mm_mul_ps(soa.absNz[j], ez));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+		}
+		bool intersects = _mm_movemask_ps(outside) == 0;
+		results[i] = intersects ? 1 : 0;
+		intersectCount += intersects ? 1 : 0;
+	}
+#endif // MATH_SIMD_SSE2
+	for (; i < count; ++i) {
+		bool intersects = Intersects(aabbs[i]);
+		results[i] = intersects ? 1 : 0;
+		intersectCount += intersects ? 1 : 0;
+	}
+	return intersectCount;
+}
+
+size_t Frustum::IntersectsBatch(const BoundingSphere* spheres, size_t count, uint8_t* results) const {
+	assert((spheres && results) || count == 0);
+	size_t i = 0;
+	size_t intersectCount = 0;
+#ifdef MATH_SIMD_SSE2
+	FrustumSoA soa(*this);
+	__m128 zero = _mm_setzero_ps();
+	for (; i < count; ++i) {
+		__m128 cx = _mm_set1_ps(spheres[i].center.x), cy = _mm_set1_ps(spheres[i].center.y), cz = _mm_set1_ps(spheres[i].center.z);
+		__m128 radius = _mm_set1_ps(spheres[i].radius);
+		__m128 outside = zero;
+		for (size_t j = 0; j < 2; ++j) {
+			__m128 distance = _mm_sub_ps(
+				_mm_add_ps(_mm_add_ps(_mm_mul_ps(soa.nx[j], cx), _mm_mul_ps(soa.ny[j], cy)), _mm_mul_ps(soa.nz[j], cz)),
+				soa.distance[j]);
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+		}
+		bool intersects = _mm_movemask_ps(outside) == 0;
+		results[i] = intersects ? 1 : 0;
+		intersectCount += intersects ? 1 : 0;
+	}
+#endif // MATH_SIMD_SSE2
+	for (; i < count; ++i) {
+		bool intersects = Intersects(spheres[i]);
+		results[i] = intersects ? 1 : 0;
+		intersectCount += intersects ? 1 : 0;
+	}
+	return intersectCount;
+}
+
+Frustum Frustum::MakeFromMatrix(const Matrix4x4& viewProjection) {
+	// 行ベクトル規約なのでクリップ座標の各成分は行列の列との内積
+	// Gribb/Hartmannの方法で列の和と差から平面を取り出す
+	const auto& m = viewProjection.m;
+	auto make = [&](float a, float b, float c, float d) {
+		return Plane(Vector3(a, b, c), -d).Normalized();
+	};
+	Frustum result;
+	result.planes[Left] = make(m[0][3] + m[0][0], m[1][3] + m[1][0], m[2][3] + m[2][0], m[3][3] + m[3][0]);
+	result.planes[Right] = make(m[0][3] - m[0][0], m[1][3] - m[1][0], m[2][3] - m[2][0], m[3][3] - m[3][0]);
+	result.planes[Bottom] = make(m[0][3] + m[0][1], m[1][3] + m[1][1], m[2][3] + m[2][1], m[3][3] + m[3][1]);
+	result.planes[Top] = make(m[0][3] - m[0][1], m[1][3] - m[1][1], m[2][3] - m[2][1], m[3][3] - m[3][1]);
+	result.planes[Near] = make(m[0][2], m[1][2], m[2][2], m[3][2]);
+	result.planes[Far] = make(m[0][3] - m[0][2], m[1][3] - m[1][2], m[2][3] - m[2][2], m[3][3] - m[3][2]);
+	return result;
+}
+#pragma endregion
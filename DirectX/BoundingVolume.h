@@ -0,0 +1,309 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "Vector3.h"
+#include "Quaternion.h"
+#include "Matrix4x4.h"
+
+// 境界ボリューム
+// 平面の法線は内側を向き、Dot(normal, point) - distance >= 0 が内側
+
+class Plane {
+public:
+	Vector3 normal;
+	float distance;
+
+	inline Plane();
+	inline Plane(const Vector3& normal, float distance);
+
+	/// <summary>
+	/// 正規化
+	/// </summary>
+	/// <returns></returns>
+	inline Plane Normalized() const;
+	/// <summary>
+	/// 符号付き距離（法線側が正）
+	/// </summary>
+	/// <param name="point"></param>
+	/// <returns></returns>
+	inline float SignedDistance(const Vector3& point) const;
+
+	/// <summary>
+	/// 点と法線から生成
+	/// </summary>
+	/// <param name="point"></param>
+	/// <param name="normal">正規化法線</param>
+	/// <returns></returns>
+	static inline Plane MakeFromPointNormal(const Vector3& point, const Vector3& normal);
+	/// <summary>
+	/// 三点から生成（反時計回りが表）
+	/// </summary>
+	/// <param name="p0"></param>
+	/// <param name="p1"></param>
+	/// <param name="p2"></param>
+	/// <returns></returns>
+	static inline Plane MakeFromPoints(const Vector3& p0, const Vector3& p1, const Vector3& p2);
+};
+
+class BoundingSphere;
+
+class AABB {
+public:
+	Vector3 min;
+	Vector3 max;
+
+	// Mergeの単位元（min = +∞, max = -∞）
+	static const AABB empty;
+
+	inline AABB();
+	inline AABB(const Vector3& min, const Vector3& max);
+
+	/// <summary>
+	/// 中心
+	/// </summary>
+	/// <returns></returns>
+	inline Vector3 GetCenter() const;
+	/// <summary>
+	/// 各軸の半分の大きさ
+	/// </summary>
+	/// <returns></returns>
+	inline Vector3 GetExtents() const;
+	/// <summary>
+	/// 大きさ
+	/// </summary>
+	/// <returns></returns>
+	inline Vector3 GetSize() const;
+	/// <summary>
+	/// 空か（一度もExpandされていない）
+	/// </summary>
+	/// <returns></returns>
+	inline bool IsEmpty() const;
+
+	/// <summary>
+	/// 点を含むか
+	/// </summary>
+	/// <param name="point"></param>
+	/// <returns></returns>
+	inline bool Contains(const Vector3& point) const;
+	/// <summary>
+	/// AABBと交差しているか
+	/// </summary>
+	/// <param name="other"></param>
+	/// <returns></returns>
+	inline bool Intersects(const AABB& other) const;
+	/// <summary>
+	/// 球と交差しているか
+	/// </summary>
+	/// <param name="sphere"></param>
+	/// <returns></returns>
+	inline bool Intersects(const BoundingSphere& sphere) const;
+	/// <summary>
+	/// 点を含むように広げる
+	/// </summary>
+	/// <param name="point"></param>
+	/// <returns></returns>
+	inline AABB& Expand(const Vector3& point);
+	/// <summary>
+	/// 各方向に広げる
+	/// </summary>
+	/// <param name="amount"></param>
+	/// <returns></returns>
+	inline AABB& Expand(float amount);
+	/// <summary>
+	/// 変換後のボックスを包むAABB
+	/// </summary>
+	/// <param name="matrix">アフィン変換行列</param>
+	/// <returns></returns>
+	inline AABB Transformed(const Matrix4x4& matrix) const;
+
+	/// <summary>
+	/// 二つを包むAABB
+	/// </summary>
+	/// <param name="lhs"></param>
+	/// <param name="rhs"></param>
+	/// <returns></returns>
+	static inline AABB Merge(const AABB& lhs, const AABB& rhs);
+	/// <summary>
+	/// 配列をすべて包むAABB
+	/// </summary>
+	/// <param name="aabbs"></param>
+	/// <param name="count"></param>
+	/// <returns>countが0の場合はempty</returns>
+	static AABB Merge(const AABB* aabbs, size_t count);
+	/// <summary>
+	/// 点群を包むAABB
+	/// </summary>
+	/// <param name="points"></param>
+	/// <param name="count"></param>
+	/// <returns>countが0の場合はempty</returns>
+	static AABB MakeFromPoints(const Vector3* points, size_t count);
+	/// <summary>
+	/// 配列をまとめて変換
+	/// </summary>
+	/// <param name="aabbs"></param>
+	/// <param name="count"></param>
+	/// <param name="matrix">アフィン変換行列</param>
+	/// <param name="results">count個の書き込み先（aabbsと同じでもよい）</param>
+	static void TransformBatch(const AABB* aabbs, size_t count, const Matrix4x4& matrix, AABB* results);
+};
+
+class BoundingSphere {
+public:
+	Vector3 center;
+	float radius;
+
+	inline BoundingSphere();
+	inline BoundingSphere(const Vector3& center, float radius);
+
+	/// <summary>
+	/// 点を含むか
+	/// </summary>
+	/// <param name="point"></param>
+	/// <returns></returns>
+	inline bool Contains(const Vector3& point) const;
+	/// <summary>
+	/// 球と交差しているか
+	/// </summary>
+	/// <param name="other"></param>
+	/// <returns></returns>
+	inline bool Intersects(const BoundingSphere& other) const;
+	/// <summary>
+	/// 変換後の球を包む球
+	/// </summary>
+	/// <param name="matrix">アフィン変換行列</param>
+	/// <returns></returns>
+	inline BoundingSphere Transformed(const Matrix4x4& matrix) const;
+	/// <summary>
+	/// 点群をまとめて判定
+	/// </summary>
+	/// <param name="points"></param>
+	/// <param name="count"></param>
+	/// <param name="results">count個の書き込み先（含む場合1）</param>
+	/// <returns>含まれる点の数</returns>
+	size_t ContainsBatch(const Vector3* points, size_t count, uint8_t* results) const;
+
+	/// <summary>
+	/// 二つを包む球
+	/// </summary>
+	/// <param name="lhs"></param>
+	/// <param name="rhs"></param>
+	/// <returns></returns>
+	static inline BoundingSphere Merge(const BoundingSphere& lhs, const BoundingSphere& rhs);
+	/// <summary>
+	/// AABBを包む球
+	/// </summary>
+	/// <param name="aabb"></param>
+	/// <returns></returns>
+	static inline BoundingSphere MakeFromAABB(const AABB& aabb);
+	/// <summary>
+	/// 点群を包む球（Ritterの近似）
+	/// </summary>
+	/// <param name="points"></param>
+	/// <param name="count"></param>
+	/// <returns></returns>
+	static BoundingSphere MakeFromPoints(const Vector3* points, size_t count);
+};
+
+class OBB {
+public:
+	Vector3 center;
+	// 各軸の半分の大きさ
+	Vector3 extents;
+	Quaternion orientation;
+
+	inline OBB();
+	inline OBB(const Vector3& center, const Vector3& extents, const Quaternion& orientation);
+
+	/// <summary>
+	/// 各軸の向き
+	/// </summary>
+	/// <param name="axes">x, y, zの順で書き込む</param>
+	inline void GetAxes(Vector3 axes[3]) const;
+	/// <summary>
+	/// 点を含むか
+	/// </summary>
+	/// <param name="point"></param>
+	/// <returns></returns>
+	inline bool Contains(const Vector3& point) const;
+	/// <summary>
+	/// OBBと交差しているか（分離軸判定）
+	/// </summary>
+	/// <param name="other"></param>
+	/// <returns></returns>
+	bool Intersects(const OBB& other) const;
+	/// <summary>
+	/// 包むAABB
+	/// </summary>
+	/// <returns></returns>
+	inline AABB GetAABB() const;
+
+	/// <summary>
+	/// AABBと変換から生成
+	/// </summary>
+	/// <param name="aabb"></param>
+	/// <param name="rotate"></param>
+	/// <param name="translate"></param>
+	/// <returns></returns>
+	static inline OBB MakeFromAABB(const AABB& aabb, const Quaternion& rotate, const Vector3& translate);
+};
+
+class Frustum {
+public:
+	enum PlaneIndex {
+		Left,
+		Right,
+		Bottom,
+		Top,
+		Near,
+		Far,
+
+		PlaneCount
+	};
+
+	Plane planes[PlaneCount];
+
+	/// <summary>
+	/// 点を含むか
+	/// </summary>
+	/// <param name="point"></param>
+	/// <returns></returns>
+	inline bool Contains(const Vector3& point) const;
+	/// <summary>
+	/// AABBと交差しているか（保守的）
+	/// </summary>
+	/// <param name="aabb"></param>
+	/// <returns></returns>
+	inline bool Intersects(const AABB& aabb) const;
+	/// <summary>
+	/// 球と交差しているか（保守的）
+	/// </summary>
+	/// <param name="sphere"></param>
+	/// <returns></returns>
+	inline bool Intersects(const BoundingSphere& sphere) const;
+	/// <summary>
+	/// AABBをまとめて判定
+	/// </summary>
+	/// <param name="aabbs"></param>
+	/// <param name="count"></param>
+	/// <param name="results">count個の書き込み先（交差する場合1）</param>
+	/// <returns>交差するAABBの数</returns>
+	size_t IntersectsBatch(const AABB* aabbs, size_t count, uint8_t* results) const;
+	/// <summary>
+	/// 球をまとめて判定
+	/// </summary>
+	/// <param name="spheres"></param>
+	/// <param name="count"></param>
+	/// <param name="results">count個の書き込み先（交差する場合1）</param>
+	/// <returns>交差する球の数</returns>
+	size_t IntersectsBatch(const BoundingSphere* spheres, size_t count, uint8_t* results) const;
+
+	/// <summary>
+	/// ビュープロジェクション行列から生成（クリップ空間のzは0~1）
+	/// </summary>
+	/// <param name="viewProjection"></param>
+	/// <returns></returns>
+	static Frustum MakeFromMatrix(const Matrix4x4& viewProjection);
+};
+
+#include "BoundingVolume_inline.h"
@@ -0,0 +1,139 @@
+#pragma once
+#include "BoundingVolume.h"
+
+#pragma region Plane
+inline Plane::Plane() : normal(Vector3::unitY), distance(0.0f) {}
+inline Plane::Plane(const Vector3& normal, float distance) : normal(normal), distance(distance) {}
+inline Plane Plane::Normalized() const {
+	float length = normal.Length();
+	assert(length != 0.0f);
+	float invLength = 1.0f / length;
+	return { normal * invLength, distance * invLength };
+}
+inline float Plane::SignedDistance(const Vector3& point) const { return Vector3::Dot(normal, point) - distance; }
+inline Plane Plane::MakeFromPointNormal(const Vector3& point, const Vector3& normal) { return { normal, Vector3::Dot(normal, point) }; }
+inline Plane Plane::MakeFromPoints(const Vector3& p0, const Vector3& p1, const Vector3& p2) {
+	Vector3 n = Vector3::Cross(p1 - p0, p2 - p0).Normalized();
+	return MakeFromPointNormal(p0, n);
+}
+#pragma endregion
+
+#pragma region AABB
+inline AABB::AABB() : min(), max() {}
+inline AABB::AABB(const Vector3& min, const Vector3& max) : min(min), max(max) {}
+inline Vector3 AABB::GetCenter() const { return (min + max) * 0.5f; }
+inline Vector3 AABB::GetExtents() const { return (max - min) * 0.5f; }
+inline Vector3 AABB::GetSize() const { return max - min; }
+inline bool AABB::IsEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+inline bool AABB::Contains(const Vector3& point) const {
+	return
+		point.x >= min.x && point.x <= max.x &&
+		point.y >= min.y && point.y <= max.y &&
+		point.z >= min.z && point.z <= max.z;
+}
+inline bool AABB::Intersects(const AABB& other) const {
+	return
+		min.x <= other.max.x && max.x >= other.min.x &&
+		min.y <= other.max.y && max.y >= other.min.y &&
+		min.z <= other.max.z && max.z >= other.min.z;
+}
+inline bool AABB::Intersects(const BoundingSphere& sphere) const {
+	Vector3 closest = Vector3::Min(Vector3::Max(sphere.center, min), max);
+	return (closest - sphere.center).LengthSquare() <= sphere.radius * sphere.radius;
+}
+inline AABB& AABB::Expand(const Vector3& point) {
+	min = Vector3::Min(min, point);
+	max = Vector3::Max(max, point);
+	return *this;
+}
+inline AABB& AABB::Expand(float amount) {
+	min -= Vector3(amount);
+	max += Vector3(amount);
+	return *this;
+}
+inline AABB AABB::Transformed(const Matrix4x4& matrix) const {
+	// 中心を変換し、各軸の大きさは行列の絶対値で広げる（Arvoの方法）
+	Vector3 center = GetCenter() * matrix;
+	Vector3 extents = GetExtents();
+	Vector3 newExtents = {
+		std::abs(matrix.m[0][0]) * extents.x + std::abs(matrix.m[1][0]) * extents.y + std::abs(matrix.m[2][0]) * extents.z,
+		std::abs(matrix.m[0][1]) * extents.x + std::abs(matrix.m[1][1]) * extents.y + std::abs(matrix.m[2][1]) * extents.z,
+		std::abs(matrix.m[0][2]) * extents.x + std::abs(matrix.m[1][2]) * extents.y + std::abs(matrix.m[2][2]) * extents.z };
+	return { center - newExtents, center + newExtents };
+}
+inline AABB AABB::Merge(const AABB& lhs, const AABB& rhs) { return { Vector3::Min(lhs.min, rhs.min), Vector3::Max(lhs.max, rhs.max) }; }
+#pragma endregion
+
+#pragma region BoundingSphere
+inline BoundingSphere::BoundingSphere() : center(), radius(0.0f) {}
+inline BoundingSphere::BoundingSphere(const Vector3& center, float radius) : center(center), radius(radius) {}
+inline bool BoundingSphere::Contains(const Vector3& point) const { return (point - center).LengthSquare() <= radius * radius; }
+inline bool BoundingSphere::Intersects(const BoundingSphere& other) const {
+	float radiusSum = radius + other.radius;
+	return (other.center - center).LengthSquare() <= radiusSum * radiusSum;
+}
+inline BoundingSphere BoundingSphere::Transformed(const Matrix4x4& matrix) const {
+	// 一番大きい拡大率で半径を広げる
+	float scaleSquare = std::max({ matrix.GetXAxis().LengthSquare(), matrix.GetYAxis().LengthSquare(), matrix.GetZAxis().LengthSquare() });
+	return { center * matrix, radius * std::sqrt(scaleSquare) };
+}
+inline BoundingSphere BoundingSphere::Merge(const BoundingSphere& lhs, const BoundingSphere& rhs) {
+	Vector3 diff = rhs.center - lhs.center;
+	float distance = diff.Length();
+	// 片方がもう片方を含む場合
+	if (distance + rhs.radius <= lhs.radius) { return lhs; }
+	if (distance + lhs.radius <= rhs.radius) { return rhs; }
+	float newRadius = (distance + lhs.radius + rhs.radius) * 0.5f;
+	return { lhs.center + diff * ((newRadius - lhs.radius) / distance), newRadius };
+}
+inline BoundingSphere BoundingSphere::MakeFromAABB(const AABB& aabb) { return { aabb.GetCenter(), aabb.GetExtents().Length() }; }
+#pragma endregion
+
+#pragma region OBB
+inline OBB::OBB() : center(), extents(), orientation() {}
+inline OBB::OBB(const Vector3& center, const Vector3& extents, const Quaternion& orientation) : center(center), extents(extents), orientation(orientation) {}
+inline void OBB::GetAxes(Vector3 axes[3]) const {
+	Matrix4x4 rotate = Matrix4x4::MakeRotationFromQuaternion(orientation);
+	axes[0] = rotate.GetXAxis();
+	axes[1] = rotate.GetYAxis();
+	axes[2] = rotate.GetZAxis();
+}
+inline bool OBB::Contains(const Vector3& point) const {
+	Vector3 local = orientation.GetConjugate() * (point - center);
+	return
+		std::abs(local.x) <= extents.x &&
+		std::abs(local.y) <= extents.y &&
+		std::abs(local.z) <= extents.z;
+}
+inline AABB OBB::GetAABB() const {
+	return AABB(-extents, extents).Transformed(Matrix4x4::MakeAffine(Vector3::one, orientation, center));
+}
+inline OBB OBB::MakeFromAABB(const AABB& aabb, const Quaternion& rotate, const Vector3& translate) {
+	return { rotate * aabb.GetCenter() + translate, aabb.GetExtents(), rotate };
+}
+#pragma endregion
+
+#pragma region Frustum
+inline bool Frustum::Contains(const Vector3& point) const {
+	for (const auto& plane : planes) {
+		if (plane.SignedDistance(point) < 0.0f) { return false; }
+	}
+	return true;
+}
+inline bool Frustum::Intersects(const AABB& aabb) const {
+	Vector3 center = aabb.GetCenter();
+	Vector3 extents = aabb.GetExtents();
+	for (const auto& plane : planes) {
+		// 平面の法線方向へのボックスの半径
+		float r = std::abs(plane.normal.x) * extents.x + std::abs(plane.normal.y) * extents.y + std::abs(plane.normal.z) * extents.z;
+		if (plane.SignedDistance(center) + r < 0.0f) { return false; }
+	}
+	return true;
+}
+inline bool Frustum::Intersects(const BoundingSphere& sphere) const {
+	for (const auto& plane : planes) {
+		if (plane.SignedDistance(sphere.center) < -sphere.radius) { return false; }
+	}
+	return true;
+}
+#pragma endregion
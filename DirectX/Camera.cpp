@@ -1,8 +1,19 @@
-#include "stdafx.h"
 #include "Camera.h"
 
 void Camera::UpdateMatrix() {
-	viewMatrix_ = Matrix4x4::MakeAffine({ 1.0f,1.0f,1.0f }, rotate_, position_).inverse;
+	// 回転の逆行列は転置
+	relativeViewMatrix_ = Matrix4x4::MakeRotationFromQuaternion(rotate_).GetTranspose();
 	projectionMatrix_ = Matrix4x4::MakePerspectiveProjection(fovY_, aspect_, nearZ_, farZ_);
+	relativeViewProjectionMatrix_ = relativeViewMatrix_ * projectionMatrix_;
+
+	// ワールド原点基準のビュー行列の平行移動は -position * R^T を倍精度で計算する
+	viewMatrix_ = relativeViewMatrix_;
+	for (size_t j = 0; j < 3; ++j) {
+		double translate = 0.0;
+		for (size_t i = 0; i < 3; ++i) {
+			translate -= position_[i] * static_cast<double>(relativeViewMatrix_.m[i][j]);
+		}
+		viewMatrix_.m[3][j] = static_cast<float>(translate);
+	}
 	viewProjectionMatrix_ = viewMatrix_ * projectionMatrix_;
 }
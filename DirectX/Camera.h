@@ -1,23 +1,54 @@
 #pragma once
 #include "MathUtils.h"
+#include "Vector3d.h"
+
+// 位置は倍精度で持ち、原点から離れても描画がぶれないようにカメラ位置を原点とした行列も用意する
+// 原点から遠い物はCamera::ToCameraRelativeで相対位置にしてから、GetRelativeViewProjectionMatrixで描画する
 
 class Camera {
 public:
 	void UpdateMatrix();
 
-	void SetPosition(const Vector3& position) { position_ = position; }
+	void SetPosition(const Vector3d& position) { position_ = position; }
 	void SetRotate(const Quaternion& rotate) { rotate_ = rotate; }
 	void SetProjectionParameter(float fovY, float aspect, float nearZ, float farZ) { fovY_ = fovY, aspect_ = aspect, nearZ_ = nearZ, farZ_ = farZ; }
 	void SetViewMatrix(const Matrix4x4& viewMatrix) { viewMatrix_ = viewMatrix; }
 	void SetProjectionMatrix(const Matrix4x4& projectionMatrix) { projectionMatrix_ = projectionMatrix; }
 
+	const Vector3d& GetPosition() const { return position_; }
+	const Quaternion& GetRotate() const { return rotate_; }
 	const Matrix4x4& GetViewMatrix() const { return viewMatrix_; }
 	const Matrix4x4& GetProjectionMatrix() const { return projectionMatrix_; }
 	const Matrix4x4& GetViewProjectionMatrix() const { return viewProjectionMatrix_; }
+	// カメラ位置を原点とした空間のビュー行列（回転のみ）
+	const Matrix4x4& GetRelativeViewMatrix() const { return relativeViewMatrix_; }
+	const Matrix4x4& GetRelativeViewProjectionMatrix() const { return relativeViewProjectionMatrix_; }
+
+	/// <summary>
+	/// ワールド座標をカメラからの相対位置に変換
+	/// </summary>
+	/// <param name="worldPosition"></param>
+	/// <returns></returns>
+	Vector3 ToCameraRelative(const Vector3d& worldPosition) const { return worldPosition.RelativeTo(position_); }
+	/// <summary>
+	/// 配列をまとめてカメラからの相対位置に変換
+	/// </summary>
+	/// <param name="worldPositions"></param>
+	/// <param name="count"></param>
+	/// <param name="results">count個の書き込み先</param>
+	void ToCameraRelative(const Vector3d* worldPositions, size_t count, Vector3* results) const { Vector3d::RelativeToBatch(worldPositions, count, position_, results); }
+	/// <summary>
+	/// カメラ位置を原点とした空間のワールド行列
+	/// </summary>
+	/// <param name="scale"></param>
+	/// <param name="rotate"></param>
+	/// <param name="translate">ワールド座標</param>
+	/// <returns></returns>
+	Matrix4x4 MakeRelativeWorldMatrix(const Vector3& scale, const Quaternion& rotate, const Vector3d& translate) const { return Matrix4x4::MakeAffine(scale, rotate, ToCameraRelative(translate)); }
 
 private:
-	Vector3 position_ = { 0.0f, 1.5f, -5.0f };
-	Quaternion rotate_ = Quaternion::MakeLookRotation(-position_);
+	Vector3d position_ = { 0.0, 1.5, -5.0 };
+	Quaternion rotate_ = Quaternion::MakeLookRotation(-position_.ToVector3());
 
 	float fovY_{ 45.0f * Math::ToRadian };
 	float aspect_{ 1280.0f / 720.0f };
@@ -27,5 +58,6 @@ private:
 	Matrix4x4 viewMatrix_;
 	Matrix4x4 projectionMatrix_;
 	Matrix4x4 viewProjectionMatrix_;
+	Matrix4x4 relativeViewMatrix_;
+	Matrix4x4 relativeViewProjectionMatrix_;
 };
-
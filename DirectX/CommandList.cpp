@@ -4,6 +4,23 @@
 
 namespace DirectXHelper {
 
+	namespace {
+		// Engine::ResourceStateはD3D12_RESOURCE_STATESと同じ値
+		static_assert(static_cast<uint32_t>(Engine::ResourceState::UnorderedAccess) == D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+		static_assert(static_cast<uint32_t>(Engine::ResourceState::NonPixelShaderResource) == D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+		static_assert(static_cast<uint32_t>(Engine::ResourceState::GenericRead) == D3D12_RESOURCE_STATE_GENERIC_READ);
+		static_assert(static_cast<uint32_t>(Engine::ResourceState::ResolveSource) == D3D12_RESOURCE_STATE_RESOLVE_SOURCE);
+		static_assert(static_cast<uint32_t>(Engine::ResourceBarrier::Flag::BeginOnly) == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+		static_assert(static_cast<uint32_t>(Engine::ResourceBarrier::Flag::EndOnly) == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+
+		Engine::ResourceState ToEngineState(ResourceState state) {
+			return static_cast<Engine::ResourceState>(static_cast<uint32_t>(state));
+		}
+		ResourceState ToResourceState(Engine::ResourceState state) {
+			return static_cast<ResourceState>(static_cast<uint32_t>(state));
+		}
+	}
+
 	bool CommandList::Initalize(ID3D12Device5* device, ID3D12CommandQueue* commandQueue) {
 		// キューを割り当てる
 		commandQueue_.Attach(commandQueue);
@@ -36,6 +53,7 @@ namespace DirectXHelper {
 
 	bool CommandList::Execute() {
 		assert(isRecordingCommands);
+		FlushResourceBarriers();
 		// リストを閉じる
 		if (FAILED(commandList_->Close())) {
 			Logger::Error("ID3D12GraphicsCommandList4::Close()");
@@ -73,7 +91,68 @@ namespace DirectXHelper {
 			assert(false);
 			return false;
 		}
+		stateTracker_.Reset();
 		isRecordingCommands = true;
 		return true;
 	}
+
+	void CommandList::TransitionResource(GPUResource& resource, ResourceState state) {
+		resource.state_ = ToResourceState(stateTracker_.Transition(resource.Get(), ToEngineState(resource.state_), ToEngineState(state)));
+	}
+
+	void CommandList::BeginResourceTransition(GPUResource& resource, ResourceState state) {
+		resource.state_ = ToResourceState(stateTracker_.BeginTransition(resource.Get(), ToEngineState(resource.state_), ToEngineState(state)));
+	}
+
+	void CommandList::UAVBarrier(GPUResource& resource) {
+		stateTracker_.UAVBarrier(resource.Get());
+	}
+
+	void CommandList::FlushResourceBarriers() {
+		if (!stateTracker_.HasPendingBarriers()) { return; }
+		const std::vector<Engine::ResourceBarrier>& pending = stateTracker_.GetPendingBarriers();
+		resourceBarriers_.clear();
+		AppendResourceBarriers(pending.data(), static_cast<uint32_t>(pending.size()));
+		commandList_->ResourceBarrier(static_cast<uint32_t>(resourceBarriers_.size()), resourceBarriers_.data());
+		stateTracker_.ClearPendingBarriers();
+	}
+
+	void CommandList::ResourceBarriers(const Engine::ResourceBarrier* barriers, uint32_t count) {
+		resourceBarriers_.clear();
+		if (stateTracker_.HasPendingBarriers()) {
+			const std::vector<Engine::ResourceBarrier>& pending = stateTracker_.GetPendingBarriers();
+			AppendResourceBarriers(pending.data(), static_cast<uint32_t>(pending.size()));
+			stateTracker_.ClearPendingBarriers();
+		}
+		AppendResourceBarriers(barriers, count);
+		if (!resourceBarriers_.empty()) {
+			commandList_->ResourceBarrier(static_cast<uint32_t>(resourceBarriers_.size()), resourceBarriers_.data());
+		}
+	}
+
+	void CommandList::AppendResourceBarriers(const Engine::ResourceBarrier* barriers, uint32_t count) {
+		for (uint32_t i = 0; i < count; ++i) {
+			const Engine::ResourceBarrier& source = barriers[i];
+			D3D12_RESOURCE_BARRIER barrier{};
+			barrier.Flags = static_cast<D3D12_RESOURCE_BARRIER_FLAGS>(source.flag);
+			if (source.type == Engine::ResourceBarrier::Type::UAV) {
+				barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+				barrier.UAV.pResource = static_cast<ID3D12Resource*>(source.resource);
+			}
+			else if (source.type == Engine::ResourceBarrier::Type::Aliasing) {
+				// 前に使っていたリソースは指定しない（同じメモリのどのリソースからでもよい）
+				barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+				barrier.Aliasing.pResourceBefore = nullptr;
+				barrier.Aliasing.pResourceAfter = static_cast<ID3D12Resource*>(source.resource);
+			}
+			else {
+				barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+				barrier.Transition.pResource = static_cast<ID3D12Resource*>(source.resource);
+				barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+				barrier.Transition.StateBefore = static_cast<D3D12_RESOURCE_STATES>(source.before);
+				barrier.Transition.StateAfter = static_cast<D3D12_RESOURCE_STATES>(source.after);
+			}
+			resourceBarriers_.push_back(barrier);
+		}
+	}
 }
@@ -1,5 +1,7 @@
 #pragma once
 #include "Fence.h"
+#include "GPUResource.h"
+#include "ResourceStateTracker.h"
 
 namespace DirectXHelper {
 	using namespace Microsoft::WRL;
@@ -42,23 +44,46 @@ namespace DirectXHelper {
 		//void SetComputeRootConstantBufferView();
 		//void SetComputeRootShaderResourceView();
 		//void SetComputeRootDescriptorTable();
-		//
-		//void AddTransitionBarrier(const D3D12_RESOURCE_BARRIER& barrier) {
-		//	resouceReferences_.emplace_back(barrier);
-		//	resouceReferences_.emplace_back(barrier.Transition.pResource);
-		//}
-		//void AddUAVBarrier(const D3D12_RESOURCE_BARRIER& barrier) {
-		//	resourceBarriers_.emplace_back(barrier);
-		//	resouceReferences_.emplace_back(barrier.UAV.pResource);
-		//}
-		//void BatchResourceBarrier() {
-		//	commandList_->ResourceBarrier(static_cast<uint32_t>(resourceBarriers_.size()), resourceBarriers_.data());
-		//	resourceBarriers_.clear();
-		//}
-		//
-		//void DrawInstanced();
-		//void DrawIndexInstanced();
-		//void Dispatch();
+
+		/// <summary>
+		/// 状態の遷移を予約する（次の描画、ディスパッチ、コピーの直前にまとめて出す）
+		/// </summary>
+		void TransitionResource(GPUResource& resource, ResourceState state);
+		/// <summary>
+		/// 分割バリアを開始する（同じ状態へのTransitionResourceで終わる、その間はリソースを使わない）
+		/// </summary>
+		void BeginResourceTransition(GPUResource& resource, ResourceState state);
+		/// <summary>
+		/// UAVへの書き込みを待つバリアを予約する
+		/// </summary>
+		void UAVBarrier(GPUResource& resource);
+		/// <summary>
+		/// 予約したバリアを1回のResourceBarrierで出す
+		/// </summary>
+		void FlushResourceBarriers();
+		/// <summary>
+		/// 予約したバリアを出してから、渡したバリアを出す（Engine::RenderGraphが求めたバリアなど）
+		/// </summary>
+		void ResourceBarriers(const Engine::ResourceBarrier* barriers, uint32_t count);
+
+		void DrawInstanced(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertex = 0, uint32_t startInstance = 0) {
+			FlushResourceBarriers();
+			commandList_->DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+		}
+		void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex = 0, int32_t baseVertex = 0, uint32_t startInstance = 0) {
+			FlushResourceBarriers();
+			commandList_->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+		}
+		void Dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY = 1, uint32_t threadGroupCountZ = 1) {
+			FlushResourceBarriers();
+			commandList_->Dispatch(threadGroupCountX, threadGroupCountY, threadGroupCountZ);
+		}
+		void CopyResource(GPUResource& destination, GPUResource& source) {
+			FlushResourceBarriers();
+			commandList_->CopyResource(destination, source);
+		}
+
+		const Engine::ResourceStateTracker::Statistics& GetBarrierStatistics() const { return stateTracker_.GetStatistics(); }
 
 		bool IsEnabled() const { return commandList_; }
 		ID3D12GraphicsCommandList4* Get() const { return commandList_.Get(); }
@@ -74,6 +99,11 @@ namespace DirectXHelper {
 		ComPtr<ID3D12PipelineState> pipelineState_;
 		ComPtr<ID3D12RootSignature> rootSignature_;
 		
+		// Engine::ResourceBarrierを変換してresourceBarriers_に足す
+		void AppendResourceBarriers(const Engine::ResourceBarrier* barriers, uint32_t count);
+
+		Engine::ResourceStateTracker stateTracker_;
+		// ResourceBarrierに渡す（使い回す）
 		std::vector<D3D12_RESOURCE_BARRIER> resourceBarriers_;
 
 		std::vector<ComPtr<ID3D12Object>> resouceReferences_;
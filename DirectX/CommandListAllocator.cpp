@@ -0,0 +1,92 @@
+#include "stdafx.h"
+#include "CommandListAllocator.h"
+#include "Logger.h"
+
+namespace DirectXHelper {
+
+	bool CommandListAllocator::Initalize(ID3D12Device5* device, CommandQueue* queue, D3D12_COMMAND_LIST_TYPE type) {
+		assert(device);
+		assert(queue);
+
+		backend_.device = device;
+		backend_.queue = queue;
+		backend_.type = type;
+		if (!pool_.Initalize(&backend_, queue)) {
+			Logger::Error("CommandListPool::Initalize()");
+			assert(false);
+			return false;
+		}
+		return true;
+	}
+
+	void CommandListAllocator::Finalize() {
+		pool_.Finalize();
+		backend_.device.Reset();
+		backend_.queue = nullptr;
+	}
+
+	void* CommandListAllocator::D3D12CommandListBackend::CreateAllocator() {
+		ID3D12CommandAllocator* allocator = nullptr;
+		if (FAILED(device->CreateCommandAllocator(type, IID_PPV_ARGS(&allocator)))) {
+			Logger::Error("ID3D12Device::CreateCommandAllocator()");
+			assert(false);
+			return nullptr;
+		}
+		return allocator;
+	}
+
+	bool CommandListAllocator::D3D12CommandListBackend::ResetAllocator(void* allocator) {
+		if (FAILED(static_cast<ID3D12CommandAllocator*>(allocator)->Reset())) {
+			Logger::Error("ID3D12CommandAllocator::Reset()");
+			assert(false);
+			return false;
+		}
+		return true;
+	}
+
+	void CommandListAllocator::D3D12CommandListBackend::DestroyAllocator(void* allocator) {
+		static_cast<ID3D12CommandAllocator*>(allocator)->Release();
+	}
+
+	void* CommandListAllocator::D3D12CommandListBackend::CreateCommandList(void* allocator) {
+		ID3D12GraphicsCommandList4* commandList = nullptr;
+		if (FAILED(device->CreateCommandList(0, type, static_cast<ID3D12CommandAllocator*>(allocator), nullptr, IID_PPV_ARGS(&commandList)))) {
+			Logger::Error("ID3D12Device::CreateCommandList()");
+			assert(false);
+			return nullptr;
+		}
+		return commandList;
+	}
+
+	bool CommandListAllocator::D3D12CommandListBackend::ResetCommandList(void* commandList, void* allocator) {
+		if (FAILED(static_cast<ID3D12GraphicsCommandList4*>(commandList)->Reset(static_cast<ID3D12CommandAllocator*>(allocator), nullptr))) {
+			Logger::Error("ID3D12GraphicsCommandList4::Reset()");
+			assert(false);
+			return false;
+		}
+		return true;
+	}
+
+	bool CommandListAllocator::D3D12CommandListBackend::CloseCommandList(void* commandList) {
+		if (FAILED(static_cast<ID3D12GraphicsCommandList4*>(commandList)->Close())) {
+			Logger::Error("ID3D12GraphicsCommandList4::Close()");
+			assert(false);
+			return false;
+		}
+		return true;
+	}
+
+	void CommandListAllocator::D3D12CommandListBackend::DestroyCommandList(void* commandList) {
+		static_cast<ID3D12GraphicsCommandList4*>(commandList)->Release();
+	}
+
+	void CommandListAllocator::D3D12CommandListBackend::ExecuteCommandLists(void* const* commandLists, uint32_t count) {
+		// ID3D12GraphicsCommandList4*からID3D12CommandList*へは基底クラスへの変換なので、一つずつ変換する
+		executeBuffer.resize(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			executeBuffer[i] = static_cast<ID3D12GraphicsCommandList4*>(commandLists[i]);
+		}
+		queue->ExecuteCommandLists(count, executeBuffer.data());
+	}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "CommandListPool.h"
+#include "CommandQueue.h"
+
+namespace DirectXHelper {
+
+	// ID3D12CommandAllocatorとID3D12GraphicsCommandList4を使い回す
+	// 使い回しの方針はEngine::CommandListPoolが決め、このクラスはアロケータとリストを作って積むだけ
+	class CommandListAllocator {
+	public:
+		CommandListAllocator() = default;
+		DELETE_COPY_MOVE(CommandListAllocator);
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="device"></param>
+		/// <param name="queue">リストを積むキュー（種類はキューに合わせる）</param>
+		/// <param name="type"></param>
+		/// <returns></returns>
+		bool Initalize(ID3D12Device5* device, CommandQueue* queue, D3D12_COMMAND_LIST_TYPE type = D3D12_COMMAND_LIST_TYPE_DIRECT);
+		void Finalize();
+
+		/// <summary>
+		/// 記録できる状態のコマンドリストを取る（複数のスレッドから呼べる）
+		/// </summary>
+		[[nodiscard]] Engine::CommandListPool::CommandContext Acquire() { return pool_.Acquire(); }
+		/// <summary>
+		/// 閉じて、渡した順に1回のExecuteCommandListsで積む
+		/// </summary>
+		/// <returns>積んだリストが終わったら進むフェンス値</returns>
+		uint64_t Submit(Engine::CommandListPool::CommandContext* contexts, uint32_t count) { return pool_.Submit(contexts, count); }
+		void Discard(Engine::CommandListPool::CommandContext& context) { pool_.Discard(context); }
+
+		static ID3D12GraphicsCommandList4* GetCommandList(void* commandList) { return static_cast<ID3D12GraphicsCommandList4*>(commandList); }
+		static ID3D12GraphicsCommandList4* GetCommandList(const Engine::CommandListPool::CommandContext& context) { return GetCommandList(context.commandList); }
+
+		// ParallelCommandRecorderに渡す
+		Engine::CommandListPool& GetPool() { return pool_; }
+		Engine::CommandListPool::Statistics GetStatistics() const { return pool_.GetStatistics(); }
+
+	private:
+		class D3D12CommandListBackend :
+			public Engine::CommandListBackend {
+		public:
+			void* CreateAllocator() override;
+			bool ResetAllocator(void* allocator) override;
+			void DestroyAllocator(void* allocator) override;
+			void* CreateCommandList(void* allocator) override;
+			bool ResetCommandList(void* commandList, void* allocator) override;
+			bool CloseCommandList(void* commandList) override;
+			void DestroyCommandList(void* commandList) override;
+			void ExecuteCommandLists(void* const* commandLists, uint32_t count) override;
+
+			Microsoft::WRL::ComPtr<ID3D12Device5> device;
+			CommandQueue* queue{ nullptr };
+			D3D12_COMMAND_LIST_TYPE type{ D3D12_COMMAND_LIST_TYPE_DIRECT };
+			std::vector<ID3D12CommandList*> executeBuffer;
+		};
+
+		D3D12CommandListBackend backend_;
+		Engine::CommandListPool pool_;
+	};
+
+}
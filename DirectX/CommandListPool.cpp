@@ -0,0 +1,250 @@
+#include "CommandListPool.h"
+
+#include "Assert.h"
+#include "SimulatedGPUQueue.h"
+
+namespace Engine {
+
+	CommandListPool::~CommandListPool() {
+		Finalize();
+	}
+
+	bool CommandListPool::Initalize(CommandListBackend* backend, GPUQueue* queue) {
+		if (!backend || !queue) {
+			ASSERT_MSG(false, "Backend and queue are required");
+			return false;
+		}
+		Finalize();
+		std::lock_guard<std::mutex> lock(mutex_);
+		backend_ = backend;
+		queue_ = queue;
+		allocatorReuseCount_ = 0;
+		commandListReuseCount_ = 0;
+		return true;
+	}
+
+	void CommandListPool::Finalize() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (!backend_) { return; }
+		// 積んだリストが終わるまではアロケータを破棄できない
+		if (!pendingAllocators_.empty()) {
+			queue_->WaitForValue(pendingAllocators_.back().fenceValue);
+		}
+		ASSERT_MSG(freeCommandLists_.size() == commandLists_.size(), "Command list acquired but not submitted");
+		for (void* commandList : commandLists_) { backend_->DestroyCommandList(commandList); }
+		for (void* allocator : allocators_) { backend_->DestroyAllocator(allocator); }
+		pendingAllocators_.clear();
+		readyAllocators_.clear();
+		freeCommandLists_.clear();
+		allocators_.clear();
+		commandLists_.clear();
+		backend_ = nullptr;
+		queue_ = nullptr;
+	}
+
+	CommandListPool::CommandContext CommandListPool::Acquire() {
+		CommandContext context{};
+		void* commandList = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			context.allocator = AcquireAllocator();
+			if (!context.allocator) { return {}; }
+			if (!freeCommandLists_.empty()) {
+				commandList = freeCommandLists_.back();
+				freeCommandLists_.pop_back();
+				++commandListReuseCount_;
+			}
+		}
+		if (commandList) {
+			// リセットはリストごとに独立しているのでロックの外で行う
+			if (!backend_->ResetCommandList(commandList, context.allocator)) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				freeCommandLists_.push_back(commandList);
+				readyAllocators_.push_back(context.allocator);
+				return {};
+			}
+		}
+		else {
+			commandList = backend_->CreateCommandList(context.allocator);
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (!commandList) {
+				readyAllocators_.push_back(context.allocator);
+				return {};
+			}
+			commandLists_.push_back(commandList);
+		}
+		context.commandList = commandList;
+		return context;
+	}
+
+	uint64_t CommandListPool::Submit(CommandContext* contexts, uint32_t count) {
+		submitBuffer_.clear();
+		for (uint32_t i = 0; i < count; ++i) {
+			ASSERT_MSG(contexts[i].IsEnabled(), "Submitting an invalid command context");
+			backend_->CloseCommandList(contexts[i].commandList);
+			submitBuffer_.push_back(contexts[i].commandList);
+		}
+		if (!submitBuffer_.empty()) {
+			backend_->ExecuteCommandLists(submitBuffer_.data(), static_cast<uint32_t>(submitBuffer_.size()));
+		}
+		uint64_t fenceValue = queue_->Signal();
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (uint32_t i = 0; i < count; ++i) {
+			pendingAllocators_.push_back(PendingAllocator{ contexts[i].allocator, fenceValue });
+			freeCommandLists_.push_back(contexts[i].commandList);
+			contexts[i] = {};
+		}
+		return fenceValue;
+	}
+
+	void CommandListPool::Discard(CommandContext& context) {
+		if (!context.IsEnabled()) { return; }
+		backend_->CloseCommandList(context.commandList);
+		std::lock_guard<std::mutex> lock(mutex_);
+		// 積んでいないのでアロケータはすぐに使える
+		readyAllocators_.push_back(context.allocator);
+		freeCommandLists_.push_back(context.commandList);
+		context = {};
+	}
+
+	CommandListPool::Statistics CommandListPool::GetStatistics() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		Statistics statistics{};
+		statistics.allocatorCount = static_cast<uint32_t>(allocators_.size());
+		statistics.commandListCount = static_cast<uint32_t>(commandLists_.size());
+		statistics.pendingAllocatorCount = static_cast<uint32_t>(pendingAllocators_.size());
+		statistics.allocatorReuseCount = allocatorReuseCount_;
+		statistics.commandListReuseCount = commandListReuseCount_;
+		return statistics;
+	}
+
+	void* CommandListPool::AcquireAllocator() {
+		if (!readyAllocators_.empty()) {
+			void* allocator = readyAllocators_.back();
+			readyAllocators_.pop_back();
+			++allocatorReuseCount_;
+			return allocator;
+		}
+		// 一番古いものだけを見る（それが終わっていなければ後ろも終わっていない）
+		if (!pendingAllocators_.empty() && queue_->IsCompleted(pendingAllocators_.front().fenceValue)) {
+			void* allocator = pendingAllocators_.front().allocator;
+			pendingAllocators_.pop_front();
+			if (backend_->ResetAllocator(allocator)) {
+				++allocatorReuseCount_;
+				return allocator;
+			}
+			// リセットできないものは使わない（Finalizeで破棄する）
+		}
+		void* allocator = backend_->CreateAllocator();
+		if (allocator) { allocators_.push_back(allocator); }
+		return allocator;
+	}
+
+	struct SimulatedCommandListBackend::Allocator {
+		// 記録したリストが終わるフェンス値
+		uint64_t fenceValue{ 0 };
+		// 記録中のリストの数
+		std::atomic<uint32_t> recordingCount{ 0 };
+	};
+
+	struct SimulatedCommandListBackend::CommandList {
+		Allocator* allocator{ nullptr };
+		bool isRecording{ false };
+		std::vector<uint32_t> commands;
+	};
+
+	SimulatedCommandListBackend::SimulatedCommandListBackend(SimulatedGPUQueue* queue, std::chrono::nanoseconds commandDuration) :
+		queue_(queue), commandDuration_(commandDuration) {
+	}
+
+	SimulatedCommandListBackend::~SimulatedCommandListBackend() {
+		ASSERT_MSG(allocatorCount_.load() == 0 && commandListCount_.load() == 0, "Simulated command objects leaked");
+	}
+
+	void* SimulatedCommandListBackend::CreateAllocator() {
+		allocatorCount_.fetch_add(1, std::memory_order_relaxed);
+		return new Allocator();
+	}
+
+	bool SimulatedCommandListBackend::ResetAllocator(void* allocator) {
+		Allocator* simulatedAllocator = static_cast<Allocator*>(allocator);
+		// GPUが使っている、または記録中のリストがある
+		if (!queue_->IsCompleted(simulatedAllocator->fenceValue) || simulatedAllocator->recordingCount.load(std::memory_order_relaxed) != 0) {
+			errorCount_.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		return true;
+	}
+
+	void SimulatedCommandListBackend::DestroyAllocator(void* allocator) {
+		Allocator* simulatedAllocator = static_cast<Allocator*>(allocator);
+		if (!queue_->IsCompleted(simulatedAllocator->fenceValue)) {
+			errorCount_.fetch_add(1, std::memory_order_relaxed);
+		}
+		delete simulatedAllocator;
+		allocatorCount_.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	void* SimulatedCommandListBackend::CreateCommandList(void* allocator) {
+		commandListCount_.fetch_add(1, std::memory_order_relaxed);
+		CommandList* commandList = new CommandList();
+		commandList->allocator = static_cast<Allocator*>(allocator);
+		commandList->isRecording = true;
+		commandList->allocator->recordingCount.fetch_add(1, std::memory_order_relaxed);
+		return commandList;
+	}
+
+	bool SimulatedCommandListBackend::ResetCommandList(void* commandList, void* allocator) {
+		CommandList* simulatedList = static_cast<CommandList*>(commandList);
+		if (simulatedList->isRecording) {
+			errorCount_.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		simulatedList->allocator = static_cast<Allocator*>(allocator);
+		simulatedList->isRecording = true;
+		simulatedList->commands.clear();
+		simulatedList->allocator->recordingCount.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool SimulatedCommandListBackend::CloseCommandList(void* commandList) {
+		CommandList* simulatedList = static_cast<CommandList*>(commandList);
+		if (!simulatedList->isRecording) {
+			errorCount_.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		simulatedList->isRecording = false;
+		simulatedList->allocator->recordingCount.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	void SimulatedCommandListBackend::DestroyCommandList(void* commandList) {
+		delete static_cast<CommandList*>(commandList);
+		commandListCount_.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	void SimulatedCommandListBackend::ExecuteCommandLists(void* const* commandLists, uint32_t count) {
+		// CommandListPool::Submitは積んだ直後にシグナルする
+		uint64_t fenceValue = queue_->GetLastSignaledValue() + 1;
+		size_t commandCount = 0;
+		++executeCount_;
+		for (uint32_t i = 0; i < count; ++i) {
+			CommandList* simulatedList = static_cast<CommandList*>(commandLists[i]);
+			if (simulatedList->isRecording) {
+				errorCount_.fetch_add(1, std::memory_order_relaxed);
+			}
+			simulatedList->allocator->fenceValue = fenceValue;
+			executedCommands_.insert(executedCommands_.end(), simulatedList->commands.begin(), simulatedList->commands.end());
+			commandCount += simulatedList->commands.size();
+		}
+		if (commandDuration_.count() > 0) {
+			queue_->Submit(commandDuration_ * static_cast<int64_t>(commandCount));
+		}
+	}
+
+	void SimulatedCommandListBackend::RecordCommand(void* commandList, uint32_t value) {
+		static_cast<CommandList*>(commandList)->commands.push_back(value);
+	}
+
+}
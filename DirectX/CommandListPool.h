@@ -0,0 +1,184 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "GPUQueue.h"
+
+namespace Engine {
+
+	class SimulatedGPUQueue;
+
+	// コマンドアロケータとコマンドリストを作る側（D3DではID3D12CommandAllocatorとID3D12GraphicsCommandList、テストでは模擬オブジェクト）
+	// Create、Reset、Closeは別々のオブジェクトなら複数のスレッドから同時に呼ばれる
+	class CommandListBackend {
+	public:
+		virtual ~CommandListBackend() = default;
+		/// <summary>
+		/// アロケータを作る
+		/// </summary>
+		/// <returns>作れない場合はnullptr</returns>
+		virtual void* CreateAllocator() = 0;
+		/// <summary>
+		/// アロケータのメモリを再利用する（GPUが使い終えてから呼ばれる）
+		/// </summary>
+		virtual bool ResetAllocator(void* allocator) = 0;
+		virtual void DestroyAllocator(void* allocator) = 0;
+		/// <summary>
+		/// allocatorに記録する状態のコマンドリストを作る
+		/// </summary>
+		/// <returns>作れない場合はnullptr</returns>
+		virtual void* CreateCommandList(void* allocator) = 0;
+		/// <summary>
+		/// 閉じたコマンドリストをallocatorに記録する状態に戻す
+		/// </summary>
+		virtual bool ResetCommandList(void* commandList, void* allocator) = 0;
+		virtual bool CloseCommandList(void* commandList) = 0;
+		virtual void DestroyCommandList(void* commandList) = 0;
+		/// <summary>
+		/// 閉じたコマンドリストを順にキューに積む
+		/// </summary>
+		virtual void ExecuteCommandLists(void* const* commandLists, uint32_t count) = 0;
+	};
+
+	// コマンドアロケータとコマンドリストを使い回すプール
+	// アロケータは積んだ後のフェンス値と一緒に戻し、GPUがその値を通過してから別の記録に渡す
+	// コマンドリストは積んだらすぐに別のアロケータで記録し直せるので、フェンスを待たずに使い回す
+	// Acquireは複数のスレッドから呼べる（Submitは積むキューを使うスレッドから呼ぶ）
+	class CommandListPool {
+	public:
+		// 記録一つ分（一つのスレッドだけが使う）
+		struct CommandContext {
+			void* commandList{ nullptr };
+			void* allocator{ nullptr };
+
+			bool IsEnabled() const { return commandList != nullptr; }
+		};
+
+		struct Statistics {
+			uint32_t allocatorCount;
+			uint32_t commandListCount;
+			// GPUの処理待ちで使えないアロケータの数
+			uint32_t pendingAllocatorCount;
+			// 作らずに使い回した回数
+			uint64_t allocatorReuseCount;
+			uint64_t commandListReuseCount;
+		};
+
+		CommandListPool() = default;
+		~CommandListPool();
+		CommandListPool(const CommandListPool&) = delete;
+		CommandListPool& operator=(const CommandListPool&) = delete;
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="backend">アロケータとリストを作る側（このクラスより長く生きること）</param>
+		/// <param name="queue">リストを積むキュー（このクラスより長く生きること）</param>
+		/// <returns></returns>
+		bool Initalize(CommandListBackend* backend, GPUQueue* queue);
+		/// <summary>
+		/// GPUを待ってからすべて破棄する
+		/// </summary>
+		void Finalize();
+
+		/// <summary>
+		/// 記録できる状態のコマンドリストを取る
+		/// </summary>
+		/// <returns>作れない場合は無効な記録</returns>
+		[[nodiscard]] CommandContext Acquire();
+		/// <summary>
+		/// 記録を閉じて、渡した順に1回で積み、フェンスをシグナルする
+		/// </summary>
+		/// <param name="contexts">Acquireで取った記録（積んだ後は無効になる）</param>
+		/// <param name="count"></param>
+		/// <returns>積んだリストが終わったら進むフェンス値</returns>
+		uint64_t Submit(CommandContext* contexts, uint32_t count);
+		/// <summary>
+		/// 積まずに返す（記録した内容は捨てる）
+		/// </summary>
+		void Discard(CommandContext& context);
+
+		Statistics GetStatistics() const;
+
+	private:
+		struct PendingAllocator {
+			void* allocator;
+			uint64_t fenceValue;
+		};
+
+		// 使えるアロケータを取る（mutex_を取った状態で呼ぶ）
+		void* AcquireAllocator();
+
+		mutable std::mutex mutex_;
+		CommandListBackend* backend_{ nullptr };
+		GPUQueue* queue_{ nullptr };
+		// フェンス値の順に並ぶ（Submitはフェンス値が増える順に呼ばれる）
+		std::deque<PendingAllocator> pendingAllocators_;
+		// すぐに使えるアロケータ（Discardで返したもの）
+		std::vector<void*> readyAllocators_;
+		// 閉じた状態のリスト
+		std::vector<void*> freeCommandLists_;
+		// 作ったすべて（破棄用）
+		std::vector<void*> allocators_;
+		std::vector<void*> commandLists_;
+		std::vector<void*> submitBuffer_;
+		uint64_t allocatorReuseCount_{ 0 };
+		uint64_t commandListReuseCount_{ 0 };
+	};
+
+	// 模擬のアロケータとリスト（D3Dの無い環境でのテストと計測用）
+	// リストに記録した値をExecuteCommandListsで順に残し、SimulatedGPUQueueに記録したコマンド数に応じた処理を積む
+	// GPUが使っている間にアロケータをリセットするなどの誤った使い方を数える
+	class SimulatedCommandListBackend :
+		public CommandListBackend {
+	public:
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="queue">リストを積む模擬GPU</param>
+		/// <param name="commandDuration">記録したコマンド一つあたりのGPUの処理時間</param>
+		explicit SimulatedCommandListBackend(SimulatedGPUQueue* queue, std::chrono::nanoseconds commandDuration = std::chrono::nanoseconds(0));
+		~SimulatedCommandListBackend();
+
+		void* CreateAllocator() override;
+		bool ResetAllocator(void* allocator) override;
+		void DestroyAllocator(void* allocator) override;
+		void* CreateCommandList(void* allocator) override;
+		bool ResetCommandList(void* commandList, void* allocator) override;
+		bool CloseCommandList(void* commandList) override;
+		void DestroyCommandList(void* commandList) override;
+		void ExecuteCommandLists(void* const* commandLists, uint32_t count) override;
+
+		/// <summary>
+		/// コマンドを記録する（値はExecuteCommandLists後にGetExecutedCommandsで読める）
+		/// </summary>
+		static void RecordCommand(void* commandList, uint32_t value);
+
+		// 積んだ順に並んだ記録済みの値
+		const std::vector<uint32_t>& GetExecutedCommands() const { return executedCommands_; }
+		void ClearExecutedCommands() { executedCommands_.clear(); }
+		// ExecuteCommandListsを呼んだ回数
+		uint32_t GetExecuteCount() const { return executeCount_; }
+		// 誤った使い方の回数
+		uint32_t GetErrorCount() const { return errorCount_.load(std::memory_order_relaxed); }
+		uint32_t GetAllocatorCount() const { return allocatorCount_.load(std::memory_order_relaxed); }
+		uint32_t GetCommandListCount() const { return commandListCount_.load(std::memory_order_relaxed); }
+
+	private:
+		struct Allocator;
+		struct CommandList;
+
+		SimulatedGPUQueue* queue_;
+		std::chrono::nanoseconds commandDuration_;
+		std::vector<uint32_t> executedCommands_;
+		uint32_t executeCount_{ 0 };
+		std::atomic<uint32_t> errorCount_{ 0 };
+		std::atomic<uint32_t> allocatorCount_{ 0 };
+		std::atomic<uint32_t> commandListCount_{ 0 };
+	};
+
+}
@@ -0,0 +1,53 @@
+#include "stdafx.h"
+#include "CommandQueue.h"
+#include "Logger.h"
+
+namespace DirectXHelper {
+
+	bool CommandQueue::Initalize(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type) {
+		assert(device);
+
+		D3D12_COMMAND_QUEUE_DESC desc{};
+		desc.Type = type;
+		if (FAILED(device->CreateCommandQueue(&desc, IID_PPV_ARGS(commandQueue_.ReleaseAndGetAddressOf())))) {
+			Logger::Error("CreateCommandQueue()");
+			assert(false);
+			return false;
+		}
+		return fence_.Initalize(device);
+	}
+
+	void CommandQueue::ExecuteCommandLists(uint32_t count, ID3D12CommandList* const* commandLists) {
+		commandQueue_->ExecuteCommandLists(count, commandLists);
+	}
+
+	uint64_t CommandQueue::Signal() {
+		fence_.Signal(commandQueue_.Get());
+		return fence_.GetLastSignaledValue();
+	}
+
+	uint64_t CommandQueue::GetCompletedValue() {
+		return fence_.GetCompletedValue();
+	}
+
+	bool CommandQueue::WaitForValue(uint64_t value) {
+		return fence_.Wait(value);
+	}
+
+	bool CommandQueue::WaitOnQueue(Engine::GPUQueue& queue, uint64_t value) {
+		CommandQueue* waitQueue = dynamic_cast<CommandQueue*>(&queue);
+		if (!waitQueue) {
+			Logger::Error("CommandQueue::WaitOnQueue() requires a CommandQueue");
+			assert(false);
+			return false;
+		}
+		if (waitQueue == this) { return true; }
+		if (FAILED(commandQueue_->Wait(waitQueue->GetFence(), value))) {
+			Logger::Error("ID3D12CommandQueue::Wait()");
+			assert(false);
+			return false;
+		}
+		return true;
+	}
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "Fence.h"
+#include "GPUQueue.h"
+
+namespace DirectXHelper {
+	using namespace Microsoft::WRL;
+
+	// ID3D12CommandQueueとそのフェンス
+	class CommandQueue :
+		public Engine::GPUQueue {
+	public:
+		CommandQueue() = default;
+		DELETE_COPY_MOVE(CommandQueue);
+
+		bool Initalize(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type = D3D12_COMMAND_LIST_TYPE_DIRECT);
+
+		/// <summary>
+		/// コマンドリストを実行する
+		/// </summary>
+		void ExecuteCommandLists(uint32_t count, ID3D12CommandList* const* commandLists);
+
+		uint64_t Signal() override;
+		uint64_t GetCompletedValue() override;
+		bool WaitForValue(uint64_t value) override;
+		uint64_t GetLastSignaledValue() const override { return fence_.GetLastSignaledValue(); }
+		bool WaitOnQueue(Engine::GPUQueue& queue, uint64_t value) override;
+		Engine::TimelineFence& GetTimelineFence() override { return fence_; }
+
+		ID3D12CommandQueue* Get() const { return commandQueue_.Get(); }
+		ID3D12Fence* GetFence() const { return fence_.Get(); }
+
+	private:
+		ComPtr<ID3D12CommandQueue> commandQueue_;
+		Fence fence_;
+	};
+
+}
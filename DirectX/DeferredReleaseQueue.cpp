@@ -0,0 +1,165 @@
+#include "DeferredReleaseQueue.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "Assert.h"
+
+namespace Engine {
+
+	DeferredReleaseQueue::~DeferredReleaseQueue() {
+		ASSERT_MSG(entries_.empty() && frameEntries_.empty(), "DeferredReleaseQueue destroyed without Flush");
+	}
+
+	bool DeferredReleaseQueue::Initalize(GPUQueue* queue, uint32_t destroyBudget) {
+		return Initalize({ queue }, destroyBudget);
+	}
+
+	bool DeferredReleaseQueue::Initalize(std::initializer_list<GPUQueue*> queues, uint32_t destroyBudget) {
+		if (queues.size() == 0 || queues.size() > kMaxQueueCount) {
+			ASSERT_MSG(false, "Invalid queue count");
+			return false;
+		}
+		for (GPUQueue* queue : queues) {
+			if (!queue) {
+				ASSERT_MSG(false, "Queue is null");
+				return false;
+			}
+		}
+		std::lock_guard<std::mutex> lock(mutex_);
+		ASSERT_MSG(entries_.empty() && frameEntries_.empty(), "Initalize called with pending objects");
+		queueCount_ = 0;
+		for (GPUQueue* queue : queues) {
+			queues_[queueCount_++] = queue;
+		}
+		destroyBudget_ = destroyBudget;
+		statistics_ = {};
+		return true;
+	}
+
+	void DeferredReleaseQueue::Release(void* object, DestroyFunction destroy) {
+		if (!object) { return; }
+		// 記録中のコマンドはフレームの途中のシグナルより後に積まれることがあるので、EndFrameまで値を決めない
+		std::lock_guard<std::mutex> lock(mutex_);
+		frameEntries_.push_back(Entry{ {}, object, destroy });
+		++statistics_.releaseCount;
+		statistics_.maxPendingCount = std::max(statistics_.maxPendingCount, static_cast<uint32_t>(entries_.size() + frameEntries_.size()));
+	}
+
+	void DeferredReleaseQueue::Release(void* object, DestroyFunction destroy, uint64_t fenceValue) {
+		if (!object) { return; }
+		Entry entry{ {}, object, destroy };
+		entry.fenceValues[0] = fenceValue;
+		for (uint32_t i = 1; i < queueCount_; ++i) {
+			entry.fenceValues[i] = queues_[i]->GetLastSignaledValue() + 1;
+		}
+		std::lock_guard<std::mutex> lock(mutex_);
+		Push(entry);
+		++statistics_.releaseCount;
+		statistics_.maxPendingCount = std::max(statistics_.maxPendingCount, static_cast<uint32_t>(entries_.size() + frameEntries_.size()));
+	}
+
+	void DeferredReleaseQueue::EndFrame(uint64_t fenceValue) {
+		uint64_t fenceValues[kMaxQueueCount]{ fenceValue };
+		for (uint32_t i = 1; i < queueCount_; ++i) {
+			fenceValues[i] = queues_[i]->GetLastSignaledValue() + 1;
+		}
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (Entry& entry : frameEntries_) {
+			std::copy(std::begin(fenceValues), std::end(fenceValues), entry.fenceValues);
+			Push(entry);
+		}
+		frameEntries_.clear();
+	}
+
+	void DeferredReleaseQueue::Push(Entry entry) {
+		// 遅く破棄する分には問題ないので、順を保つために前の値に揃える
+		if (!entries_.empty()) {
+			for (uint32_t i = 0; i < queueCount_; ++i) {
+				entry.fenceValues[i] = std::max(entry.fenceValues[i], entries_.back().fenceValues[i]);
+			}
+		}
+		entries_.push_back(entry);
+	}
+
+	uint32_t DeferredReleaseQueue::Process() {
+		uint64_t completedValues[kMaxQueueCount]{};
+		for (uint32_t i = 0; i < queueCount_; ++i) {
+			completedValues[i] = queues_[i]->GetCompletedValue();
+		}
+		return Destroy(completedValues, destroyBudget_);
+	}
+
+	void DeferredReleaseQueue::Flush() {
+		// フレームの途中で終わる場合は、ここまでに積んだコマンドの後を待つ
+		if (queueCount_ != 0) {
+			EndFrame(queues_[0]->GetLastSignaledValue() + 1);
+		}
+		uint64_t fenceValues[kMaxQueueCount]{};
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (entries_.empty()) { return; }
+			std::copy(std::begin(entries_.back().fenceValues), std::end(entries_.back().fenceValues), fenceValues);
+		}
+		for (uint32_t i = 0; i < queueCount_; ++i) {
+			GPUQueue* queue = queues_[i];
+			if (queue->IsCompleted(fenceValues[i])) { continue; }
+			// まだ積んでいない値を待つ場合は、ここまでの分をシグナルして待つ
+			if (fenceValues[i] > queue->GetLastSignaledValue()) {
+				queue->WaitForIdle();
+			}
+			else {
+				queue->WaitForValue(fenceValues[i]);
+			}
+		}
+		Destroy(fenceValues, 0);
+	}
+
+	uint32_t DeferredReleaseQueue::GetPendingCount() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return static_cast<uint32_t>(entries_.size() + frameEntries_.size());
+	}
+
+	DeferredReleaseQueue::Statistics DeferredReleaseQueue::GetStatistics() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		Statistics statistics = statistics_;
+		statistics.pendingCount = static_cast<uint32_t>(entries_.size() + frameEntries_.size());
+		return statistics;
+	}
+
+	bool DeferredReleaseQueue::IsCompleted(const Entry& entry, const uint64_t* completedValues) const {
+		for (uint32_t i = 0; i < queueCount_; ++i) {
+			if (entry.fenceValues[i] > completedValues[i]) { return false; }
+		}
+		return true;
+	}
+
+	uint32_t DeferredReleaseQueue::Destroy(const uint64_t* completedValues, uint32_t budget) {
+		std::vector<Entry> destroyBuffer;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (entries_.empty() || !IsCompleted(entries_.front(), completedValues)) { return 0; }
+			destroyBuffer.swap(destroyBuffer_);
+			while (!entries_.empty() && IsCompleted(entries_.front(), completedValues)) {
+				if (budget != 0 && destroyBuffer.size() >= budget) {
+					++statistics_.budgetLimitedCount;
+					break;
+				}
+				destroyBuffer.push_back(entries_.front());
+				entries_.pop_front();
+			}
+		}
+		// 破棄の中から預けてもよいように、ロックの外で呼ぶ
+		for (const Entry& entry : destroyBuffer) {
+			entry.destroy(entry.object);
+		}
+		uint32_t destroyCount = static_cast<uint32_t>(destroyBuffer.size());
+		destroyBuffer.clear();
+		std::lock_guard<std::mutex> lock(mutex_);
+		statistics_.destroyCount += destroyCount;
+		statistics_.maxDestroyCount = std::max(statistics_.maxDestroyCount, destroyCount);
+		if (destroyBuffer_.empty()) { destroyBuffer_.swap(destroyBuffer); }
+		return destroyCount;
+	}
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <mutex>
+#include <vector>
+
+#include "GPUQueue.h"
+
+namespace Engine {
+
+	// GPUが使っているかもしれないオブジェクトを、キューがフェンス値を通過するまで預かってから破棄する
+	// ・Releaseはフレームの分として預かり、EndFrameでそのフレームのフェンス値を付ける
+	//   （フレームの途中でも同じキューにシグナルされるので、次のシグナルでは記録中のコマンドが終わっていない）
+	// ・Processで通過した値の分をまとめて破棄する（1回に破棄する数の上限を決めると、残りは次のフレームに回す）
+	// 預ける順にフェンス値は増えるので、先頭から見るだけでよい
+	// 複数のキューで使うもの（グラフィックスとコンピュートなど）は、すべてのキューが通過するまで待つ
+	// D3DではDirectXHelper::DeferredReleaseでComPtrを預ける
+	class DeferredReleaseQueue {
+	public:
+		using DestroyFunction = void(*)(void* object);
+		// 待てるキューの数
+		static constexpr uint32_t kMaxQueueCount = 2;
+
+		struct Statistics {
+			uint64_t releaseCount;
+			uint64_t destroyCount;
+			// 上限に達して次に回したProcessの回数
+			uint64_t budgetLimitedCount;
+			uint32_t pendingCount;
+			uint32_t maxPendingCount;
+			// 1回のProcessで破棄した数の最大
+			uint32_t maxDestroyCount;
+		};
+
+		DeferredReleaseQueue() = default;
+		~DeferredReleaseQueue();
+		DeferredReleaseQueue(const DeferredReleaseQueue&) = delete;
+		DeferredReleaseQueue& operator=(const DeferredReleaseQueue&) = delete;
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="queue">オブジェクトを使うコマンドを積むキュー</param>
+		/// <param name="destroyBudget">1回のProcessで破棄する数の上限（0なら上限なし）</param>
+		/// <returns></returns>
+		bool Initalize(GPUQueue* queue, uint32_t destroyBudget = 0);
+		/// <summary>
+		/// 複数のキューで初期化（すべてのキューが通過してから破棄する）
+		/// </summary>
+		/// <param name="queues">オブジェクトを使うコマンドを積むキュー（kMaxQueueCountまで）</param>
+		/// <param name="destroyBudget">1回のProcessで破棄する数の上限（0なら上限なし）</param>
+		/// <returns></returns>
+		bool Initalize(std::initializer_list<GPUQueue*> queues, uint32_t destroyBudget = 0);
+
+		/// <summary>
+		/// オブジェクトを預ける（複数のスレッドから呼べる）
+		/// 次のEndFrameのフェンス値を通過するまで破棄しない
+		/// </summary>
+		/// <param name="object">nullptrなら何もしない</param>
+		/// <param name="destroy">GPUが通過したら呼ぶ</param>
+		void Release(void* object, DestroyFunction destroy);
+		/// <summary>
+		/// 最初のキューのフェンス値を指定して預ける（前に預けた値より小さければ、その値まで待つ）
+		/// 他のキューは次に積まれる値まで待つ
+		/// </summary>
+		void Release(void* object, DestroyFunction destroy, uint64_t fenceValue);
+		/// <summary>
+		/// フレームの終了
+		/// このフレームで預けたものに、最初のキューはfenceValue、他のキューは次に積まれる値を付ける
+		/// </summary>
+		/// <param name="fenceValue">このフレームのコマンドの後にシグナルしたフェンス値</param>
+		void EndFrame(uint64_t fenceValue);
+		/// <summary>
+		/// GPUが通過したものを破棄する（フレームの始めに呼ぶ、待たない）
+		/// </summary>
+		/// <returns>破棄した数</returns>
+		uint32_t Process();
+		/// <summary>
+		/// 預けたものがすべて終わるまで待ってから、上限に関係なくすべて破棄する（終了時）
+		/// </summary>
+		void Flush();
+
+		void SetDestroyBudget(uint32_t destroyBudget) { destroyBudget_ = destroyBudget; }
+		uint32_t GetDestroyBudget() const { return destroyBudget_; }
+		uint32_t GetPendingCount() const;
+		Statistics GetStatistics() const;
+
+	private:
+		struct Entry {
+			// キューごとのフェンス値
+			uint64_t fenceValues[kMaxQueueCount];
+			void* object;
+			DestroyFunction destroy;
+		};
+
+		// entriesの後ろに足す（順を保つために前の値に揃える、ロックして呼ぶ）
+		void Push(Entry entry);
+		// すべてのキューがcompletedValues以下の分をbudgetまで取り出して破棄する
+		uint32_t Destroy(const uint64_t* completedValues, uint32_t budget);
+		bool IsCompleted(const Entry& entry, const uint64_t* completedValues) const;
+
+		GPUQueue* queues_[kMaxQueueCount]{};
+		uint32_t queueCount_{ 0 };
+		uint32_t destroyBudget_{ 0 };
+		mutable std::mutex mutex_;
+		// フェンス値の順
+		std::deque<Entry> entries_;
+		// このフレームで預けた、まだフェンス値が決まっていないもの
+		std::vector<Entry> frameEntries_;
+		// 破棄する分（ロックの外で呼ぶ、使い回す）
+		std::vector<Entry> destroyBuffer_;
+		Statistics statistics_{};
+	};
+
+}
@@ -0,0 +1,199 @@
+#include "DescriptorAllocator.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "Assert.h"
+
+namespace Engine {
+
+	bool DescriptorAllocator::Initalize(uint32_t capacity) {
+		if (capacity == 0 || capacity > kMaxCapacity) {
+			ASSERT_MSG(false, "Invalid capacity");
+			return false;
+		}
+		capacity_ = capacity;
+		blocks_.assign(capacity, Block{});
+		Reset();
+		return true;
+	}
+
+	uint32_t DescriptorAllocator::Allocate(uint32_t count) {
+		ASSERT_MSG(count > 0, "Zero size allocation");
+		if (count == 0 || count > capacity_ - usedCount_) { return kInvalidIndex; }
+
+		uint32_t firstLevel = 0, secondLevel = 0;
+		MappingSearch(count, firstLevel, secondLevel);
+		uint32_t index = FindFreeBlock(firstLevel, secondLevel);
+		if (index == kInvalidIndex) { return kInvalidIndex; }
+		RemoveFreeBlock(index);
+
+		Block& block = blocks_[index];
+		// 余った後ろ側を空きとして戻す
+		if (block.size > count) {
+			uint32_t restIndex = index + count;
+			Block& rest = blocks_[restIndex];
+			rest.size = block.size - count;
+			rest.prevPhysical = index;
+			rest.isFree = true;
+			uint32_t nextIndex = restIndex + rest.size;
+			if (nextIndex < capacity_) {
+				blocks_[nextIndex].prevPhysical = restIndex;
+			}
+			block.size = count;
+			InsertFreeBlock(restIndex);
+		}
+		block.isFree = false;
+		usedCount_ += count;
+		++allocationCount_;
+		return index;
+	}
+
+	bool DescriptorAllocator::Deallocate(uint32_t index) {
+		if (!IsAllocated(index)) {
+			ASSERT_MSG(false, "Deallocated a slot that is not allocated (double free?)");
+			return false;
+		}
+		Block* block = &blocks_[index];
+		usedCount_ -= block->size;
+		--allocationCount_;
+		block->isFree = true;
+
+		// 後ろの空きと結合
+		uint32_t nextIndex = index + block->size;
+		if (nextIndex < capacity_ && blocks_[nextIndex].isFree) {
+			RemoveFreeBlock(nextIndex);
+			block->size += blocks_[nextIndex].size;
+			blocks_[nextIndex] = Block{};
+		}
+		// 前の空きと結合
+		if (block->prevPhysical != kInvalidIndex && blocks_[block->prevPhysical].isFree) {
+			uint32_t prevIndex = block->prevPhysical;
+			RemoveFreeBlock(prevIndex);
+			blocks_[prevIndex].size += block->size;
+			*block = Block{};
+			index = prevIndex;
+			block = &blocks_[index];
+		}
+		nextIndex = index + block->size;
+		if (nextIndex < capacity_) {
+			blocks_[nextIndex].prevPhysical = index;
+		}
+		InsertFreeBlock(index);
+		return true;
+	}
+
+	void DescriptorAllocator::Reset() {
+		std::fill(blocks_.begin(), blocks_.end(), Block{});
+		std::fill(&freeHeads_[0][0], &freeHeads_[0][0] + kFirstLevelCount * kSecondLevelCount, kInvalidIndex);
+		std::fill(std::begin(secondLevelBitmaps_), std::end(secondLevelBitmaps_), 0u);
+		firstLevelBitmap_ = 0;
+		usedCount_ = 0;
+		allocationCount_ = 0;
+		if (capacity_ == 0) { return; }
+
+		Block& block = blocks_[0];
+		block.size = capacity_;
+		block.prevPhysical = kInvalidIndex;
+		block.isFree = true;
+		InsertFreeBlock(0);
+	}
+
+	bool DescriptorAllocator::IsAllocated(uint32_t index) const {
+		return index < capacity_ && blocks_[index].size != 0 && !blocks_[index].isFree;
+	}
+
+	uint32_t DescriptorAllocator::GetAllocationSize(uint32_t index) const {
+		return IsAllocated(index) ? blocks_[index].size : 0;
+	}
+
+	DescriptorAllocator::Statistics DescriptorAllocator::GetStatistics() const {
+		Statistics statistics{};
+		statistics.capacity = capacity_;
+		statistics.usedCount = usedCount_;
+		statistics.allocationCount = allocationCount_;
+		for (uint32_t firstLevel = 0; firstLevel < kFirstLevelCount; ++firstLevel) {
+			for (uint32_t secondLevel = 0; secondLevel < kSecondLevelCount; ++secondLevel) {
+				for (uint32_t index = freeHeads_[firstLevel][secondLevel]; index != kInvalidIndex; index = blocks_[index].nextFree) {
+					++statistics.freeBlockCount;
+					statistics.largestFreeBlock = std::max(statistics.largestFreeBlock, blocks_[index].size);
+				}
+			}
+		}
+		uint32_t freeCount = capacity_ - usedCount_;
+		statistics.fragmentation = freeCount > 0 ? 1.0f - static_cast<float>(statistics.largestFreeBlock) / static_cast<float>(freeCount) : 0.0f;
+		return statistics;
+	}
+
+	void DescriptorAllocator::Mapping(uint32_t size, uint32_t& firstLevel, uint32_t& secondLevel) {
+		// 小さい範囲は一段目を使わずに大きさごとに分ける
+		if (size < kSecondLevelCount) {
+			firstLevel = 0;
+			secondLevel = size;
+			return;
+		}
+		uint32_t log2 = static_cast<uint32_t>(std::bit_width(size)) - 1;
+		firstLevel = log2 - kSecondLevelLog2 + 1;
+		secondLevel = (size >> (log2 - kSecondLevelLog2)) - kSecondLevelCount;
+	}
+
+	void DescriptorAllocator::MappingSearch(uint32_t size, uint32_t& firstLevel, uint32_t& secondLevel) {
+		if (size >= kSecondLevelCount) {
+			uint32_t log2 = static_cast<uint32_t>(std::bit_width(size)) - 1;
+			size += (1u << (log2 - kSecondLevelLog2)) - 1;
+		}
+		Mapping(size, firstLevel, secondLevel);
+	}
+
+	uint32_t DescriptorAllocator::FindFreeBlock(uint32_t firstLevel, uint32_t secondLevel) const {
+		uint32_t secondLevelMap = secondLevelBitmaps_[firstLevel] & (~0u << secondLevel);
+		if (secondLevelMap == 0) {
+			// 同じ段に無ければ一段上の空きを使う
+			uint32_t firstLevelMap = firstLevel + 1 < kFirstLevelCount ? firstLevelBitmap_ & (~0u << (firstLevel + 1)) : 0;
+			if (firstLevelMap == 0) { return kInvalidIndex; }
+			firstLevel = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+			secondLevelMap = secondLevelBitmaps_[firstLevel];
+		}
+		secondLevel = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+		return freeHeads_[firstLevel][secondLevel];
+	}
+
+	void DescriptorAllocator::InsertFreeBlock(uint32_t index) {
+		Block& block = blocks_[index];
+		uint32_t firstLevel = 0, secondLevel = 0;
+		Mapping(block.size, firstLevel, secondLevel);
+		uint32_t& head = freeHeads_[firstLevel][secondLevel];
+		block.prevFree = kInvalidIndex;
+		block.nextFree = head;
+		if (head != kInvalidIndex) {
+			blocks_[head].prevFree = index;
+		}
+		head = index;
+		firstLevelBitmap_ |= 1u << firstLevel;
+		secondLevelBitmaps_[firstLevel] |= 1u << secondLevel;
+	}
+
+	void DescriptorAllocator::RemoveFreeBlock(uint32_t index) {
+		Block& block = blocks_[index];
+		uint32_t firstLevel = 0, secondLevel = 0;
+		Mapping(block.size, firstLevel, secondLevel);
+		if (block.prevFree != kInvalidIndex) {
+			blocks_[block.prevFree].nextFree = block.nextFree;
+		}
+		else {
+			freeHeads_[firstLevel][secondLevel] = block.nextFree;
+			if (block.nextFree == kInvalidIndex) {
+				secondLevelBitmaps_[firstLevel] &= ~(1u << secondLevel);
+				if (secondLevelBitmaps_[firstLevel] == 0) {
+					firstLevelBitmap_ &= ~(1u << firstLevel);
+				}
+			}
+		}
+		if (block.nextFree != kInvalidIndex) {
+			blocks_[block.nextFree].prevFree = block.prevFree;
+		}
+		block.nextFree = kInvalidIndex;
+		block.prevFree = kInvalidIndex;
+	}
+
+}
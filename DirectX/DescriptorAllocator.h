@@ -0,0 +1,114 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+	// ディスクリプタヒープの中の位置（スロット番号）を管理する
+	// D3Dに依存しないので、ヒープ本体はDirectXHelper::DescriptorHeapが持つ
+	// TLSF（二段の大きさ別フリーリスト）で確保、解放ともにO(1)、連続した範囲も確保できる
+	// 解放した範囲は前後の空きと結合する
+	class DescriptorAllocator {
+	public:
+		// 確保できなかった場合の戻り値
+		static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+		// 扱えるスロット数の上限
+		static constexpr uint32_t kMaxCapacity = 1u << 30;
+
+		struct Statistics {
+			uint32_t capacity;
+			// 確保中のスロット数
+			uint32_t usedCount;
+			// 確保中の範囲の数
+			uint32_t allocationCount;
+			// 空きの範囲の数
+			uint32_t freeBlockCount;
+			// 一度に確保できる最大のスロット数
+			uint32_t largestFreeBlock;
+			// 1 - 最大の空き / 空きの合計（0なら空きが一か所にまとまっている）
+			float fragmentation;
+		};
+
+		/// <summary>
+		/// 初期化（すべて空きになる）
+		/// </summary>
+		/// <param name="capacity">スロット数</param>
+		/// <returns></returns>
+		bool Initalize(uint32_t capacity);
+		/// <summary>
+		/// 連続したスロットを確保
+		/// </summary>
+		/// <param name="count">スロット数</param>
+		/// <returns>先頭のスロット、確保できない場合はkInvalidIndex</returns>
+		[[nodiscard]] uint32_t Allocate(uint32_t count = 1);
+		/// <summary>
+		/// Allocateで確保したスロットを解放
+		/// </summary>
+		/// <param name="index">Allocateの戻り値</param>
+		/// <returns>確保されていない位置（二重解放など）の場合はfalse</returns>
+		bool Deallocate(uint32_t index);
+		/// <summary>
+		/// すべて解放する
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// Allocateの戻り値として確保中か
+		/// </summary>
+		/// <param name="index"></param>
+		/// <returns></returns>
+		bool IsAllocated(uint32_t index) const;
+		/// <summary>
+		/// 確保した範囲のスロット数
+		/// </summary>
+		/// <param name="index">Allocateの戻り値</param>
+		/// <returns>確保されていない場合は0</returns>
+		uint32_t GetAllocationSize(uint32_t index) const;
+		/// <summary>
+		/// 使用状況（空きのリストをたどるのでデバッグ表示用）
+		/// </summary>
+		/// <returns></returns>
+		Statistics GetStatistics() const;
+
+		uint32_t GetCapacity() const { return capacity_; }
+		uint32_t GetUsedCount() const { return usedCount_; }
+		uint32_t GetFreeCount() const { return capacity_ - usedCount_; }
+
+	private:
+		// 二段目の分割数は2^kSecondLevelLog2
+		static constexpr uint32_t kSecondLevelLog2 = 4;
+		static constexpr uint32_t kSecondLevelCount = 1u << kSecondLevelLog2;
+		static constexpr uint32_t kFirstLevelCount = 32;
+
+		// 先頭のスロットの位置に置く範囲の情報
+		// 範囲の先頭以外はsize == 0
+		struct Block {
+			uint32_t size;
+			// 直前の範囲の先頭
+			uint32_t prevPhysical;
+			// 同じ大きさの空きのリスト
+			uint32_t nextFree;
+			uint32_t prevFree;
+			bool isFree;
+		};
+
+		// 大きさからフリーリストの位置を求める
+		static void Mapping(uint32_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+		// 見つかった空きが必ずsize以上になるように切り上げてから求める
+		static void MappingSearch(uint32_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+
+		uint32_t FindFreeBlock(uint32_t firstLevel, uint32_t secondLevel) const;
+		void InsertFreeBlock(uint32_t index);
+		void RemoveFreeBlock(uint32_t index);
+
+		std::vector<Block> blocks_;
+		uint32_t freeHeads_[kFirstLevelCount][kSecondLevelCount]{};
+		uint32_t firstLevelBitmap_{};
+		uint32_t secondLevelBitmaps_[kFirstLevelCount]{};
+		uint32_t capacity_{};
+		uint32_t usedCount_{};
+		uint32_t allocationCount_{};
+	};
+
+}
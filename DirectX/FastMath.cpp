@@ -0,0 +1,92 @@
+#include "FastMath.h"
+
+namespace Math {
+
+	void FastSin(const float* x, float* results, size_t count) {
+		size_t i = 0;
+#ifdef MATH_SIMD_SSE2
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(results + i, FastSin(_mm_loadu_ps(x + i)));
+		}
+#endif // MATH_SIMD_SSE2
+		for (; i < count; ++i) {
+			results[i] = FastSin(x[i]);
+		}
+	}
+
+	void FastCos(const float* x, float* results, size_t count) {
+		size_t i = 0;
+#ifdef MATH_SIMD_SSE2
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(results + i, FastCos(_mm_loadu_ps(x + i)));
+		}
+#endif // MATH_SIMD_SSE2
+		for (; i < count; ++i) {
+			results[i] = FastCos(x[i]);
+		}
+	}
+
+	void FastSinCos(const float* x, float* s, float* c, size_t count) {
+		size_t i = 0;
+#ifdef MATH_SIMD_SSE2
+		for (; i + 4 <= count; i += 4) {
+			__m128 sin, cos;
+			FastSinCos(_mm_loadu_ps(x + i), sin, cos);
+			_mm_storeu_ps(s + i, sin);
+			_mm_storeu_ps(c + i, cos);
+		}
+#endif // MATH_SIMD_SSE2
+		for (; i < count; ++i) {
+			FastSinCos(x[i], s[i], c[i]);
+		}
+	}
+
+	void FastAtan2(const float* y, const float* x, float* results, size_t count) {
+		size_t i = 0;
+#ifdef MATH_SIMD_SSE2
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(results + i, FastAtan2(_mm_loadu_ps(y + i), _mm_loadu_ps(x + i)));
+		}
+#endif // MATH_SIMD_SSE2
+		for (; i < count; ++i) {
+			results[i] = FastAtan2(y[i], x[i]);
+		}
+	}
+
+	void FastAcos(const float* x, float* results, size_t count) {
+		size_t i = 0;
+#ifdef MATH_SIMD_SSE2
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(results + i, FastAcos(_mm_loadu_ps(x + i)));
+		}
+#endif // MATH_SIMD_SSE2
+		for (; i < count; ++i) {
+			results[i] = FastAcos(x[i]);
+		}
+	}
+
+	void FastRsqrt(const float* x, float* results, size_t count) {
+		size_t i = 0;
+#ifdef MATH_SIMD_SSE2
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(results + i, FastRsqrt(_mm_loadu_ps(x + i)));
+		}
+#endif // MATH_SIMD_SSE2
+		for (; i < count; ++i) {
+			results[i] = FastRsqrt(x[i]);
+		}
+	}
+
+	void FastExp(const float* x, float* results, size_t count) {
+		size_t i = 0;
+#ifdef MATH_SIMD_SSE2
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(results + i, FastExp(_mm_loadu_ps(x + i)));
+		}
+#endif // MATH_SIMD_SSE2
+		for (; i < count; ++i) {
+			results[i] = FastExp(x[i]);
+		}
+	}
+
+}
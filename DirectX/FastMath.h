@@ -0,0 +1,101 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "MathSIMD.h"
+
+// ループの中で使う近似の超越関数
+// std:: と比べた最大誤差は各関数のコメントに書いた範囲で計測したもの
+// HLSL側は Resource/Shader/FastMath.hlsli に同じ係数で実装してある
+
+namespace Math {
+
+	// FastSin/FastCos/FastSinCosの最大絶対誤差（|x| <= FastTrigRange）
+	constexpr float FastTrigMaxError = 1.2e-7f;
+	// FastSin/FastCos/FastSinCosの精度を保証する範囲
+	constexpr float FastTrigRange = 8192.0f;
+	// FastAtan2の最大絶対誤差（ラジアン）
+	constexpr float FastAtan2MaxError = 3.6e-7f;
+	// FastAcosの最大絶対誤差（ラジアン）
+	constexpr float FastAcosMaxError = 4.8e-7f;
+	// FastRsqrtの最大相対誤差
+	constexpr float FastRsqrtMaxError = 4.0e-7f;
+	// FastExpの最大相対誤差（FastExpMin <= x <= FastExpMax）
+	constexpr float FastExpMaxError = 1.2e-7f;
+	// FastExpの入力の下限（これより小さい場合はこの値として計算する）
+	constexpr float FastExpMin = -87.33654f;
+	// FastExpの入力の上限（これより大きい場合はこの値として計算する）
+	constexpr float FastExpMax = 88.72283f;
+
+	/// <summary>
+	/// 近似sin
+	/// </summary>
+	/// <param name="x">ラジアン</param>
+	/// <returns></returns>
+	inline float FastSin(float x);
+	/// <summary>
+	/// 近似cos
+	/// </summary>
+	/// <param name="x">ラジアン</param>
+	/// <returns></returns>
+	inline float FastCos(float x);
+	/// <summary>
+	/// 近似sinとcosを同時に計算
+	/// </summary>
+	/// <param name="x">ラジアン</param>
+	/// <param name="s">sin</param>
+	/// <param name="c">cos</param>
+	inline void FastSinCos(float x, float& s, float& c);
+	/// <summary>
+	/// 近似atan2
+	/// </summary>
+	/// <param name="y"></param>
+	/// <param name="x"></param>
+	/// <returns>-π~π（両方0の場合は0）</returns>
+	inline float FastAtan2(float y, float x);
+	/// <summary>
+	/// 近似acos
+	/// </summary>
+	/// <param name="x">-1~1の外は丸める</param>
+	/// <returns>0~π</returns>
+	inline float FastAcos(float x);
+	/// <summary>
+	/// 近似1/sqrt(x)
+	/// </summary>
+	/// <param name="x">正の値</param>
+	/// <returns></returns>
+	inline float FastRsqrt(float x);
+	/// <summary>
+	/// 近似exp
+	/// スカラーではstd::expとあまり変わらないので、まとめて計算できる場合は配列版を使う
+	/// </summary>
+	/// <param name="x"></param>
+	/// <returns></returns>
+	inline float FastExp(float x);
+
+#ifdef MATH_SIMD_SSE2
+	// 4要素版（スカラー版と同じ係数で、結果も同じになる）
+	inline __m128 FastSin(__m128 x);
+	inline __m128 FastCos(__m128 x);
+	inline void FastSinCos(__m128 x, __m128& s, __m128& c);
+	inline __m128 FastAtan2(__m128 y, __m128 x);
+	inline __m128 FastAcos(__m128 x);
+	inline __m128 FastRsqrt(__m128 x);
+	inline __m128 FastExp(__m128 x);
+#endif // MATH_SIMD_SSE2
+
+	// 配列版
+	// SIMDが使える場合は4要素ずつ処理する
+	// 入力と出力は同じ配列でもよい
+
+	void FastSin(const float* x, float* results, size_t count);
+	void FastCos(const float* x, float* results, size_t count);
+	void FastSinCos(const float* x, float* s, float* c, size_t count);
+	void FastAtan2(const float* y, const float* x, float* results, size_t count);
+	void FastAcos(const float* x, float* results, size_t count);
+	void FastRsqrt(const float* x, float* results, size_t count);
+	void FastExp(const float* x, float* results, size_t count);
+}
+
+#include "FastMath_inline.h"
@@ -0,0 +1,223 @@
+#pragma once
+#include "FastMath.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Math {
+
+	namespace FastMathInternal {
+		constexpr float kPi = 3.141592653589793f;
+		constexpr float kHalfPi = 1.570796326794897f;
+		constexpr float kTwoOverPi = 0.636619772367581f;
+		// π/2を3つに分けたもの（Cody-Waiteの範囲縮小）
+		constexpr float kHalfPiHi = 1.5703125f;
+		constexpr float kHalfPiMid = 4.837512969970703125e-4f;
+		constexpr float kHalfPiLo = 7.54978995489188216e-8f;
+		// [-π/4, π/4]でのsinとcosのミニマックス多項式
+		constexpr float kSin1 = -1.6666654611e-1f;
+		constexpr float kSin2 = 8.3321608736e-3f;
+		constexpr float kSin3 = -1.9515295891e-4f;
+		constexpr float kCos1 = 4.166664568298827e-2f;
+		constexpr float kCos2 = -1.388731625493765e-3f;
+		constexpr float kCos3 = 2.443315711809948e-5f;
+		// [0, 1]でのatan（Abramowitz & Stegun 4.4.49）
+		constexpr float kAtan[8] = {
+			-0.3333314528f, 0.1999355085f, -0.1420889944f, 0.1065626393f,
+			-0.0752896400f, 0.0429096138f, -0.0161657367f, 0.0028662257f };
+		// [0, 1]でのacos/sqrt(1-x)（Abramowitz & Stegun 4.4.46）
+		constexpr float kAcos[8] = {
+			1.5707963050f, -0.2145988016f, 0.0889789874f, -0.0501743046f,
+			0.0308918810f, -0.0170881256f, 0.0066700901f, -0.0012624911f };
+		// exp(x) = 2^n * exp(r)、r = x - n*ln2
+		constexpr float kLog2e = 1.44269504088896341f;
+		constexpr float kLn2Hi = 0.693359375f;
+		constexpr float kLn2Lo = -2.12194440e-4f;
+		// [-ln2/2, ln2/2]でのexp
+		constexpr float kExp[6] = {
+			1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f,
+			4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f };
+
+		inline int32_t RoundToInt(float x) {
+#ifdef MATH_SIMD_SSE2
+			// 4要素版と同じ丸め（偶数丸め）にする
+			return _mm_cvtss_si32(_mm_set_ss(x));
+#else
+			return static_cast<int32_t>(std::lrint(x));
+#endif // MATH_SIMD_SSE2
+		}
+
+		// x * 2^n（-252 <= n <= 254）
+		inline float ScaleByPow2(float x, int32_t n) {
+			// 2回に分けて掛けることで2^nが単精度の指数の範囲を超えてもよいようにする
+			int32_t n1 = n >> 1;
+			int32_t n2 = n - n1;
+			return x * std::bit_cast<float>((n1 + 127) << 23) * std::bit_cast<float>((n2 + 127) << 23);
+		}
+
+#ifdef MATH_SIMD_SSE2
+		inline __m128 Abs(__m128 v) { return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF))); }
+		inline __m128 SignBit(__m128 v) { return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(static_cast<int32_t>(0x80000000u)))); }
+		inline __m128 Select(__m128 mask, __m128 ifTrue, __m128 ifFalse) { return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse)); }
+		inline __m128 MulAdd(__m128 a, __m128 b, float c) { return _mm_add_ps(_mm_mul_ps(a, b), _mm_set1_ps(c)); }
+		inline __m128 ScaleByPow2(__m128 x, __m128i n) {
+			__m128i n1 = _mm_srai_epi32(n, 1);
+			__m128i n2 = _mm_sub_epi32(n, n1);
+			__m128i bias = _mm_set1_epi32(127);
+			x = _mm_mul_ps(x, _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n1, bias), 23)));
+			return _mm_mul_ps(x, _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n2, bias), 23)));
+		}
+#endif // MATH_SIMD_SSE2
+	}
+
+	inline float FastSin(float x) {
+		float s, c;
+		FastSinCos(x, s, c);
+		return s;
+	}
+
+	inline float FastCos(float x) {
+		float s, c;
+		FastSinCos(x, s, c);
+		return c;
+	}
+
+	inline void FastSinCos(float x, float& s, float& c) {
+		using namespace FastMathInternal;
+		// x = q*π/2 + r、|r| <= π/4
+		int32_t q = RoundToInt(x * kTwoOverPi);
+		float fq = static_cast<float>(q);
+		float r = ((x - fq * kHalfPiHi) - fq * kHalfPiMid) - fq * kHalfPiLo;
+		float r2 = r * r;
+		float sinR = r + r * r2 * (kSin1 + r2 * (kSin2 + r2 * kSin3));
+		float cosR = 1.0f - 0.5f * r2 + r2 * r2 * (kCos1 + r2 * (kCos2 + r2 * kCos3));
+		// 象限で入れ替えと符号を決める
+		if (q & 1) { std::swap(sinR, cosR); }
+		s = (q & 2) ? -sinR : sinR;
+		c = ((q + 1) & 2) ? -cosR : cosR;
+	}
+
+	inline float FastAtan2(float y, float x) {
+		using namespace FastMathInternal;
+		float absX = std::abs(x), absY = std::abs(y);
+		float maxXY = std::max(absX, absY), minXY = std::min(absX, absY);
+		float a = maxXY > 0.0f ? minXY / maxXY : 0.0f;
+		float s = a * a;
+		float p = kAtan[7];
+		for (int i = 6; i >= 0; --i) { p = p * s + kAtan[i]; }
+		float r = a + a * s * p;
+		if (absY > absX) { r = kHalfPi - r; }
+		if (x < 0.0f) { r = kPi - r; }
+		return std::copysign(r, y);
+	}
+
+	inline float FastAcos(float x) {
+		using namespace FastMathInternal;
+		float a = std::min(std::abs(x), 1.0f);
+		float p = kAcos[7];
+		for (int i = 6; i >= 0; --i) { p = p * a + kAcos[i]; }
+		float r = std::sqrt(1.0f - a) * p;
+		return x < 0.0f ? kPi - r : r;
+	}
+
+	inline float FastRsqrt(float x) {
+#ifdef MATH_SIMD_SSE2
+		// 12ビット精度の近似にニュートン法を1回
+		float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+		return y * (1.5f - (y * y) * (x * 0.5f));
+#else
+		return 1.0f / std::sqrt(x);
+#endif // MATH_SIMD_SSE2
+	}
+
+	inline float FastExp(float x) {
+		using namespace FastMathInternal;
+		x = std::clamp(x, FastExpMin, FastExpMax);
+		int32_t n = RoundToInt(x * kLog2e);
+		float fn = static_cast<float>(n);
+		float r = (x - fn * kLn2Hi) - fn * kLn2Lo;
+		float p = kExp[0];
+		for (int i = 1; i < 6; ++i) { p = p * r + kExp[i]; }
+		p = p * r * r + r + 1.0f;
+		return ScaleByPow2(p, n);
+	}
+
+#ifdef MATH_SIMD_SSE2
+	inline __m128 FastSin(__m128 x) {
+		__m128 s, c;
+		FastSinCos(x, s, c);
+		return s;
+	}
+
+	inline __m128 FastCos(__m128 x) {
+		__m128 s, c;
+		FastSinCos(x, s, c);
+		return c;
+	}
+
+	inline void FastSinCos(__m128 x, __m128& s, __m128& c) {
+		using namespace FastMathInternal;
+		__m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(kTwoOverPi)));
+		__m128 fq = _mm_cvtepi32_ps(q);
+		__m128 r = _mm_sub_ps(x, _mm_mul_ps(fq, _mm_set1_ps(kHalfPiHi)));
+		r = _mm_sub_ps(r, _mm_mul_ps(fq, _mm_set1_ps(kHalfPiMid)));
+		r = _mm_sub_ps(r, _mm_mul_ps(fq, _mm_set1_ps(kHalfPiLo)));
+		__m128 r2 = _mm_mul_ps(r, r);
+		__m128 sinR = MulAdd(MulAdd(_mm_set1_ps(kSin3), r2, kSin2), r2, kSin1);
+		sinR = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), sinR));
+		__m128 cosR = MulAdd(MulAdd(_mm_set1_ps(kCos3), r2, kCos2), r2, kCos1);
+		cosR = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)), _mm_mul_ps(_mm_mul_ps(r2, r2), cosR));
+
+		__m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+		__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+		__m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+		__m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+		s = _mm_xor_ps(Select(swap, cosR, sinR), sinSign);
+		c = _mm_xor_ps(Select(swap, sinR, cosR), cosSign);
+	}
+
+	inline __m128 FastAtan2(__m128 y, __m128 x) {
+		using namespace FastMathInternal;
+		__m128 zero = _mm_setzero_ps();
+		__m128 absX = Abs(x), absY = Abs(y);
+		__m128 maxXY = _mm_max_ps(absX, absY), minXY = _mm_min_ps(absX, absY);
+		__m128 a = _mm_and_ps(_mm_div_ps(minXY, maxXY), _mm_cmpgt_ps(maxXY, zero));
+		__m128 s = _mm_mul_ps(a, a);
+		__m128 p = _mm_set1_ps(kAtan[7]);
+		for (int i = 6; i >= 0; --i) { p = MulAdd(p, s, kAtan[i]); }
+		__m128 r = _mm_add_ps(a, _mm_mul_ps(_mm_mul_ps(a, s), p));
+		r = Select(_mm_cmpgt_ps(absY, absX), _mm_sub_ps(_mm_set1_ps(kHalfPi), r), r);
+		r = Select(_mm_cmplt_ps(x, zero), _mm_sub_ps(_mm_set1_ps(kPi), r), r);
+		return _mm_or_ps(r, SignBit(y));
+	}
+
+	inline __m128 FastAcos(__m128 x) {
+		using namespace FastMathInternal;
+		__m128 one = _mm_set1_ps(1.0f);
+		__m128 a = _mm_min_ps(Abs(x), one);
+		__m128 p = _mm_set1_ps(kAcos[7]);
+		for (int i = 6; i >= 0; --i) { p = MulAdd(p, a, kAcos[i]); }
+		__m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(one, a)), p);
+		return Select(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(kPi), r), r);
+	}
+
+	inline __m128 FastRsqrt(__m128 x) {
+		__m128 y = _mm_rsqrt_ps(x);
+		__m128 yyx = _mm_mul_ps(_mm_mul_ps(y, y), _mm_mul_ps(x, _mm_set1_ps(0.5f)));
+		return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), yyx));
+	}
+
+	inline __m128 FastExp(__m128 x) {
+		using namespace FastMathInternal;
+		x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(FastExpMin)), _mm_set1_ps(FastExpMax));
+		__m128i n = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(kLog2e)));
+		__m128 fn = _mm_cvtepi32_ps(n);
+		__m128 r = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(fn, _mm_set1_ps(kLn2Hi))), _mm_mul_ps(fn, _mm_set1_ps(kLn2Lo)));
+		__m128 p = _mm_set1_ps(kExp[0]);
+		for (int i = 1; i < 6; ++i) { p = MulAdd(p, r, kExp[i]); }
+		p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r), r), r), _mm_set1_ps(1.0f));
+		return ScaleByPow2(p, n);
+	}
+#endif // MATH_SIMD_SSE2
+
+}
@@ -4,50 +4,50 @@
 
 namespace DirectXHelper {
 
-	Fence::~Fence() {
-		if (fenceEvent_) {
-			CloseHandle(fenceEvent_);
-		}
-	}
-
 	bool Fence::Initalize(ID3D12Device* device) {
 		assert(device);
 		
-		fenceValue_ = 0;
-		if (FAILED(device->CreateFence(fenceValue_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(fence_.ReleaseAndGetAddressOf())))) {
+		fenceValue_.store(0, std::memory_order_relaxed);
+		completedValue_.store(0, std::memory_order_relaxed);
+		if (FAILED(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(fence_.ReleaseAndGetAddressOf())))) {
 			Logger::Error("CreateFence()");
 			assert(false);
 			return false;
 		}
-		fenceEvent_ = CreateEvent(NULL, FALSE, FALSE, NULL);
-		if (!fenceEvent_) {
-			Logger::Error("CreateHandle()");
-			assert(false);
-			return false;
-		}
 		return true;
 	}
 
 	bool Fence::Signal(ID3D12CommandQueue* commandQueue) {
-		++fenceValue_;
-		if (FAILED(commandQueue->Signal(fence_.Get(), fenceValue_))) {
+		uint64_t fenceValue = fenceValue_.load(std::memory_order_relaxed) + 1;
+		if (FAILED(commandQueue->Signal(fence_.Get(), fenceValue))) {
 			Logger::Error("ID3D12CommandQueue::Signal()");
 			assert(false);
 			return false;
 		}
+		// 積んでから公開する（他のスレッドが積む前の値を待たないように）
+		fenceValue_.store(fenceValue, std::memory_order_release);
 		return true;
 	}
 
-	bool Fence::WaitForGPU() {
-		if (fence_->GetCompletedValue() < fenceValue_) {
-			if (FAILED(fence_->SetEventOnCompletion(fenceValue_, fenceEvent_))) {
-				Logger::Error("ID3D12Fence::SetEventOnCompletion()");
-				assert(false);
-				return false;
-			}
-			WaitForSingleObject(fenceEvent_, INFINITE);
+	uint64_t Fence::GetCompletedValue() {
+		uint64_t signaledValue = fenceValue_.load(std::memory_order_acquire);
+		uint64_t cachedValue = completedValue_.load(std::memory_order_acquire);
+		if (cachedValue >= signaledValue) { return cachedValue; }
+		// デバイスが失われると UINT64_MAX が返るので、積んだ値より先には進めない
+		uint64_t completedValue = fence_->GetCompletedValue();
+		if (completedValue > signaledValue) { completedValue = signaledValue; }
+		// 他のスレッドが先に進めていれば、大きい方を残す
+		while (completedValue > cachedValue && !completedValue_.compare_exchange_weak(cachedValue, completedValue, std::memory_order_acq_rel)) {}
+		return completedValue > cachedValue ? completedValue : cachedValue;
+	}
+
+	bool Fence::SetEventOnCompletion(uint64_t value, Engine::FenceEvent& event) {
+		if (FAILED(fence_->SetEventOnCompletion(value, static_cast<HANDLE>(event.GetNativeHandle())))) {
+			Logger::Error("ID3D12Fence::SetEventOnCompletion()");
+			assert(false);
+			return false;
 		}
 		return true;
 	}
 
-}
\ No newline at end of file
+}
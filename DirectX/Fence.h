@@ -1,19 +1,36 @@
 #pragma once
+#include <atomic>
+#include "TimelineFence.h"
 
 namespace DirectXHelper {
 	using namespace Microsoft::WRL;
 
-	class Fence {
+	// ID3D12Fence（CommandQueueとCommandListが使う）
+	class Fence :
+		public Engine::TimelineFence {
 	public:
-		~Fence();
 		bool Initalize(ID3D12Device* device);
+		/// <summary>
+		/// 値を一つ進めてキューに積む
+		/// </summary>
 		bool Signal(ID3D12CommandQueue* commandQueue);
-		bool WaitForGPU();
+		/// <summary>
+		/// 最後に積んだ値まで待つ
+		/// </summary>
+		bool WaitForGPU() { return Wait(GetLastSignaledValue()); }
+
+		uint64_t GetCompletedValue() override;
+		bool SetEventOnCompletion(uint64_t value, Engine::FenceEvent& event) override;
+
+		uint64_t GetLastSignaledValue() const { return fenceValue_.load(std::memory_order_acquire); }
+		ID3D12Fence* Get() const { return fence_.Get(); }
 
 	private:
 		ComPtr<ID3D12Fence> fence_;
-		HANDLE fenceEvent_{ nullptr };
-		uint64_t fenceValue_{ 0 };
+		// Signalは一つのスレッドから呼ぶが、値はワーカースレッドからも読む（CommandListPoolなど）
+		std::atomic<uint64_t> fenceValue_{ 0 };
+		// 最後に問い合わせた値（GetCompletedValueの呼び出しを減らす、どのスレッドからも進める）
+		std::atomic<uint64_t> completedValue_{ 0 };
 	};
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,53 @@
+#include "FrameScheduler.h"
+
+#include "Assert.h"
+
+namespace Engine {
+
+	bool FrameScheduler::Initalize(GPUQueue* queue, uint32_t frameCount) {
+		if (!queue || frameCount == 0 || frameCount > kMaxFrameCount) {
+			ASSERT_MSG(false, "Frame count must be between 1 and kMaxFrameCount");
+			return false;
+		}
+		queue_ = queue;
+		frameCount_ = frameCount;
+		frameIndex_ = 0;
+		frameNumber_ = 0;
+		isInFrame_ = false;
+		waitCount_ = 0;
+		waitTime_ = std::chrono::nanoseconds(0);
+		for (uint64_t& fenceValue : fenceValues_) { fenceValue = 0; }
+		return true;
+	}
+
+	uint32_t FrameScheduler::BeginFrame() {
+		ASSERT_MSG(!isInFrame_, "BeginFrame called twice without EndFrame");
+		frameIndex_ = static_cast<uint32_t>(frameNumber_ % frameCount_);
+		uint64_t fenceValue = fenceValues_[frameIndex_];
+		// GPUがframeCountフレーム遅れている場合だけ待つ
+		if (!queue_->IsCompleted(fenceValue)) {
+			auto begin = std::chrono::steady_clock::now();
+			queue_->WaitForValue(fenceValue);
+			waitTime_ += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+			++waitCount_;
+		}
+		++frameNumber_;
+		isInFrame_ = true;
+		return frameIndex_;
+	}
+
+	uint64_t FrameScheduler::EndFrame() {
+		ASSERT_MSG(isInFrame_, "EndFrame called without BeginFrame");
+		uint64_t fenceValue = queue_->Signal();
+		fenceValues_[frameIndex_] = fenceValue;
+		isInFrame_ = false;
+		return fenceValue;
+	}
+
+	void FrameScheduler::WaitForIdle() {
+		if (queue_) {
+			queue_->WaitForIdle();
+		}
+	}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+#include "GPUQueue.h"
+
+namespace Engine {
+
+	// 複数のフレームを並行してGPUに積むための、フレームごとのコンテキストの管理
+	// フレームごとにコマンドアロケータやアップロード領域を持たせ、そのフレームのフェンス値を記録する
+	// CPUはGPUよりframeCountフレーム先に進んだときだけ、同じコンテキストを使った前のフレームを待つ
+	class FrameScheduler {
+	public:
+		static constexpr uint32_t kMaxFrameCount = 4;
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="queue">フレームのコマンドを積むキュー</param>
+		/// <param name="frameCount">並行して積むフレーム数（1ならフレームごとにGPUを待つ）</param>
+		/// <returns></returns>
+		bool Initalize(GPUQueue* queue, uint32_t frameCount);
+
+		/// <summary>
+		/// フレームの開始
+		/// このフレームが使うコンテキストを前に使ったフレームをGPUが終えるまで待つ
+		/// </summary>
+		/// <returns>コンテキストの番号（アロケータなどの添字）</returns>
+		uint32_t BeginFrame();
+		/// <summary>
+		/// フレームの終了（このフレームのコマンドをすべて積んだ後に呼ぶ）
+		/// </summary>
+		/// <returns>このフレームのフェンス値</returns>
+		uint64_t EndFrame();
+		/// <summary>
+		/// 積んだフレームがすべて終わるまで待つ（終了時やリソースの作り直しで使う）
+		/// </summary>
+		void WaitForIdle();
+
+		// 現在のフレームのコンテキストの番号
+		uint32_t GetFrameIndex() const { return frameIndex_; }
+		uint32_t GetFrameCount() const { return frameCount_; }
+		// 開始したフレームの数
+		uint64_t GetFrameNumber() const { return frameNumber_; }
+		// コンテキストを使ったフレームのフェンス値（まだ使っていなければ0）
+		uint64_t GetFenceValue(uint32_t frameIndex) const { return fenceValues_[frameIndex]; }
+		// GPUを待った回数と時間
+		uint64_t GetWaitCount() const { return waitCount_; }
+		std::chrono::nanoseconds GetWaitTime() const { return waitTime_; }
+
+	private:
+		GPUQueue* queue_{ nullptr };
+		uint64_t fenceValues_[kMaxFrameCount]{};
+		uint32_t frameCount_{ 0 };
+		uint32_t frameIndex_{ 0 };
+		uint64_t frameNumber_{ 0 };
+		bool isInFrame_{ false };
+		uint64_t waitCount_{ 0 };
+		std::chrono::nanoseconds waitTime_{ 0 };
+	};
+
+}
@@ -0,0 +1,183 @@
+#include "GPUMemoryAllocator.h"
+
+#include <algorithm>
+#include <new>
+
+#include "Assert.h"
+
+namespace Engine {
+
+	void* CPUHeapBackingStore::CreateHeap(MemoryCategory, uint64_t size) {
+		++heapCount_;
+		return ::operator new(static_cast<size_t>(size), std::align_val_t(GPUMemoryAllocator::kDefaultAlignment));
+	}
+
+	void CPUHeapBackingStore::DestroyHeap(MemoryCategory, void* heap) {
+		--heapCount_;
+		::operator delete(heap, std::align_val_t(GPUMemoryAllocator::kDefaultAlignment));
+	}
+
+	GPUMemoryAllocator::~GPUMemoryAllocator() {
+		Finalize();
+	}
+
+	bool GPUMemoryAllocator::Initalize(HeapBackingStore* backingStore, uint64_t heapSize) {
+		if (!backingStore || heapSize == 0 || heapSize % kDefaultAlignment != 0) {
+			ASSERT_MSG(false, "Heap size must be a multiple of 64KB");
+			return false;
+		}
+		Finalize();
+		std::lock_guard<std::mutex> lock(mutex_);
+		backingStore_ = backingStore;
+		heapSize_ = heapSize;
+		return true;
+	}
+
+	void GPUMemoryAllocator::Finalize() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (size_t category = 0; category < static_cast<size_t>(MemoryCategory::Count); ++category) {
+			Pool& pool = pools_[category];
+			for (uint32_t heapIndex = 0; heapIndex < pool.heaps.size(); ++heapIndex) {
+				if (pool.heaps[heapIndex]) {
+					DestroyHeap(static_cast<MemoryCategory>(category), pool, heapIndex);
+				}
+			}
+			pool.heaps.clear();
+		}
+	}
+
+	void GPUMemoryAllocator::SetBudget(MemoryCategory category, uint64_t budget) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		pools_[static_cast<size_t>(category)].budget = budget;
+	}
+
+	GPUMemoryAllocator::Allocation GPUMemoryAllocator::Allocate(MemoryCategory category, uint64_t size, uint64_t alignment) {
+		ASSERT_MSG(backingStore_, "Not initialized");
+		ASSERT_MSG(size > 0, "Zero size allocation");
+		ASSERT_MSG(alignment != 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two");
+		if (!backingStore_ || size == 0 || alignment == 0) { return {}; }
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		Pool& pool = pools_[static_cast<size_t>(category)];
+		Allocation allocation;
+		allocation.category = category;
+		allocation.size = size;
+		// 前のヒープから埋める（後ろのヒープが空きやすくなり、ReleaseEmptyHeapsで返せる）
+		for (uint32_t heapIndex = 0; heapIndex < pool.heaps.size(); ++heapIndex) {
+			Heap* heap = pool.heaps[heapIndex].get();
+			if (!heap || heap->allocator.GetCapacity() - heap->allocator.GetUsedSize() < size) { continue; }
+			MemoryBlockAllocator::Allocation block = heap->allocator.Allocate(size, alignment);
+			if (block.IsEnabled()) {
+				allocation.heap = heap->heap;
+				allocation.offset = block.offset;
+				allocation.heapIndex = heapIndex;
+				allocation.handle = block.handle;
+				return allocation;
+			}
+		}
+
+		// 入らなければ新しいヒープを作る（大きいリソースはそれだけのヒープになる）
+		uint64_t alignedSize = (size + kDefaultAlignment - 1) & ~(kDefaultAlignment - 1);
+		uint64_t heapSize = std::max(heapSize_, alignedSize);
+		if (pool.budget != kUnlimitedBudget && pool.reservedSize + heapSize > pool.budget) {
+			return {};
+		}
+		uint32_t heapIndex = 0;
+		Heap* heap = CreateHeap(category, pool, heapSize, heapIndex);
+		if (!heap) { return {}; }
+		MemoryBlockAllocator::Allocation block = heap->allocator.Allocate(size, alignment);
+		ASSERT_MSG(block.IsEnabled(), "Allocation from a new heap failed");
+		allocation.heap = heap->heap;
+		allocation.offset = block.offset;
+		allocation.heapIndex = heapIndex;
+		allocation.handle = block.handle;
+		return allocation;
+	}
+
+	bool GPUMemoryAllocator::Deallocate(Allocation& allocation) {
+		if (!allocation.IsEnabled()) { return false; }
+		std::lock_guard<std::mutex> lock(mutex_);
+		Pool& pool = pools_[static_cast<size_t>(allocation.category)];
+		Heap* heap = allocation.heapIndex < pool.heaps.size() ? pool.heaps[allocation.heapIndex].get() : nullptr;
+		if (!heap || heap->heap != allocation.heap || !heap->allocator.Deallocate(allocation.handle)) {
+			ASSERT_MSG(false, "Deallocated memory that is not allocated (double free?)");
+			return false;
+		}
+		allocation = Allocation{};
+		return true;
+	}
+
+	uint32_t GPUMemoryAllocator::ReleaseEmptyHeaps(uint32_t keepCount) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		uint32_t releasedCount = 0;
+		for (size_t category = 0; category < static_cast<size_t>(MemoryCategory::Count); ++category) {
+			Pool& pool = pools_[category];
+			uint32_t keptCount = 0;
+			for (uint32_t heapIndex = 0; heapIndex < pool.heaps.size(); ++heapIndex) {
+				Heap* heap = pool.heaps[heapIndex].get();
+				if (!heap || !heap->allocator.IsEmpty()) { continue; }
+				if (keptCount < keepCount) {
+					++keptCount;
+					continue;
+				}
+				DestroyHeap(static_cast<MemoryCategory>(category), pool, heapIndex);
+				++releasedCount;
+			}
+			// 末尾の空いた位置は詰める
+			while (!pool.heaps.empty() && !pool.heaps.back()) {
+				pool.heaps.pop_back();
+			}
+		}
+		return releasedCount;
+	}
+
+	GPUMemoryAllocator::Statistics GPUMemoryAllocator::GetStatistics(MemoryCategory category) const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		const Pool& pool = pools_[static_cast<size_t>(category)];
+		Statistics statistics{};
+		statistics.budget = pool.budget;
+		statistics.reservedSize = pool.reservedSize;
+		uint64_t freeSize = 0;
+		for (const auto& heap : pool.heaps) {
+			if (!heap) { continue; }
+			MemoryBlockAllocator::Statistics heapStatistics = heap->allocator.GetStatistics();
+			++statistics.heapCount;
+			if (heapStatistics.allocationCount == 0) { ++statistics.emptyHeapCount; }
+			statistics.usedSize += heapStatistics.usedSize;
+			statistics.allocationCount += heapStatistics.allocationCount;
+			statistics.freeBlockCount += heapStatistics.freeBlockCount;
+			statistics.largestFreeBlock = std::max(statistics.largestFreeBlock, heapStatistics.largestFreeBlock);
+			statistics.movableSize += heapStatistics.movableSize;
+			freeSize += heapStatistics.capacity - heapStatistics.usedSize;
+		}
+		statistics.fragmentation = freeSize > 0 ? 1.0f - static_cast<float>(static_cast<double>(statistics.largestFreeBlock) / static_cast<double>(freeSize)) : 0.0f;
+		return statistics;
+	}
+
+	GPUMemoryAllocator::Heap* GPUMemoryAllocator::CreateHeap(MemoryCategory category, Pool& pool, uint64_t size, uint32_t& heapIndex) {
+		void* nativeHeap = backingStore_->CreateHeap(category, size);
+		if (!nativeHeap) { return nullptr; }
+		auto heap = std::make_unique<Heap>();
+		heap->heap = nativeHeap;
+		heap->allocator.Initalize(size);
+		pool.reservedSize += size;
+		// 破棄したヒープの位置を使い回す
+		auto found = std::find(pool.heaps.begin(), pool.heaps.end(), nullptr);
+		heapIndex = static_cast<uint32_t>(found - pool.heaps.begin());
+		if (found == pool.heaps.end()) {
+			pool.heaps.push_back(std::move(heap));
+		}
+		else {
+			*found = std::move(heap);
+		}
+		return pool.heaps[heapIndex].get();
+	}
+
+	void GPUMemoryAllocator::DestroyHeap(MemoryCategory category, Pool& pool, uint32_t heapIndex) {
+		Heap* heap = pool.heaps[heapIndex].get();
+		pool.reservedSize -= heap->allocator.GetCapacity();
+		backingStore_->DestroyHeap(category, heap->heap);
+		pool.heaps[heapIndex].reset();
+	}
+
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "MemoryBlockAllocator.h"
+
+namespace Engine {
+
+	// リソースの種類ごとに分けるヒープ
+	// ヒープティア1ではバッファ、テクスチャ、レンダーターゲットを同じヒープに置けないので分けておく
+	enum class MemoryCategory : uint32_t {
+		Buffer,
+		UploadBuffer,
+		ReadbackBuffer,
+		Texture,
+		RenderTarget,
+		Count
+	};
+
+	// ヒープ本体を作る側（D3DではID3D12Heap、テストではCPUのメモリ）
+	class HeapBackingStore {
+	public:
+		virtual ~HeapBackingStore() = default;
+		/// <summary>
+		/// ヒープを作る
+		/// </summary>
+		/// <param name="category"></param>
+		/// <param name="size">バイト数</param>
+		/// <returns>ヒープ、作れない場合はnullptr</returns>
+		virtual void* CreateHeap(MemoryCategory category, uint64_t size) = 0;
+		virtual void DestroyHeap(MemoryCategory category, void* heap) = 0;
+	};
+
+	// CPUのメモリをヒープの代わりにする（D3Dの無い環境でのテストと計測用）
+	class CPUHeapBackingStore :
+		public HeapBackingStore {
+	public:
+		void* CreateHeap(MemoryCategory category, uint64_t size) override;
+		void DestroyHeap(MemoryCategory category, void* heap) override;
+
+		uint32_t GetHeapCount() const { return heapCount_; }
+
+	private:
+		uint32_t heapCount_{ 0 };
+	};
+
+	// 大きなヒープをまとめて作り、その中をMemoryBlockAllocatorで切り出してリソースを配置する
+	// 種類ごとに予算（作るヒープの合計）を決められる
+	// 複数のスレッドから呼べる
+	class GPUMemoryAllocator {
+	public:
+		// ヒープ一つの大きさ
+		static constexpr uint64_t kDefaultHeapSize = 64ull * 1024 * 1024;
+		// 配置するリソースのアライメント（D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT）
+		static constexpr uint64_t kDefaultAlignment = 64 * 1024;
+		// 予算を決めていない場合
+		static constexpr uint64_t kUnlimitedBudget = UINT64_MAX;
+
+		struct Allocation {
+			// HeapBackingStore::CreateHeapで作ったヒープ
+			void* heap{ nullptr };
+			// ヒープの先頭からのバイト位置
+			uint64_t offset{ 0 };
+			uint64_t size{ 0 };
+			MemoryCategory category{ MemoryCategory::Buffer };
+			uint32_t heapIndex{ 0 };
+			uint32_t handle{ MemoryBlockAllocator::kInvalidHandle };
+
+			bool IsEnabled() const { return heap != nullptr; }
+		};
+
+		struct Statistics {
+			uint64_t budget;
+			// 作ったヒープの合計
+			uint64_t reservedSize;
+			// 確保中のバイト数
+			uint64_t usedSize;
+			uint32_t heapCount;
+			// 一つも確保していないヒープの数
+			uint32_t emptyHeapCount;
+			uint32_t allocationCount;
+			uint32_t freeBlockCount;
+			// 新しいヒープを作らずに確保できる最大のバイト数
+			uint64_t largestFreeBlock;
+			// 各ヒープを詰め直す場合に動かすバイト数
+			uint64_t movableSize;
+			// 1 - 最大の空き / 空きの合計（ヒープをまたいだ値）
+			float fragmentation;
+		};
+
+		GPUMemoryAllocator() = default;
+		~GPUMemoryAllocator();
+		GPUMemoryAllocator(const GPUMemoryAllocator&) = delete;
+		GPUMemoryAllocator& operator=(const GPUMemoryAllocator&) = delete;
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="backingStore">ヒープを作る側（このクラスより長く生きること）</param>
+		/// <param name="heapSize">ヒープ一つの大きさ（これより大きいリソースは専用のヒープを作る）</param>
+		/// <returns></returns>
+		bool Initalize(HeapBackingStore* backingStore, uint64_t heapSize = kDefaultHeapSize);
+		/// <summary>
+		/// すべてのヒープを破棄する
+		/// </summary>
+		void Finalize();
+
+		/// <summary>
+		/// 予算を決める（超える場合は新しいヒープを作らずに確保に失敗する）
+		/// </summary>
+		/// <param name="category"></param>
+		/// <param name="budget">作るヒープの合計のバイト数</param>
+		void SetBudget(MemoryCategory category, uint64_t budget);
+		/// <summary>
+		/// 範囲を確保
+		/// </summary>
+		/// <param name="category"></param>
+		/// <param name="size">バイト数（D3DではGetResourceAllocationInfoの値）</param>
+		/// <param name="alignment">2のべき乗</param>
+		/// <returns>確保できない場合は無効な範囲</returns>
+		[[nodiscard]] Allocation Allocate(MemoryCategory category, uint64_t size, uint64_t alignment = kDefaultAlignment);
+		/// <summary>
+		/// Allocateで確保した範囲を解放
+		/// </summary>
+		/// <param name="allocation">解放後は無効になる</param>
+		/// <returns>確保されていない場合（二重解放など）はfalse</returns>
+		bool Deallocate(Allocation& allocation);
+		/// <summary>
+		/// 一つも確保していないヒープを破棄する
+		/// </summary>
+		/// <param name="keepCount">種類ごとに残しておく空のヒープの数</param>
+		/// <returns>破棄したヒープの数</returns>
+		uint32_t ReleaseEmptyHeaps(uint32_t keepCount = 0);
+
+		/// <summary>
+		/// 使用状況（ブロックをたどるのでデバッグ表示用）
+		/// </summary>
+		/// <param name="category"></param>
+		/// <returns></returns>
+		Statistics GetStatistics(MemoryCategory category) const;
+
+		uint64_t GetHeapSize() const { return heapSize_; }
+
+	private:
+		struct Heap {
+			void* heap;
+			MemoryBlockAllocator allocator;
+		};
+		struct Pool {
+			// 破棄したヒープの位置はnullptrのまま残して、Allocation::heapIndexを変えない
+			std::vector<std::unique_ptr<Heap>> heaps;
+			uint64_t budget{ kUnlimitedBudget };
+			uint64_t reservedSize{ 0 };
+		};
+
+		// ヒープを作ってpoolに追加する
+		Heap* CreateHeap(MemoryCategory category, Pool& pool, uint64_t size, uint32_t& heapIndex);
+		void DestroyHeap(MemoryCategory category, Pool& pool, uint32_t heapIndex);
+
+		mutable std::mutex mutex_;
+		HeapBackingStore* backingStore_{ nullptr };
+		Pool pools_[static_cast<size_t>(MemoryCategory::Count)];
+		uint64_t heapSize_{ kDefaultHeapSize };
+	};
+
+}
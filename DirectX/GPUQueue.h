@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+
+#include "TimelineFence.h"
+
+namespace Engine {
+
+	// コマンドキューとそのフェンスの抽象
+	// D3D12のキュー（DirectXHelper::CommandQueue）と、テスト用の模擬GPU（SimulatedGPUQueue）を同じように扱う
+	// フェンス値は1から増えていき、GetCompletedValue以下の値を積んだ処理はすべて終わっている
+	class GPUQueue {
+	public:
+		virtual ~GPUQueue() = default;
+
+		/// <summary>
+		/// ここまでに積んだ処理が終わったら進むフェンス値を積む
+		/// </summary>
+		/// <returns>積んだフェンス値</returns>
+		virtual uint64_t Signal() = 0;
+		/// <summary>
+		/// GPUが終えたフェンス値
+		/// </summary>
+		virtual uint64_t GetCompletedValue() = 0;
+		/// <summary>
+		/// フェンス値に届くまでCPUで待つ
+		/// </summary>
+		/// <returns>待てなかった場合はfalse</returns>
+		virtual bool WaitForValue(uint64_t value) = 0;
+		/// <summary>
+		/// 最後に積んだフェンス値
+		/// </summary>
+		virtual uint64_t GetLastSignaledValue() const = 0;
+		/// <summary>
+		/// 以降に積む処理を、別のキューがフェンス値に届くまでGPU上で待たせる（CPUは待たない）
+		/// </summary>
+		/// <param name="queue">待つ相手（同じ実装のキュー）</param>
+		/// <param name="value">まだシグナルを積んでいない値でもよい</param>
+		/// <returns>待たせられない場合はfalse</returns>
+		virtual bool WaitOnQueue(GPUQueue& queue, uint64_t value) = 0;
+		/// <summary>
+		/// キューのフェンス（時間切れ付きの待機、複数のキューを待つ、完了したら呼ぶ関数）
+		/// </summary>
+		virtual TimelineFence& GetTimelineFence() = 0;
+
+		bool IsCompleted(uint64_t value) { return GetCompletedValue() >= value; }
+		/// <summary>
+		/// 積んだ処理がすべて終わるまで待つ
+		/// </summary>
+		bool WaitForIdle() { return WaitForValue(Signal()); }
+	};
+
+}
@@ -1,8 +1,27 @@
 #include "stdafx.h"
 #include "GPUResource.h"
+#include "DirectXHelper.h"
 #include "Logger.h"
+#include "ResourceAllocator.h"
 
 namespace DirectXHelper {
+	GPUResource::~GPUResource() {
+		// 配置したメモリは、そこに置いたリソースの後に戻す（預けた順に破棄される）
+		DeferredRelease(resource_);
+		DeferredRelease(allocation_);
+	}
+
+	GPUResource& GPUResource::operator=(const GPUResource& other) {
+		if (this == &other) { return *this; }
+		// 預けてから受け取る（同じリソースでも参照は預けた分と別に数える）
+		DeferredRelease(resource_);
+		DeferredRelease(allocation_);
+		allocation_ = other.allocation_;
+		resource_ = other.resource_;
+		state_ = other.state_;
+		return *this;
+	}
+
 	bool GPUResource::Initalize(
 		ID3D12Device5* device,
 		const D3D12_HEAP_PROPERTIES& heapProp,
@@ -11,6 +30,9 @@ namespace DirectXHelper {
 		const D3D12_CLEAR_VALUE& clearValue) {
 		assert(device);
 
+		// 前のリソースは使っているコマンドが終わってから解放する
+		DeferredRelease(resource_);
+		DeferredRelease(allocation_);
 		if (FAILED(device->CreateCommittedResource(
 			&heapProp,
 			D3D12_HEAP_FLAG_NONE,
@@ -25,6 +47,27 @@ namespace DirectXHelper {
 		state_ = initState;
 		return true;
 	}
+	bool GPUResource::Initalize(
+		ResourceAllocator& allocator,
+		D3D12_HEAP_TYPE heapType,
+		const D3D12_RESOURCE_DESC& desc,
+		ResourceState initState,
+		const D3D12_CLEAR_VALUE& clearValue) {
+		DeferredRelease(resource_);
+		DeferredRelease(allocation_);
+		allocation_ = allocator.CreatePlacedResource(
+			heapType,
+			desc,
+			static_cast<D3D12_RESOURCE_STATES>(initState),
+			clearValue.Format != DXGI_FORMAT_UNKNOWN ? &clearValue : nullptr,
+			resource_);
+		if (!allocation_) {
+			resource_.Reset();
+			return false;
+		}
+		state_ = initState;
+		return true;
+	}
 	D3D12_RESOURCE_BARRIER DirectXHelper::GPUResource::TransitionBarrier(ResourceState nextState) {
 		D3D12_RESOURCE_BARRIER barrier{};
 		barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
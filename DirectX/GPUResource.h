@@ -1,5 +1,8 @@
 #pragma once
 namespace DirectXHelper {
+	class ResourceAllocator;
+	class ResourceAllocation;
+
 	using namespace Microsoft::WRL;
 
 	enum class ResourceState {
@@ -34,6 +37,13 @@ namespace DirectXHelper {
 
 	class GPUResource {
 	public:
+		GPUResource() = default;
+		GPUResource(const GPUResource&) = default;
+		// 前のリソースと配置したメモリはGPUが使い終えてから解放する
+		GPUResource& operator=(const GPUResource& other);
+		// リソースと配置したメモリはGPUが使い終えてから解放する
+		~GPUResource();
+
 		operator ID3D12Resource* () const { return resource_.Get(); }
 
 		bool Initalize(
@@ -42,6 +52,21 @@ namespace DirectXHelper {
 			const D3D12_RESOURCE_DESC& desc,
 			ResourceState initState,
 			const D3D12_CLEAR_VALUE& colorValue = {});
+		/// <summary>
+		/// ResourceAllocatorのヒープに配置して初期化
+		/// </summary>
+		/// <param name="allocator"></param>
+		/// <param name="heapType">DEFAULT、UPLOAD、READBACK</param>
+		/// <param name="desc"></param>
+		/// <param name="initState"></param>
+		/// <param name="clearValue"></param>
+		/// <returns></returns>
+		bool Initalize(
+			ResourceAllocator& allocator,
+			D3D12_HEAP_TYPE heapType,
+			const D3D12_RESOURCE_DESC& desc,
+			ResourceState initState,
+			const D3D12_CLEAR_VALUE& clearValue = {});
 		D3D12_RESOURCE_BARRIER TransitionBarrier(ResourceState nextState);
 		D3D12_RESOURCE_BARRIER UAVBarrier();
 
@@ -55,6 +80,11 @@ namespace DirectXHelper {
 		ResourceState GetState() const { return state_; }
 
 	protected:
+		// 状態の追跡はCommandListが行う
+		friend class CommandList;
+
+		// 配置したリソースのメモリ（リソースより後に破棄するので先に宣言する）
+		std::shared_ptr<ResourceAllocation> allocation_;
 		ComPtr<ID3D12Resource> resource_;
 		ResourceState state_{ ResourceState::Common };
 	};
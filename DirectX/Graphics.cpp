@@ -46,7 +46,7 @@ namespace Engine {
 			// ソフトウェアアダプタでなければ採用
 			if (!(adapterDesc.Flags & DXGI_ADAPTER_FLAG3_SOFTWARE)) {
 				// 採用したアダプタ情報を出力
-				Logger::Info(std::format("Use adapter {}", String::Convert(adapterDesc.Description)));
+				Logger::Info("Use adapter {}", String::ToUtf8(adapterDesc.Description));
 				break;
 			}
 			useAdapter = nullptr; // ソフトウェアアダプタは見なかったことにする
@@ -68,7 +68,7 @@ namespace Engine {
 			// 指定した機能レベルでデバイスが生成できたかを確認
 			if (SUCCEEDED(D3D12CreateDevice(useAdapter.Get(), featureLevels[i], IID_PPV_ARGS(device_.GetAddressOf())))) {
 				// 生成できたのでログ出力を行ってループを抜ける
-				Logger::Info(std::format("FeatureLevel {}", featureLevelStrings[i]));
+				Logger::Info("FeatureLevel {}", featureLevelStrings[i]);
 				break;
 			}
 		}
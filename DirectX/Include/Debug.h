@@ -1,6 +1,16 @@
 #pragma once
+#include "StringFormat.h"
 
 namespace Debug {
+	void Log(const char* str);
 	void Log(const std::string& str);
 	void Log(const std::wstring& str);
+
+	/// <summary>
+	/// 書式化して出力（スレッドごとのバッファを使うので確保しない）
+	/// </summary>
+	template<class Arg, class... Args>
+	void Log(String::FormatString<std::type_identity_t<Arg>, std::type_identity_t<Args>...> format, const Arg& arg, const Args&... args) {
+		Log(String::FormatTemporary(format, arg, args...).data());
+	}
 }
@@ -1,5 +1,10 @@
 #pragma once
 #include "DirectXHelper.h"
+#include "CommandListAllocator.h"
+#include "CommandQueue.h"
+#include "FrameScheduler.h"
+#include "TransientDescriptorRing.h"
+#include "UploadBuffer.h"
 
 class DirectXDevice {
 public:
@@ -7,9 +12,17 @@ public:
 	DELETE_COPY_MOVE(DirectXDevice);
 
 	static const uint32_t kSwapChainBufferCount = 2;
+	// GPUより先に記録しておけるフレーム数（フレームごとにアロケータを持つ）
+	static const uint32_t kFrameCount = kSwapChainBufferCount;
 	static const uint32_t kRTVDescriptorMaxCount = 16;
 	static const uint32_t kDSVDescriptorMaxCount = 8;
 	static const uint32_t kCommonDescriptorMaxCount = 1024;
+	// 共通ヒープのうち1フレームだけ使うディスクリプタに回す数
+	static const uint32_t kTransientDescriptorCount = 512;
+	// 毎フレーム書き換える定数バッファなどに使うアップロードバッファのサイズ
+	static const uint32_t kUploadBufferSize = 4 * 1024 * 1024;
+	// 1フレームに解放する預けたオブジェクトの数の上限（残りは次のフレームに回す）
+	static const uint32_t kDeferredReleaseBudget = 64;
 
 
 	void Initalize(HWND hwnd);
@@ -19,18 +32,48 @@ public:
 	void FinishScreenRendering();
 
 	void SubmitCommandList();
+	/// <summary>
+	/// 積んだコマンドがすべて終わるまで待つ（毎フレームは呼ばない）
+	/// </summary>
 	void WaitForGPU();
 	void ResetCommandList(uint32_t allocatorIndex);
 
+	/// <summary>
+	/// このフレームだけ使うディスクリプタを共通ヒープから確保（解放は不要）
+	/// </summary>
+	/// <param name="count">連続したディスクリプタの数</param>
+	/// <returns>確保できない場合は無効なディスクリプタ</returns>
+	DirectXHelper::Descriptor AllocateTransientDescriptor(uint32_t count = 1);
+	/// <summary>
+	/// 記録スレッドごとの塊から確保する（スレッド同士で取り合わない）
+	/// </summary>
+	/// <param name="threadBlock">記録スレッドが持つ塊</param>
+	/// <param name="count">連続したディスクリプタの数</param>
+	/// <returns>確保できない場合は無効なディスクリプタ</returns>
+	DirectXHelper::Descriptor AllocateTransientDescriptor(Engine::TransientDescriptorRing::ThreadBlock& threadBlock, uint32_t count = 1);
+
 	IDXGIFactory7* GetDXGIFactory() const { return dxgiFactory_.Get(); }
 	ID3D12Device5* GetDevice() const { return device_.Get(); }
 	ID3D12CommandQueue* GetCommandQueue() const { return commandQueue_.Get(); }
+	DirectXHelper::CommandQueue& GetQueue() { return commandQueue_; }
 	ID3D12GraphicsCommandList4* GetCommnadList() const { return commandList_.Get(); }
 	ID3D12CommandAllocator* GetCommandAllocator(uint32_t index) const { return commandAllocator_[index].Get(); }
-	ID3D12Fence* GetFence() const { return fence_.Get(); }
+	ID3D12Fence* GetFence() const { return commandQueue_.GetFence(); }
+	const Engine::FrameScheduler& GetFrameScheduler() const { return frameScheduler_; }
+	// ワーカースレッドで記録するコマンドリストの取得先
+	DirectXHelper::CommandListAllocator& GetCommandListAllocator() { return commandListAllocator_; }
+	// パーティクルの更新を描画と並行して行うキュー（待ち合わせはEngine::AsyncComputeSchedulerを使う側が持つ）
+	DirectXHelper::CommandQueue& GetComputeQueue() { return computeQueue_; }
+	DirectXHelper::CommandListAllocator& GetComputeCommandListAllocator() { return computeCommandListAllocator_; }
 	DirectXHelper::DescriptorHeap& GetRTVHeap() { return rtvHeap_; }
 	DirectXHelper::DescriptorHeap& GetDSVHeap() { return dsvHeap_; }
 	DirectXHelper::DescriptorHeap& GetCommonHeap() { return commonHeap_; }
+	// ヒープに配置するリソースの確保先
+	DirectXHelper::ResourceAllocator& GetResourceAllocator() { return resourceAllocator_; }
+	// GPUが使い終えてから解放するものの預け先（DirectXHelper::DeferredReleaseが使う）
+	Engine::DeferredReleaseQueue& GetDeferredReleaseQueue() { return deferredReleaseQueue_; }
+	// このフレームだけ使うデータの書き込み先
+	DirectXHelper::UploadBuffer& GetUploadBuffer() { return uploadBuffer_; }
 	IDXGISwapChain4* GetSwapChain() const { return swapChain_.Get(); }
 	ID3D12Resource* GetSwapChianResource(uint32_t index) const { return swapChainResource_[index].Get(); }
 	const DirectXHelper::Descriptor& GetRTVHandle(uint32_t index) const { return rtvHandle_[index]; }
@@ -43,6 +86,7 @@ private:
 	void CreateDevice();
 	void CreateCommands();
 	void CreateDescriptorHeap();
+	void CreateUploadBuffer();
 	void CreateSwapChain();
 	void CreateDepthStencilBuffer();
 	void CreateImGui();
@@ -51,18 +95,24 @@ private:
 
 	DirectXHelper::ComPtr<ID3D12Device5>				device_;
 	DirectXHelper::ComPtr<IDXGIFactory7>				dxgiFactory_;
+	// 配置したリソースより後に破棄するので先に宣言する
+	DirectXHelper::ResourceAllocator					resourceAllocator_;
 
-	DirectXHelper::ComPtr<ID3D12CommandQueue>			commandQueue_;
+	DirectXHelper::CommandQueue							commandQueue_;
+	Engine::DeferredReleaseQueue						deferredReleaseQueue_;
 	DirectXHelper::ComPtr<ID3D12GraphicsCommandList4>	commandList_;
-	DirectXHelper::ComPtr<ID3D12CommandAllocator>		commandAllocator_[kSwapChainBufferCount];
-
-	DirectXHelper::ComPtr<ID3D12Fence>					fence_;
-	uint64_t											fenceValue_{ 0 };
-	HANDLE												fenceEvent_{};
+	DirectXHelper::ComPtr<ID3D12CommandAllocator>		commandAllocator_[kFrameCount];
+	Engine::FrameScheduler								frameScheduler_;
+	DirectXHelper::CommandListAllocator					commandListAllocator_;
+	DirectXHelper::CommandQueue							computeQueue_;
+	DirectXHelper::CommandListAllocator					computeCommandListAllocator_;
 
 	DirectXHelper::DescriptorHeap						rtvHeap_;
 	DirectXHelper::DescriptorHeap						dsvHeap_;
 	DirectXHelper::DescriptorHeap						commonHeap_;
+	DirectXHelper::Descriptor							transientDescriptorRange_{};
+	Engine::TransientDescriptorRing						transientDescriptorRing_;
+	DirectXHelper::UploadBuffer							uploadBuffer_;
 
 	DirectXHelper::ComPtr<IDXGISwapChain4>				swapChain_;
 	DirectXHelper::ComPtr<ID3D12Resource>				swapChainResource_[kSwapChainBufferCount]{};
@@ -1,4 +1,7 @@
 #pragma once
+#include "DeferredReleaseQueue.h"
+#include "DescriptorAllocator.h"
+#include "ResourceAllocator.h"
 
 #define CHECK_HRESULT(hr) { if(FAILED(hr)) assert(false); }
 
@@ -22,6 +25,23 @@ namespace DirectXHelper {
 		D3D12_RESOURCE_STATES initState,
 		D3D12_HEAP_TYPE heapType);
 	/// <summary>
+	/// ResourceAllocatorのヒープに配置してバッファを生成
+	/// </summary>
+	/// <param name="allocator">配置先</param>
+	/// <param name="allocation">配置したメモリ（バッファより長く持つこと）</param>
+	/// <param name="size">バッファサイズ</param>
+	/// <param name="flags">バッファフラグ</param>
+	/// <param name="initState">初期化状態</param>
+	/// <param name="heapType">ヒープの種類</param>
+	/// <returns></returns>
+	ComPtr<ID3D12Resource> CreateBuffer(
+		ResourceAllocator& allocator,
+		std::shared_ptr<ResourceAllocation>& allocation,
+		uint64_t size,
+		D3D12_RESOURCE_FLAGS flags,
+		D3D12_RESOURCE_STATES initState,
+		D3D12_HEAP_TYPE heapType);
+	/// <summary>
 	/// UAVバッファを生成
 	/// </summary>
 	/// <param name="device">デバイス</param>
@@ -44,6 +64,32 @@ namespace DirectXHelper {
 	uint64_t Align(uint64_t value, uint64_t alignment);
 	uint32_t Align(uint32_t value, uint32_t alignment);
 
+	/// <summary>
+	/// DeferredReleaseで預けるキューを設定（DirectXDeviceが設定する、nullptrならすぐに解放する）
+	/// </summary>
+	void SetDeferredReleaseQueue(Engine::DeferredReleaseQueue* queue);
+	/// <summary>
+	/// GPUが使い終えてから解放する（参照を一つ預ける）
+	/// </summary>
+	void DeferredRelease(IUnknown* object);
+	/// <summary>
+	/// GPUが使い終えてからdestroyを呼ぶ（キューが無ければすぐに呼ぶ）
+	/// </summary>
+	void DeferredRelease(void* object, Engine::DeferredReleaseQueue::DestroyFunction destroy);
+	/// <summary>
+	/// 作り直す前に古いオブジェクトを預けて、objectを空にする
+	/// </summary>
+	template<class T>
+	void DeferredRelease(ComPtr<T>& object) { DeferredRelease(static_cast<IUnknown*>(object.Detach())); }
+	/// <summary>
+	/// 参照を一つ預けて、objectを空にする（最後の参照ならGPUが使い終えてから破棄される）
+	/// </summary>
+	template<class T>
+	void DeferredRelease(std::shared_ptr<T>& object) {
+		if (!object) { return; }
+		DeferredRelease(new std::shared_ptr<T>(std::move(object)), [](void* holder) { delete static_cast<std::shared_ptr<T>*>(holder); });
+	}
+
 
 #pragma region ディスクリプタヒープ
 	class DescriptorHeap;
@@ -73,26 +119,73 @@ namespace DirectXHelper {
 			bool isShaderVisible,
 			const std::string& name = "DescriptorHeap");
 
-		[[nodiscard]] Descriptor Allocate();
+		/// <summary>
+		/// ディスクリプタを確保
+		/// </summary>
+		/// <param name="count">連続して確保する数（ディスクリプタテーブル用）</param>
+		/// <returns>先頭のディスクリプタ、確保できない場合は無効なディスクリプタ</returns>
+		[[nodiscard]] Descriptor Allocate(uint32_t count = 1);
+		/// <summary>
+		/// Allocateで確保したディスクリプタを返す（連続して確保した場合は先頭を渡す）
+		/// シェーダーから見えるヒープでは、このフレームのフェンス値をGPUが通過したBeginFrameで再利用される
+		/// </summary>
+		/// <param name="descriptorHandle"></param>
 		void Deallocate(Descriptor& descriptorHandle);
+		/// <summary>
+		/// フレームの開始
+		/// GPUが通過したフレームで返したディスクリプタを戻す
+		/// </summary>
+		/// <param name="completedFenceValue">GPUが完了したフェンス値</param>
+		void BeginFrame(uint64_t completedFenceValue);
+		/// <summary>
+		/// フレームの終了
+		/// このフレームで返したディスクリプタをフェンス値と一緒に記録する
+		/// </summary>
+		/// <param name="fenceValue">このフレームのコマンドの後にシグナルしたフェンス値</param>
+		void EndFrame(uint64_t fenceValue);
+		/// <summary>
+		/// ヒープの中の位置からディスクリプタを取得（確保はしない）
+		/// 別のアロケーターで管理している範囲の位置を変換するときに使う
+		/// </summary>
+		/// <param name="index">ヒープの先頭からの位置</param>
+		/// <returns></returns>
+		Descriptor GetDescriptor(uint32_t index) const;
+		/// <summary>
+		/// ディスクリプタのヒープの中の位置
+		/// </summary>
+		/// <param name="descriptorHandle">このヒープのディスクリプタ</param>
+		/// <returns></returns>
+		uint32_t GetIndex(const Descriptor& descriptorHandle) const;
 
 		ID3D12DescriptorHeap* Get() const { return heap_.Get(); }
 		DirectXHelper::ComPtr<ID3D12DescriptorHeap> GetComPtr() const { return heap_; }
 		uint32_t GetCapacity() const { return capacity_; }
-		uint32_t GetSize() const { return allocateIndex_; }
+		uint32_t GetSize() const { return allocator_.GetUsedCount(); }
+		Engine::DescriptorAllocator::Statistics GetStatistics() const { return allocator_.GetStatistics(); }
 		uint32_t GetDescriptorSize() const { return descriptorSize_; }
 		D3D12_DESCRIPTOR_HEAP_TYPE GetType() const { return type_; }
 		bool IsShaderVisible() const { return gpuStartHandle_.ptr != 0; }
 		bool IsEnabled() const { return heap_; }
 
 	private:
+		// GPUが通過するまで戻さないディスクリプタ
+		struct RetiredDescriptor {
+			uint32_t index;
+			uint64_t fenceValue;
+		};
+		void Free(uint32_t index);
+
 		DirectXHelper::ComPtr<ID3D12DescriptorHeap> heap_;
 		D3D12_CPU_DESCRIPTOR_HANDLE cpuStartHandle_{};
 		D3D12_GPU_DESCRIPTOR_HANDLE gpuStartHandle_{};
+		Engine::DescriptorAllocator allocator_;
 		uint32_t capacity_{};
-		uint32_t allocateIndex_{};
 		uint32_t descriptorSize_{};
 		D3D12_DESCRIPTOR_HEAP_TYPE type_{};
+		// このフレームで返したもの（EndFrameでフェンス値を付ける）
+		std::vector<uint32_t> frameRetiredIndices_;
+		// フェンス値の順
+		std::deque<RetiredDescriptor> retiredDescriptors_;
 	};
 #pragma endregion ディスクリプタヒープ
 
@@ -4,6 +4,10 @@
 #include "Vector4.h"
 #include "Quaternion.h"
 #include "Matrix4x4.h"
+#include "Vector3d.h"
+#include "BoundingVolume.h"
+#include "FastMath.h"
+#include "Packing.h"
 
 namespace Math {
 
@@ -1,19 +1,69 @@
 #pragma once
 #include "DirectXHelper.h"
+#include "ShaderCache.h"
+#include "ShaderCompileOptions.h"
+#include "ShaderCompileQueue.h"
+#include "ShaderCompilerBackend.h"
+
+// DXCでコンパイルする
+class DxcShaderCompiler :
+	public Engine::ShaderCompilerBackend {
+public:
+	bool Initalize();
+	bool Compile(const Engine::ShaderCompileDesc& desc, std::vector<uint8_t>& bytecode, std::string& errors) override;
+
+	IDxcUtils* GetUtils() const { return utils_.Get(); }
+
+private:
+	// 引数に -Fd があれば、そのディレクトリにPDBを書く
+	void WritePDB(const Engine::ShaderCompileDesc& desc, IDxcResult* shaderResult);
+
+	DirectXHelper::ComPtr<IDxcUtils> utils_;
+	DirectXHelper::ComPtr<IDxcCompiler3> compiler_;
+	DirectXHelper::ComPtr<IDxcIncludeHandler> includeHandler_;
+};
 
 class ShaderCompiler {
 public:
+	// コンパイルしたシェーダーを残すディレクトリ（作業ディレクトリから）
+	static constexpr const char* kCacheDirectory = "ShaderCache";
+
 	static void Initalize();
+	/// <summary>
+	/// コンパイルのスレッドを止めて、キャッシュのファイルを閉じる（DXCを解放する前に呼ぶ）
+	/// </summary>
+	static void Finalize();
+	/// <summary>
+	/// コンパイルして、終わるまで待つ
+	/// </summary>
 	static DirectXHelper::ComPtr<IDxcBlob> Compile(const std::wstring& fileName, const std::wstring& entryPoint, const std::wstring& profile);
+	/// <summary>
+	/// コンパイルを積んですぐに戻る（まとめて積んでからGetBlobで受け取ると並行してコンパイルされる）
+	/// </summary>
+	/// <param name="permutationSpace">#defineの組み合わせ（nullptrなら使わない）</param>
+	/// <param name="permutationKey">permutationSpaceのキー</param>
+	static Engine::ShaderCompileFuture CompileAsync(const std::wstring& fileName, const std::wstring& entryPoint, const std::wstring& profile,
+		const Engine::ShaderPermutationSpace* permutationSpace = nullptr, Engine::ShaderPermutationSpace::Key permutationKey = 0);
+	/// <summary>
+	/// 最適化とデバッグ情報の設定（既定はビルドの構成に合わせたもの、以降に積むものから使う）
+	/// </summary>
+	static void SetOptions(const Engine::ShaderCompileOptions& options);
+	/// <summary>
+	/// CompileAsyncの結果を待ってBlobにする
+	/// </summary>
+	/// <returns>コンパイルできなければnullptr</returns>
+	static DirectXHelper::ComPtr<IDxcBlob> GetBlob(const Engine::ShaderCompileFuture& future);
 
 private:
 	static ShaderCompiler* GetInstance();
 	void InternalInitalize();
-	DirectXHelper::ComPtr<IDxcBlob> InternalCompile(const std::wstring& fileName, const std::wstring& entryPoint, const std::wstring& profile);
-
+	Engine::ShaderCompileFuture InternalCompileAsync(const std::wstring& fileName, const std::wstring& entryPoint, const std::wstring& profile,
+		const Engine::ShaderPermutationSpace* permutationSpace, Engine::ShaderPermutationSpace::Key permutationKey);
+	DirectXHelper::ComPtr<IDxcBlob> InternalGetBlob(const Engine::ShaderCompileFuture& future);
 
+	// Blobを作る（コンパイルはワーカーごとのDxcShaderCompilerで行う）
 	DirectXHelper::ComPtr<IDxcUtils> utils_;
-	DirectXHelper::ComPtr<IDxcCompiler3> compiler_;
-	DirectXHelper::ComPtr<IDxcIncludeHandler> includeHandler_;
+	Engine::ShaderCache cache_;
+	Engine::ShaderCompileQueue queue_;
+	Engine::ShaderCompileOptions options_{ Engine::ShaderCompileOptions::GetDefault() };
 };
-
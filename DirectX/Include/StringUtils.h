@@ -1,4 +1,13 @@
 #pragma once
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "StringFormat.h"
+
+// UTF-8とUTF-16（wchar_tはWindowsではUTF-16、それ以外ではUTF-32）の変換
+// 不正なバイト列は正しく続いていた所までを1文字としてU+FFFDに置き換える
+// ASCIIが続く部分はSIMDでまとめて変換する
 
 namespace String {
 
@@ -7,12 +16,96 @@ namespace String {
 	// wstringから変換
 	std::string Convert(const std::wstring& str);
 
-	template<typename ... Args>
-	std::string Format(const std::string& format, Args ... args) {
-		size_t len = static_cast<size_t>(std::snprintf(nullptr, 0, format.c_str(), args ...));
-		std::vector<char> buffer(len + 1);
-		std::snprintf(buffer.data(), len + 1, format.c_str(), args ...);
-		return std::string(buffer.data(), buffer.data() + len);
+	// 変換後の長さ（終端を除く）
+	size_t GetUtf16Length(std::string_view utf8);
+	size_t GetWideLength(std::string_view utf8);
+	size_t GetUtf8Length(std::u16string_view utf16);
+	size_t GetUtf8Length(std::wstring_view wide);
+
+	/// <summary>
+	/// バッファに変換して書き込む（常に終端する、収まらない文字は書かない）
+	/// </summary>
+	/// <param name="source"></param>
+	/// <param name="buffer"></param>
+	/// <param name="bufferSize">終端を含む文字数</param>
+	/// <returns>必要な文字数（終端を除く、bufferSize以上なら切り捨てた）</returns>
+	size_t Convert(std::string_view source, char16_t* buffer, size_t bufferSize);
+	size_t Convert(std::string_view source, wchar_t* buffer, size_t bufferSize);
+	size_t Convert(std::u16string_view source, char* buffer, size_t bufferSize);
+	size_t Convert(std::wstring_view source, char* buffer, size_t bufferSize);
+
+	/// <summary>
+	/// 使い回す文字列に変換する（容量が足りていれば確保しない）
+	/// </summary>
+	void ConvertTo(std::string_view source, std::u16string& result);
+	void ConvertTo(std::string_view source, std::wstring& result);
+	void ConvertTo(std::u16string_view source, std::string& result);
+	void ConvertTo(std::wstring_view source, std::string& result);
+
+	// 短い文字列はメンバーの配列に置き、収まらない場合だけヒープを使う
+	// SmallString<wchar_t, N>はUTF-8から、SmallString<char, N>はwchar_tから変換する
+	template<class CharT, size_t N>
+	class SmallString {
+	public:
+		static_assert(N > 0);
+		using SourceChar = std::conditional_t<std::is_same_v<CharT, char>, wchar_t, char>;
+
+		SmallString() {
+			local_[0] = 0;
+		}
+		explicit SmallString(std::basic_string_view<SourceChar> source) {
+			Assign(source);
+		}
+
+		SmallString& Assign(std::basic_string_view<SourceChar> source) {
+			heap_.clear();
+			// 変換後の文字数はUTF-8からなら元のバイト数以下、wchar_tからなら元の3倍（UTF-32なら4倍）以下
+			constexpr size_t kMaxExpansion = std::is_same_v<CharT, char> ? (sizeof(wchar_t) == 2 ? 3 : 4) : 1;
+			if (source.size() * kMaxExpansion < N || GetConvertedLength(source) < N) {
+				length_ = Convert(source, local_, N);
+			}
+			else {
+				ConvertTo(source, heap_);
+				length_ = heap_.size();
+			}
+			return *this;
+		}
+
+		const CharT* GetCString() const { return heap_.empty() ? local_ : heap_.c_str(); }
+		std::basic_string_view<CharT> GetView() const { return std::basic_string_view<CharT>(GetCString(), length_); }
+		operator std::basic_string_view<CharT>() const { return GetView(); }
+		size_t GetLength() const { return length_; }
+		// ヒープを使っていないか
+		bool IsLocal() const { return heap_.empty(); }
+		static constexpr size_t GetLocalCapacity() { return N - 1; }
+
+	private:
+		static size_t GetConvertedLength(std::basic_string_view<SourceChar> source) {
+			if constexpr (std::is_same_v<CharT, char>) { return GetUtf8Length(source); }
+			else { return GetWideLength(source); }
+		}
+
+		// 使う所まで書くので0で埋めない
+		CharT local_[N];
+		std::basic_string<CharT> heap_;
+		size_t length_{ 0 };
+	};
+
+	inline constexpr size_t kSmallStringSize = 128;
+
+	/// <summary>
+	/// UTF-8からwchar_tに変換する（短ければ確保しない）
+	/// </summary>
+	/// <param name="utf8"></param>
+	/// <returns>GetCString()でSetNameなどに渡す</returns>
+	inline SmallString<wchar_t, kSmallStringSize> ToWide(std::string_view utf8) {
+		return SmallString<wchar_t, kSmallStringSize>(utf8);
+	}
+	/// <summary>
+	/// wchar_tからUTF-8に変換する（短ければ確保しない）
+	/// </summary>
+	inline SmallString<char, kSmallStringSize> ToUtf8(std::wstring_view wide) {
+		return SmallString<char, kSmallStringSize>(wide);
 	}
 
 };
@@ -1,24 +1,37 @@
 #include "stdafx.h"
 #include "Logger.h"
 
-void Logger::Write(const std::string& str) {
-	GetInstance()->stream_ << str << std::endl;
+void Logger::Write(std::string_view str) {
+	GetInstance()->logger_.Log(Engine::LogSeverity::Info, str);
 }
 
-void Logger::Info(const std::string& str) {
-	GetInstance()->stream_ << "Info      : " + str << std::endl;
+void Logger::Info(std::string_view str) {
+	GetInstance()->logger_.Log(Engine::LogSeverity::Info, str);
 }
 
-void Logger::Warning(const std::string& str) {
-	GetInstance()->stream_ << "Warning   : " + str << std::endl;
+void Logger::Warning(std::string_view str) {
+	GetInstance()->logger_.Log(Engine::LogSeverity::Warning, str);
 }
 
-void Logger::Error(const std::string& str) {
-	GetInstance()->stream_ << "Error     : " + str << std::endl;
+void Logger::Error(std::string_view str) {
+	GetInstance()->logger_.Log(Engine::LogSeverity::Error, str);
+	GetInstance()->logger_.Flush();
 }
 
 void Logger::Border() {
-	GetInstance()->stream_ << "-------------------------------------------------" << std::endl;
+	GetInstance()->logger_.Log(Engine::LogSeverity::Info, "-------------------------------------------------");
+}
+
+void Logger::Flush() {
+	GetInstance()->logger_.Flush();
+}
+
+void Logger::SetMinSeverity(Engine::LogSeverity severity) {
+	GetInstance()->logger_.SetMinSeverity(severity);
+}
+
+Engine::AsyncLogger& Logger::GetAsyncLogger() {
+	return GetInstance()->logger_;
 }
 
 Logger* Logger::GetInstance() {
@@ -27,5 +40,6 @@ Logger* Logger::GetInstance() {
 }
 
 Logger::Logger() {
-	stream_.open("Log.txt");
+	sink_.Open("Log.txt");
+	logger_.Initalize(&sink_);
 }
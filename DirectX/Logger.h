@@ -1,13 +1,47 @@
 #pragma once
+#include "AsyncLogger.h"
+#include "StringFormat.h"
 
+// コンパイル時と実行時の重要度で絞り込むログ（絞り込まれた場合はmessageを評価しない）
+#define LOG_TRACE(message) ENGINE_LOG(Logger::GetAsyncLogger(), Engine::LogSeverity::Trace, message)
+#define LOG_INFO(message) ENGINE_LOG(Logger::GetAsyncLogger(), Engine::LogSeverity::Info, message)
+#define LOG_WARNING(message) ENGINE_LOG(Logger::GetAsyncLogger(), Engine::LogSeverity::Warning, message)
+#define LOG_ERROR(message) ENGINE_LOG(Logger::GetAsyncLogger(), Engine::LogSeverity::Error, message)
+
+// Log.txtに書き出す
+// 呼び出したスレッドでは積むだけで、書き出しはEngine::AsyncLoggerのスレッドが行う
 class Logger {
 public:
-	static void Write(const std::string& str);
-	static void Info(const std::string& str);
-	static void Warning(const std::string& str);
-	static void Error(const std::string& str);
+	static void Write(std::string_view str);
+	static void Info(std::string_view str);
+	static void Warning(std::string_view str);
+	// 直後にassertで止まることが多いので、書き出しまで待つ
+	static void Error(std::string_view str);
 	static void Border();
 
+	// 書式化して積む（スレッドごとのバッファを使うので確保しない）
+	template<class Arg, class... Args>
+	static void Write(String::FormatString<std::type_identity_t<Arg>, std::type_identity_t<Args>...> format, const Arg& arg, const Args&... args) {
+		Write(String::FormatTemporary(format, arg, args...));
+	}
+	template<class Arg, class... Args>
+	static void Info(String::FormatString<std::type_identity_t<Arg>, std::type_identity_t<Args>...> format, const Arg& arg, const Args&... args) {
+		Info(String::FormatTemporary(format, arg, args...));
+	}
+	template<class Arg, class... Args>
+	static void Warning(String::FormatString<std::type_identity_t<Arg>, std::type_identity_t<Args>...> format, const Arg& arg, const Args&... args) {
+		Warning(String::FormatTemporary(format, arg, args...));
+	}
+	template<class Arg, class... Args>
+	static void Error(String::FormatString<std::type_identity_t<Arg>, std::type_identity_t<Args>...> format, const Arg& arg, const Args&... args) {
+		Error(String::FormatTemporary(format, arg, args...));
+	}
+	// ここまでのログを書き出すまで待つ
+	static void Flush();
+
+	static void SetMinSeverity(Engine::LogSeverity severity);
+	static Engine::AsyncLogger& GetAsyncLogger();
+
 private:
 	static Logger* GetInstance();
 
@@ -16,6 +50,7 @@ private:
 	Logger(const Logger&) = delete;
 	const Logger& operator=(const Logger&) = delete;
 
-	std::ofstream stream_;
+	// loggerより後に破棄する
+	Engine::FileLogSink sink_;
+	Engine::AsyncLogger logger_;
 };
-
@@ -0,0 +1,84 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _MSC_VER
+#include <Windows.h>
+#include "StringUtils.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _MSC_VER
+
+namespace Engine {
+
+	MappedFile::~MappedFile() {
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept :
+		data_(std::exchange(other.data_, nullptr)),
+		size_(std::exchange(other.size_, 0)) {
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			Close();
+			data_ = std::exchange(other.data_, nullptr);
+			size_ = std::exchange(other.size_, 0);
+		}
+		return *this;
+	}
+
+	bool MappedFile::Open(const char* path) {
+		Close();
+#ifdef _MSC_VER
+		// 書き込み側が置き換えられるように、削除も許可して開く
+		HANDLE file = CreateFileW(String::ToWide(path).GetCString(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) { return false; }
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+			CloseHandle(file);
+			return false;
+		}
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (!mapping) { return false; }
+		// ビューがマッピングを保持するので、ハンドルは閉じてよい
+		void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (!data) { return false; }
+		data_ = data;
+		size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+		int file = open(path, O_RDONLY | O_CLOEXEC);
+		if (file < 0) { return false; }
+		struct stat fileStatus {};
+		if (fstat(file, &fileStatus) != 0 || fileStatus.st_size <= 0) {
+			close(file);
+			return false;
+		}
+		void* data = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		// マップした後はファイルを閉じてよい
+		close(file);
+		if (data == MAP_FAILED) { return false; }
+		data_ = data;
+		size_ = static_cast<size_t>(fileStatus.st_size);
+#endif // _MSC_VER
+		return true;
+	}
+
+	void MappedFile::Close() {
+		if (!data_) { return; }
+#ifdef _MSC_VER
+		UnmapViewOfFile(data_);
+#else
+		munmap(const_cast<void*>(data_), size_);
+#endif // _MSC_VER
+		data_ = nullptr;
+		size_ = 0;
+	}
+
+}
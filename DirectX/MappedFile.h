@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Engine {
+
+	// 読み取り専用でメモリに割り当てたファイル（Windowsでは MapViewOfFile、それ以外では mmap）
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		/// <summary>
+		/// 開く（開いていれば先に閉じる）
+		/// </summary>
+		/// <param name="path">UTF-8</param>
+		/// <returns>開けない、または空のファイルならfalse</returns>
+		bool Open(const char* path);
+		void Close();
+
+		bool IsOpen() const { return data_ != nullptr; }
+		const uint8_t* GetData() const { return static_cast<const uint8_t*>(data_); }
+		size_t GetSize() const { return size_; }
+
+	private:
+		const void* data_{ nullptr };
+		size_t size_{ 0 };
+	};
+
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+// 数学ライブラリのまとめて処理する関数で使うSIMD命令の選択
+// x64は常にSSE2が使えるので、それ以外の環境ではスカラー実装になる
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+// 半精度の変換命令（MSVCはF16Cのマクロがないので/arch:AVX2で判定する）
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define MATH_SIMD_F16C
+#include <immintrin.h>
+#endif
@@ -6,7 +6,7 @@ const Matrix4x4 Matrix4x4::identity{
 	0.0f,0.0f,1.0f,0.0f,
 	0.0f,0.0f,0.0f,1.0f };
 
-float Matrix4x4::GetDeterminant() {
+float Matrix4x4::GetDeterminant() const {
 	float result = 0.0f;
 
 	result += m[0][0] * m[1][1] * m[2][2] * m[3][3]; // +11,22,33,44
@@ -43,7 +43,7 @@ float Matrix4x4::GetDeterminant() {
 
 	return result;
 }
-Matrix4x4 Matrix4x4::GetAdjugate() {
+Matrix4x4 Matrix4x4::GetAdjugate() const {
 	Matrix4x4 result;
 	// 1行目
 	result.m[0][0] = 0.0f;							// 11
@@ -1,4 +1,9 @@
 #pragma once
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "Property.h"
 #include "Vector3.h"
 class Vector4;
 class Quaternion;
@@ -39,55 +44,55 @@ public:
 	/// <summary>
 	/// 行
 	/// </summary>
-	__declspec(property(get = GetRow, put = SetRow)) Vector4 row[];
+	PROPERTY(Vector4 row[], get = GetRow, put = SetRow);
 	inline Matrix4x4& SetRow(size_t i, const Vector4& v);
 	inline Vector4 GetRow(size_t i) const;
 	/// <summary>
 	/// 列
 	/// </summary>
-	__declspec(property(get = GetColumn, put = SetColumn)) Vector4 column[];
+	PROPERTY(Vector4 column[], get = GetColumn, put = SetColumn);
 	inline Matrix4x4& SetColumn(size_t i, const Vector4& v);
 	inline Vector4 GetColumn(size_t i) const;
 	/// <summary>
 	/// X軸の向き（読み取り専用）
 	/// </summary>
-	__declspec(property(get = GetXAxis)) Vector3 xAxis;
+	PROPERTY(Vector3 xAxis, get = GetXAxis);
 	inline Vector3 GetXAxis() const;
 	/// <summary>
 	/// Y軸の向き（読み取り専用）
 	/// </summary>
-	__declspec(property(get = GetXAxis)) Vector3 yAxis;
+	PROPERTY(Vector3 yAxis, get = GetYAxis);
 	inline Vector3 GetYAxis() const;
 	/// <summary>
 	/// Z軸の向き（読み取り専用）
 	/// </summary>
-	__declspec(property(get = GetXAxis)) Vector3 zAxis;
+	PROPERTY(Vector3 zAxis, get = GetZAxis);
 	inline Vector3 GetZAxis() const;
 	/// <summary>
 	/// 平行移動成分（読み取り専用）
 	/// </summary>
-	__declspec(property(get = GetTranslate)) Vector3 translate;
+	PROPERTY(Vector3 translate, get = GetTranslate);
 	inline Vector3 GetTranslate() const;
 	/// <summary>
 	/// 行列式（読み取り専用）
 	/// </summary>
-	__declspec(property(get = GetDeterminant)) float determinant;
-	float GetDeterminant();
+	PROPERTY(float determinant, get = GetDeterminant);
+	float GetDeterminant() const;
 	/// <summary>
 	/// 余因子行列（読み取り専用）
 	/// </summary>
-	__declspec(property(get = GetAdjugate)) Matrix4x4 adjugate;
-	Matrix4x4 GetAdjugate();
+	PROPERTY(Matrix4x4 adjugate, get = GetAdjugate);
+	Matrix4x4 GetAdjugate() const;
 	/// <summary>
 	/// 逆行列（読み取り専用）
 	/// </summary>
-	__declspec(property(get = GetInverse)) Matrix4x4 inverse;
-	inline Matrix4x4 GetInverse();
+	PROPERTY(Matrix4x4 inverse, get = GetInverse);
+	inline Matrix4x4 GetInverse() const;
 	/// <summary>
 	/// 転置行列（読み取り専用）
 	/// </summary>
-	__declspec(property(get = GetTranspose)) Matrix4x4 transpose;
-	inline Matrix4x4 GetTranspose();
+	PROPERTY(Matrix4x4 transpose, get = GetTranspose);
+	inline Matrix4x4 GetTranspose() const;
 
 	/// <summary>
 	/// 拡大縮小行列
@@ -134,11 +134,11 @@ inline Vector3 Matrix4x4::GetTranslate() const {
 	return { m[3][0], m[3][1], m[3][2] };
 }
 
-inline Matrix4x4 Matrix4x4::GetInverse() {
+inline Matrix4x4 Matrix4x4::GetInverse() const {
 	return 1.0f / GetDeterminant() * GetAdjugate();
 }
 
-inline Matrix4x4 Matrix4x4::GetTranspose() {
+inline Matrix4x4 Matrix4x4::GetTranspose() const {
 	return {
 		m[0][0], m[1][0], m[2][0], m[3][0],
 		m[0][1], m[1][1], m[2][1], m[3][1],
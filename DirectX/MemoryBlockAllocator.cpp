@@ -0,0 +1,252 @@
+#include "MemoryBlockAllocator.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "Assert.h"
+
+namespace Engine {
+
+	bool MemoryBlockAllocator::Initalize(uint64_t capacity) {
+		if (capacity == 0) {
+			ASSERT_MSG(false, "Invalid capacity");
+			return false;
+		}
+		capacity_ = capacity;
+		Reset();
+		return true;
+	}
+
+	MemoryBlockAllocator::Allocation MemoryBlockAllocator::Allocate(uint64_t size, uint64_t alignment) {
+		ASSERT_MSG(size > 0, "Zero size allocation");
+		ASSERT_MSG(alignment != 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two");
+		if (size == 0 || size > capacity_ - usedSize_ || alignment == 0 || alignment > capacity_) { return {}; }
+
+		uint32_t firstLevel = 0, secondLevel = 0;
+		MappingSearch(size, firstLevel, secondLevel);
+		uint32_t index = FindFreeBlock(firstLevel, secondLevel);
+		auto fits = [&](uint32_t blockIndex) {
+			const Block& block = blocks_[blockIndex];
+			uint64_t alignedOffset = (block.offset + alignment - 1) & ~(alignment - 1);
+			return alignedOffset + size <= block.offset + block.size;
+		};
+		// 見つかった空きの先頭が揃っていない場合は、ずらしても収まる大きさで探し直す
+		if ((index == kInvalidHandle || !fits(index)) && alignment > 1) {
+			if (size > capacity_ - (alignment - 1)) { return {}; }
+			MappingSearch(size + alignment - 1, firstLevel, secondLevel);
+			index = FindFreeBlock(firstLevel, secondLevel);
+		}
+		if (index == kInvalidHandle) { return {}; }
+		RemoveFreeBlock(index);
+
+		// 前側の余りは空きのまま残す
+		uint64_t padding = ((blocks_[index].offset + alignment - 1) & ~(alignment - 1)) - blocks_[index].offset;
+		if (padding > 0) {
+			SplitBlock(index, padding);
+			InsertFreeBlock(index);
+			index = blocks_[index].nextPhysical;
+		}
+		// 後ろ側の余りを空きとして戻す
+		if (blocks_[index].size > size) {
+			SplitBlock(index, size);
+			InsertFreeBlock(blocks_[index].nextPhysical);
+		}
+		blocks_[index].isFree = false;
+		usedSize_ += size;
+		++allocationCount_;
+		return Allocation{ blocks_[index].offset, index };
+	}
+
+	bool MemoryBlockAllocator::Deallocate(uint32_t handle) {
+		if (!IsAllocated(handle)) {
+			ASSERT_MSG(false, "Deallocated a block that is not allocated (double free?)");
+			return false;
+		}
+		usedSize_ -= blocks_[handle].size;
+		--allocationCount_;
+		blocks_[handle].isFree = true;
+
+		// 後ろの空きと結合
+		uint32_t next = blocks_[handle].nextPhysical;
+		if (next != kInvalidHandle && blocks_[next].isFree) {
+			RemoveFreeBlock(next);
+			MergeWithNext(handle);
+		}
+		// 前の空きと結合
+		uint32_t prev = blocks_[handle].prevPhysical;
+		if (prev != kInvalidHandle && blocks_[prev].isFree) {
+			RemoveFreeBlock(prev);
+			MergeWithNext(prev);
+			handle = prev;
+		}
+		InsertFreeBlock(handle);
+		return true;
+	}
+
+	void MemoryBlockAllocator::Reset() {
+		blocks_.clear();
+		unusedNodeHead_ = kInvalidHandle;
+		std::fill(&freeHeads_[0][0], &freeHeads_[0][0] + kFirstLevelCount * kSecondLevelCount, kInvalidHandle);
+		std::fill(std::begin(secondLevelBitmaps_), std::end(secondLevelBitmaps_), 0u);
+		firstLevelBitmap_ = 0;
+		firstPhysical_ = kInvalidHandle;
+		usedSize_ = 0;
+		allocationCount_ = 0;
+		if (capacity_ == 0) { return; }
+
+		firstPhysical_ = CreateNode();
+		Block& block = blocks_[firstPhysical_];
+		block.offset = 0;
+		block.size = capacity_;
+		block.isFree = true;
+		InsertFreeBlock(firstPhysical_);
+	}
+
+	bool MemoryBlockAllocator::IsAllocated(uint32_t handle) const {
+		return handle < blocks_.size() && blocks_[handle].isUsed && !blocks_[handle].isFree;
+	}
+
+	MemoryBlockAllocator::Statistics MemoryBlockAllocator::GetStatistics() const {
+		Statistics statistics{};
+		statistics.capacity = capacity_;
+		statistics.usedSize = usedSize_;
+		statistics.allocationCount = allocationCount_;
+		bool foundFree = false;
+		uint64_t freeSize = 0;
+		for (uint32_t index = firstPhysical_; index != kInvalidHandle; index = blocks_[index].nextPhysical) {
+			const Block& block = blocks_[index];
+			if (block.isFree) {
+				foundFree = true;
+				++statistics.freeBlockCount;
+				freeSize += block.size;
+				statistics.largestFreeBlock = std::max(statistics.largestFreeBlock, block.size);
+			}
+			else if (foundFree) {
+				statistics.movableSize += block.size;
+			}
+		}
+		statistics.fragmentation = freeSize > 0 ? 1.0f - static_cast<float>(static_cast<double>(statistics.largestFreeBlock) / static_cast<double>(freeSize)) : 0.0f;
+		return statistics;
+	}
+
+	void MemoryBlockAllocator::Mapping(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel) {
+		// 小さい範囲は一段目を使わずに大きさごとに分ける
+		if (size < kSecondLevelCount) {
+			firstLevel = 0;
+			secondLevel = static_cast<uint32_t>(size);
+			return;
+		}
+		uint32_t log2 = static_cast<uint32_t>(std::bit_width(size)) - 1;
+		firstLevel = log2 - kSecondLevelLog2 + 1;
+		secondLevel = static_cast<uint32_t>(size >> (log2 - kSecondLevelLog2)) - kSecondLevelCount;
+	}
+
+	void MemoryBlockAllocator::MappingSearch(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel) {
+		if (size >= kSecondLevelCount) {
+			uint32_t log2 = static_cast<uint32_t>(std::bit_width(size)) - 1;
+			size += (uint64_t(1) << (log2 - kSecondLevelLog2)) - 1;
+		}
+		Mapping(size, firstLevel, secondLevel);
+	}
+
+	uint32_t MemoryBlockAllocator::FindFreeBlock(uint32_t firstLevel, uint32_t secondLevel) const {
+		if (firstLevel >= kFirstLevelCount) { return kInvalidHandle; }
+		uint32_t secondLevelMap = secondLevelBitmaps_[firstLevel] & (~0u << secondLevel);
+		if (secondLevelMap == 0) {
+			// 同じ段に無ければ一段上の空きを使う
+			uint64_t firstLevelMap = firstLevel + 1 < kFirstLevelCount ? firstLevelBitmap_ & (~uint64_t(0) << (firstLevel + 1)) : 0;
+			if (firstLevelMap == 0) { return kInvalidHandle; }
+			firstLevel = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+			secondLevelMap = secondLevelBitmaps_[firstLevel];
+		}
+		secondLevel = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+		return freeHeads_[firstLevel][secondLevel];
+	}
+
+	void MemoryBlockAllocator::InsertFreeBlock(uint32_t index) {
+		Block& block = blocks_[index];
+		uint32_t firstLevel = 0, secondLevel = 0;
+		Mapping(block.size, firstLevel, secondLevel);
+		uint32_t& head = freeHeads_[firstLevel][secondLevel];
+		block.isFree = true;
+		block.prevFree = kInvalidHandle;
+		block.nextFree = head;
+		if (head != kInvalidHandle) {
+			blocks_[head].prevFree = index;
+		}
+		head = index;
+		firstLevelBitmap_ |= uint64_t(1) << firstLevel;
+		secondLevelBitmaps_[firstLevel] |= 1u << secondLevel;
+	}
+
+	void MemoryBlockAllocator::RemoveFreeBlock(uint32_t index) {
+		Block& block = blocks_[index];
+		uint32_t firstLevel = 0, secondLevel = 0;
+		Mapping(block.size, firstLevel, secondLevel);
+		if (block.prevFree != kInvalidHandle) {
+			blocks_[block.prevFree].nextFree = block.nextFree;
+		}
+		else {
+			freeHeads_[firstLevel][secondLevel] = block.nextFree;
+			if (block.nextFree == kInvalidHandle) {
+				secondLevelBitmaps_[firstLevel] &= ~(1u << secondLevel);
+				if (secondLevelBitmaps_[firstLevel] == 0) {
+					firstLevelBitmap_ &= ~(uint64_t(1) << firstLevel);
+				}
+			}
+		}
+		if (block.nextFree != kInvalidHandle) {
+			blocks_[block.nextFree].prevFree = block.prevFree;
+		}
+		block.nextFree = kInvalidHandle;
+		block.prevFree = kInvalidHandle;
+	}
+
+	uint32_t MemoryBlockAllocator::CreateNode() {
+		uint32_t index = unusedNodeHead_;
+		if (index != kInvalidHandle) {
+			unusedNodeHead_ = blocks_[index].nextFree;
+		}
+		else {
+			index = static_cast<uint32_t>(blocks_.size());
+			blocks_.emplace_back();
+		}
+		blocks_[index] = Block{ 0, 0, kInvalidHandle, kInvalidHandle, kInvalidHandle, kInvalidHandle, false, true };
+		return index;
+	}
+
+	void MemoryBlockAllocator::DestroyNode(uint32_t index) {
+		blocks_[index].isUsed = false;
+		blocks_[index].isFree = false;
+		blocks_[index].nextFree = unusedNodeHead_;
+		unusedNodeHead_ = index;
+	}
+
+	void MemoryBlockAllocator::SplitBlock(uint32_t index, uint64_t size) {
+		// CreateNodeで配列が伸びるので参照は後から取る
+		uint32_t restIndex = CreateNode();
+		Block& block = blocks_[index];
+		Block& rest = blocks_[restIndex];
+		rest.offset = block.offset + size;
+		rest.size = block.size - size;
+		rest.prevPhysical = index;
+		rest.nextPhysical = block.nextPhysical;
+		if (rest.nextPhysical != kInvalidHandle) {
+			blocks_[rest.nextPhysical].prevPhysical = restIndex;
+		}
+		block.size = size;
+		block.nextPhysical = restIndex;
+	}
+
+	void MemoryBlockAllocator::MergeWithNext(uint32_t index) {
+		uint32_t next = blocks_[index].nextPhysical;
+		Block& block = blocks_[index];
+		block.size += blocks_[next].size;
+		block.nextPhysical = blocks_[next].nextPhysical;
+		if (block.nextPhysical != kInvalidHandle) {
+			blocks_[block.nextPhysical].prevPhysical = index;
+		}
+		DestroyNode(next);
+	}
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+	// 一つのメモリ範囲（ID3D12Heapなど）の中をバイト単位で切り出す
+	// DescriptorAllocatorと同じTLSF（二段の大きさ別フリーリスト）で確保、解放ともにO(1)
+	// 範囲が大きいので、ブロックの情報はバイト位置ではなくノードの配列に持つ
+	// D3Dに依存しないので、メモリ本体は呼び出し側が持つ
+	class MemoryBlockAllocator {
+	public:
+		// 確保できなかった場合の戻り値
+		static constexpr uint64_t kInvalidOffset = UINT64_MAX;
+		static constexpr uint32_t kInvalidHandle = UINT32_MAX;
+
+		struct Allocation {
+			// 範囲の先頭からのバイト位置
+			uint64_t offset{ kInvalidOffset };
+			// 解放に使う番号
+			uint32_t handle{ kInvalidHandle };
+
+			bool IsEnabled() const { return handle != kInvalidHandle; }
+		};
+
+		struct Statistics {
+			uint64_t capacity;
+			// 確保中のバイト数（アライメントで空けた分は含まない）
+			uint64_t usedSize;
+			// 確保中の範囲の数
+			uint32_t allocationCount;
+			// 空きの範囲の数
+			uint32_t freeBlockCount;
+			// 一度に確保できる最大のバイト数
+			uint64_t largestFreeBlock;
+			// 最初の空きより後ろにある確保中のバイト数（詰め直す場合に動かす量）
+			uint64_t movableSize;
+			// 1 - 最大の空き / 空きの合計（0なら空きが一か所にまとまっている）
+			float fragmentation;
+		};
+
+		/// <summary>
+		/// 初期化（すべて空きになる）
+		/// </summary>
+		/// <param name="capacity">バイト数</param>
+		/// <returns></returns>
+		bool Initalize(uint64_t capacity);
+		/// <summary>
+		/// 範囲を確保
+		/// </summary>
+		/// <param name="size">バイト数</param>
+		/// <param name="alignment">2のべき乗</param>
+		/// <returns>確保できない場合は無効な範囲</returns>
+		[[nodiscard]] Allocation Allocate(uint64_t size, uint64_t alignment = 1);
+		/// <summary>
+		/// Allocateで確保した範囲を解放
+		/// </summary>
+		/// <param name="handle">Allocation::handle</param>
+		/// <returns>確保されていない場合（二重解放など）はfalse</returns>
+		bool Deallocate(uint32_t handle);
+		/// <summary>
+		/// すべて解放する
+		/// </summary>
+		void Reset();
+
+		bool IsAllocated(uint32_t handle) const;
+		/// <summary>
+		/// 使用状況（ブロックをたどるのでデバッグ表示用）
+		/// </summary>
+		/// <returns></returns>
+		Statistics GetStatistics() const;
+
+		uint64_t GetCapacity() const { return capacity_; }
+		uint64_t GetUsedSize() const { return usedSize_; }
+		uint32_t GetAllocationCount() const { return allocationCount_; }
+		bool IsEmpty() const { return allocationCount_ == 0; }
+
+	private:
+		// 二段目の分割数は2^kSecondLevelLog2
+		static constexpr uint32_t kSecondLevelLog2 = 4;
+		static constexpr uint32_t kSecondLevelCount = 1u << kSecondLevelLog2;
+		static constexpr uint32_t kFirstLevelCount = 64 - kSecondLevelLog2 + 1;
+
+		struct Block {
+			uint64_t offset;
+			uint64_t size;
+			// 隣の範囲（アドレス順）
+			uint32_t prevPhysical;
+			uint32_t nextPhysical;
+			// 同じ大きさの空きのリスト（使っていないノードはnextFreeでつなぐ）
+			uint32_t nextFree;
+			uint32_t prevFree;
+			bool isFree;
+			bool isUsed;
+		};
+
+		static void Mapping(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+		static void MappingSearch(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+
+		uint32_t FindFreeBlock(uint32_t firstLevel, uint32_t secondLevel) const;
+		void InsertFreeBlock(uint32_t index);
+		void RemoveFreeBlock(uint32_t index);
+		uint32_t CreateNode();
+		void DestroyNode(uint32_t index);
+		// 先頭からsize分を残して、後ろを新しいブロックに切り離す（空きのリストには入れない）
+		void SplitBlock(uint32_t index, uint64_t size);
+		// 後ろのブロックを結合する（後ろのブロックは空きのリストから外しておく）
+		void MergeWithNext(uint32_t index);
+
+		std::vector<Block> blocks_;
+		uint32_t unusedNodeHead_{ kInvalidHandle };
+		uint32_t freeHeads_[kFirstLevelCount][kSecondLevelCount]{};
+		uint64_t firstLevelBitmap_{};
+		uint32_t secondLevelBitmaps_[kFirstLevelCount]{};
+		// アドレスが0のブロック（結合しても残るのは前側なので変わらない）
+		uint32_t firstPhysical_{ kInvalidHandle };
+		uint64_t capacity_{};
+		uint64_t usedSize_{};
+		uint32_t allocationCount_{};
+	};
+
+}
@@ -0,0 +1,112 @@
+#include "Packing.h"
+
+#include "MathSIMD.h"
+
+namespace {
+
+#if defined(MATH_SIMD_SSE2) && !defined(MATH_SIMD_F16C)
+	// FloatToHalf/HalfToFloatの4要素版
+	// 分岐の代わりに全部の場合を計算して選ぶ
+
+	inline __m128i Select(__m128i mask, __m128i ifTrue, __m128i ifFalse) {
+		return _mm_or_si128(_mm_and_si128(mask, ifTrue), _mm_andnot_si128(mask, ifFalse));
+	}
+
+	// 結果は各32ビットの下位16ビット
+	inline __m128i FloatToHalf4(__m128 value) {
+		const __m128i kHalfMax = _mm_set1_epi32((127 + 16) << 23);
+		const __m128i kHalfMinNormal = _mm_set1_epi32((127 - 14) << 23);
+		const __m128i kDenormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+
+		__m128i bits = _mm_castps_si128(value);
+		__m128i sign = _mm_and_si128(bits, _mm_set1_epi32(static_cast<int32_t>(0x80000000u)));
+		bits = _mm_xor_si128(bits, sign);
+
+		__m128i infinityOrNaN = Select(
+			_mm_cmpgt_epi32(bits, _mm_set1_epi32(0x7F800000)),
+			_mm_set1_epi32(0x7E00), _mm_set1_epi32(0x7C00));
+		__m128i denormal = _mm_sub_epi32(
+			_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(bits), _mm_castsi128_ps(kDenormalMagic))),
+			kDenormalMagic);
+		__m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1));
+		__m128i normal = _mm_add_epi32(bits, _mm_set1_epi32(((15 - 127) << 23) + 0xFFF));
+		normal = _mm_srli_epi32(_mm_add_epi32(normal, mantissaOdd), 13);
+
+		__m128i result = Select(_mm_cmplt_epi32(bits, kHalfMinNormal), denormal, normal);
+		result = Select(_mm_cmplt_epi32(bits, kHalfMax), result, infinityOrNaN);
+		return _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+	}
+
+	// 引数は各32ビットの下位16ビット
+	inline __m128 HalfToFloat4(__m128i value) {
+		const __m128i kShiftedExponent = _mm_set1_epi32(0x7C00 << 13);
+		const __m128i kMagic = _mm_set1_epi32(113 << 23);
+
+		__m128i bits = _mm_slli_epi32(_mm_and_si128(value, _mm_set1_epi32(0x7FFF)), 13);
+		__m128i exponent = _mm_and_si128(bits, kShiftedExponent);
+		bits = _mm_add_epi32(bits, _mm_set1_epi32((127 - 15) << 23));
+
+		__m128i infinityOrNaN = _mm_add_epi32(bits, _mm_set1_epi32((128 - 16) << 23));
+		__m128i denormal = _mm_castps_si128(_mm_sub_ps(
+			_mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(1 << 23))),
+			_mm_castsi128_ps(kMagic)));
+		bits = Select(_mm_cmpeq_epi32(exponent, kShiftedExponent), infinityOrNaN, bits);
+		bits = Select(_mm_cmpeq_epi32(exponent, _mm_setzero_si128()), denormal, bits);
+		__m128i sign = _mm_slli_epi32(_mm_and_si128(value, _mm_set1_epi32(0x8000)), 16);
+		return _mm_castsi128_ps(_mm_or_si128(bits, sign));
+	}
+#endif
+
+}
+
+namespace Math {
+
+	void FloatToHalf(const float* values, uint16_t* results, size_t count) {
+		size_t i = 0;
+#if defined(MATH_SIMD_F16C)
+		for (; i + 8 <= count; i += 8) {
+			__m128i low = _mm_cvtps_ph(_mm_loadu_ps(values + i), _MM_FROUND_TO_NEAREST_INT);
+			__m128i high = _mm_cvtps_ph(_mm_loadu_ps(values + i + 4), _MM_FROUND_TO_NEAREST_INT);
+			__m128i halves = _mm_unpacklo_epi64(low, high);
+			// F16CはNaNの仮数部の上位を残すので、スカラー版と同じ符号付きのquiet NaN（0x7E00）にそろえる
+			__m128i isNaN = _mm_cmpgt_epi16(_mm_and_si128(halves, _mm_set1_epi16(0x7FFF)), _mm_set1_epi16(0x7C00));
+			__m128i canonicalNaN = _mm_or_si128(_mm_and_si128(halves, _mm_set1_epi16(static_cast<int16_t>(0x8000))), _mm_set1_epi16(0x7E00));
+			halves = _mm_or_si128(_mm_andnot_si128(isNaN, halves), _mm_and_si128(isNaN, canonicalNaN));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(results + i), halves);
+		}
+#elif defined(MATH_SIMD_SSE2)
+		for (; i + 8 <= count; i += 8) {
+			__m128i low = FloatToHalf4(_mm_loadu_ps(values + i));
+			__m128i high = FloatToHalf4(_mm_loadu_ps(values + i + 4));
+			// packsは符号付きの飽和なので、16ビットを符号拡張してから詰める
+			low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+			high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(results + i), _mm_packs_epi32(low, high));
+		}
+#endif
+		for (; i < count; ++i) {
+			results[i] = FloatToHalf(values[i]);
+		}
+	}
+
+	void HalfToFloat(const uint16_t* values, float* results, size_t count) {
+		size_t i = 0;
+#if defined(MATH_SIMD_F16C)
+		for (; i + 8 <= count; i += 8) {
+			__m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+			_mm_storeu_ps(results + i, _mm_cvtph_ps(halves));
+			_mm_storeu_ps(results + i + 4, _mm_cvtph_ps(_mm_unpackhi_epi64(halves, halves)));
+		}
+#elif defined(MATH_SIMD_SSE2)
+		for (; i + 8 <= count; i += 8) {
+			__m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+			_mm_storeu_ps(results + i, HalfToFloat4(_mm_unpacklo_epi16(halves, _mm_setzero_si128())));
+			_mm_storeu_ps(results + i + 4, HalfToFloat4(_mm_unpackhi_epi16(halves, _mm_setzero_si128())));
+		}
+#endif
+		for (; i < count; ++i) {
+			results[i] = HalfToFloat(values[i]);
+		}
+	}
+
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Vector4.h"
+
+// 頂点やパーティクルの属性を小さい型に詰める
+// 変換規則はD3DのDXGI_FORMATと同じで、HLSL側は Resource/Shader/HLSLCompat.h に同名の関数がある
+// unorm/snormは四捨五入、halfは偶数丸め
+
+namespace Math {
+
+	/// <summary>
+	/// 単精度を半精度に変換
+	/// </summary>
+	/// <param name="value">範囲外は無限大になる</param>
+	/// <returns>半精度のビット</returns>
+	inline uint16_t FloatToHalf(float value);
+	/// <summary>
+	/// 半精度を単精度に変換
+	/// </summary>
+	/// <param name="value">半精度のビット</param>
+	/// <returns></returns>
+	inline float HalfToFloat(uint16_t value);
+	/// <summary>
+	/// 配列をまとめて半精度に変換
+	/// F16Cが使える場合はF16C、それ以外はSSE2で4要素ずつ変換する（どちらもスカラー版とビットまで同じ、NaNは0x7E00に符号を付けたもの）
+	/// </summary>
+	/// <param name="values"></param>
+	/// <param name="results">count個の書き込み先</param>
+	/// <param name="count"></param>
+	void FloatToHalf(const float* values, uint16_t* results, size_t count);
+	/// <summary>
+	/// 配列をまとめて単精度に変換
+	/// NaN以外はスカラー版とビットまで同じ（F16Cはsignaling NaNをquiet NaNにするので、NaNの仮数部は同じとは限らない）
+	/// </summary>
+	/// <param name="values"></param>
+	/// <param name="results">count個の書き込み先</param>
+	/// <param name="count"></param>
+	void HalfToFloat(const uint16_t* values, float* results, size_t count);
+
+	/// <summary>
+	/// R16G16_FLOAT
+	/// </summary>
+	/// <param name="value"></param>
+	/// <returns>下位16ビットがx</returns>
+	inline uint32_t PackHalf2(const Vector2& value);
+	inline Vector2 UnpackHalf2(uint32_t value);
+	/// <summary>
+	/// R16G16B16A16_FLOAT
+	/// </summary>
+	/// <param name="value"></param>
+	/// <returns>下位16ビットがx（HLSLではuint32_t2）</returns>
+	inline uint64_t PackHalf4(const Vector4& value);
+	inline Vector4 UnpackHalf4(uint64_t value);
+
+	/// <summary>
+	/// 0~1を8ビットに
+	/// </summary>
+	inline uint8_t PackUnorm8(float value);
+	inline float UnpackUnorm8(uint8_t value);
+	/// <summary>
+	/// 0~1を16ビットに
+	/// </summary>
+	inline uint16_t PackUnorm16(float value);
+	inline float UnpackUnorm16(uint16_t value);
+	/// <summary>
+	/// -1~1を8ビットに
+	/// </summary>
+	inline int8_t PackSnorm8(float value);
+	inline float UnpackSnorm8(int8_t value);
+	/// <summary>
+	/// -1~1を16ビットに
+	/// </summary>
+	inline int16_t PackSnorm16(float value);
+	inline float UnpackSnorm16(int16_t value);
+
+	/// <summary>
+	/// R8G8B8A8_UNORM
+	/// </summary>
+	/// <param name="value">各成分0~1</param>
+	/// <returns>下位8ビットがx</returns>
+	inline uint32_t PackUnorm8x4(const Vector4& value);
+	inline Vector4 UnpackUnorm8x4(uint32_t value);
+	/// <summary>
+	/// R8G8B8A8_SNORM
+	/// </summary>
+	/// <param name="value">各成分-1~1</param>
+	/// <returns>下位8ビットがx</returns>
+	inline uint32_t PackSnorm8x4(const Vector4& value);
+	inline Vector4 UnpackSnorm8x4(uint32_t value);
+	/// <summary>
+	/// R16G16_UNORM
+	/// </summary>
+	inline uint32_t PackUnorm16x2(const Vector2& value);
+	inline Vector2 UnpackUnorm16x2(uint32_t value);
+	/// <summary>
+	/// R16G16_SNORM
+	/// </summary>
+	inline uint32_t PackSnorm16x2(const Vector2& value);
+	inline Vector2 UnpackSnorm16x2(uint32_t value);
+	/// <summary>
+	/// R10G10B10A2_UNORM
+	/// </summary>
+	/// <param name="value">各成分0~1</param>
+	/// <returns>下位10ビットがx</returns>
+	inline uint32_t PackR10G10B10A2(const Vector4& value);
+	inline Vector4 UnpackR10G10B10A2(uint32_t value);
+
+	/// <summary>
+	/// 単位ベクトルを八面体に展開した二次元座標に変換
+	/// </summary>
+	/// <param name="normal">単位ベクトル</param>
+	/// <returns>各成分-1~1</returns>
+	inline Vector2 OctahedralEncode(const Vector3& normal);
+	/// <summary>
+	/// 八面体の二次元座標から単位ベクトルに戻す
+	/// </summary>
+	/// <param name="encoded">各成分-1~1</param>
+	/// <returns>正規化済み</returns>
+	inline Vector3 OctahedralDecode(const Vector2& encoded);
+	/// <summary>
+	/// 単位ベクトルを八面体座標のR16G16_SNORMに詰める（角度誤差は最大で約0.004度）
+	/// </summary>
+	inline uint32_t PackOctahedral(const Vector3& normal);
+	inline Vector3 UnpackOctahedral(uint32_t value);
+}
+
+#include "Packing_inline.h"
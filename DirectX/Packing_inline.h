@@ -0,0 +1,171 @@
+#pragma once
+#include "Packing.h"
+
+#include <bit>
+
+namespace Math {
+
+	namespace PackingInternal {
+		inline float Saturate(float value) { return std::clamp(value, 0.0f, 1.0f); }
+		// 0~maxValueに四捨五入
+		inline uint32_t ToUnorm(float value, float maxValue) { return static_cast<uint32_t>(Saturate(value) * maxValue + 0.5f); }
+		// -maxValue~maxValueに四捨五入
+		inline int32_t ToSnorm(float value, float maxValue) {
+			float scaled = std::clamp(value, -1.0f, 1.0f) * maxValue;
+			return static_cast<int32_t>(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+		}
+		// -maxValue-1も-1.0にする
+		inline float FromSnorm(int32_t value, float maxValue) { return std::max(static_cast<float>(value) / maxValue, -1.0f); }
+		// 0の場合も1を返す符号
+		inline float SignNotZero(float value) { return value >= 0.0f ? 1.0f : -1.0f; }
+	}
+
+	inline uint16_t FloatToHalf(float value) {
+		// 指数が半精度の範囲を超える境界、半精度の非正規化数になる境界
+		constexpr uint32_t kHalfMax = (127 + 16) << 23;
+		constexpr uint32_t kHalfMinNormal = (127 - 14) << 23;
+		// 加算の丸めで仮数部を下位10ビットにそろえるための値
+		constexpr uint32_t kDenormalMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+		uint32_t bits = std::bit_cast<uint32_t>(value);
+		uint32_t sign = bits & 0x80000000u;
+		bits ^= sign;
+		uint32_t result;
+		if (bits >= kHalfMax) {
+			// NaNはquiet NaN、それ以外は無限大
+			result = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+		}
+		else if (bits < kHalfMinNormal) {
+			result = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) + std::bit_cast<float>(kDenormalMagic)) - kDenormalMagic;
+		}
+		else {
+			// 指数を付け替え、切り捨てる13ビットで偶数丸め
+			uint32_t mantissaOdd = (bits >> 13) & 1;
+			bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xFFFu + mantissaOdd;
+			result = bits >> 13;
+		}
+		return static_cast<uint16_t>(result | (sign >> 16));
+	}
+
+	inline float HalfToFloat(uint16_t value) {
+		constexpr uint32_t kShiftedExponent = 0x7C00u << 13;
+		constexpr uint32_t kMagic = 113 << 23;
+
+		uint32_t bits = static_cast<uint32_t>(value & 0x7FFFu) << 13;
+		uint32_t exponent = bits & kShiftedExponent;
+		bits += (127 - 15) << 23;
+		if (exponent == kShiftedExponent) {
+			// 無限大とNaN
+			bits += (128 - 16) << 23;
+		}
+		else if (exponent == 0) {
+			// 0と非正規化数
+			bits += 1 << 23;
+			bits = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) - std::bit_cast<float>(kMagic));
+		}
+		return std::bit_cast<float>(bits | (static_cast<uint32_t>(value & 0x8000u) << 16));
+	}
+
+	inline uint32_t PackHalf2(const Vector2& value) {
+		return static_cast<uint32_t>(FloatToHalf(value.x)) | (static_cast<uint32_t>(FloatToHalf(value.y)) << 16);
+	}
+	inline Vector2 UnpackHalf2(uint32_t value) {
+		return { HalfToFloat(static_cast<uint16_t>(value)), HalfToFloat(static_cast<uint16_t>(value >> 16)) };
+	}
+	inline uint64_t PackHalf4(const Vector4& value) {
+		return static_cast<uint64_t>(PackHalf2({ value.x, value.y })) | (static_cast<uint64_t>(PackHalf2({ value.z, value.w })) << 32);
+	}
+	inline Vector4 UnpackHalf4(uint64_t value) {
+		Vector2 xy = UnpackHalf2(static_cast<uint32_t>(value));
+		Vector2 zw = UnpackHalf2(static_cast<uint32_t>(value >> 32));
+		return { xy.x, xy.y, zw.x, zw.y };
+	}
+
+	inline uint8_t PackUnorm8(float value) { return static_cast<uint8_t>(PackingInternal::ToUnorm(value, 255.0f)); }
+	inline float UnpackUnorm8(uint8_t value) { return static_cast<float>(value) / 255.0f; }
+	inline uint16_t PackUnorm16(float value) { return static_cast<uint16_t>(PackingInternal::ToUnorm(value, 65535.0f)); }
+	inline float UnpackUnorm16(uint16_t value) { return static_cast<float>(value) / 65535.0f; }
+	inline int8_t PackSnorm8(float value) { return static_cast<int8_t>(PackingInternal::ToSnorm(value, 127.0f)); }
+	inline float UnpackSnorm8(int8_t value) { return PackingInternal::FromSnorm(value, 127.0f); }
+	inline int16_t PackSnorm16(float value) { return static_cast<int16_t>(PackingInternal::ToSnorm(value, 32767.0f)); }
+	inline float UnpackSnorm16(int16_t value) { return PackingInternal::FromSnorm(value, 32767.0f); }
+
+	inline uint32_t PackUnorm8x4(const Vector4& value) {
+		return
+			static_cast<uint32_t>(PackUnorm8(value.x)) |
+			(static_cast<uint32_t>(PackUnorm8(value.y)) << 8) |
+			(static_cast<uint32_t>(PackUnorm8(value.z)) << 16) |
+			(static_cast<uint32_t>(PackUnorm8(value.w)) << 24);
+	}
+	inline Vector4 UnpackUnorm8x4(uint32_t value) {
+		return {
+			UnpackUnorm8(static_cast<uint8_t>(value)),
+			UnpackUnorm8(static_cast<uint8_t>(value >> 8)),
+			UnpackUnorm8(static_cast<uint8_t>(value >> 16)),
+			UnpackUnorm8(static_cast<uint8_t>(value >> 24)) };
+	}
+	inline uint32_t PackSnorm8x4(const Vector4& value) {
+		return
+			static_cast<uint32_t>(static_cast<uint8_t>(PackSnorm8(value.x))) |
+			(static_cast<uint32_t>(static_cast<uint8_t>(PackSnorm8(value.y))) << 8) |
+			(static_cast<uint32_t>(static_cast<uint8_t>(PackSnorm8(value.z))) << 16) |
+			(static_cast<uint32_t>(static_cast<uint8_t>(PackSnorm8(value.w))) << 24);
+	}
+	inline Vector4 UnpackSnorm8x4(uint32_t value) {
+		return {
+			UnpackSnorm8(static_cast<int8_t>(value)),
+			UnpackSnorm8(static_cast<int8_t>(value >> 8)),
+			UnpackSnorm8(static_cast<int8_t>(value >> 16)),
+			UnpackSnorm8(static_cast<int8_t>(value >> 24)) };
+	}
+	inline uint32_t PackUnorm16x2(const Vector2& value) {
+		return static_cast<uint32_t>(PackUnorm16(value.x)) | (static_cast<uint32_t>(PackUnorm16(value.y)) << 16);
+	}
+	inline Vector2 UnpackUnorm16x2(uint32_t value) {
+		return { UnpackUnorm16(static_cast<uint16_t>(value)), UnpackUnorm16(static_cast<uint16_t>(value >> 16)) };
+	}
+	inline uint32_t PackSnorm16x2(const Vector2& value) {
+		return static_cast<uint32_t>(static_cast<uint16_t>(PackSnorm16(value.x))) | (static_cast<uint32_t>(static_cast<uint16_t>(PackSnorm16(value.y))) << 16);
+	}
+	inline Vector2 UnpackSnorm16x2(uint32_t value) {
+		return { UnpackSnorm16(static_cast<int16_t>(value)), UnpackSnorm16(static_cast<int16_t>(value >> 16)) };
+	}
+	inline uint32_t PackR10G10B10A2(const Vector4& value) {
+		using namespace PackingInternal;
+		return
+			ToUnorm(value.x, 1023.0f) |
+			(ToUnorm(value.y, 1023.0f) << 10) |
+			(ToUnorm(value.z, 1023.0f) << 20) |
+			(ToUnorm(value.w, 3.0f) << 30);
+	}
+	inline Vector4 UnpackR10G10B10A2(uint32_t value) {
+		return {
+			static_cast<float>(value & 0x3FFu) / 1023.0f,
+			static_cast<float>((value >> 10) & 0x3FFu) / 1023.0f,
+			static_cast<float>((value >> 20) & 0x3FFu) / 1023.0f,
+			static_cast<float>(value >> 30) / 3.0f };
+	}
+
+	inline Vector2 OctahedralEncode(const Vector3& normal) {
+		using namespace PackingInternal;
+		// L1ノルムで八面体に射影し、下半分を外側に折り返す
+		float invL1 = 1.0f / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+		Vector2 result(normal.x * invL1, normal.y * invL1);
+		if (normal.z < 0.0f) {
+			result = {
+				(1.0f - std::abs(result.y)) * SignNotZero(result.x),
+				(1.0f - std::abs(result.x)) * SignNotZero(result.y) };
+		}
+		return result;
+	}
+	inline Vector3 OctahedralDecode(const Vector2& encoded) {
+		Vector3 result(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+		float t = std::max(-result.z, 0.0f);
+		result.x += result.x >= 0.0f ? -t : t;
+		result.y += result.y >= 0.0f ? -t : t;
+		return result.Normalized();
+	}
+	inline uint32_t PackOctahedral(const Vector3& normal) { return PackSnorm16x2(OctahedralEncode(normal)); }
+	inline Vector3 UnpackOctahedral(uint32_t value) { return OctahedralDecode(UnpackSnorm16x2(value)); }
+
+}
@@ -0,0 +1,111 @@
+#include "ParallelCommandRecorder.h"
+
+#include "Assert.h"
+
+namespace Engine {
+
+	ParallelCommandRecorder::~ParallelCommandRecorder() {
+		Finalize();
+	}
+
+	bool ParallelCommandRecorder::Initalize(CommandListPool* pool, uint32_t workerCount) {
+		if (!pool) {
+			ASSERT_MSG(false, "Command list pool is required");
+			return false;
+		}
+		Finalize();
+		pool_ = pool;
+		stopRequested_ = false;
+		threads_.reserve(workerCount);
+		for (uint32_t i = 0; i < workerCount; ++i) {
+			threads_.emplace_back(&ParallelCommandRecorder::WorkerThread, this);
+		}
+		return true;
+	}
+
+	void ParallelCommandRecorder::Finalize() {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopRequested_ = true;
+		}
+		startCondition_.notify_all();
+		for (auto& thread : threads_) { thread.join(); }
+		threads_.clear();
+		// 積まなかった記録は返す
+		if (pool_) {
+			for (auto& context : contexts_) { pool_->Discard(context); }
+		}
+		contexts_.clear();
+		pool_ = nullptr;
+	}
+
+	bool ParallelCommandRecorder::Record(uint32_t jobCount, const RecordFunction& record) {
+		ASSERT_MSG(contexts_.empty(), "Record called twice without Submit");
+		contexts_.assign(jobCount, CommandListPool::CommandContext{});
+		record_ = &record;
+		jobCount_ = jobCount;
+		nextJob_.store(0, std::memory_order_relaxed);
+		failed_.store(false, std::memory_order_relaxed);
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			++generation_;
+		}
+		// 仕事が一つならワーカーを起こさない
+		if (jobCount > 1) { startCondition_.notify_all(); }
+		RunJobs();
+		{
+			// 仕事を取ったワーカーが記録を終えるまで待つ
+			std::unique_lock<std::mutex> lock(mutex_);
+			finishCondition_.wait(lock, [&] { return activeWorkerCount_ == 0; });
+			record_ = nullptr;
+		}
+		if (failed_.load(std::memory_order_relaxed)) {
+			for (auto& context : contexts_) { pool_->Discard(context); }
+			contexts_.clear();
+			return false;
+		}
+		return true;
+	}
+
+	uint64_t ParallelCommandRecorder::Submit() {
+		uint64_t fenceValue = pool_->Submit(contexts_.data(), static_cast<uint32_t>(contexts_.size()));
+		contexts_.clear();
+		return fenceValue;
+	}
+
+	void ParallelCommandRecorder::WorkerThread() {
+		uint64_t generation = 0;
+		for (;;) {
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				startCondition_.wait(lock, [&] { return stopRequested_ || generation_ != generation; });
+				if (stopRequested_) { return; }
+				generation = generation_;
+				// 呼び出したスレッドが既に全部終えていたら何もしない
+				if (!record_) { continue; }
+				++activeWorkerCount_;
+			}
+			RunJobs();
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				--activeWorkerCount_;
+			}
+			finishCondition_.notify_one();
+		}
+	}
+
+	void ParallelCommandRecorder::RunJobs() {
+		for (;;) {
+			uint32_t jobIndex = nextJob_.fetch_add(1, std::memory_order_relaxed);
+			if (jobIndex >= jobCount_) { return; }
+			CommandListPool::CommandContext context = pool_->Acquire();
+			if (!context.IsEnabled()) {
+				failed_.store(true, std::memory_order_relaxed);
+				continue;
+			}
+			(*record_)(jobIndex, context.commandList);
+			contexts_[jobIndex] = context;
+		}
+	}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CommandListPool.h"
+
+namespace Engine {
+
+	// 複数のワーカースレッドで別々のコマンドリストに記録し、番号の順に1回で積む
+	// 記録の仕事は0からjobCount-1の番号で分け、どのスレッドがどの順に終えても積む順は番号の順になる
+	// 呼び出したスレッドも記録に加わる
+	class ParallelCommandRecorder {
+	public:
+		// 仕事の番号と、記録するリスト（CommandListBackendが作ったもの）
+		using RecordFunction = std::function<void(uint32_t jobIndex, void* commandList)>;
+
+		ParallelCommandRecorder() = default;
+		~ParallelCommandRecorder();
+		ParallelCommandRecorder(const ParallelCommandRecorder&) = delete;
+		ParallelCommandRecorder& operator=(const ParallelCommandRecorder&) = delete;
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="pool">リストを取るプール（このクラスより長く生きること）</param>
+		/// <param name="workerCount">呼び出したスレッド以外に立てるスレッドの数（0なら呼び出したスレッドだけで記録する）</param>
+		/// <returns></returns>
+		bool Initalize(CommandListPool* pool, uint32_t workerCount);
+		/// <summary>
+		/// ワーカースレッドを止める
+		/// </summary>
+		void Finalize();
+
+		/// <summary>
+		/// jobCount個のリストを並行して記録する（すべて終わるまで戻らない）
+		/// </summary>
+		/// <param name="jobCount">記録するリストの数</param>
+		/// <param name="record">仕事ごとに一度だけ、いずれかのスレッドから呼ばれる</param>
+		/// <returns>リストを取れなかった場合はfalse</returns>
+		bool Record(uint32_t jobCount, const RecordFunction& record);
+		/// <summary>
+		/// Recordで記録したリストを番号の順に1回で積む
+		/// </summary>
+		/// <returns>積んだリストが終わったら進むフェンス値</returns>
+		uint64_t Submit();
+
+		uint32_t GetWorkerCount() const { return static_cast<uint32_t>(threads_.size()); }
+
+	private:
+		void WorkerThread();
+		// 仕事がなくなるまで記録する
+		void RunJobs();
+
+		CommandListPool* pool_{ nullptr };
+		std::vector<std::thread> threads_;
+
+		std::mutex mutex_;
+		std::condition_variable startCondition_;
+		std::condition_variable finishCondition_;
+		// Recordのたびに増やして、ワーカーに新しい仕事を知らせる
+		uint64_t generation_{ 0 };
+		// 仕事に取り掛かっているワーカーの数
+		uint32_t activeWorkerCount_{ 0 };
+		bool stopRequested_{ false };
+
+		const RecordFunction* record_{ nullptr };
+		uint32_t jobCount_{ 0 };
+		std::atomic<uint32_t> nextJob_{ 0 };
+		std::atomic<bool> failed_{ false };
+		// 仕事の番号の順
+		std::vector<CommandListPool::CommandContext> contexts_;
+	};
+
+}
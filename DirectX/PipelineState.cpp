@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "PipelineState.h"
+#include "DirectXHelper.h"
 #include "Logger.h"
 
 namespace DirectXHelper {
@@ -152,7 +153,9 @@ namespace DirectXHelper {
 	bool PipelineState::Initalize(ID3D12Device* device, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc) {
 		assert(device);
 
-		if (FAILED(device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(pipelineState_.ReleaseAndGetAddressOf())))) {
+		// 前のものは使っているコマンドが終わってから解放する
+		DeferredRelease(pipelineState_);
+		if (FAILED(device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(pipelineState_.GetAddressOf())))) {
 			Logger::Error("CreateGraphicsPipelineState()");
 			assert(false);
 			return false;
@@ -163,7 +166,9 @@ namespace DirectXHelper {
 	bool PipelineState::Initalize(ID3D12Device* device, const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc) {
 		assert(device);
 
-		if (FAILED(device->CreateComputePipelineState(&desc, IID_PPV_ARGS(pipelineState_.ReleaseAndGetAddressOf())))) {
+		// コンピュートキューで使っている場合もあるので、DeferredReleaseQueueは両方のキューを待つ
+		DeferredRelease(pipelineState_);
+		if (FAILED(device->CreateComputePipelineState(&desc, IID_PPV_ARGS(pipelineState_.GetAddressOf())))) {
 			Logger::Error("CreateComputePipelineState()");
 			assert(false);
 			return false;
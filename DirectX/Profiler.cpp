@@ -0,0 +1,318 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "StringFormat.h"
+
+namespace Engine {
+
+	namespace {
+		constexpr ProfileZone kFrameZone{ "Frame", HashProfileZoneName("Frame") };
+
+		// スレッドが終わったらバッファを返す
+		// Profilerは関数内の静的変数なので、メインスレッドでもこちらが先に破棄される
+		struct ThreadState {
+			void* buffer{ nullptr };
+			std::atomic<bool>* inUse{ nullptr };
+			uint32_t depth{ 0 };
+			~ThreadState() {
+				if (inUse) { inUse->store(false, std::memory_order_release); }
+			}
+		};
+		thread_local ThreadState threadState;
+
+		double ToMilliseconds(uint64_t nanoseconds) {
+			return static_cast<double>(nanoseconds) * 1e-6;
+		}
+
+		Profiler::ZoneStatistics MakeStatistics(const ProfileZone& zone) {
+			Profiler::ZoneStatistics statistics{};
+			statistics.name = zone.name;
+			statistics.hash = zone.hash;
+			return statistics;
+		}
+
+		// 区間の名前は文字列リテラルだが、念のため引用符などを逃がす
+		void AppendJsonString(std::string& json, std::string_view text) {
+			json.push_back('"');
+			for (char c : text) {
+				if (c == '"' || c == '\\') {
+					json.push_back('\\');
+					json.push_back(c);
+				}
+				else if (static_cast<unsigned char>(c) < 0x20) {
+					char escaped[8];
+					size_t length = String::FormatTo(escaped, "\\u{:04x}", static_cast<unsigned int>(c));
+					json.append(escaped, length);
+				}
+				else {
+					json.push_back(c);
+				}
+			}
+			json.push_back('"');
+		}
+	}
+
+	Profiler& Profiler::GetInstance() {
+		static Profiler instance;
+		return instance;
+	}
+
+	Profiler::Profiler() {
+		Reset();
+	}
+
+	Profiler::~Profiler() {
+	}
+
+	uint64_t Profiler::GetTimestamp() {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	void Profiler::BeginFrame() {
+		frameBegin_ = GetTimestamp();
+	}
+
+	void Profiler::EndFrame() {
+		uint64_t frameEnd = GetTimestamp();
+		Record(&kFrameZone, frameBegin_, frameEnd, 0);
+		for (ZoneHistory& history : histories_) {
+			history.frameTotal = 0;
+			history.frameCallCount = 0;
+		}
+		Drain(true);
+		for (size_t i = 0; i < histories_.size(); ++i) {
+			if (histories_[i].frameCallCount > 0) { UpdateStatistics(i); }
+		}
+		++frameCount_;
+		frameBegin_ = frameEnd;
+	}
+
+	void Profiler::Record(const ProfileZone* zone, uint64_t begin, uint64_t end, uint32_t depth) {
+		ThreadBuffer* buffer = GetThreadBuffer();
+		uint64_t position = buffer->writePosition.load(std::memory_order_relaxed);
+		if (position - buffer->readPosition.load(std::memory_order_acquire) >= kThreadBufferCapacity) {
+			buffer->droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		Event& event = buffer->events[position & (kThreadBufferCapacity - 1)];
+		event.zone = zone;
+		event.begin = begin;
+		event.end = end;
+		event.depth = depth;
+		event.threadId = buffer->threadId;
+		buffer->writePosition.store(position + 1, std::memory_order_release);
+	}
+
+	void Profiler::SetThreadName(std::string_view name) {
+		ThreadBuffer* buffer = GetThreadBuffer();
+		std::lock_guard<std::mutex> lock(threadBufferMutex_);
+		buffer->name = name;
+		buffer->nameCaptured = false;
+	}
+
+	uint64_t Profiler::GetDroppedCount() const {
+		std::lock_guard<std::mutex> lock(threadBufferMutex_);
+		uint64_t droppedCount = 0;
+		for (const auto& buffer : threadBuffers_) {
+			droppedCount += buffer->droppedCount.load(std::memory_order_relaxed);
+		}
+		return droppedCount;
+	}
+
+	void Profiler::BeginCapture() {
+		// それまでに積まれていた分は含めない
+		Drain(false);
+		capturedEvents_.clear();
+		capturedThreadNames_.clear();
+		{
+			std::lock_guard<std::mutex> lock(threadBufferMutex_);
+			for (const auto& buffer : threadBuffers_) { buffer->nameCaptured = false; }
+		}
+		captureBegin_ = GetTimestamp();
+		capturing_ = true;
+	}
+
+	void Profiler::EndCapture() {
+		Drain(true);
+		capturing_ = false;
+	}
+
+	void Profiler::AppendChromeTrace(std::string& json) const {
+		// 時間はマイクロ秒
+		char number[64];
+		json += "{\"traceEvents\":[\n";
+		bool first = true;
+		for (const auto& [threadId, name] : capturedThreadNames_) {
+			json += first ? "" : ",\n";
+			first = false;
+			json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+			json.append(number, String::FormatTo(number, "{}", threadId));
+			json += ",\"args\":{\"name\":";
+			AppendJsonString(json, name);
+			json += "}}";
+		}
+		for (const Event& event : capturedEvents_) {
+			json += first ? "" : ",\n";
+			first = false;
+			json += "{\"name\":";
+			AppendJsonString(json, event.zone->name);
+			json += ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+			uint64_t begin = event.begin > captureBegin_ ? event.begin - captureBegin_ : 0;
+			json.append(number, String::FormatTo(number, "{},\"ts\":{:.3},\"dur\":{:.3}}}", event.threadId,
+				static_cast<double>(begin) * 1e-3, static_cast<double>(event.end - event.begin) * 1e-3));
+		}
+		json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+	}
+
+	bool Profiler::WriteChromeTrace(const char* path) const {
+		std::string json;
+		json.reserve(capturedEvents_.size() * 96 + 64);
+		AppendChromeTrace(json);
+		std::FILE* file = nullptr;
+#ifdef _MSC_VER
+		if (fopen_s(&file, path, "wb") != 0) { file = nullptr; }
+#else
+		file = std::fopen(path, "wb");
+#endif // _MSC_VER
+		if (!file) { return false; }
+		bool succeeded = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+		std::fclose(file);
+		return succeeded;
+	}
+
+	void Profiler::Reset() {
+		Drain(false);
+		histories_.clear();
+		statistics_.clear();
+		zoneIndices_.clear();
+		capturedEvents_.clear();
+		capturedThreadNames_.clear();
+		capturing_ = false;
+		frameCount_ = 0;
+		frameBegin_ = GetTimestamp();
+		// 先頭はフレーム
+		zoneIndices_.emplace(kFrameZone.hash, 0);
+		histories_.emplace_back();
+		statistics_.push_back(MakeStatistics(kFrameZone));
+	}
+
+	Profiler::ThreadBuffer* Profiler::GetThreadBuffer() {
+		if (threadState.buffer) { return static_cast<ThreadBuffer*>(threadState.buffer); }
+		std::lock_guard<std::mutex> lock(threadBufferMutex_);
+		ThreadBuffer* buffer = nullptr;
+		// 終わったスレッドのバッファを、記録を読み終えていれば使い回す
+		for (const auto& candidate : threadBuffers_) {
+			if (candidate->readPosition.load(std::memory_order_relaxed) != candidate->writePosition.load(std::memory_order_relaxed)) { continue; }
+			bool expected = false;
+			if (candidate->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+				buffer = candidate.get();
+				buffer->name.clear();
+				buffer->nameCaptured = false;
+				break;
+			}
+		}
+		if (!buffer) {
+			threadBuffers_.push_back(std::make_unique<ThreadBuffer>());
+			buffer = threadBuffers_.back().get();
+			buffer->events = std::make_unique<Event[]>(kThreadBufferCapacity);
+			buffer->inUse.store(true, std::memory_order_relaxed);
+		}
+		buffer->threadId = nextThreadId_++;
+		threadState.buffer = buffer;
+		threadState.inUse = &buffer->inUse;
+		return buffer;
+	}
+
+	void Profiler::Drain(bool accumulate) {
+		std::lock_guard<std::mutex> lock(threadBufferMutex_);
+		for (const auto& buffer : threadBuffers_) {
+			uint64_t readPosition = buffer->readPosition.load(std::memory_order_relaxed);
+			uint64_t writePosition = buffer->writePosition.load(std::memory_order_acquire);
+			if (accumulate) {
+				for (uint64_t position = readPosition; position < writePosition; ++position) {
+					const Event& event = buffer->events[position & (kThreadBufferCapacity - 1)];
+					Accumulate(event);
+					if (capturing_) { capturedEvents_.push_back(event); }
+				}
+				if (capturing_ && !buffer->nameCaptured && !buffer->name.empty()) {
+					capturedThreadNames_.emplace_back(buffer->threadId, buffer->name);
+					buffer->nameCaptured = true;
+				}
+			}
+			buffer->readPosition.store(writePosition, std::memory_order_release);
+		}
+	}
+
+	void Profiler::Accumulate(const Event& event) {
+		uint32_t index = FindZoneIndex(*event.zone);
+		ZoneHistory& history = histories_[index];
+		history.frameTotal += event.end - event.begin;
+		++history.frameCallCount;
+		statistics_[index].depth = event.depth;
+	}
+
+	uint32_t Profiler::FindZoneIndex(const ProfileZone& zone) {
+		auto [begin, end] = zoneIndices_.equal_range(zone.hash);
+		for (auto iterator = begin; iterator != end; ++iterator) {
+			// 同じ場所の区間はアドレスが同じなので、文字列を比べるのは別の場所か衝突した場合だけ
+			const char* name = statistics_[iterator->second].name;
+			if (name == zone.name || std::string_view(name) == zone.name) { return iterator->second; }
+		}
+		uint32_t index = static_cast<uint32_t>(histories_.size());
+		zoneIndices_.emplace(zone.hash, index);
+		histories_.emplace_back();
+		statistics_.push_back(MakeStatistics(zone));
+		return index;
+	}
+
+	void Profiler::UpdateStatistics(size_t index) {
+		ZoneHistory& history = histories_[index];
+		if (history.samples.size() < kHistoryFrameCount) {
+			history.samples.push_back(history.frameTotal);
+		}
+		else {
+			history.samples[history.nextSample] = history.frameTotal;
+			history.nextSample = (history.nextSample + 1) % kHistoryFrameCount;
+		}
+
+		ZoneStatistics& statistics = statistics_[index];
+		statistics.callCount = history.frameCallCount;
+		statistics.sampleCount = static_cast<uint32_t>(history.samples.size());
+		statistics.lastMilliseconds = ToMilliseconds(history.frameTotal);
+
+		uint64_t minimum = UINT64_MAX, maximum = 0, total = 0;
+		for (uint64_t sample : history.samples) {
+			minimum = std::min(minimum, sample);
+			maximum = std::max(maximum, sample);
+			total += sample;
+		}
+		statistics.minMilliseconds = ToMilliseconds(minimum);
+		statistics.maxMilliseconds = ToMilliseconds(maximum);
+		statistics.averageMilliseconds = ToMilliseconds(total) / static_cast<double>(history.samples.size());
+		// 99パーセンタイル（小さい方から数えて99%の位置）
+		sortBuffer_.assign(history.samples.begin(), history.samples.end());
+		size_t rank = (sortBuffer_.size() * 99 + 99) / 100 - 1;
+		std::nth_element(sortBuffer_.begin(), sortBuffer_.begin() + rank, sortBuffer_.end());
+		statistics.p99Milliseconds = ToMilliseconds(sortBuffer_[rank]);
+	}
+
+	ProfileScope::ProfileScope(const ProfileZone* zone) :
+		zone_(Profiler::GetInstance().IsEnabled() ? zone : nullptr), begin_(0) {
+		if (zone_) {
+			++threadState.depth;
+			begin_ = Profiler::GetTimestamp();
+		}
+	}
+
+	ProfileScope::~ProfileScope() {
+		if (zone_) {
+			uint64_t end = Profiler::GetTimestamp();
+			--threadState.depth;
+			Profiler::GetInstance().Record(zone_, begin_, end, threadState.depth);
+		}
+	}
+
+}
@@ -0,0 +1,205 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 0にするとPROFILE_SCOPEがすべて消える
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif // PROFILER_ENABLED
+
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+
+#if PROFILER_ENABLED
+// スコープの開始から終了までを計測する（nameは文字列リテラル、ハッシュはコンパイル時に計算する）
+#define PROFILE_SCOPE(name) \
+	static constexpr ::Engine::ProfileZone PROFILER_CONCAT(profileZone, __LINE__){ name, ::Engine::HashProfileZoneName(name) }; \
+	::Engine::ProfileScope PROFILER_CONCAT(profileScope, __LINE__)(&PROFILER_CONCAT(profileZone, __LINE__))
+#else
+#define PROFILE_SCOPE(name) do {} while (0)
+#endif // PROFILER_ENABLED
+
+namespace Engine {
+
+	// FNV-1a
+	constexpr uint32_t HashProfileZoneName(std::string_view name) {
+		uint32_t hash = 2166136261u;
+		for (char c : name) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	// 計測する区間（静的に置いて、アドレスを記録に使う）
+	// 同じ名前の区間は同じものとして集計する
+	struct ProfileZone {
+		const char* name;
+		uint32_t hash;
+	};
+
+	// 区間を記録して、フレームごとに集計する
+	// 記録はスレッドごとのリングバッファに積むだけで（ロックを取らない）、集計はEndFrameを呼ぶスレッドがまとめて行う
+	class Profiler {
+	public:
+		// スレッドごとに積める記録の数（EndFrameまでに超えた分は捨てる）
+		static constexpr uint32_t kThreadBufferCapacity = 1 << 14;
+		// 統計に使うフレームの数
+		static constexpr uint32_t kHistoryFrameCount = 256;
+
+		// 直近kHistoryFrameCountフレーム（その区間を通ったフレームだけ）の、1フレームあたりの合計時間
+		struct ZoneStatistics {
+			const char* name;
+			uint32_t hash;
+			// 入れ子の深さ（0が一番外側）
+			uint32_t depth;
+			// 最後のフレームで通った回数
+			uint32_t callCount;
+			uint32_t sampleCount;
+			double lastMilliseconds;
+			double minMilliseconds;
+			double averageMilliseconds;
+			double maxMilliseconds;
+			double p99Milliseconds;
+		};
+
+		static Profiler& GetInstance();
+
+		~Profiler();
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+
+		// 経過時間の基準（ナノ秒）
+		static uint64_t GetTimestamp();
+
+		/// <summary>
+		/// フレームの開始
+		/// </summary>
+		void BeginFrame();
+		/// <summary>
+		/// フレームの終了（すべてのスレッドの記録を集めて統計を更新する）
+		/// </summary>
+		void EndFrame();
+
+		/// <summary>
+		/// 区間を記録する（ProfileScopeから呼ばれる）
+		/// </summary>
+		void Record(const ProfileZone* zone, uint64_t begin, uint64_t end, uint32_t depth);
+		/// <summary>
+		/// 呼び出したスレッドの名前（Chromeのトレースに出る）
+		/// </summary>
+		void SetThreadName(std::string_view name);
+
+		void SetEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+		bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+		// フレームの統計（EndFrameを呼ぶスレッドから読む）
+		const ZoneStatistics& GetFrameStatistics() const { return statistics_[0]; }
+		// 区間の統計（最初に現れた順、先頭はフレーム）
+		const std::vector<ZoneStatistics>& GetStatistics() const { return statistics_; }
+		uint64_t GetFrameCount() const { return frameCount_; }
+		// バッファが一杯で捨てた数
+		uint64_t GetDroppedCount() const;
+
+		/// <summary>
+		/// 記録をChromeのトレース用に残し始める
+		/// </summary>
+		void BeginCapture();
+		void EndCapture();
+		bool IsCapturing() const { return capturing_; }
+		size_t GetCapturedEventCount() const { return capturedEvents_.size(); }
+		/// <summary>
+		/// 残した記録をChromeのトレースのJSON（chrome://tracing、Perfetto）で書き出す
+		/// </summary>
+		void AppendChromeTrace(std::string& json) const;
+		bool WriteChromeTrace(const char* path) const;
+
+		/// <summary>
+		/// 統計と残した記録を捨てる
+		/// </summary>
+		void Reset();
+
+	private:
+		Profiler();
+
+		struct Event {
+			const ProfileZone* zone;
+			uint64_t begin;
+			uint64_t end;
+			uint32_t depth;
+			uint32_t threadId;
+		};
+
+		// 一つのスレッドが積んで、集計するスレッドが読む（SPSC）
+		struct ThreadBuffer {
+			std::unique_ptr<Event[]> events;
+			alignas(64) std::atomic<uint64_t> writePosition{ 0 };
+			std::atomic<uint64_t> droppedCount{ 0 };
+			alignas(64) std::atomic<uint64_t> readPosition{ 0 };
+			// スレッドが終わって記録を読み終えたら、別のスレッドが使い回す
+			std::atomic<bool> inUse{ false };
+			// トレースに出すスレッドの番号（使い回すたびに変える）
+			uint32_t threadId{ 0 };
+			std::string name;
+			bool nameCaptured{ false };
+		};
+
+		struct ZoneHistory {
+			// フレームごとの合計時間（ナノ秒）
+			std::vector<uint64_t> samples;
+			uint64_t frameTotal{ 0 };
+			uint32_t frameCallCount{ 0 };
+			uint32_t nextSample{ 0 };
+		};
+
+		ThreadBuffer* GetThreadBuffer();
+		// すべてのスレッドの記録を読む
+		void Drain(bool accumulate);
+		void Accumulate(const Event& event);
+		// 区間の集計の番号（無ければ足す）
+		uint32_t FindZoneIndex(const ProfileZone& zone);
+		void UpdateStatistics(size_t index);
+
+		std::atomic<bool> enabled_{ true };
+
+		mutable std::mutex threadBufferMutex_;
+		std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers_;
+		uint32_t nextThreadId_{ 0 };
+
+		// 以下は集計するスレッドだけが使う
+		std::vector<ZoneHistory> histories_;
+		std::vector<ZoneStatistics> statistics_;
+		// ハッシュから集計の番号（32ビットのハッシュは衝突しうるので、同じハッシュの名前を比べて選ぶ）
+		std::unordered_multimap<uint32_t, uint32_t> zoneIndices_;
+		std::vector<uint64_t> sortBuffer_;
+		uint64_t frameBegin_{ 0 };
+		uint64_t frameCount_{ 0 };
+
+		bool capturing_{ false };
+		uint64_t captureBegin_{ 0 };
+		std::vector<Event> capturedEvents_;
+		std::vector<std::pair<uint32_t, std::string>> capturedThreadNames_;
+	};
+
+	// スコープの間を計測する（PROFILE_SCOPEから使う）
+	class ProfileScope {
+	public:
+		explicit ProfileScope(const ProfileZone* zone);
+		~ProfileScope();
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		const ProfileZone* zone_;
+		uint64_t begin_;
+	};
+
+}
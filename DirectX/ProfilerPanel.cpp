@@ -0,0 +1,76 @@
+#include "stdafx.h"
+#include "ProfilerPanel.h"
+
+namespace Engine {
+
+	void ShowProfilerPanel(bool* open) {
+#if PROFILER_ENABLED
+		Profiler& profiler = Profiler::GetInstance();
+		if (!ImGui::Begin("Profiler", open)) {
+			ImGui::End();
+			return;
+		}
+		const Profiler::ZoneStatistics& frame = profiler.GetFrameStatistics();
+		ImGui::Text("Frame %.2f ms (avg %.2f, p99 %.2f, max %.2f)", frame.lastMilliseconds, frame.averageMilliseconds, frame.p99Milliseconds, frame.maxMilliseconds);
+		uint64_t droppedCount = profiler.GetDroppedCount();
+		if (droppedCount > 0) {
+			ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "%llu events dropped", static_cast<unsigned long long>(droppedCount));
+		}
+
+		bool enabled = profiler.IsEnabled();
+		if (ImGui::Checkbox("Enabled", &enabled)) { profiler.SetEnabled(enabled); }
+		ImGui::SameLine();
+		if (!profiler.IsCapturing()) {
+			if (ImGui::Button("Capture")) { profiler.BeginCapture(); }
+		}
+		else {
+			if (ImGui::Button("Save trace")) {
+				profiler.EndCapture();
+				profiler.WriteChromeTrace("ProfileTrace.json");
+			}
+			ImGui::SameLine();
+			ImGui::Text("%zu events", profiler.GetCapturedEventCount());
+		}
+
+		constexpr ImGuiTableFlags kTableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+		if (ImGui::BeginTable("Zones", 7, kTableFlags)) {
+			ImGui::TableSetupScrollFreeze(0, 1);
+			ImGui::TableSetupColumn("Zone", ImGuiTableColumnFlags_WidthStretch);
+			ImGui::TableSetupColumn("Calls");
+			ImGui::TableSetupColumn("Last");
+			ImGui::TableSetupColumn("Avg");
+			ImGui::TableSetupColumn("Min");
+			ImGui::TableSetupColumn("Max");
+			ImGui::TableSetupColumn("P99");
+			ImGui::TableHeadersRow();
+			const auto& statistics = profiler.GetStatistics();
+			// 先頭はフレームなので飛ばす
+			for (size_t i = 1; i < statistics.size(); ++i) {
+				const Profiler::ZoneStatistics& zone = statistics[i];
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				// 入れ子の深さだけ字下げする
+				ImGui::SetCursorPosX(ImGui::GetCursorPosX() + static_cast<float>(zone.depth) * 8.0f);
+				ImGui::TextUnformatted(zone.name);
+				ImGui::TableNextColumn();
+				ImGui::Text("%u", zone.callCount);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", zone.lastMilliseconds);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", zone.averageMilliseconds);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", zone.minMilliseconds);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", zone.maxMilliseconds);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", zone.p99Milliseconds);
+			}
+			ImGui::EndTable();
+		}
+		ImGui::End();
+#else
+		(void)open;
+#endif // PROFILER_ENABLED
+	}
+
+}
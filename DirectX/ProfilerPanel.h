@@ -0,0 +1,13 @@
+#pragma once
+#include "Profiler.h"
+
+namespace Engine {
+
+	/// <summary>
+	/// Profilerの統計をImGuiのウィンドウに出す（ImGui::NewFrameとRenderの間で呼ぶ）
+	/// PROFILER_ENABLEDが0なら何もしない
+	/// </summary>
+	/// <param name="open">閉じるボタンを出す場合</param>
+	void ShowProfilerPanel(bool* open = nullptr);
+
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+// __declspec(property)はMSVC拡張なので、それ以外のコンパイラでは宣言ごと消す
+// プロパティはGet/Setアクセサの糖衣なので、移植先ではアクセサを直接呼ぶ
+// 第一引数はプロパティの宣言、以降はget/putの指定
+#ifdef _MSC_VER
+#define PROPERTY(declaration, ...) __declspec(property(__VA_ARGS__)) declaration
+#else
+#define PROPERTY(declaration, ...)
+#endif
@@ -1,4 +1,9 @@
 #pragma once
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "Property.h"
 #include "Vector3.h"
 class Matrix4x4;
 
@@ -21,48 +26,48 @@ public:
 	friend inline Quaternion operator*(const Quaternion& lhs, const Quaternion& rhs);
 	friend inline Quaternion& operator+=(Quaternion& v1, const Quaternion& v2);
 	friend inline Quaternion& operator*=(Quaternion& v, float s);
-	friend inline Quaternion& operator*=(Quaternion lhs, const Quaternion& rhs);
+	friend inline Quaternion& operator*=(Quaternion& lhs, const Quaternion& rhs);
 	friend inline bool operator==(const Quaternion& v1, const Quaternion& v2);
 	friend inline bool operator!=(const Quaternion& v1, const Quaternion& v2);
 
 	/// <summary>
 	/// オイラー角（不安）
 	/// </summary>
-	__declspec(property(get = GetEulerAngle, put = SetEulerAngle)) Vector3 eulerAngle;
+	PROPERTY(Vector3 eulerAngle, get = GetEulerAngle, put = SetEulerAngle);
 	inline Quaternion& SetEulerAngle(const Vector3& eulerAngle);
 	inline Vector3 GetEulerAngle() const;
 	/// <summary>
 	/// 正規化（読み取り専用）
 	/// </summary>
-	__declspec(property(get = Normalized)) Quaternion normalized;
+	PROPERTY(Quaternion normalized, get = Normalized);
 	inline Quaternion Normalized() const;
 	/// <summary>
 	/// xyz（読み取り専用）
 	/// </summary>
-	__declspec(property(get = GetXYZ)) Vector3 xyz;
+	PROPERTY(Vector3 xyz, get = GetXYZ);
 	inline Vector3 GetXYZ() const;
 	/// <summary>
 	/// 回転角
 	/// </summary>
-	__declspec(property(get = GetAngle, put = SetAngle)) float angle;
+	PROPERTY(float angle, get = GetAngle, put = SetAngle);
 	inline Quaternion& SetAngle(float angle);
 	inline float GetAngle() const;
 	/// <summary>
 	/// 回転軸
 	/// </summary>
-	__declspec(property(get = GetAxis, put = SetAxis)) Vector3 axis;
+	PROPERTY(Vector3 axis, get = GetAxis, put = SetAxis);
 	inline Quaternion& SetAxis(const Vector3& axis);
 	inline Vector3 GetAxis() const;
 	/// <summary>
 	/// 共役（読み取り専用）
 	/// </summary>
-	__declspec(property(get = GetConjugate)) Quaternion conjugate;
-	inline Quaternion GetConjugate();
+	PROPERTY(Quaternion conjugate, get = GetConjugate);
+	inline Quaternion GetConjugate() const;
 	/// <summary>
 	/// 逆クォータニオン（読み取り専用）
 	/// </summary>
-	__declspec(property(get = GetInverse)) Quaternion inverse;
-	inline Quaternion GetInverse();
+	PROPERTY(Quaternion inverse, get = GetInverse);
+	inline Quaternion GetInverse() const;
 	/// <summary>
 	/// 内積
 	/// </summary>
@@ -36,7 +36,7 @@ inline Quaternion& operator*=(Quaternion& v, float s) {
 	return v;
 }
 
-inline Quaternion& operator*=(Quaternion lhs, const Quaternion& rhs) {
+inline Quaternion& operator*=(Quaternion& lhs, const Quaternion& rhs) {
 	lhs = lhs * rhs;
 	return lhs;
 }
@@ -76,10 +76,10 @@ inline Quaternion& Quaternion::SetAxis(const Vector3& axis) {
 inline Vector3 Quaternion::GetAxis() const {
 	return GetXYZ() * (1.0f / std::sin(std::acos(w)));
 }
-inline Quaternion Quaternion::GetConjugate() {
+inline Quaternion Quaternion::GetConjugate() const {
 	return Quaternion{ -x,-y,-z,w };
 }
-inline Quaternion Quaternion::GetInverse() {
+inline Quaternion Quaternion::GetInverse() const {
 	return GetConjugate() * (1.0f / std::sqrt(Dot(*this, *this)));
 }
 inline float Quaternion::Dot(const Quaternion& lhs, const Quaternion& rhs) {
@@ -0,0 +1,560 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+
+#include "Assert.h"
+#include "StringFormat.h"
+
+namespace Engine {
+
+	namespace {
+		constexpr uint32_t kUnused = UINT32_MAX;
+		constexpr uint64_t kUnplaced = UINT64_MAX;
+
+		uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		const char* GetCategoryName(MemoryCategory category) {
+			switch (category) {
+			case MemoryCategory::Buffer: return "Buffer";
+			case MemoryCategory::UploadBuffer: return "UploadBuffer";
+			case MemoryCategory::ReadbackBuffer: return "ReadbackBuffer";
+			case MemoryCategory::Texture: return "Texture";
+			case MemoryCategory::RenderTarget: return "RenderTarget";
+			default: return "Unknown";
+			}
+		}
+
+		const char* GetStateName(ResourceState state) {
+			switch (state) {
+			case ResourceState::Common: return "Common";
+			case ResourceState::VertexAndConstantBuffer: return "VertexAndConstantBuffer";
+			case ResourceState::IndexBuffer: return "IndexBuffer";
+			case ResourceState::RenderTarget: return "RenderTarget";
+			case ResourceState::UnorderedAccess: return "UnorderedAccess";
+			case ResourceState::DepthWrite: return "DepthWrite";
+			case ResourceState::DepthRead: return "DepthRead";
+			case ResourceState::NonPixelShaderResource: return "NonPixelShaderResource";
+			case ResourceState::PixelShaderResource: return "PixelShaderResource";
+			case ResourceState::AllShaderResource: return "AllShaderResource";
+			case ResourceState::IndirectArgument: return "IndirectArgument";
+			case ResourceState::CopyDest: return "CopyDest";
+			case ResourceState::CopySource: return "CopySource";
+			case ResourceState::GenericRead: return "GenericRead";
+			default: return nullptr;
+			}
+		}
+
+		void AppendState(std::string& text, ResourceState state) {
+			const char* name = GetStateName(state);
+			if (name) { text += name; }
+			else { text += String::FormatTemporary("0x{:x}", static_cast<uint32_t>(state)); }
+		}
+	}
+
+	RenderGraph::~RenderGraph() {
+		ASSERT_MSG(!HasTransientResources(), "Transient resources must be released before destroying the graph");
+	}
+
+	RenderGraph::ResourceHandle RenderGraph::CreateTransient(const char* name, const TransientResourceDesc& desc) {
+		ASSERT_MSG(desc.size != 0, "Transient resource size must not be zero");
+		ASSERT_MSG(desc.alignment != 0 && (desc.alignment & (desc.alignment - 1)) == 0, "Alignment must be a power of two");
+		Resource resource{};
+		resource.name = name;
+		resource.desc = desc;
+		resource.initialState = ResourceState::Common;
+		resource.finalState = ResourceState::Common;
+		resources_.push_back(std::move(resource));
+		isCompiled_ = false;
+		return static_cast<ResourceHandle>(resources_.size() - 1);
+	}
+
+	RenderGraph::ResourceHandle RenderGraph::Import(const char* name, void* resource, ResourceState initialState, ResourceState finalState) {
+		ASSERT_MSG(resource, "Imported resource must not be null");
+		Resource imported{};
+		imported.name = name;
+		imported.imported = resource;
+		imported.physical = resource;
+		imported.initialState = initialState;
+		imported.finalState = finalState;
+		resources_.push_back(std::move(imported));
+		isCompiled_ = false;
+		return static_cast<ResourceHandle>(resources_.size() - 1);
+	}
+
+	RenderGraph::PassHandle RenderGraph::AddPass(const char* name, ExecuteFunction execute, bool hasSideEffect) {
+		Pass pass{};
+		pass.name = name;
+		pass.execute = std::move(execute);
+		pass.hasSideEffect = hasSideEffect;
+		passes_.push_back(std::move(pass));
+		isCompiled_ = false;
+		return static_cast<PassHandle>(passes_.size() - 1);
+	}
+
+	void RenderGraph::Read(PassHandle pass, ResourceHandle resource, ResourceState state) {
+		ASSERT_MSG(pass < passes_.size() && resource < resources_.size(), "Invalid render graph handle");
+		passes_[pass].accesses.push_back(Access{ resource, state, false });
+		isCompiled_ = false;
+	}
+
+	void RenderGraph::Write(PassHandle pass, ResourceHandle resource, ResourceState state) {
+		ASSERT_MSG(pass < passes_.size() && resource < resources_.size(), "Invalid render graph handle");
+		passes_[pass].accesses.push_back(Access{ resource, state, true });
+		isCompiled_ = false;
+	}
+
+	bool RenderGraph::Compile() {
+		// 配置が変わるので、作った透過リソースは使えない
+		if (HasTransientResources()) {
+			ASSERT_MSG(false, "Transient resources must be released before recompiling");
+			return false;
+		}
+		for (Pass& pass : passes_) {
+			pass.dependencies.clear();
+			pass.producers.clear();
+			pass.barriers.clear();
+			pass.isCulled = false;
+		}
+		executionOrder_.clear();
+		finalBarriers_.clear();
+		statistics_ = {};
+		isCompiled_ = false;
+
+		// 書かれる前に読む透過リソースは中身が無い
+		std::vector<bool> written(resources_.size(), false);
+		for (const Pass& pass : passes_) {
+			for (const Access& access : pass.accesses) {
+				const Resource& resource = resources_[access.resource];
+				if (!access.isWrite && !resource.IsImported() && !written[access.resource]) {
+					ASSERT_MSG(false, "Transient resource is read before any pass writes it");
+					return false;
+				}
+				if (access.isWrite) { written[access.resource] = true; }
+			}
+		}
+
+		BuildDependencies();
+		CullPasses();
+		SortPasses();
+		ComputeLifetimes();
+		AliasTransientResources();
+		BuildBarriers();
+
+		statistics_.passCount = static_cast<uint32_t>(passes_.size());
+		statistics_.culledPassCount = static_cast<uint32_t>(passes_.size() - executionOrder_.size());
+		for (PassHandle pass : executionOrder_) { statistics_.barrierCount += static_cast<uint32_t>(passes_[pass].barriers.size()); }
+		statistics_.barrierCount += static_cast<uint32_t>(finalBarriers_.size());
+		isCompiled_ = true;
+		return true;
+	}
+
+	bool RenderGraph::Execute(RenderGraphBackend& backend) {
+		if (!isCompiled_) {
+			ASSERT_MSG(false, "RenderGraph::Compile must succeed before Execute");
+			return false;
+		}
+		// 透過リソースの実体はReleaseTransientResourcesまで使い回す
+		bool needsCreate = false;
+		for (const Resource& resource : resources_) {
+			if (!resource.IsImported() && resource.offset != kUnplaced && !resource.physical) { needsCreate = true; }
+		}
+		if (needsCreate) {
+			for (uint32_t category = 0; category < static_cast<uint32_t>(MemoryCategory::Count); ++category) {
+				if (transientMemorySizes_[category] == 0) { continue; }
+				if (!backend.ReserveTransientMemory(static_cast<MemoryCategory>(category), transientMemorySizes_[category])) { return false; }
+			}
+			for (Resource& resource : resources_) {
+				if (resource.IsImported() || resource.offset == kUnplaced || resource.physical) { continue; }
+				resource.physical = backend.CreateTransientResource(resource.desc, resource.offset, resource.initialState);
+				if (!resource.physical) { return false; }
+			}
+		}
+
+		auto emit = [&](const std::vector<ResourceBarrier>& barriers) {
+			if (barriers.empty()) { return; }
+			barrierBuffer_.assign(barriers.begin(), barriers.end());
+			for (ResourceBarrier& barrier : barrierBuffer_) {
+				barrier.resource = resources_[FromKey(barrier.resource)].physical;
+			}
+			backend.ResourceBarriers(barrierBuffer_.data(), static_cast<uint32_t>(barrierBuffer_.size()));
+		};
+		for (PassHandle handle : executionOrder_) {
+			const Pass& pass = passes_[handle];
+			emit(pass.barriers);
+			if (pass.execute) { pass.execute(*this); }
+		}
+		emit(finalBarriers_);
+		return true;
+	}
+
+	void RenderGraph::ReleaseTransientResources(RenderGraphBackend& backend) {
+		for (Resource& resource : resources_) {
+			if (resource.IsImported() || !resource.physical) { continue; }
+			backend.DestroyTransientResource(resource.physical);
+			resource.physical = nullptr;
+		}
+	}
+
+	void RenderGraph::Reset() {
+		ASSERT_MSG(!HasTransientResources(), "Transient resources must be released before Reset");
+		passes_.clear();
+		resources_.clear();
+		executionOrder_.clear();
+		finalBarriers_.clear();
+		std::fill(std::begin(transientMemorySizes_), std::end(transientMemorySizes_), 0);
+		statistics_ = {};
+		isCompiled_ = false;
+	}
+
+	bool RenderGraph::HasTransientResources() const {
+		for (const Resource& resource : resources_) {
+			if (!resource.IsImported() && resource.physical) { return true; }
+		}
+		return false;
+	}
+
+	void* RenderGraph::GetResource(ResourceHandle resource) const {
+		ASSERT_MSG(resource < resources_.size(), "Invalid render graph handle");
+		return resources_[resource].physical;
+	}
+
+	void RenderGraph::BuildDependencies() {
+		// リソースごとに、最後に書いたパスとその後に読んだパス
+		std::vector<PassHandle> lastWriters(resources_.size(), kInvalidHandle);
+		std::vector<std::vector<PassHandle>> readers(resources_.size());
+		auto addUnique = [](std::vector<PassHandle>& list, PassHandle pass) {
+			if (std::find(list.begin(), list.end(), pass) == list.end()) { list.push_back(pass); }
+		};
+		for (PassHandle handle = 0; handle < passes_.size(); ++handle) {
+			Pass& pass = passes_[handle];
+			for (const Access& access : pass.accesses) {
+				PassHandle writer = lastWriters[access.resource];
+				// 書いたものを読む、続けて書く（UAVは前の値を読む）
+				if (writer != kInvalidHandle && writer != handle) {
+					addUnique(pass.dependencies, writer);
+					addUnique(pass.producers, writer);
+				}
+				if (!access.isWrite) {
+					addUnique(readers[access.resource], handle);
+					continue;
+				}
+				// 読み終わるまで書かない
+				for (PassHandle reader : readers[access.resource]) {
+					if (reader != handle) { addUnique(pass.dependencies, reader); }
+				}
+				readers[access.resource].clear();
+				lastWriters[access.resource] = handle;
+			}
+		}
+	}
+
+	void RenderGraph::CullPasses() {
+		// 外から渡したリソースに書くパスと、副作用のあるパスから、読む値を作るパスを遡る
+		std::vector<bool> isNeeded(passes_.size(), false);
+		std::vector<PassHandle> stack;
+		for (PassHandle handle = 0; handle < passes_.size(); ++handle) {
+			const Pass& pass = passes_[handle];
+			bool isRoot = pass.hasSideEffect;
+			for (const Access& access : pass.accesses) {
+				if (access.isWrite && resources_[access.resource].IsImported()) { isRoot = true; }
+			}
+			if (isRoot) {
+				isNeeded[handle] = true;
+				stack.push_back(handle);
+			}
+		}
+		while (!stack.empty()) {
+			PassHandle handle = stack.back();
+			stack.pop_back();
+			for (PassHandle producer : passes_[handle].producers) {
+				if (isNeeded[producer]) { continue; }
+				isNeeded[producer] = true;
+				stack.push_back(producer);
+			}
+		}
+		for (PassHandle handle = 0; handle < passes_.size(); ++handle) {
+			passes_[handle].isCulled = !isNeeded[handle];
+		}
+	}
+
+	void RenderGraph::SortPasses() {
+		std::vector<uint32_t> remainingDependencies(passes_.size(), 0);
+		std::vector<std::vector<PassHandle>> dependents(passes_.size());
+		std::vector<PassHandle> ready;
+		for (PassHandle handle = 0; handle < passes_.size(); ++handle) {
+			const Pass& pass = passes_[handle];
+			if (pass.isCulled) { continue; }
+			for (PassHandle dependency : pass.dependencies) {
+				// 除いたパスの後に書く場合などは、順を守る必要はない
+				if (passes_[dependency].isCulled) { continue; }
+				++remainingDependencies[handle];
+				dependents[dependency].push_back(handle);
+			}
+			if (remainingDependencies[handle] == 0) { ready.push_back(handle); }
+		}
+
+		PassHandle previous = kInvalidHandle;
+		while (!ready.empty()) {
+			// 直前のパスの結果を読むパスを優先し、無ければ宣言した順
+			size_t selected = 0;
+			bool consumesPrevious = false;
+			for (size_t i = 0; i < ready.size(); ++i) {
+				const std::vector<PassHandle>& producers = passes_[ready[i]].producers;
+				bool consumes = previous != kInvalidHandle && std::find(producers.begin(), producers.end(), previous) != producers.end();
+				if (consumes != consumesPrevious ? consumes : ready[i] < ready[selected]) {
+					selected = i;
+					consumesPrevious = consumes;
+				}
+			}
+			PassHandle handle = ready[selected];
+			ready.erase(ready.begin() + selected);
+			executionOrder_.push_back(handle);
+			previous = handle;
+			for (PassHandle dependent : dependents[handle]) {
+				if (--remainingDependencies[dependent] == 0) { ready.push_back(dependent); }
+			}
+		}
+	}
+
+	void RenderGraph::ComputeLifetimes() {
+		for (Resource& resource : resources_) {
+			resource.firstUse = kUnused;
+			resource.lastUse = 0;
+			resource.offset = kUnplaced;
+			resource.isAliased = false;
+		}
+		for (uint32_t position = 0; position < executionOrder_.size(); ++position) {
+			for (const Access& access : passes_[executionOrder_[position]].accesses) {
+				Resource& resource = resources_[access.resource];
+				if (resource.firstUse == kUnused) {
+					resource.firstUse = position;
+					// 透過リソースは最初に使う状態で作る
+					if (!resource.IsImported()) {
+						resource.initialState = access.state;
+						resource.finalState = access.state;
+					}
+				}
+				resource.lastUse = position;
+			}
+		}
+	}
+
+	void RenderGraph::AliasTransientResources() {
+		std::fill(std::begin(transientMemorySizes_), std::end(transientMemorySizes_), 0);
+		// 大きい順に、寿命の重なるリソースと重ならない一番低い位置に置く
+		std::vector<ResourceHandle> order;
+		for (ResourceHandle handle = 0; handle < resources_.size(); ++handle) {
+			const Resource& resource = resources_[handle];
+			if (resource.IsImported() || resource.firstUse == kUnused) { continue; }
+			order.push_back(handle);
+			statistics_.unaliasedMemorySize += AlignUp(resource.desc.size, resource.desc.alignment);
+		}
+		std::sort(order.begin(), order.end(), [this](ResourceHandle a, ResourceHandle b) {
+			const Resource& left = resources_[a];
+			const Resource& right = resources_[b];
+			if (left.desc.size != right.desc.size) { return left.desc.size > right.desc.size; }
+			return left.firstUse < right.firstUse;
+		});
+
+		struct Placed {
+			uint64_t begin;
+			uint64_t end;
+		};
+		std::vector<ResourceHandle> placed;
+		std::vector<Placed> overlapping;
+		for (ResourceHandle handle : order) {
+			Resource& resource = resources_[handle];
+			overlapping.clear();
+			for (ResourceHandle other : placed) {
+				const Resource& placedResource = resources_[other];
+				if (placedResource.desc.category != resource.desc.category) { continue; }
+				if (placedResource.lastUse < resource.firstUse || resource.lastUse < placedResource.firstUse) { continue; }
+				overlapping.push_back(Placed{ placedResource.offset, placedResource.offset + placedResource.desc.size });
+			}
+			std::sort(overlapping.begin(), overlapping.end(), [](const Placed& a, const Placed& b) { return a.begin < b.begin; });
+			uint64_t offset = 0;
+			for (const Placed& range : overlapping) {
+				if (AlignUp(offset, resource.desc.alignment) + resource.desc.size <= range.begin) { break; }
+				offset = std::max(offset, range.end);
+			}
+			resource.offset = AlignUp(offset, resource.desc.alignment);
+			uint64_t& memorySize = transientMemorySizes_[static_cast<uint32_t>(resource.desc.category)];
+			memorySize = std::max(memorySize, resource.offset + resource.desc.size);
+			placed.push_back(handle);
+		}
+
+		// 前に同じメモリを使ったリソースがあれば、使い始めるときにAliasingバリアがいる
+		for (ResourceHandle handle : placed) {
+			Resource& resource = resources_[handle];
+			for (ResourceHandle other : placed) {
+				const Resource& previous = resources_[other];
+				if (other == handle || previous.desc.category != resource.desc.category || previous.lastUse >= resource.firstUse) { continue; }
+				if (previous.offset < resource.offset + resource.desc.size && resource.offset < previous.offset + previous.desc.size) {
+					resource.isAliased = true;
+					break;
+				}
+			}
+			if (resource.isAliased) { ++statistics_.aliasedResourceCount; }
+		}
+		statistics_.transientResourceCount = static_cast<uint32_t>(placed.size());
+		for (uint64_t size : transientMemorySizes_) { statistics_.transientMemorySize += size; }
+	}
+
+	void RenderGraph::BuildBarriers() {
+		ResourceStateTracker tracker;
+		std::vector<ResourceState> states(resources_.size());
+		// 前のUAVバリアか遷移の後に、UAVとして読んだか書いたか
+		enum UAVAccess : uint8_t { kUAVRead = 1 << 0, kUAVWrite = 1 << 1 };
+		std::vector<uint8_t> uavAccesses(resources_.size(), 0);
+		for (ResourceHandle handle = 0; handle < resources_.size(); ++handle) {
+			states[handle] = resources_[handle].initialState;
+		}
+
+		for (uint32_t position = 0; position < executionOrder_.size(); ++position) {
+			Pass& pass = passes_[executionOrder_[position]];
+			for (const Access& access : pass.accesses) {
+				const Resource& resource = resources_[access.resource];
+				if (resource.isAliased && resource.firstUse == position) {
+					// 同じリソースを一つのパスで何度か使っても1回だけ
+					bool alreadyAdded = false;
+					for (const ResourceBarrier& barrier : pass.barriers) {
+						alreadyAdded = alreadyAdded || (barrier.type == ResourceBarrier::Type::Aliasing && barrier.resource == ToKey(access.resource));
+					}
+					if (!alreadyAdded) {
+						ResourceBarrier barrier{};
+						barrier.type = ResourceBarrier::Type::Aliasing;
+						barrier.resource = ToKey(access.resource);
+						pass.barriers.push_back(barrier);
+					}
+				}
+			}
+			for (const Access& access : pass.accesses) {
+				ResourceState& state = states[access.resource];
+				if (state == access.state) {
+					// 書き込みと、その前後のUAVとしてのアクセスの間はUAVバリアで待つ（読んだ後に書く場合も）
+					uint8_t& pending = uavAccesses[access.resource];
+					if (access.state == ResourceState::UnorderedAccess && (access.isWrite ? pending != 0 : (pending & kUAVWrite) != 0)) {
+						tracker.UAVBarrier(ToKey(access.resource));
+						pending = 0;
+					}
+				}
+				else {
+					ResourceState after = access.state;
+					// 続けて読むパスの状態をまとめて、読むたびに遷移しない
+					if (!access.isWrite && IsReadOnlyState(after)) {
+						for (uint32_t next = position + 1; next < executionOrder_.size(); ++next) {
+							bool stop = false;
+							for (const Access& nextAccess : passes_[executionOrder_[next]].accesses) {
+								if (nextAccess.resource != access.resource) { continue; }
+								if (nextAccess.isWrite || !IsReadOnlyState(nextAccess.state)) { stop = true; break; }
+								after = after | nextAccess.state;
+							}
+							if (stop) { break; }
+						}
+					}
+					state = tracker.Transition(ToKey(access.resource), state, after);
+					// 遷移が前のアクセスを待つ
+					uavAccesses[access.resource] = 0;
+				}
+				if (access.state == ResourceState::UnorderedAccess) {
+					uavAccesses[access.resource] |= access.isWrite ? kUAVWrite : kUAVRead;
+				}
+			}
+			const std::vector<ResourceBarrier>& pending = tracker.GetPendingBarriers();
+			pass.barriers.insert(pass.barriers.end(), pending.begin(), pending.end());
+			tracker.ClearPendingBarriers();
+		}
+
+		// 外から渡したリソースは決めた状態に、透過リソースは次のフレームのために作った状態に戻す
+		for (ResourceHandle handle = 0; handle < resources_.size(); ++handle) {
+			const Resource& resource = resources_[handle];
+			if (resource.firstUse == kUnused && !resource.IsImported()) { continue; }
+			ResourceState& state = states[handle];
+			if (state == resource.finalState) { continue; }
+			state = tracker.Transition(ToKey(handle), state, resource.finalState);
+		}
+		finalBarriers_ = tracker.GetPendingBarriers();
+		tracker.ClearPendingBarriers();
+	}
+
+	std::string RenderGraph::Dump() const {
+		std::string text;
+		text += String::FormatTemporary("RenderGraph: {} passes ({} culled), {} barriers, transient memory {} bytes (unaliased {} bytes)\n",
+			statistics_.passCount, statistics_.culledPassCount, statistics_.barrierCount, statistics_.transientMemorySize, statistics_.unaliasedMemorySize);
+		auto appendBarriers = [&](const std::vector<ResourceBarrier>& barriers) {
+			for (const ResourceBarrier& barrier : barriers) {
+				const std::string& name = resources_[FromKey(barrier.resource)].name;
+				if (barrier.type == ResourceBarrier::Type::Aliasing) {
+					text += String::FormatTemporary("    aliasing {}\n", name);
+				}
+				else if (barrier.type == ResourceBarrier::Type::UAV) {
+					text += String::FormatTemporary("    uav {}\n", name);
+				}
+				else {
+					text += String::FormatTemporary("    transition {} ", name);
+					AppendState(text, barrier.before);
+					text += " -> ";
+					AppendState(text, barrier.after);
+					text += "\n";
+				}
+			}
+		};
+		for (uint32_t position = 0; position < executionOrder_.size(); ++position) {
+			const Pass& pass = passes_[executionOrder_[position]];
+			text += String::FormatTemporary("[{}] {}{}\n", position, pass.name, pass.hasSideEffect ? " (side effect)" : "");
+			appendBarriers(pass.barriers);
+			for (const Access& access : pass.accesses) {
+				text += String::FormatTemporary("    {} {} ", access.isWrite ? "write" : "read", resources_[access.resource].name);
+				AppendState(text, access.state);
+				text += "\n";
+			}
+		}
+		if (!finalBarriers_.empty()) {
+			text += "[end]\n";
+			appendBarriers(finalBarriers_);
+		}
+		for (const Pass& pass : passes_) {
+			if (pass.isCulled) { text += String::FormatTemporary("culled {}\n", pass.name); }
+		}
+		for (const Resource& resource : resources_) {
+			if (resource.IsImported()) {
+				text += String::FormatTemporary("resource {} imported", resource.name);
+			}
+			else if (resource.offset == kUnplaced) {
+				text += String::FormatTemporary("resource {} unused", resource.name);
+			}
+			else {
+				text += String::FormatTemporary("resource {} {} offset {} size {}", resource.name, GetCategoryName(resource.desc.category), resource.offset, resource.desc.size);
+			}
+			if (resource.firstUse != kUnused) {
+				text += String::FormatTemporary(" passes [{}, {}]", resource.firstUse, resource.lastUse);
+			}
+			text += resource.isAliased ? " aliased\n" : "\n";
+		}
+		return text;
+	}
+
+	std::string RenderGraph::DumpGraphviz() const {
+		std::string text = "digraph RenderGraph {\n\trankdir=LR;\n";
+		for (PassHandle handle = 0; handle < passes_.size(); ++handle) {
+			const Pass& pass = passes_[handle];
+			text += String::FormatTemporary("\tp{} [shape=box,label=\"{}\"{}];\n", handle, pass.name, pass.isCulled ? ",style=dashed,color=gray" : "");
+		}
+		for (ResourceHandle handle = 0; handle < resources_.size(); ++handle) {
+			const Resource& resource = resources_[handle];
+			text += String::FormatTemporary("\tr{} [shape=ellipse,label=\"{}\"{}];\n", handle, resource.name,
+				resource.IsImported() ? ",style=filled,fillcolor=lightblue" : (resource.isAliased ? ",style=filled,fillcolor=orange" : ""));
+		}
+		for (PassHandle handle = 0; handle < passes_.size(); ++handle) {
+			for (const Access& access : passes_[handle].accesses) {
+				if (access.isWrite) { text += String::FormatTemporary("\tp{} -> r{};\n", handle, access.resource); }
+				else { text += String::FormatTemporary("\tr{} -> p{};\n", access.resource, handle); }
+			}
+		}
+		text += "}\n";
+		return text;
+	}
+
+}
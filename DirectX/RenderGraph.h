@@ -0,0 +1,223 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "GPUMemoryAllocator.h"
+#include "ResourceStateTracker.h"
+
+namespace Engine {
+
+	class RenderGraph;
+
+	// フレームの間だけ使うリソース（寿命が重ならないものは同じメモリに置く）
+	struct TransientResourceDesc {
+		// バイト数（D3DではGetResourceAllocationInfoの値）
+		uint64_t size;
+		// 2のべき乗
+		uint64_t alignment;
+		MemoryCategory category;
+		// バックエンドにそのまま渡す（D3DではD3D12_RESOURCE_DESCなど）
+		const void* userData;
+	};
+
+	// コンパイルした結果を実行する側（D3Dではコマンドリストと配置したリソース、テストでは模擬のメモリ）
+	class RenderGraphBackend {
+	public:
+		virtual ~RenderGraphBackend() = default;
+		/// <summary>
+		/// 種類ごとに透過リソースを置くメモリを用意する（CreateTransientResourceより先に呼ばれる）
+		/// </summary>
+		/// <param name="category"></param>
+		/// <param name="size">RenderGraph::GetTransientMemorySizeの値</param>
+		/// <returns></returns>
+		virtual bool ReserveTransientMemory(MemoryCategory category, uint64_t size) = 0;
+		/// <summary>
+		/// 透過リソースを作る
+		/// </summary>
+		/// <param name="desc"></param>
+		/// <param name="offset">ReserveTransientMemoryで用意したメモリの先頭からのバイト位置</param>
+		/// <param name="initialState">最初に使う状態</param>
+		/// <returns>リソース、作れない場合はnullptr</returns>
+		virtual void* CreateTransientResource(const TransientResourceDesc& desc, uint64_t offset, ResourceState initialState) = 0;
+		virtual void DestroyTransientResource(void* resource) = 0;
+		/// <summary>
+		/// パスの前のバリアを出す
+		/// </summary>
+		virtual void ResourceBarriers(const ResourceBarrier* barriers, uint32_t count) = 0;
+	};
+
+	// フレームの処理をパスとして並べ、パスが読み書きするリソースから実行順とバリアと透過リソースの配置を決める
+	// ・読み書きを宣言した順に依存を作る（書いたものを後で読む、読んだものを後で書く、続けて書く）
+	// ・結果がどこにも使われないパスは除く（外から渡したリソースに書くパスと、副作用のあるパスから遡って残す）
+	// ・依存を守る範囲で、直前のパスの結果を読むパスを先に並べて透過リソースの寿命を短くする
+	// ・並べた順に状態を追ってバリアを求める（ResourceStateTrackerでまとめる）
+	// ・寿命の重ならない透過リソースは同じメモリに置き、使い始めるときにAliasingバリアを出す
+	// 宣言、Compile、Executeの順に呼ぶ（Compileはバックエンドを使わないので、D3Dの無い環境でも結果を確かめられる）
+	class RenderGraph {
+	public:
+		using ResourceHandle = uint32_t;
+		using PassHandle = uint32_t;
+		static constexpr uint32_t kInvalidHandle = UINT32_MAX;
+
+		// パスの処理（GetResourceで実体を取ってコマンドを積む）
+		using ExecuteFunction = std::function<void(const RenderGraph& graph)>;
+
+		struct Statistics {
+			uint32_t passCount;
+			uint32_t culledPassCount;
+			uint32_t barrierCount;
+			uint32_t transientResourceCount;
+			// 同じメモリに置いた透過リソースの数
+			uint32_t aliasedResourceCount;
+			// 種類ごとのメモリの合計
+			uint64_t transientMemorySize;
+			// 同じメモリに置かない場合の合計
+			uint64_t unaliasedMemorySize;
+		};
+
+		RenderGraph() = default;
+		~RenderGraph();
+		RenderGraph(const RenderGraph&) = delete;
+		RenderGraph& operator=(const RenderGraph&) = delete;
+
+		/// <summary>
+		/// 透過リソースを宣言する
+		/// </summary>
+		/// <param name="name"></param>
+		/// <param name="desc"></param>
+		/// <returns></returns>
+		ResourceHandle CreateTransient(const char* name, const TransientResourceDesc& desc);
+		/// <summary>
+		/// 外で作ったリソースを使う（バックバッファ、フレームをまたぐパーティクルのバッファなど）
+		/// </summary>
+		/// <param name="name"></param>
+		/// <param name="resource">D3DではID3D12Resource*</param>
+		/// <param name="initialState">グラフを実行する前の状態</param>
+		/// <param name="finalState">グラフを実行した後に戻す状態</param>
+		/// <returns></returns>
+		ResourceHandle Import(const char* name, void* resource, ResourceState initialState, ResourceState finalState);
+		/// <summary>
+		/// パスを足す
+		/// </summary>
+		/// <param name="name"></param>
+		/// <param name="execute"></param>
+		/// <param name="hasSideEffect">書いたリソースが使われなくても除かない（ImGuiなど）</param>
+		/// <returns></returns>
+		PassHandle AddPass(const char* name, ExecuteFunction execute, bool hasSideEffect = false);
+		/// <summary>
+		/// パスがリソースを読む
+		/// </summary>
+		void Read(PassHandle pass, ResourceHandle resource, ResourceState state);
+		/// <summary>
+		/// パスがリソースに書く（UnorderedAccessは読み書き）
+		/// </summary>
+		void Write(PassHandle pass, ResourceHandle resource, ResourceState state);
+
+		/// <summary>
+		/// 不要なパスを除き、並べて、バリアと透過リソースの配置を求める
+		/// </summary>
+		/// <returns>書かれる前に読む透過リソースがある場合はfalse</returns>
+		bool Compile();
+		/// <summary>
+		/// 透過リソースを作り（まだ作っていなければ）、並べた順にバリアを出してパスを実行する
+		/// </summary>
+		/// <param name="backend"></param>
+		/// <returns>透過リソースを作れない場合はfalse</returns>
+		bool Execute(RenderGraphBackend& backend);
+		/// <summary>
+		/// Executeで作った透過リソースを破棄する（GPUが使い終えてから呼ぶ）
+		/// </summary>
+		void ReleaseTransientResources(RenderGraphBackend& backend);
+		/// <summary>
+		/// 宣言をすべて捨てる（透過リソースは先にReleaseTransientResourcesで破棄しておく）
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// リソースの実体（パスの処理の中で呼ぶ）
+		/// </summary>
+		void* GetResource(ResourceHandle resource) const;
+
+		// Compile後の値
+		const std::vector<PassHandle>& GetExecutionOrder() const { return executionOrder_; }
+		bool IsPassCulled(PassHandle pass) const { return passes_[pass].isCulled; }
+		// パスの前に出すバリア（resourceはリソースの番号+1で、Executeで実体に置き換える）
+		const std::vector<ResourceBarrier>& GetPassBarriers(PassHandle pass) const { return passes_[pass].barriers; }
+		// すべてのパスの後で、外から渡したリソースと透過リソースを元の状態に戻すバリア
+		const std::vector<ResourceBarrier>& GetFinalBarriers() const { return finalBarriers_; }
+		// 透過リソースを置いたバイト位置（使われないものはUINT64_MAX）
+		uint64_t GetTransientOffset(ResourceHandle resource) const { return resources_[resource].offset; }
+		uint64_t GetTransientMemorySize(MemoryCategory category) const { return transientMemorySizes_[static_cast<uint32_t>(category)]; }
+		const Statistics& GetStatistics() const { return statistics_; }
+
+		/// <summary>
+		/// 並べた順とバリアと配置を文字列にする
+		/// </summary>
+		std::string Dump() const;
+		/// <summary>
+		/// Graphvizのdot形式にする（除いたパスは灰色）
+		/// </summary>
+		std::string DumpGraphviz() const;
+
+	private:
+		struct Access {
+			ResourceHandle resource;
+			ResourceState state;
+			bool isWrite;
+		};
+		struct Pass {
+			std::string name;
+			ExecuteFunction execute;
+			bool hasSideEffect;
+			std::vector<Access> accesses;
+			// 実行順の依存（先に実行するパス）
+			std::vector<PassHandle> dependencies;
+			// 読む値を作るパス（除くかを決める）
+			std::vector<PassHandle> producers;
+			std::vector<ResourceBarrier> barriers;
+			bool isCulled;
+		};
+		struct Resource {
+			std::string name;
+			TransientResourceDesc desc;
+			void* imported;
+			ResourceState initialState;
+			ResourceState finalState;
+			// 実行順での最初と最後に使う位置
+			uint32_t firstUse;
+			uint32_t lastUse;
+			uint64_t offset;
+			// 前に同じメモリを使った透過リソースがある
+			bool isAliased;
+			// Executeで作った実体
+			void* physical;
+
+			bool IsImported() const { return imported != nullptr; }
+		};
+
+		// Executeで作った透過リソースが残っている
+		bool HasTransientResources() const;
+		void BuildDependencies();
+		void CullPasses();
+		void SortPasses();
+		void ComputeLifetimes();
+		void AliasTransientResources();
+		void BuildBarriers();
+		// ResourceBarrierのresourceとリソースの番号の変換
+		static void* ToKey(ResourceHandle resource) { return reinterpret_cast<void*>(static_cast<uintptr_t>(resource) + 1); }
+		static ResourceHandle FromKey(void* key) { return static_cast<ResourceHandle>(reinterpret_cast<uintptr_t>(key) - 1); }
+
+		std::vector<Pass> passes_;
+		std::vector<Resource> resources_;
+		std::vector<PassHandle> executionOrder_;
+		std::vector<ResourceBarrier> finalBarriers_;
+		uint64_t transientMemorySizes_[static_cast<uint32_t>(MemoryCategory::Count)]{};
+		bool isCompiled_{ false };
+		// Executeで実体に置き換えたバリア（使い回す）
+		std::vector<ResourceBarrier> barrierBuffer_;
+		Statistics statistics_{};
+	};
+
+}
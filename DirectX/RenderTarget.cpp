@@ -1,17 +1,19 @@
 #include "stdafx.h"
 #include "RenderTarget.h"
+#include "DirectXHelper.h"
 #include "Logger.h"
 
 namespace DirectXHelper {
 
 	D3D12_CPU_DESCRIPTOR_HANDLE RenderTarget::sStartHandle_{};
 	ComPtr<ID3D12DescriptorHeap> RenderTarget::sDescriptorHeap_;
-	Engine::Bitset<kRTVMaxCount> RenderTarget::sUseTable_;
+	Engine::AtomicBitset<kRTVMaxCount> RenderTarget::sUseTable_;
+	std::mutex RenderTarget::sCreateHeapMutex_;
 	uint32_t RenderTarget::sDescriptorSize_{ 0 };
 
 	bool RenderTarget::CreateHeap(ID3D12Device5* device) {
 		D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc{};
-		descriptorHeapDesc.NumDescriptors = 1;
+		descriptorHeapDesc.NumDescriptors = kRTVMaxCount;
 		descriptorHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
 		if (FAILED(device->CreateDescriptorHeap(&descriptorHeapDesc, IID_PPV_ARGS(sDescriptorHeap_.GetAddressOf())))) {
 			Logger::Error("CreateDescriptorHeap()");
@@ -24,16 +26,43 @@ namespace DirectXHelper {
 		return true;
 	}
 
+	RenderTarget::~RenderTarget() {
+		// リサイズで作り直す場合など、GPUがまだ描いているかもしれないのでリソースは通過してから解放する
+		DeferredRelease(resource_);
+		// RTVはコマンドを積む時に読まれるだけなので、GPUの完了を待たずにスロットを戻してよい
+		if (descriptorIndex_ != sUseTable_.kNotFound) {
+			sUseTable_.Release(descriptorIndex_);
+		}
+	}
+
 	bool RenderTarget::Initalize(ID3D12Device5* device, ID3D12Resource* resource, DXGI_FORMAT viewFormat) {
 		assert(device);
 		assert(resource);
 
+		{
+			std::lock_guard<std::mutex> lock(sCreateHeapMutex_);
+			if (!sDescriptorHeap_ && !CreateHeap(device)) {
+				return false;
+			}
+		}
+		// 作り直す場合は同じスロットを使う
+		if (descriptorIndex_ == sUseTable_.kNotFound) {
+			descriptorIndex_ = sUseTable_.TryAcquire();
+			if (descriptorIndex_ == sUseTable_.kNotFound) {
+				Logger::Error("RenderTarget descriptor is full");
+				assert(false);
+				return false;
+			}
+			handle_.ptr = sStartHandle_.ptr + static_cast<SIZE_T>(descriptorIndex_) * sDescriptorSize_;
+		}
 
 		D3D12_RENDER_TARGET_VIEW_DESC rtvDesc{};
 		rtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
 		rtvDesc.Format = viewFormat;
 		device->CreateRenderTargetView(resource, &rtvDesc, handle_);
 
+		// 前のリソースは使っているコマンドが終わってから解放する
+		DeferredRelease(resource_);
 		resource_.Attach(resource);
 		auto resourceDesc = resource_->GetDesc();
 		width_ = static_cast<uint32_t>(resourceDesc.Width);
@@ -1,6 +1,7 @@
 #pragma once
+#include <mutex>
 #include "GPUResource.h"
-#include "Bitset.h"
+#include "AtomicBitset.h"
 
 namespace DirectXHelper {
 	using namespace Microsoft::WRL;
@@ -14,10 +15,18 @@ namespace DirectXHelper {
 
 		static D3D12_CPU_DESCRIPTOR_HANDLE sStartHandle_;
 		static ComPtr<ID3D12DescriptorHeap> sDescriptorHeap_;
-		static Engine::Bitset<kRTVMaxCount> sUseTable_;
+		// RTVのスロットの使用状況（ワーカースレッドからも確保、解放する）
+		static Engine::AtomicBitset<kRTVMaxCount> sUseTable_;
+		// ヒープを最初に作る時だけ使う
+		static std::mutex sCreateHeapMutex_;
 		static uint32_t sDescriptorSize_;
 		
 	public:
+		RenderTarget() = default;
+		~RenderTarget();
+		RenderTarget(const RenderTarget&) = delete;
+		RenderTarget& operator=(const RenderTarget&) = delete;
+
 		bool Initalize(ID3D12Device5* device, ID3D12Resource* resource, DXGI_FORMAT viewFormat);
 		bool Initalize(ID3D12Device5* device, uint32_t width, uint32_t height, DXGI_FORMAT format, float clearColor[4]);
 
@@ -39,6 +48,8 @@ namespace DirectXHelper {
 	private:
 		ComPtr<ID3D12DescriptorHeap> descriptorHeap_;
 		D3D12_CPU_DESCRIPTOR_HANDLE handle_{};
+		// sUseTable_で確保したスロット（kNotFoundは未確保）
+		size_t descriptorIndex_{ Engine::AtomicBitset<kRTVMaxCount>::kNotFound };
 		uint32_t width_{ 0 };
 		uint32_t height_{ 0 };
 		DXGI_FORMAT format_{ DXGI_FORMAT_UNKNOWN };
@@ -0,0 +1,97 @@
+#ifndef FASTMATH_HLSLI
+#define FASTMATH_HLSLI
+
+// FastMath.h のHLSL版
+// CPUと同じ係数、同じ計算順だが、GPUはFMAへの融合などで丸めが変わるので、結果はCPU側とビット単位では一致しない
+// 保証するのは FastMath.h の *MaxError（倍精度の std:: と比べた絶対誤差または相対誤差、FastMathBenchmarkで確認している範囲）まで
+// FastRsqrtはrsqrt命令を使うので、誤差はFastRsqrtMaxErrorではなくD3Dのrsqrtの精度（相対2ULP）になる
+
+static const float32_t kFastMathPi = 3.141592653589793f;
+static const float32_t kFastMathHalfPi = 1.570796326794897f;
+static const float32_t kFastMathTwoOverPi = 0.636619772367581f;
+
+void FastSinCos(float32_t x, out float32_t s, out float32_t c) {
+	// x = q*π/2 + r、|r| <= π/4
+	int32_t q = int32_t(round(x * kFastMathTwoOverPi));
+	float32_t fq = float32_t(q);
+	float32_t r = ((x - fq * 1.5703125f) - fq * 4.837512969970703125e-4f) - fq * 7.54978995489188216e-8f;
+	float32_t r2 = r * r;
+	float32_t sinR = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+	float32_t cosR = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+	// 象限で入れ替えと符号を決める
+	bool swap = (q & 1) != 0;
+	float32_t sinQ = swap ? cosR : sinR;
+	float32_t cosQ = swap ? sinR : cosR;
+	s = (q & 2) != 0 ? -sinQ : sinQ;
+	c = ((q + 1) & 2) != 0 ? -cosQ : cosQ;
+}
+
+float32_t FastSin(float32_t x) {
+	float32_t s, c;
+	FastSinCos(x, s, c);
+	return s;
+}
+
+float32_t FastCos(float32_t x) {
+	float32_t s, c;
+	FastSinCos(x, s, c);
+	return c;
+}
+
+float32_t FastAtan2(float32_t y, float32_t x) {
+	float32_t absX = abs(x), absY = abs(y);
+	float32_t maxXY = max(absX, absY), minXY = min(absX, absY);
+	float32_t a = maxXY > 0.0f ? minXY / maxXY : 0.0f;
+	float32_t s = a * a;
+	float32_t p = 0.0028662257f;
+	p = p * s - 0.0161657367f;
+	p = p * s + 0.0429096138f;
+	p = p * s - 0.0752896400f;
+	p = p * s + 0.1065626393f;
+	p = p * s - 0.1420889944f;
+	p = p * s + 0.1999355085f;
+	p = p * s - 0.3333314528f;
+	float32_t r = a + a * s * p;
+	r = absY > absX ? kFastMathHalfPi - r : r;
+	r = x < 0.0f ? kFastMathPi - r : r;
+	return asuint(y) >> 31 ? -r : r;
+}
+
+float32_t FastAcos(float32_t x) {
+	float32_t a = min(abs(x), 1.0f);
+	float32_t p = -0.0012624911f;
+	p = p * a + 0.0066700901f;
+	p = p * a - 0.0170881256f;
+	p = p * a + 0.0308918810f;
+	p = p * a - 0.0501743046f;
+	p = p * a + 0.0889789874f;
+	p = p * a - 0.2145988016f;
+	p = p * a + 1.5707963050f;
+	float32_t r = sqrt(1.0f - a) * p;
+	return x < 0.0f ? kFastMathPi - r : r;
+}
+
+float32_t FastRsqrt(float32_t x) {
+	// GPUではrsqrt命令がそのまま速い
+	return rsqrt(x);
+}
+
+float32_t FastExp(float32_t x) {
+	x = clamp(x, -87.33654f, 88.72283f);
+	int32_t n = int32_t(round(x * 1.44269504088896341f));
+	float32_t fn = float32_t(n);
+	float32_t r = (x - fn * 0.693359375f) - fn * -2.12194440e-4f;
+	float32_t p = 1.9875691500e-4f;
+	p = p * r + 1.3981999507e-3f;
+	p = p * r + 8.3334519073e-3f;
+	p = p * r + 4.1665795894e-2f;
+	p = p * r + 1.6666665459e-1f;
+	p = p * r + 5.0000001201e-1f;
+	p = p * r * r + r + 1.0f;
+	// 2^nが単精度の指数の範囲を超えてもよいように2回に分けて掛ける
+	int32_t n1 = n >> 1;
+	int32_t n2 = n - n1;
+	return p * asfloat((n1 + 127) << 23) * asfloat((n2 + 127) << 23);
+}
+
+#endif // FASTMATH_HLSLI
@@ -4,10 +4,95 @@ typedef float32_t2 Vector2;
 typedef float32_t3 Vector3;
 typedef float32_t4 Vector4;
 typedef float32_t4x4 Matrix44;
+
+// Packing.h のHLSL版
+// 丸めと範囲はCPU側と同じにしてある
+// 要素ごとの選択は、HLSL 2021にしかないselectの代わりにstep（x >= 0で1）で作る（言語のバージョンに依らない）
+
+uint32_t PackHalf2(float32_t2 value) { return f32tof16(value.x) | (f32tof16(value.y) << 16); }
+float32_t2 UnpackHalf2(uint32_t value) { return float32_t2(f16tof32(value), f16tof32(value >> 16)); }
+// CPU側のuint64_tと同じ並び
+uint32_t2 PackHalf4(float32_t4 value) { return uint32_t2(PackHalf2(value.xy), PackHalf2(value.zw)); }
+float32_t4 UnpackHalf4(uint32_t2 value) { return float32_t4(UnpackHalf2(value.x), UnpackHalf2(value.y)); }
+
+uint32_t PackUnorm8x4(float32_t4 value) {
+	uint32_t4 u = uint32_t4(saturate(value) * 255.0f + 0.5f);
+	return u.x | (u.y << 8) | (u.z << 16) | (u.w << 24);
+}
+float32_t4 UnpackUnorm8x4(uint32_t value) {
+	return float32_t4(value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, value >> 24) / 255.0f;
+}
+uint32_t PackSnorm8x4(float32_t4 value) {
+	float32_t4 scaled = clamp(value, -1.0f, 1.0f) * 127.0f;
+	int32_t4 s = int32_t4(scaled + (step(0.0f, scaled) - 0.5f));
+	uint32_t4 u = uint32_t4(s) & 0xFF;
+	return u.x | (u.y << 8) | (u.z << 16) | (u.w << 24);
+}
+float32_t4 UnpackSnorm8x4(uint32_t value) {
+	// 符号拡張
+	int32_t4 s = int32_t4(value << 24, value << 16, value << 8, value) >> 24;
+	return max(float32_t4(s) / 127.0f, -1.0f);
+}
+uint32_t PackUnorm16x2(float32_t2 value) {
+	uint32_t2 u = uint32_t2(saturate(value) * 65535.0f + 0.5f);
+	return u.x | (u.y << 16);
+}
+float32_t2 UnpackUnorm16x2(uint32_t value) {
+	return float32_t2(value & 0xFFFF, value >> 16) / 65535.0f;
+}
+uint32_t PackSnorm16x2(float32_t2 value) {
+	float32_t2 scaled = clamp(value, -1.0f, 1.0f) * 32767.0f;
+	int32_t2 s = int32_t2(scaled + (step(0.0f, scaled) - 0.5f));
+	uint32_t2 u = uint32_t2(s) & 0xFFFF;
+	return u.x | (u.y << 16);
+}
+float32_t2 UnpackSnorm16x2(uint32_t value) {
+	int32_t2 s = int32_t2(value << 16, value) >> 16;
+	return max(float32_t2(s) / 32767.0f, -1.0f);
+}
+uint32_t PackR10G10B10A2(float32_t4 value) {
+	uint32_t4 u = uint32_t4(saturate(value) * float32_t4(1023.0f, 1023.0f, 1023.0f, 3.0f) + 0.5f);
+	return u.x | (u.y << 10) | (u.z << 20) | (u.w << 30);
+}
+float32_t4 UnpackR10G10B10A2(uint32_t value) {
+	return float32_t4(value & 0x3FF, (value >> 10) & 0x3FF, (value >> 20) & 0x3FF, value >> 30) / float32_t4(1023.0f, 1023.0f, 1023.0f, 3.0f);
+}
+
+float32_t2 OctahedralEncode(float32_t3 normal) {
+	float32_t2 result = normal.xy / (abs(normal.x) + abs(normal.y) + abs(normal.z));
+	if (normal.z < 0.0f) {
+		result = (1.0f - abs(result.yx)) * (step(0.0f, result) * 2.0f - 1.0f);
+	}
+	return result;
+}
+float32_t3 OctahedralDecode(float32_t2 encoded) {
+	float32_t3 result = float32_t3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float32_t t = max(-result.z, 0.0f);
+	result.xy += (1.0f - step(0.0f, result.xy) * 2.0f) * t;
+	return normalize(result);
+}
+uint32_t PackOctahedral(float32_t3 normal) { return PackSnorm16x2(OctahedralEncode(normal)); }
+float32_t3 UnpackOctahedral(uint32_t value) { return OctahedralDecode(UnpackSnorm16x2(value)); }
 #else
 #include "MathUtils.h"
-using Vector2 = Math::Vector2;
-using Vector3 = Math::Vector3;
-using Vector4 = Math::Vector4;
-using Matrix44 = Math::Matrix44;
+#include "Packing.h"
+using Matrix44 = Matrix4x4;
+using Math::PackHalf2;
+using Math::UnpackHalf2;
+using Math::PackHalf4;
+using Math::UnpackHalf4;
+using Math::PackUnorm8x4;
+using Math::UnpackUnorm8x4;
+using Math::PackSnorm8x4;
+using Math::UnpackSnorm8x4;
+using Math::PackUnorm16x2;
+using Math::UnpackUnorm16x2;
+using Math::PackSnorm16x2;
+using Math::UnpackSnorm16x2;
+using Math::PackR10G10B10A2;
+using Math::UnpackR10G10B10A2;
+using Math::OctahedralEncode;
+using Math::OctahedralDecode;
+using Math::PackOctahedral;
+using Math::UnpackOctahedral;
 #endif
@@ -8,7 +8,18 @@ namespace ParticleShader {
 		Vector3 acceleration;
 	};
 
+	// PACKED_LAYOUT=1 の並び（速度と加速度を半精度で持つ）
+	struct PackedParticle {
+		Vector4 position;
+		uint32_t velocityXY;
+		uint32_t velocityZAccelerationX;
+		uint32_t accelerationYZ;
+		uint32_t padding;
+	};
+
 	struct Target {
 		Vector3 position;
+		// 最後のスレッドグループで余ったスレッドは何もしない
+		uint32_t particleCount;
 	};
 }
\ No newline at end of file
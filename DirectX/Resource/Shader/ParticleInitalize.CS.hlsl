@@ -1,5 +1,6 @@
 #define HLSL
 #include "ParticleCompute_HLSLCompat.h"
+#include "FastMath.hlsli"
 
 RWStructuredBuffer<ParticleShader::Particle> particlesRWSB : register(u0);
 
@@ -13,8 +14,8 @@ void main(uint32_t3 DTid : SV_DispatchThreadID) {
 	uint32_t a = DTid.x / (65536 / 10);
 
 	float32_t dis = 0.2f * float32_t(a);
-	float32_t s = sin(theta);
-	float32_t c = cos(theta);
+	float32_t s, c;
+	FastSinCos(theta, s, c);
 	float32_t initSpeed = 0.01f;
 	particlesRWSB[DTid.x].velocity = float32_t3(c * initSpeed, s * initSpeed, 0.0f);
 	particlesRWSB[DTid.x].position = float32_t4(c * dis, s * dis, 0.0f, 1.0f);
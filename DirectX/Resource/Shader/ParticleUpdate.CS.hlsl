@@ -1,12 +1,55 @@
 #define HLSL
 #include "ParticleCompute_HLSLCompat.h"
 
+// 組み合わせ（ShaderCompileOptions.h の MakeParticleUpdatePermutationSpace）
+#ifndef THREAD_GROUP_SIZE
+#define THREAD_GROUP_SIZE 16
+#endif
+// 0: 半陰的オイラー、1: 速度ベルレ
+#ifndef INTEGRATOR
+#define INTEGRATOR 0
+#endif
+// 1: 速度と加速度を半精度で持つ
+#ifndef PACKED_LAYOUT
+#define PACKED_LAYOUT 0
+#endif
+
+#if PACKED_LAYOUT
+RWStructuredBuffer<ParticleShader::PackedParticle> particlesRWSB : register(u0);
+
+ParticleShader::Particle LoadParticle(uint32_t index) {
+	ParticleShader::PackedParticle packed = particlesRWSB[index];
+	float32_t4 velocityAcceleration = UnpackHalf4(uint32_t2(packed.velocityXY, packed.velocityZAccelerationX));
+	ParticleShader::Particle particle;
+	particle.position = packed.position;
+	particle.velocity = velocityAcceleration.xyz;
+	particle.acceleration = float32_t3(velocityAcceleration.w, UnpackHalf2(packed.accelerationYZ));
+	return particle;
+}
+void StoreParticle(uint32_t index, ParticleShader::Particle particle) {
+	uint32_t2 velocityAcceleration = PackHalf4(float32_t4(particle.velocity, particle.acceleration.x));
+	ParticleShader::PackedParticle packed;
+	packed.position = particle.position;
+	packed.velocityXY = velocityAcceleration.x;
+	packed.velocityZAccelerationX = velocityAcceleration.y;
+	packed.accelerationYZ = PackHalf2(particle.acceleration.yz);
+	packed.padding = 0;
+	particlesRWSB[index] = packed;
+}
+#else
 RWStructuredBuffer<ParticleShader::Particle> particlesRWSB : register(u0);
+
+ParticleShader::Particle LoadParticle(uint32_t index) { return particlesRWSB[index]; }
+void StoreParticle(uint32_t index, ParticleShader::Particle particle) { particlesRWSB[index] = particle; }
+#endif
 ConstantBuffer<ParticleShader::Target> targetCB : register(b0);
 
-[numthreads(16, 1, 1)]
+[numthreads(THREAD_GROUP_SIZE, 1, 1)]
 void main(uint32_t3 DTid : SV_DispatchThreadID) {
-	float32_t3 direction = targetCB.position - particlesRWSB[DTid.x].position.xyz;
+	// THREAD_GROUP_SIZEで割り切れない数のときに、バッファの外を書かない
+	if (DTid.x >= targetCB.particleCount) { return; }
+	ParticleShader::Particle particle = LoadParticle(DTid.x);
+	float32_t3 direction = targetCB.position - particle.position.xyz;
 	float32_t distance = length(direction);
 	direction = direction / distance;
 	if (distance <= 1.0f) {
@@ -16,7 +59,13 @@ void main(uint32_t3 DTid : SV_DispatchThreadID) {
 
 	
 
-	particlesRWSB[DTid.x].acceleration = direction * 0.001f;
-	particlesRWSB[DTid.x].velocity += particlesRWSB[DTid.x].acceleration;
-	particlesRWSB[DTid.x].position.xyz += particlesRWSB[DTid.x].velocity;
+	particle.acceleration = direction * 0.001f;
+#if INTEGRATOR == 1
+	particle.position.xyz += particle.velocity + 0.5f * particle.acceleration;
+	particle.velocity += particle.acceleration;
+#else
+	particle.velocity += particle.acceleration;
+	particle.position.xyz += particle.velocity;
+#endif
+	StoreParticle(DTid.x, particle);
 }
\ No newline at end of file
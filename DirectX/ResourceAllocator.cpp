@@ -0,0 +1,126 @@
+#include "stdafx.h"
+#include "ResourceAllocator.h"
+#include "Logger.h"
+
+namespace DirectXHelper {
+
+	ResourceAllocation::~ResourceAllocation() {
+		allocator_->allocator_.Deallocate(allocation_);
+	}
+
+	bool ResourceAllocator::Initalize(ID3D12Device5* device, uint64_t heapSize) {
+		assert(device);
+
+		backingStore_.device = device;
+		if (!allocator_.Initalize(&backingStore_, heapSize)) {
+			Logger::Error("GPUMemoryAllocator::Initalize()");
+			assert(false);
+			return false;
+		}
+		return true;
+	}
+
+	void ResourceAllocator::Finalize() {
+		allocator_.Finalize();
+		backingStore_.device.Reset();
+	}
+
+	std::shared_ptr<ResourceAllocation> ResourceAllocator::CreatePlacedResource(
+		D3D12_HEAP_TYPE heapType,
+		const D3D12_RESOURCE_DESC& desc,
+		D3D12_RESOURCE_STATES initState,
+		const D3D12_CLEAR_VALUE* clearValue,
+		Microsoft::WRL::ComPtr<ID3D12Resource>& resource) {
+		assert(backingStore_.device);
+
+		// 大きさとアライメントはドライバに問い合わせる
+		D3D12_RESOURCE_ALLOCATION_INFO info = backingStore_.device->GetResourceAllocationInfo(0, 1, &desc);
+		if (info.SizeInBytes == UINT64_MAX) {
+			Logger::Error("ID3D12Device::GetResourceAllocationInfo()");
+			assert(false);
+			return nullptr;
+		}
+		Engine::MemoryCategory category = GetCategory(heapType, desc);
+		Engine::GPUMemoryAllocator::Allocation allocation = allocator_.Allocate(category, info.SizeInBytes, info.Alignment);
+		if (!allocation.IsEnabled()) {
+			// 予算を超えた場合もここに来る
+			Logger::Warning("GPUMemoryAllocator::Allocate()");
+			return nullptr;
+		}
+		auto placed = std::make_shared<ResourceAllocation>(this, allocation);
+		if (FAILED(backingStore_.device->CreatePlacedResource(
+			placed->GetHeap(),
+			placed->GetOffset(),
+			&desc,
+			initState,
+			clearValue,
+			IID_PPV_ARGS(resource.ReleaseAndGetAddressOf())))) {
+			Logger::Error("CreatePlacedResource()");
+			assert(false);
+			return nullptr;
+		}
+		return placed;
+	}
+
+	Engine::MemoryCategory ResourceAllocator::GetCategory(D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC& desc) {
+		if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+			switch (heapType) {
+			case D3D12_HEAP_TYPE_UPLOAD:
+				return Engine::MemoryCategory::UploadBuffer;
+			case D3D12_HEAP_TYPE_READBACK:
+				return Engine::MemoryCategory::ReadbackBuffer;
+			default:
+				return Engine::MemoryCategory::Buffer;
+			}
+		}
+		if (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) {
+			return Engine::MemoryCategory::RenderTarget;
+		}
+		return Engine::MemoryCategory::Texture;
+	}
+
+	void* ResourceAllocator::D3D12HeapBackingStore::CreateHeap(Engine::MemoryCategory category, uint64_t size) {
+		D3D12_HEAP_DESC desc{};
+		desc.SizeInBytes = size;
+		desc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+		desc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+		switch (category) {
+		case Engine::MemoryCategory::Buffer:
+			desc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+			break;
+		case Engine::MemoryCategory::UploadBuffer:
+			desc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+			desc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+			break;
+		case Engine::MemoryCategory::ReadbackBuffer:
+			desc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK);
+			desc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+			break;
+		case Engine::MemoryCategory::Texture:
+			desc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+			break;
+		case Engine::MemoryCategory::RenderTarget:
+			// MSAAのレンダーターゲットは4MBアライメントが必要
+			desc.Alignment = D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT;
+			desc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+			break;
+		default:
+			assert(false);
+			return nullptr;
+		}
+
+		ID3D12Heap* heap = nullptr;
+		if (FAILED(device->CreateHeap(&desc, IID_PPV_ARGS(&heap)))) {
+			Logger::Error("ID3D12Device::CreateHeap()");
+			assert(false);
+			return nullptr;
+		}
+		return heap;
+	}
+
+	void ResourceAllocator::D3D12HeapBackingStore::DestroyHeap(Engine::MemoryCategory, void* heap) {
+		// 配置したリソースもヒープを参照しているので、残っていてもリソースが破棄されるまでは消えない
+		static_cast<ID3D12Heap*>(heap)->Release();
+	}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "GPUMemoryAllocator.h"
+
+namespace DirectXHelper {
+
+	class ResourceAllocator;
+
+	// 配置したリソースのメモリ
+	// 最後の参照が無くなったら領域をResourceAllocatorに戻す（リソースより先に破棄しないこと）
+	// GPUResourceはDirectXHelper::DeferredReleaseで参照を預けるので、領域はGPUが使い終えてから戻る
+	class ResourceAllocation {
+	public:
+		ResourceAllocation(ResourceAllocator* allocator, const Engine::GPUMemoryAllocator::Allocation& allocation) :
+			allocator_(allocator), allocation_(allocation) {}
+		~ResourceAllocation();
+		ResourceAllocation(const ResourceAllocation&) = delete;
+		ResourceAllocation& operator=(const ResourceAllocation&) = delete;
+
+		ID3D12Heap* GetHeap() const { return static_cast<ID3D12Heap*>(allocation_.heap); }
+		uint64_t GetOffset() const { return allocation_.offset; }
+		uint64_t GetSize() const { return allocation_.size; }
+
+	private:
+		ResourceAllocator* allocator_;
+		Engine::GPUMemoryAllocator::Allocation allocation_;
+	};
+
+	// 大きなID3D12Heapの中にリソースを配置する（CreateCommittedResourceでリソースごとにヒープを作らない）
+	// 切り出しはEngine::GPUMemoryAllocatorが行い、このクラスはヒープとリソースを作るだけ
+	class ResourceAllocator {
+	public:
+		ResourceAllocator() = default;
+		DELETE_COPY_MOVE(ResourceAllocator);
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="device"></param>
+		/// <param name="heapSize">ヒープ一つの大きさ（64KBの倍数）</param>
+		/// <returns></returns>
+		bool Initalize(ID3D12Device5* device, uint64_t heapSize = Engine::GPUMemoryAllocator::kDefaultHeapSize);
+		void Finalize();
+
+		/// <summary>
+		/// リソースを配置する
+		/// </summary>
+		/// <param name="heapType">DEFAULT、UPLOAD、READBACK</param>
+		/// <param name="desc"></param>
+		/// <param name="initState"></param>
+		/// <param name="clearValue">レンダーターゲットと深度バッファ以外はnullptr</param>
+		/// <param name="resource">作ったリソース</param>
+		/// <returns>配置したメモリ、失敗した場合はnullptr</returns>
+		std::shared_ptr<ResourceAllocation> CreatePlacedResource(
+			D3D12_HEAP_TYPE heapType,
+			const D3D12_RESOURCE_DESC& desc,
+			D3D12_RESOURCE_STATES initState,
+			const D3D12_CLEAR_VALUE* clearValue,
+			Microsoft::WRL::ComPtr<ID3D12Resource>& resource);
+
+		/// <summary>
+		/// リソースを置くヒープの種類
+		/// </summary>
+		/// <param name="heapType"></param>
+		/// <param name="desc"></param>
+		/// <returns></returns>
+		static Engine::MemoryCategory GetCategory(D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC& desc);
+
+		void SetBudget(Engine::MemoryCategory category, uint64_t budget) { allocator_.SetBudget(category, budget); }
+		uint32_t ReleaseEmptyHeaps(uint32_t keepCount = 0) { return allocator_.ReleaseEmptyHeaps(keepCount); }
+		Engine::GPUMemoryAllocator::Statistics GetStatistics(Engine::MemoryCategory category) const { return allocator_.GetStatistics(category); }
+
+	private:
+		friend class ResourceAllocation;
+
+		// ID3D12Heapを作る
+		class D3D12HeapBackingStore :
+			public Engine::HeapBackingStore {
+		public:
+			void* CreateHeap(Engine::MemoryCategory category, uint64_t size) override;
+			void DestroyHeap(Engine::MemoryCategory category, void* heap) override;
+
+			Microsoft::WRL::ComPtr<ID3D12Device5> device;
+		};
+
+		D3D12HeapBackingStore backingStore_;
+		Engine::GPUMemoryAllocator allocator_;
+	};
+
+}
@@ -0,0 +1,205 @@
+#include "ResourceStateTracker.h"
+
+#include "Assert.h"
+
+namespace Engine {
+
+	ResourceState ResourceStateTracker::Transition(void* resource, ResourceState currentState, ResourceState after) {
+		++statistics_.requestedCount;
+		// 開始した分割バリアを終える
+		for (size_t i = 0; i < splitTransitions_.size(); ++i) {
+			if (splitTransitions_[i].resource != resource) { continue; }
+			SplitTransition split = splitTransitions_[i];
+			splitTransitions_[i] = splitTransitions_.back();
+			splitTransitions_.pop_back();
+			// 開始をまだ出していなければ、分けずに一つの遷移にする
+			Slot& slot = FindSlot(resource);
+			if (slot.transition != kInvalidIndex && entries_[slot.transition].barrier.flag == ResourceBarrier::Flag::BeginOnly) {
+				entries_[slot.transition].barrier.flag = ResourceBarrier::Flag::None;
+				pendingBarriers_.clear();
+			}
+			else {
+				ResourceBarrier barrier{};
+				barrier.type = ResourceBarrier::Type::Transition;
+				barrier.resource = resource;
+				barrier.before = split.before;
+				barrier.after = split.after;
+				barrier.flag = ResourceBarrier::Flag::EndOnly;
+				AddBarrier(barrier);
+			}
+			currentState = split.after;
+			break;
+		}
+		if (currentState == after) { return currentState; }
+		// 既に必要な読み取りの状態を含んでいる
+		if (IsReadOnlyState(currentState) && IsReadOnlyState(after) && ContainsState(currentState, after)) { return currentState; }
+
+		Slot& slot = FindSlot(resource);
+		if (slot.transition != kInvalidIndex) {
+			ResourceBarrier& pending = entries_[slot.transition].barrier;
+			ASSERT_MSG(pending.after == currentState, "Resource state does not match the tracked state");
+			ResourceState merged = IsReadOnlyState(pending.after) && IsReadOnlyState(after) ? pending.after | after : after;
+			if (merged == pending.before) {
+				// 元に戻るので出さない
+				RemoveBarrier(slot.transition);
+				slot.transition = kInvalidIndex;
+				// UAVに戻る場合、遷移が待つはずだった前後の書き込みの間はUAVバリアで待つ
+				// （遷移を積んだ時に取り消したUAVバリアもここで戻る）
+				if (merged == ResourceState::UnorderedAccess && slot.uav == kInvalidIndex) {
+					ResourceBarrier barrier{};
+					barrier.type = ResourceBarrier::Type::UAV;
+					barrier.resource = resource;
+					barrier.flag = ResourceBarrier::Flag::None;
+					slot.uav = AddBarrier(barrier);
+				}
+			}
+			else {
+				pending.after = merged;
+				pendingBarriers_.clear();
+			}
+			return merged;
+		}
+
+		ResourceBarrier barrier{};
+		barrier.type = ResourceBarrier::Type::Transition;
+		barrier.resource = resource;
+		barrier.before = currentState;
+		barrier.after = after;
+		barrier.flag = ResourceBarrier::Flag::None;
+		slot.transition = AddBarrier(barrier);
+		// 遷移が書き込みの完了を待つので、UAVバリアは要らない
+		if (slot.uav != kInvalidIndex) {
+			RemoveBarrier(slot.uav);
+			slot.uav = kInvalidIndex;
+		}
+		return after;
+	}
+
+	ResourceState ResourceStateTracker::BeginTransition(void* resource, ResourceState currentState, ResourceState after) {
+		for (const SplitTransition& split : splitTransitions_) {
+			if (split.resource == resource) {
+				ASSERT_MSG(false, "Split transition already begun for this resource");
+				return split.after;
+			}
+		}
+		// 出していない遷移があれば、分けずにまとめる
+		Slot& slot = FindSlot(resource);
+		if (currentState == after || slot.transition != kInvalidIndex) {
+			return Transition(resource, currentState, after);
+		}
+		++statistics_.requestedCount;
+		ResourceBarrier barrier{};
+		barrier.type = ResourceBarrier::Type::Transition;
+		barrier.resource = resource;
+		barrier.before = currentState;
+		barrier.after = after;
+		barrier.flag = ResourceBarrier::Flag::BeginOnly;
+		slot.transition = AddBarrier(barrier);
+		if (slot.uav != kInvalidIndex) {
+			RemoveBarrier(slot.uav);
+			slot.uav = kInvalidIndex;
+		}
+		splitTransitions_.push_back(SplitTransition{ resource, currentState, after });
+		return after;
+	}
+
+	void ResourceStateTracker::UAVBarrier(void* resource) {
+		++statistics_.requestedCount;
+		Slot& slot = FindSlot(resource);
+		// 同じUAVバリアか、書き込みの完了を待つ遷移が既にある
+		if (slot.uav != kInvalidIndex) { return; }
+		if (slot.transition != kInvalidIndex && entries_[slot.transition].barrier.flag == ResourceBarrier::Flag::None) { return; }
+		ResourceBarrier barrier{};
+		barrier.type = ResourceBarrier::Type::UAV;
+		barrier.resource = resource;
+		barrier.flag = ResourceBarrier::Flag::None;
+		slot.uav = AddBarrier(barrier);
+	}
+
+	const std::vector<ResourceBarrier>& ResourceStateTracker::GetPendingBarriers() {
+		if (pendingBarriers_.size() != pendingCount_) {
+			pendingBarriers_.clear();
+			for (const Entry& entry : entries_) {
+				if (!entry.removed) { pendingBarriers_.push_back(entry.barrier); }
+			}
+		}
+		return pendingBarriers_;
+	}
+
+	void ResourceStateTracker::ClearPendingBarriers() {
+		if (entries_.empty()) { return; }
+		if (pendingCount_ != 0) {
+			statistics_.emittedCount += pendingCount_;
+			++statistics_.flushCount;
+		}
+		entries_.clear();
+		pendingBarriers_.clear();
+		pendingCount_ = 0;
+		slotCount_ = 0;
+		// 索引は世代を変えるだけで空になる
+		if (++generation_ == 0) {
+			for (Slot& slot : slots_) { slot.generation = 0; }
+			generation_ = 1;
+		}
+	}
+
+	void ResourceStateTracker::Reset() {
+		ASSERT_MSG(splitTransitions_.empty(), "Split transition was not ended");
+		ClearPendingBarriers();
+		splitTransitions_.clear();
+	}
+
+	ResourceStateTracker::Slot& ResourceStateTracker::FindSlot(void* resource) {
+		if (slots_.empty()) { Grow(); }
+		size_t mask = slots_.size() - 1;
+		// アドレスの下位は揃っているので掛けて上位を使う
+		size_t index = static_cast<size_t>((reinterpret_cast<uintptr_t>(resource) * 0x9E3779B97F4A7C15ull) >> 40) & mask;
+		for (;;) {
+			Slot& slot = slots_[index];
+			if (slot.generation != generation_) { break; }
+			if (slot.resource == resource) { return slot; }
+			index = (index + 1) & mask;
+		}
+		// 使っている場所が半分を超えないようにする
+		if ((slotCount_ + 1) * 2 > slots_.size()) {
+			Grow();
+			return FindSlot(resource);
+		}
+		Slot& slot = slots_[index];
+		slot.resource = resource;
+		slot.generation = generation_;
+		slot.transition = kInvalidIndex;
+		slot.uav = kInvalidIndex;
+		++slotCount_;
+		return slot;
+	}
+
+	void ResourceStateTracker::Grow() {
+		size_t capacity = slots_.empty() ? 64 : slots_.size() * 2;
+		std::vector<Slot> oldSlots = std::move(slots_);
+		uint32_t oldGeneration = generation_;
+		slots_.assign(capacity, Slot{ nullptr, 0, kInvalidIndex, kInvalidIndex });
+		generation_ = 1;
+		slotCount_ = 0;
+		for (const Slot& oldSlot : oldSlots) {
+			if (oldSlot.generation != oldGeneration) { continue; }
+			Slot& slot = FindSlot(oldSlot.resource);
+			slot.transition = oldSlot.transition;
+			slot.uav = oldSlot.uav;
+		}
+	}
+
+	uint32_t ResourceStateTracker::AddBarrier(const ResourceBarrier& barrier) {
+		entries_.push_back(Entry{ barrier, false });
+		++pendingCount_;
+		pendingBarriers_.clear();
+		return static_cast<uint32_t>(entries_.size() - 1);
+	}
+
+	void ResourceStateTracker::RemoveBarrier(uint32_t index) {
+		entries_[index].removed = true;
+		--pendingCount_;
+		pendingBarriers_.clear();
+	}
+
+}
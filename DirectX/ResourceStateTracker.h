@@ -0,0 +1,162 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+	// リソースの状態（値はD3D12_RESOURCE_STATESと同じ）
+	enum class ResourceState : uint32_t {
+		Common = 0,
+		VertexAndConstantBuffer = 0x1,
+		IndexBuffer = 0x2,
+		RenderTarget = 0x4,
+		UnorderedAccess = 0x8,
+		DepthWrite = 0x10,
+		DepthRead = 0x20,
+		NonPixelShaderResource = 0x40,
+		PixelShaderResource = 0x80,
+		StreamOut = 0x100,
+		IndirectArgument = 0x200,
+		CopyDest = 0x400,
+		CopySource = 0x800,
+		ResolveDest = 0x1000,
+		ResolveSource = 0x2000,
+		AllShaderResource = NonPixelShaderResource | PixelShaderResource,
+		GenericRead = VertexAndConstantBuffer | IndexBuffer | NonPixelShaderResource | PixelShaderResource | IndirectArgument | CopySource,
+		Present = 0,
+	};
+
+	constexpr ResourceState operator|(ResourceState a, ResourceState b) {
+		return static_cast<ResourceState>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+	}
+	// 読み取り専用の状態だけか（読み取り同士はまとめて一つの状態にできる）
+	constexpr bool IsReadOnlyState(ResourceState state) {
+		constexpr uint32_t kReadOnlyStates = static_cast<uint32_t>(ResourceState::GenericRead) | static_cast<uint32_t>(ResourceState::DepthRead) | static_cast<uint32_t>(ResourceState::ResolveSource);
+		return state != ResourceState::Common && (static_cast<uint32_t>(state) & ~kReadOnlyStates) == 0;
+	}
+	// stateがsubsetをすべて含むか
+	constexpr bool ContainsState(ResourceState state, ResourceState subset) {
+		return (static_cast<uint32_t>(state) & static_cast<uint32_t>(subset)) == static_cast<uint32_t>(subset);
+	}
+
+	// D3D12_RESOURCE_BARRIERに変換する前のバリア
+	struct ResourceBarrier {
+		enum class Type : uint8_t {
+			Transition,
+			UAV,
+			// 同じメモリに置いた別のリソースに使い始める（resourceが使い始めるリソース）
+			Aliasing,
+		};
+		// 分割バリア（D3D12_RESOURCE_BARRIER_FLAGSと同じ値）
+		enum class Flag : uint8_t {
+			None = 0,
+			BeginOnly = 1,
+			EndOnly = 2,
+		};
+		// D3DではID3D12Resource*
+		void* resource;
+		ResourceState before;
+		ResourceState after;
+		Type type;
+		Flag flag;
+	};
+
+	// コマンドリスト一つ分のリソースの状態の変化を集めて、描画とディスパッチの直前にまとめて出す
+	// ・同じリソースへの続けた遷移はまとめる（A→B→CはA→C、A→B→Aは出さない、ただしUAV→B→UAVはUAVバリアにする）
+	// ・読み取り同士の遷移は一つの状態に合わせる（UAV→頂点とUAV→SRVはUAV→頂点|SRV）
+	// ・遷移がある場合は同じリソースのUAVバリアを出さない（遷移が書き込みの完了を待つ）
+	// ・BeginTransitionで分割バリアの開始を出し、同じ状態へのTransitionで終了を出す
+	// 状態はリソース全体（サブリソースごとには扱わない）
+	// リソースの現在の状態は呼び出し側が持ち（GPUResourceなど）、遷移のたびに渡す
+	class ResourceStateTracker {
+	public:
+		struct Statistics {
+			// 要求された遷移とUAVバリアの数
+			uint64_t requestedCount;
+			// 出したバリアの数
+			uint64_t emittedCount;
+			// Flushでバリアを出した回数（ResourceBarrierの呼び出し回数）
+			uint64_t flushCount;
+		};
+
+		/// <summary>
+		/// 状態を遷移する
+		/// </summary>
+		/// <param name="resource"></param>
+		/// <param name="currentState">呼び出し側が持つ現在の状態</param>
+		/// <param name="after"></param>
+		/// <returns>遷移後の状態（読み取り同士をまとめた場合はafterを含む状態、呼び出し側はこれを持つ）</returns>
+		ResourceState Transition(void* resource, ResourceState currentState, ResourceState after);
+		/// <summary>
+		/// 分割バリアの開始（同じ状態へのTransitionまでの間に他の処理を挟める）
+		/// </summary>
+		/// <param name="resource"></param>
+		/// <param name="currentState">呼び出し側が持つ現在の状態</param>
+		/// <param name="after"></param>
+		/// <returns>遷移後の状態（終了するまでリソースを使わないこと）</returns>
+		ResourceState BeginTransition(void* resource, ResourceState currentState, ResourceState after);
+		/// <summary>
+		/// UAVへの書き込みを待つ
+		/// </summary>
+		void UAVBarrier(void* resource);
+
+		/// <summary>
+		/// 出していないバリア（描画やディスパッチの直前に、一回でコマンドリストに積んでからClearを呼ぶ）
+		/// </summary>
+		const std::vector<ResourceBarrier>& GetPendingBarriers();
+		bool HasPendingBarriers() const { return pendingCount_ != 0; }
+		/// <summary>
+		/// 出していないバリアを出したことにする
+		/// </summary>
+		void ClearPendingBarriers();
+		/// <summary>
+		/// すべて捨てる（コマンドリストのリセット時）
+		/// </summary>
+		void Reset();
+
+		// 開始したまま終わっていない分割バリアの数
+		uint32_t GetSplitTransitionCount() const { return static_cast<uint32_t>(splitTransitions_.size()); }
+		const Statistics& GetStatistics() const { return statistics_; }
+
+	private:
+		static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+		struct SplitTransition {
+			void* resource;
+			ResourceState before;
+			ResourceState after;
+		};
+		struct Entry {
+			ResourceBarrier barrier;
+			bool removed;
+		};
+		// 出していないバリアの、リソースから位置への索引（開番地法、世代が違う場所は空き）
+		struct Slot {
+			void* resource;
+			uint32_t generation;
+			// 分割しない遷移とUAVバリアの位置
+			uint32_t transition;
+			uint32_t uav;
+		};
+
+		// 無ければ空の場所を作る（新しく作る場合は索引を作り直して、前に取った参照は使えなくなることがある）
+		Slot& FindSlot(void* resource);
+		void Grow();
+		uint32_t AddBarrier(const ResourceBarrier& barrier);
+		// 出さないことにする（位置は変えず、GetPendingBarriersで詰める）
+		void RemoveBarrier(uint32_t index);
+
+		// 出していないバリア（取り消したものも残す）
+		std::vector<Entry> entries_;
+		// GetPendingBarriersで返す、取り消したものを詰めた並び
+		std::vector<ResourceBarrier> pendingBarriers_;
+		uint32_t pendingCount_{ 0 };
+		std::vector<Slot> slots_;
+		// ClearPendingBarriersで増やして索引を空にする
+		uint32_t generation_{ 1 };
+		uint32_t slotCount_{ 0 };
+		std::vector<SplitTransition> splitTransitions_;
+		Statistics statistics_{};
+	};
+
+}
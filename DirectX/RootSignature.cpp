@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "RootSignature.h"
+#include "DirectXHelper.h"
 #include "Logger.h"
 
 namespace DirectXHepler {
@@ -97,11 +98,13 @@ namespace DirectXHepler {
 			return false;
 		}
 
+		// 前のものは使っているコマンドが終わってから解放する
+		DirectXHelper::DeferredRelease(rootSignature_);
 		if (FAILED(device->CreateRootSignature(
 			0,
 			blob->GetBufferPointer(),
 			blob->GetBufferSize(),
-			IID_PPV_ARGS(rootSignature_.ReleaseAndGetAddressOf())))) {
+			IID_PPV_ARGS(rootSignature_.GetAddressOf())))) {
 			Logger::Error("CreateRootSignature()");
 			assert(false);
 			return false;
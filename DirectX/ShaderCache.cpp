@@ -0,0 +1,232 @@
+#include "ShaderCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+
+#include "Assert.h"
+#include "StringFormat.h"
+
+namespace Engine {
+
+	namespace {
+		// ファイルの形式を変えたら上げる（キーにも入れるので古いファイルは使われなくなる）
+		constexpr uint32_t kVersion = 1;
+		constexpr uint32_t kMagic = 0x43535047; // "GPSC"
+
+		struct FileHeader {
+			uint32_t magic;
+			uint32_t version;
+			uint64_t key;
+			uint64_t size;
+		};
+
+		// FNV-1a
+		class Hasher {
+		public:
+			void Add(const void* data, size_t size) {
+				const uint8_t* bytes = static_cast<const uint8_t*>(data);
+				for (size_t i = 0; i < size; ++i) {
+					hash_ ^= bytes[i];
+					hash_ *= 1099511628211ull;
+				}
+			}
+			// 長さも入れて、続けて入れた文字列の区切りを区別する
+			void Add(std::string_view str) {
+				uint64_t length = str.size();
+				Add(&length, sizeof(length));
+				Add(str.data(), str.size());
+			}
+			uint64_t Get() const { return hash_; }
+
+		private:
+			uint64_t hash_{ 14695981039346656037ull };
+		};
+
+		bool ReadFile(const std::filesystem::path& path, std::string& content) {
+#ifdef _MSC_VER
+			FILE* file = nullptr;
+			if (_wfopen_s(&file, path.c_str(), L"rb") != 0) { file = nullptr; }
+#else
+			FILE* file = std::fopen(path.c_str(), "rb");
+#endif // _MSC_VER
+			if (!file) { return false; }
+			content.clear();
+			char buffer[4096];
+			size_t readSize = 0;
+			while ((readSize = std::fread(buffer, 1, sizeof(buffer), file)) != 0) {
+				content.append(buffer, readSize);
+			}
+			std::fclose(file);
+			return true;
+		}
+
+		// 行が #include "name" か #include <name> なら名前を返す
+		std::string_view ParseInclude(std::string_view line) {
+			auto skipSpace = [&] { while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) { line.remove_prefix(1); } };
+			skipSpace();
+			if (line.empty() || line.front() != '#') { return {}; }
+			line.remove_prefix(1);
+			skipSpace();
+			constexpr std::string_view kInclude = "include";
+			if (line.substr(0, kInclude.size()) != kInclude) { return {}; }
+			line.remove_prefix(kInclude.size());
+			skipSpace();
+			if (line.empty() || (line.front() != '"' && line.front() != '<')) { return {}; }
+			char close = line.front() == '"' ? '"' : '>';
+			line.remove_prefix(1);
+			size_t end = line.find(close);
+			if (end == std::string_view::npos) { return {}; }
+			return line.substr(0, end);
+		}
+
+		// ファイルと、たどれる#includeの内容を入れる
+		// 見つからない#include（HLSLでは読まれない側の分岐など）は名前だけを入れる
+		void HashFile(Hasher& hasher, const std::filesystem::path& path, const std::string& content, const ShaderCompileDesc& desc, std::unordered_set<std::string>& visited) {
+			hasher.Add(content);
+			std::string_view rest = content;
+			std::string includeContent;
+			while (!rest.empty()) {
+				size_t lineEnd = rest.find('\n');
+				std::string_view line = rest.substr(0, lineEnd);
+				rest.remove_prefix(lineEnd == std::string_view::npos ? rest.size() : lineEnd + 1);
+				std::string_view name = ParseInclude(line);
+				if (name.empty()) { continue; }
+				hasher.Add(name);
+
+				std::filesystem::path includePath = path.parent_path() / name;
+				bool found = ReadFile(includePath, includeContent);
+				for (size_t i = 0; !found && i < desc.includeDirectories.size(); ++i) {
+					includePath = std::filesystem::path(desc.includeDirectories[i]) / name;
+					found = ReadFile(includePath, includeContent);
+				}
+				if (!found) { continue; }
+				// 何度も読まれるヘッダーは最初の一度だけ入れる
+				std::error_code error;
+				std::string canonical = std::filesystem::weakly_canonical(includePath, error).generic_string();
+				if (!visited.insert(error ? includePath.generic_string() : canonical).second) { continue; }
+				std::string nested = std::move(includeContent);
+				HashFile(hasher, includePath, nested, desc, visited);
+			}
+		}
+	}
+
+	bool ShaderCache::Initalize(const std::filesystem::path& directory) {
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+		if (error) {
+			ASSERT_MSG(false, "Failed to create shader cache directory");
+			directory_.clear();
+			return false;
+		}
+		directory_ = directory;
+		return true;
+	}
+
+	bool ShaderCache::ComputeKey(const ShaderCompileDesc& desc, uint64_t& key) {
+		std::filesystem::path path(desc.fileName);
+		std::string content;
+		if (!ReadFile(path, content)) { return false; }
+		Hasher hasher;
+		hasher.Add(&kVersion, sizeof(kVersion));
+		hasher.Add(desc.fileName);
+		hasher.Add(desc.entryPoint);
+		hasher.Add(desc.profile);
+		for (const std::string& argument : desc.arguments) {
+			hasher.Add(argument);
+		}
+		std::unordered_set<std::string> visited;
+		HashFile(hasher, path, content, desc, visited);
+		key = hasher.Get();
+		return true;
+	}
+
+	ShaderBytecodePtr ShaderCache::Load(uint64_t key) {
+		if (!IsEnabled()) { return nullptr; }
+		MappedFile file;
+		if (!file.Open(GetPath(key).string().c_str())) {
+			++missCount_;
+			return nullptr;
+		}
+		FileHeader header{};
+		if (file.GetSize() >= sizeof(header)) {
+			std::memcpy(&header, file.GetData(), sizeof(header));
+		}
+		if (header.magic != kMagic || header.version != kVersion || header.key != key || header.size != file.GetSize() - sizeof(header)) {
+			++invalidCount_;
+			++missCount_;
+			return nullptr;
+		}
+		++hitCount_;
+		size_t size = static_cast<size_t>(header.size);
+		return std::make_shared<ShaderBytecode>(std::move(file), sizeof(header), size);
+	}
+
+	bool ShaderCache::Store(uint64_t key, const void* data, size_t size) {
+		if (!IsEnabled()) { return false; }
+		std::filesystem::path path = GetPath(key);
+		// 同じキーを別のスレッドやプロセスが同時に書いてもよいように、一時ファイルの名前を分ける
+		std::filesystem::path temporaryPath = path;
+		temporaryPath += String::FormatTemporary(".{}.{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()), temporaryCount_.fetch_add(1));
+
+#ifdef _MSC_VER
+		FILE* file = nullptr;
+		if (_wfopen_s(&file, temporaryPath.c_str(), L"wb") != 0) { file = nullptr; }
+#else
+		FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+#endif // _MSC_VER
+		if (!file) { return false; }
+		FileHeader header{ kMagic, kVersion, key, size };
+		bool succeeded =
+			std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+			(size == 0 || std::fwrite(data, 1, size, file) == size);
+		succeeded = std::fclose(file) == 0 && succeeded;
+
+		std::error_code error;
+		if (succeeded) {
+			// 置き換えは一度に行われるので、読む側は古いものか新しいものの全体を見る
+			std::filesystem::rename(temporaryPath, path, error);
+			// 読まれている最中で置き換えられない場合（Windows）は、先に書いたものを使う
+			succeeded = !error || std::filesystem::exists(path);
+		}
+		if (!succeeded || error) {
+			std::filesystem::remove(temporaryPath, error);
+		}
+		if (succeeded) { ++storeCount_; }
+		return succeeded;
+	}
+
+	ShaderBytecodePtr ShaderCache::GetOrCompile(const ShaderCompileDesc& desc, ShaderCompilerBackend& backend, std::string* errors) {
+		uint64_t key = 0;
+		bool hasKey = IsEnabled() && ComputeKey(desc, key);
+		if (hasKey) {
+			if (ShaderBytecodePtr bytecode = Load(key)) { return bytecode; }
+		}
+		std::vector<uint8_t> bytecode;
+		std::string compileErrors;
+		bool succeeded = backend.Compile(desc, bytecode, compileErrors);
+		if (errors) { *errors = std::move(compileErrors); }
+		if (!succeeded) { return nullptr; }
+		if (hasKey) {
+			Store(key, bytecode.data(), bytecode.size());
+		}
+		return std::make_shared<ShaderBytecode>(std::move(bytecode));
+	}
+
+	std::filesystem::path ShaderCache::GetPath(uint64_t key) const {
+		return directory_ / String::FormatTemporary("{:016x}.bin", key);
+	}
+
+	ShaderCache::Statistics ShaderCache::GetStatistics() const {
+		Statistics statistics{};
+		statistics.hitCount = hitCount_.load(std::memory_order_relaxed);
+		statistics.missCount = missCount_.load(std::memory_order_relaxed);
+		statistics.storeCount = storeCount_.load(std::memory_order_relaxed);
+		statistics.invalidCount = invalidCount_.load(std::memory_order_relaxed);
+		return statistics;
+	}
+
+}
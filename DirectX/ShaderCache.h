@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "ShaderCompilerBackend.h"
+
+namespace Engine {
+
+	// シェーダーのバイトコード（キャッシュから割り当てたファイル、またはコンパイルした結果）
+	class ShaderBytecode {
+	public:
+		explicit ShaderBytecode(std::vector<uint8_t> buffer) :
+			buffer_(std::move(buffer)) {}
+		ShaderBytecode(MappedFile file, size_t offset, size_t size) :
+			file_(std::move(file)), offset_(offset), size_(size) {}
+
+		const uint8_t* GetData() const { return file_.IsOpen() ? file_.GetData() + offset_ : buffer_.data(); }
+		size_t GetSize() const { return file_.IsOpen() ? size_ : buffer_.size(); }
+		// キャッシュから読んだ
+		bool IsMapped() const { return file_.IsOpen(); }
+
+	private:
+		std::vector<uint8_t> buffer_;
+		MappedFile file_;
+		size_t offset_{ 0 };
+		size_t size_{ 0 };
+	};
+	using ShaderBytecodePtr = std::shared_ptr<const ShaderBytecode>;
+
+	// コンパイルしたシェーダーをディスクに残して、次の起動で使う
+	// キーはソースと#includeで読むファイル（たどれたもの）の内容、エントリ、プロファイル、引数のハッシュで、
+	// どれかが変われば別のキーになるので古いものを消す必要はない
+	// ・キーごとに一つのファイルに書き、読むときはメモリに割り当てる（コピーしない）
+	// ・一時ファイルに書いてから名前を変えるので、途中で止まっても壊れたファイルは残らない
+	// 複数のスレッドから呼べる
+	class ShaderCache {
+	public:
+		struct Statistics {
+			uint64_t hitCount;
+			uint64_t missCount;
+			uint64_t storeCount;
+			// 読めたが中身が合わなかったファイル
+			uint64_t invalidCount;
+		};
+
+		/// <summary>
+		/// 初期化（ディレクトリが無ければ作る、初期化しなければキャッシュを使わずにコンパイルする）
+		/// </summary>
+		/// <param name="directory"></param>
+		/// <returns></returns>
+		bool Initalize(const std::filesystem::path& directory);
+
+		/// <summary>
+		/// キーを求める（ソースと#includeを読む）
+		/// </summary>
+		/// <param name="desc"></param>
+		/// <param name="key"></param>
+		/// <returns>ソースを読めなければfalse</returns>
+		static bool ComputeKey(const ShaderCompileDesc& desc, uint64_t& key);
+		/// <summary>
+		/// キャッシュから読む
+		/// </summary>
+		/// <returns>無ければnullptr</returns>
+		ShaderBytecodePtr Load(uint64_t key);
+		/// <summary>
+		/// キャッシュに書く
+		/// </summary>
+		bool Store(uint64_t key, const void* data, size_t size);
+		/// <summary>
+		/// キャッシュにあれば読み、無ければコンパイルして書く
+		/// </summary>
+		/// <param name="desc"></param>
+		/// <param name="backend">無かった場合に使うコンパイラ</param>
+		/// <param name="errors">コンパイラのエラー（nullptrなら捨てる）</param>
+		/// <returns>コンパイルできなければnullptr</returns>
+		ShaderBytecodePtr GetOrCompile(const ShaderCompileDesc& desc, ShaderCompilerBackend& backend, std::string* errors = nullptr);
+
+		bool IsEnabled() const { return !directory_.empty(); }
+		std::filesystem::path GetPath(uint64_t key) const;
+		Statistics GetStatistics() const;
+
+	private:
+		std::filesystem::path directory_;
+		// 一時ファイルの名前を分ける
+		std::atomic<uint64_t> temporaryCount_{ 0 };
+		std::atomic<uint64_t> hitCount_{ 0 };
+		std::atomic<uint64_t> missCount_{ 0 };
+		std::atomic<uint64_t> storeCount_{ 0 };
+		std::atomic<uint64_t> invalidCount_{ 0 };
+	};
+
+}
@@ -0,0 +1,164 @@
+#include "ShaderCompileOptions.h"
+
+#include <charconv>
+
+#include "Assert.h"
+
+namespace Engine {
+
+	ShaderCompileOptions ShaderCompileOptions::GetDebug() {
+		ShaderCompileOptions options;
+		options.optimizationLevel = ShaderOptimizationLevel::Disabled;
+		options.debugInfo = ShaderDebugInfo::Embedded;
+		return options;
+	}
+
+	ShaderCompileOptions ShaderCompileOptions::GetRelease() {
+		ShaderCompileOptions options;
+		options.optimizationLevel = ShaderOptimizationLevel::Level3;
+		options.debugInfo = ShaderDebugInfo::Stripped;
+		options.pdbDirectory = "ShaderPDB";
+		return options;
+	}
+
+	ShaderCompileOptions ShaderCompileOptions::GetDefault() {
+#ifdef _DEBUG
+		return GetDebug();
+#else
+		return GetRelease();
+#endif // _DEBUG
+	}
+
+	void ShaderCompileOptions::AppendArguments(std::vector<std::string>& arguments) const {
+		switch (debugInfo) {
+		case ShaderDebugInfo::Embedded:
+			arguments.insert(arguments.end(), { "-Zi", "-Qembed_debug" });
+			break;
+		case ShaderDebugInfo::Stripped:
+			arguments.insert(arguments.end(), { "-Zi", "-Qstrip_debug" });
+			// ディレクトリで終わると、PDBの名前はシェーダーのハッシュになる
+			if (!pdbDirectory.empty()) {
+				arguments.insert(arguments.end(), { "-Fd", pdbDirectory + "/" });
+			}
+			break;
+		default:
+			break;
+		}
+		static const char* const kOptimizationArguments[] = { "-Od", "-O0", "-O1", "-O2", "-O3" };
+		arguments.push_back(kOptimizationArguments[static_cast<uint32_t>(optimizationLevel)]);
+		if (rowMajor) { arguments.push_back("-Zpr"); }
+		if (warningsAsErrors) { arguments.push_back("-WX"); }
+	}
+
+	bool ShaderPermutationSpace::AddDimension(std::string define, std::vector<std::string> values) {
+		if (define.empty() || values.empty()) {
+			ASSERT_MSG(false, "Permutation dimension needs a define and at least one value");
+			return false;
+		}
+		uint64_t permutationCount = static_cast<uint64_t>(permutationCount_) * values.size();
+		if (permutationCount >= kInvalidKey) {
+			ASSERT_MSG(false, "Too many permutations");
+			return false;
+		}
+		dimensions_.push_back(Dimension{ std::move(define), std::move(values), permutationCount_ });
+		permutationCount_ = static_cast<uint32_t>(permutationCount);
+		return true;
+	}
+
+	ShaderPermutationSpace::Key ShaderPermutationSpace::MakeKey(std::initializer_list<uint32_t> valueIndices) const {
+		if (valueIndices.size() > dimensions_.size()) { return kInvalidKey; }
+		Key key = 0;
+		uint32_t dimension = 0;
+		for (uint32_t valueIndex : valueIndices) {
+			if (valueIndex >= GetValueCount(dimension)) { return kInvalidKey; }
+			key += valueIndex * dimensions_[dimension].stride;
+			++dimension;
+		}
+		return key;
+	}
+
+	ShaderPermutationSpace::Key ShaderPermutationSpace::SetValue(Key key, std::string_view define, std::string_view value) const {
+		if (key >= permutationCount_) { return kInvalidKey; }
+		uint32_t dimension = FindDimension(define);
+		if (dimension == kInvalidDimension) { return kInvalidKey; }
+		const Dimension& d = dimensions_[dimension];
+		for (uint32_t valueIndex = 0; valueIndex < d.values.size(); ++valueIndex) {
+			if (d.values[valueIndex] != value) { continue; }
+			return key - GetValueIndex(key, dimension) * d.stride + valueIndex * d.stride;
+		}
+		return kInvalidKey;
+	}
+
+	uint32_t ShaderPermutationSpace::FindDimension(std::string_view define) const {
+		for (uint32_t dimension = 0; dimension < GetDimensionCount(); ++dimension) {
+			if (dimensions_[dimension].define == define) { return dimension; }
+		}
+		return kInvalidDimension;
+	}
+
+	void ShaderPermutationSpace::AppendDefines(Key key, std::vector<std::string>& arguments) const {
+		ASSERT_MSG(key < permutationCount_, "Permutation key out of range");
+		for (uint32_t dimension = 0; dimension < GetDimensionCount(); ++dimension) {
+			arguments.push_back("-D");
+			arguments.push_back(dimensions_[dimension].define + "=" + GetValue(key, dimension));
+		}
+	}
+
+	std::string ShaderPermutationSpace::ToString(Key key) const {
+		std::string result;
+		for (uint32_t dimension = 0; dimension < GetDimensionCount(); ++dimension) {
+			if (dimension != 0) { result += ','; }
+			result += dimensions_[dimension].define;
+			result += '=';
+			result += GetValue(key, dimension);
+		}
+		return result;
+	}
+
+	ShaderCompileDesc MakeShaderCompileDesc(const ShaderCompileDesc& base, const ShaderCompileOptions& options, const ShaderPermutationSpace& space, ShaderPermutationSpace::Key key) {
+		ShaderCompileDesc desc = base;
+		options.AppendArguments(desc.arguments);
+		space.AppendDefines(key, desc.arguments);
+		return desc;
+	}
+
+	std::vector<ShaderCompileFuture> SubmitAllPermutations(ShaderCompileQueue& queue, const ShaderCompileDesc& base, const ShaderCompileOptions& options, const ShaderPermutationSpace& space) {
+		std::vector<ShaderCompileFuture> futures;
+		futures.reserve(space.GetPermutationCount());
+		for (ShaderPermutationSpace::Key key = 0; key < space.GetPermutationCount(); ++key) {
+			futures.push_back(queue.Submit(MakeShaderCompileDesc(base, options, space, key)));
+		}
+		return futures;
+	}
+
+	ShaderPermutationSpace MakeParticleUpdatePermutationSpace() {
+		ShaderPermutationSpace space;
+		space.AddDimension("THREAD_GROUP_SIZE", { "16", "64", "128", "256" });
+		space.AddDimension("INTEGRATOR", { "0", "1" });
+		space.AddDimension("PACKED_LAYOUT", { "0", "1" });
+		return space;
+	}
+
+	uint32_t GetParticleUpdateThreadGroupSize(const ShaderPermutationSpace& space, ShaderPermutationSpace::Key key) {
+		// ParticleUpdate.CS.hlslの既定
+		static const uint32_t kDefaultThreadGroupSize = 16;
+		uint32_t dimension = space.FindDimension("THREAD_GROUP_SIZE");
+		if (dimension == ShaderPermutationSpace::kInvalidDimension) { return kDefaultThreadGroupSize; }
+		ASSERT_MSG(key < space.GetPermutationCount(), "Permutation key out of range");
+		const std::string& value = space.GetValue(key, dimension);
+		uint32_t threadGroupSize = 0;
+		auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), threadGroupSize);
+		if (error != std::errc() || end != value.data() + value.size() || threadGroupSize == 0) {
+			ASSERT_MSG(false, "THREAD_GROUP_SIZE is not a positive integer");
+			return kDefaultThreadGroupSize;
+		}
+		return threadGroupSize;
+	}
+
+	uint32_t GetParticleUpdateDispatchCount(const ShaderPermutationSpace& space, ShaderPermutationSpace::Key key, uint32_t particleCount) {
+		uint32_t threadGroupSize = GetParticleUpdateThreadGroupSize(space, key);
+		// 足してから割るとparticleCountが大きいときにあふれる
+		return particleCount / threadGroupSize + (particleCount % threadGroupSize != 0 ? 1 : 0);
+	}
+
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ShaderCompileQueue.h"
+#include "ShaderCompilerBackend.h"
+
+namespace Engine {
+
+	enum class ShaderOptimizationLevel : uint8_t {
+		// -Od
+		Disabled,
+		// -O0 から -O3
+		Level0,
+		Level1,
+		Level2,
+		Level3,
+	};
+
+	enum class ShaderDebugInfo : uint8_t {
+		None,
+		// バイトコードにPDBを埋め込む（-Zi -Qembed_debug）
+		Embedded,
+		// PDBを別のファイルに書き、バイトコードからは除く（-Zi -Qstrip_debug -Fd）
+		Stripped,
+	};
+
+	// ビルドの構成ごとのコンパイルの設定（引数に変換してShaderCompileDescに入れるので、キャッシュのキーにも入る）
+	struct ShaderCompileOptions {
+		ShaderOptimizationLevel optimizationLevel{ ShaderOptimizationLevel::Level3 };
+		ShaderDebugInfo debugInfo{ ShaderDebugInfo::None };
+		// Strippedの場合にPDBを書くディレクトリ
+		std::string pdbDirectory;
+		// 行列を行優先で詰める（-Zpr、CPU側のMatrix4x4と同じ）
+		bool rowMajor{ true };
+		// 警告をエラーにする（-WX）
+		bool warningsAsErrors{ false };
+
+		// 最適化なし、PDBを埋め込む
+		static ShaderCompileOptions GetDebug();
+		// 最適化あり、PDBは別のファイル
+		static ShaderCompileOptions GetRelease();
+		// ビルドの構成（_DEBUG）に合わせたもの
+		static ShaderCompileOptions GetDefault();
+
+		void AppendArguments(std::vector<std::string>& arguments) const;
+	};
+
+	// #defineで作るシェーダーの種類の組み合わせ
+	// 次元（定義の名前と取りうる値）を足していき、組み合わせを0からGetPermutationCount()-1の番号（キー）で表す
+	// キーは次元ごとの値の番号を並べたもので、すべての組み合わせを数えてオフラインでコンパイルできる
+	class ShaderPermutationSpace {
+	public:
+		using Key = uint32_t;
+		static constexpr Key kInvalidKey = UINT32_MAX;
+		static constexpr uint32_t kInvalidDimension = UINT32_MAX;
+
+		/// <summary>
+		/// 次元を足す
+		/// </summary>
+		/// <param name="define">定義の名前</param>
+		/// <param name="values">取りうる値（最初の値が既定、キー0はすべて既定）</param>
+		/// <returns>値が無い、または組み合わせが多すぎる場合はfalse</returns>
+		bool AddDimension(std::string define, std::vector<std::string> values);
+
+		uint32_t GetDimensionCount() const { return static_cast<uint32_t>(dimensions_.size()); }
+		uint32_t GetPermutationCount() const { return permutationCount_; }
+		const std::string& GetDefine(uint32_t dimension) const { return dimensions_[dimension].define; }
+		uint32_t GetValueCount(uint32_t dimension) const { return static_cast<uint32_t>(dimensions_[dimension].values.size()); }
+		/// <summary>
+		/// 定義の名前から次元を探す
+		/// </summary>
+		/// <returns>無ければkInvalidDimension</returns>
+		uint32_t FindDimension(std::string_view define) const;
+
+		/// <summary>
+		/// 次元ごとの値の番号からキーを作る（足りない次元は既定）
+		/// </summary>
+		/// <returns>番号が範囲外ならkInvalidKey</returns>
+		Key MakeKey(std::initializer_list<uint32_t> valueIndices) const;
+		/// <summary>
+		/// 一つの次元の値を変えたキー
+		/// </summary>
+		/// <returns>定義か値が無ければkInvalidKey</returns>
+		Key SetValue(Key key, std::string_view define, std::string_view value) const;
+		uint32_t GetValueIndex(Key key, uint32_t dimension) const { return key / dimensions_[dimension].stride % GetValueCount(dimension); }
+		const std::string& GetValue(Key key, uint32_t dimension) const { return dimensions_[dimension].values[GetValueIndex(key, dimension)]; }
+
+		/// <summary>
+		/// -D NAME=VALUE を足す
+		/// </summary>
+		void AppendDefines(Key key, std::vector<std::string>& arguments) const;
+		/// <summary>
+		/// NAME=VALUE をカンマで並べる（ログ用）
+		/// </summary>
+		std::string ToString(Key key) const;
+
+	private:
+		struct Dimension {
+			std::string define;
+			std::vector<std::string> values;
+			// キーの中の桁の重み
+			uint32_t stride;
+		};
+
+		std::vector<Dimension> dimensions_;
+		uint32_t permutationCount_{ 1 };
+	};
+
+	/// <summary>
+	/// オプションと組み合わせの引数を足したShaderCompileDescを作る（baseの引数は残す）
+	/// </summary>
+	ShaderCompileDesc MakeShaderCompileDesc(const ShaderCompileDesc& base, const ShaderCompileOptions& options, const ShaderPermutationSpace& space, ShaderPermutationSpace::Key key);
+	/// <summary>
+	/// すべての組み合わせを積む（キャッシュを前もって作る）
+	/// </summary>
+	/// <returns>キーの順</returns>
+	std::vector<ShaderCompileFuture> SubmitAllPermutations(ShaderCompileQueue& queue, const ShaderCompileDesc& base, const ShaderCompileOptions& options, const ShaderPermutationSpace& space);
+
+	/// <summary>
+	/// ParticleUpdate.CS.hlslの組み合わせ
+	/// THREAD_GROUP_SIZE（16、64、128、256）、INTEGRATOR（0: 半陰的オイラー、1: 速度ベルレ）、PACKED_LAYOUT（0、1: 速度と加速度を半精度で持つ）
+	/// </summary>
+	ShaderPermutationSpace MakeParticleUpdatePermutationSpace();
+	/// <summary>
+	/// キーのTHREAD_GROUP_SIZE（numthreadsのX、次元が無ければシェーダーの既定の16）
+	/// </summary>
+	uint32_t GetParticleUpdateThreadGroupSize(const ShaderPermutationSpace& space, ShaderPermutationSpace::Key key);
+	/// <summary>
+	/// particleCountをすべて更新するDispatchのスレッドグループの数（余りはシェーダーがparticleCountで弾く）
+	/// </summary>
+	uint32_t GetParticleUpdateDispatchCount(const ShaderPermutationSpace& space, ShaderPermutationSpace::Key key, uint32_t particleCount);
+
+}
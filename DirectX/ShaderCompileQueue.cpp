@@ -0,0 +1,154 @@
+#include "ShaderCompileQueue.h"
+
+#include <algorithm>
+
+#include "Assert.h"
+
+namespace Engine {
+
+	ShaderCompileQueue::~ShaderCompileQueue() {
+		Finalize();
+	}
+
+	bool ShaderCompileQueue::Initalize(BackendFactory factory, uint32_t workerCount, ShaderCache* cache) {
+		if (!factory) {
+			ASSERT_MSG(false, "Backend factory is empty");
+			return false;
+		}
+		Finalize();
+		factory_ = std::move(factory);
+		cache_ = cache;
+		if (workerCount == 0) {
+			workerCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+		stopRequested_ = false;
+		statistics_ = {};
+		threads_.reserve(workerCount);
+		for (uint32_t i = 0; i < workerCount; ++i) {
+			threads_.emplace_back(&ShaderCompileQueue::WorkerThread, this);
+		}
+		return true;
+	}
+
+	void ShaderCompileQueue::Finalize() {
+		if (threads_.empty()) { return; }
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopRequested_ = true;
+		}
+		jobCondition_.notify_all();
+		for (auto& thread : threads_) { thread.join(); }
+		threads_.clear();
+	}
+
+	ShaderCompileFuture ShaderCompileQueue::Submit(const ShaderCompileDesc& desc) {
+		ASSERT_MSG(!threads_.empty(), "Submit called before Initalize");
+		std::string identity = MakeIdentity(desc);
+		ShaderCompileFuture future;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			++statistics_.submitCount;
+			auto iterator = futures_.find(identity);
+			if (iterator != futures_.end()) {
+				++statistics_.deduplicatedCount;
+				return iterator->second;
+			}
+			Job& job = jobs_.emplace_back(Job{ desc, identity, {} });
+			future = job.promise.get_future().share();
+			futures_.emplace(std::move(identity), future);
+		}
+		jobCondition_.notify_one();
+		return future;
+	}
+
+	void ShaderCompileQueue::WaitForIdle() {
+		std::unique_lock<std::mutex> lock(mutex_);
+		idleCondition_.wait(lock, [&] { return jobs_.empty() && activeCount_ == 0; });
+	}
+
+	void ShaderCompileQueue::ClearCompleted() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (auto iterator = futures_.begin(); iterator != futures_.end();) {
+			if (iterator->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+				iterator = futures_.erase(iterator);
+			}
+			else {
+				++iterator;
+			}
+		}
+	}
+
+	bool ShaderCompileQueue::Forget(const std::string& identity) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto iterator = futures_.find(identity);
+		// 積み直してコンパイル中のものは残す
+		if (iterator == futures_.end() || iterator->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) { return false; }
+		futures_.erase(iterator);
+		return true;
+	}
+
+	uint32_t ShaderCompileQueue::GetPendingCount() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return static_cast<uint32_t>(jobs_.size()) + activeCount_;
+	}
+
+	ShaderCompileQueue::Statistics ShaderCompileQueue::GetStatistics() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return statistics_;
+	}
+
+	std::string ShaderCompileQueue::MakeIdentity(const ShaderCompileDesc& desc) {
+		// 文字列に含まれない0で区切る
+		std::string identity;
+		auto append = [&](const std::string& str) {
+			identity += str;
+			identity += '\0';
+		};
+		append(desc.fileName);
+		append(desc.entryPoint);
+		append(desc.profile);
+		for (const std::string& argument : desc.arguments) { append(argument); }
+		identity += '\0';
+		for (const std::string& includeDirectory : desc.includeDirectories) { append(includeDirectory); }
+		return identity;
+	}
+
+	void ShaderCompileQueue::WorkerThread() {
+		std::unique_ptr<ShaderCompilerBackend> backend = factory_();
+		std::unique_lock<std::mutex> lock(mutex_);
+		for (;;) {
+			// 止めるときも積んだものは終える（futureを待っているスレッドがいる）
+			jobCondition_.wait(lock, [&] { return !jobs_.empty() || stopRequested_; });
+			if (jobs_.empty()) { break; }
+			Job job = std::move(jobs_.front());
+			jobs_.pop_front();
+			++activeCount_;
+			lock.unlock();
+
+			ShaderCompileResult result;
+			result.fileName = job.desc.fileName;
+			result.identity = job.identity;
+			if (!backend) {
+				result.errors = "Failed to create shader compiler";
+			}
+			else if (cache_) {
+				result.bytecode = cache_->GetOrCompile(job.desc, *backend, &result.errors);
+			}
+			else {
+				std::vector<uint8_t> bytecode;
+				if (backend->Compile(job.desc, bytecode, result.errors)) {
+					result.bytecode = std::make_shared<ShaderBytecode>(std::move(bytecode));
+				}
+			}
+			bool succeeded = result.IsSucceeded();
+			job.promise.set_value(std::move(result));
+
+			lock.lock();
+			--activeCount_;
+			++statistics_.completedCount;
+			if (!succeeded) { ++statistics_.failedCount; }
+			if (jobs_.empty() && activeCount_ == 0) { idleCondition_.notify_all(); }
+		}
+	}
+
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ShaderCache.h"
+#include "ShaderCompilerBackend.h"
+
+namespace Engine {
+
+	struct ShaderCompileResult {
+		// コンパイルできなければnullptr
+		ShaderBytecodePtr bytecode;
+		std::string errors;
+		// 積んだときのファイル名（ログ用）
+		std::string fileName;
+		// 同じ内容かを比べる文字列（ShaderCompileQueue::Forgetに渡す）
+		std::string identity;
+
+		bool IsSucceeded() const { return bytecode != nullptr; }
+	};
+	using ShaderCompileFuture = std::shared_future<ShaderCompileResult>;
+
+	// シェーダーのコンパイルをワーカースレッドで並行して行う
+	// ・Submitはすぐに戻り、結果はfutureで受け取る
+	// ・同じ内容（ファイル、エントリ、プロファイル、引数）を積むと、前に積んだもののfutureを返す（コンパイルは一度）
+	// ・コンパイラはスレッドごとにファクトリで作る（DXCのインスタンスはスレッドをまたいで使えない）
+	// キャッシュを渡すと、ワーカーがキャッシュから読むか、コンパイルしてキャッシュに書く
+	class ShaderCompileQueue {
+	public:
+		// ワーカースレッドの中で呼ばれる
+		using BackendFactory = std::function<std::unique_ptr<ShaderCompilerBackend>()>;
+
+		struct Statistics {
+			uint64_t submitCount;
+			// 前に積んだものと同じだったので、積まなかった数
+			uint64_t deduplicatedCount;
+			uint64_t completedCount;
+			uint64_t failedCount;
+		};
+
+		ShaderCompileQueue() = default;
+		~ShaderCompileQueue();
+		ShaderCompileQueue(const ShaderCompileQueue&) = delete;
+		ShaderCompileQueue& operator=(const ShaderCompileQueue&) = delete;
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="factory">ワーカーごとのコンパイラを作る</param>
+		/// <param name="workerCount">ワーカースレッドの数（0ならハードウェアのスレッド数）</param>
+		/// <param name="cache">nullptrならキャッシュを使わない（このクラスより長く生きること）</param>
+		/// <returns></returns>
+		bool Initalize(BackendFactory factory, uint32_t workerCount = 0, ShaderCache* cache = nullptr);
+		/// <summary>
+		/// 積んだものを終えてから、ワーカースレッドを止める
+		/// </summary>
+		void Finalize();
+
+		/// <summary>
+		/// コンパイルを積む（複数のスレッドから呼べる）
+		/// </summary>
+		/// <param name="desc"></param>
+		/// <returns>結果（同じ内容を前に積んでいれば、そのfuture）</returns>
+		ShaderCompileFuture Submit(const ShaderCompileDesc& desc);
+		/// <summary>
+		/// 積んだものがすべて終わるまで待つ
+		/// </summary>
+		void WaitForIdle();
+		/// <summary>
+		/// 終わった結果を忘れる（ファイルを書き換えた後に同じ内容を積み直す場合、次のSubmitでコンパイルし直す）
+		/// </summary>
+		void ClearCompleted();
+		/// <summary>
+		/// 一つの結果だけを忘れる（失敗したものを積み直すとコンパイルし直す、他の結果は残す）
+		/// </summary>
+		/// <param name="identity">ShaderCompileResult::identity</param>
+		/// <returns>終わっていない、または無ければfalse</returns>
+		bool Forget(const std::string& identity);
+
+		uint32_t GetWorkerCount() const { return static_cast<uint32_t>(threads_.size()); }
+		uint32_t GetPendingCount() const;
+		Statistics GetStatistics() const;
+
+	private:
+		struct Job {
+			ShaderCompileDesc desc;
+			std::string identity;
+			std::promise<ShaderCompileResult> promise;
+		};
+
+		// 同じ内容かを比べる文字列
+		static std::string MakeIdentity(const ShaderCompileDesc& desc);
+		void WorkerThread();
+
+		BackendFactory factory_;
+		ShaderCache* cache_{ nullptr };
+		std::vector<std::thread> threads_;
+
+		mutable std::mutex mutex_;
+		std::condition_variable jobCondition_;
+		std::condition_variable idleCondition_;
+		std::deque<Job> jobs_;
+		// 積んだもの（終わったものも含む）
+		std::unordered_map<std::string, ShaderCompileFuture> futures_;
+		// 取り出してコンパイルしている数
+		uint32_t activeCount_{ 0 };
+		bool stopRequested_{ false };
+		Statistics statistics_{};
+	};
+
+}
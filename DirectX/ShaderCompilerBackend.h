@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+	// シェーダーをコンパイルするのに必要なもの（文字列はUTF-8）
+	struct ShaderCompileDesc {
+		std::string fileName;
+		std::string entryPoint;
+		std::string profile;
+		// ファイル名、エントリ、プロファイル以外の引数（-Od、-Zpr、-Dなど）
+		std::vector<std::string> arguments;
+		// #includeを探すディレクトリ（ファイルのあるディレクトリの次に探す）
+		std::vector<std::string> includeDirectories;
+	};
+
+	// シェーダーのコンパイラ（D3DではDXC、D3Dの無い環境ではSimulatedShaderCompiler）
+	// 一つのインスタンスは一つのスレッドから使う
+	class ShaderCompilerBackend {
+	public:
+		virtual ~ShaderCompilerBackend() = default;
+		/// <summary>
+		/// コンパイルする
+		/// </summary>
+		/// <param name="desc"></param>
+		/// <param name="bytecode">成功したらバイトコード</param>
+		/// <param name="errors">エラーと警告</param>
+		/// <returns>失敗したらfalse</returns>
+		virtual bool Compile(const ShaderCompileDesc& desc, std::vector<uint8_t>& bytecode, std::string& errors) = 0;
+	};
+
+}
@@ -0,0 +1,97 @@
+#include "SimulatedGPUQueue.h"
+
+namespace Engine {
+
+	SimulatedGPUQueue::SimulatedGPUQueue() {
+		thread_ = std::thread(&SimulatedGPUQueue::WorkerThread, this);
+	}
+
+	SimulatedGPUQueue::~SimulatedGPUQueue() {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopRequested_ = true;
+		}
+		submitCondition_.notify_one();
+		thread_.join();
+	}
+
+	void SimulatedGPUQueue::Submit(std::chrono::nanoseconds duration) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			commands_.push_back(Command{ duration, 0, nullptr, 0, nullptr });
+		}
+		submitCondition_.notify_one();
+	}
+
+	void SimulatedGPUQueue::Submit(std::function<void()> function) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			commands_.push_back(Command{ std::chrono::nanoseconds(0), 0, nullptr, 0, std::move(function) });
+		}
+		submitCondition_.notify_one();
+	}
+
+	uint64_t SimulatedGPUQueue::Signal() {
+		uint64_t fenceValue = 0;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			fenceValue = lastSignaledValue_.load(std::memory_order_relaxed) + 1;
+			lastSignaledValue_.store(fenceValue, std::memory_order_relaxed);
+			commands_.push_back(Command{ std::chrono::nanoseconds(0), fenceValue, nullptr, 0, nullptr });
+		}
+		submitCondition_.notify_one();
+		return fenceValue;
+	}
+
+	bool SimulatedGPUQueue::WaitForValue(uint64_t value) {
+		// 積んでいない値は永遠に来ない
+		if (value > lastSignaledValue_.load(std::memory_order_relaxed)) { return false; }
+		return fence_.Wait(value);
+	}
+
+	bool SimulatedGPUQueue::WaitOnQueue(GPUQueue& queue, uint64_t value) {
+		SimulatedGPUQueue* waitQueue = dynamic_cast<SimulatedGPUQueue*>(&queue);
+		if (!waitQueue) { return false; }
+		// 同じキューは積んだ順に実行するので待つ必要はない
+		if (waitQueue == this) { return true; }
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			commands_.push_back(Command{ std::chrono::nanoseconds(0), 0, waitQueue, value, nullptr });
+		}
+		submitCondition_.notify_one();
+		return true;
+	}
+
+	void SimulatedGPUQueue::WorkerThread() {
+		std::unique_lock<std::mutex> lock(mutex_);
+		for (;;) {
+			submitCondition_.wait(lock, [&] { return !commands_.empty() || stopRequested_; });
+			// 止めるときは残りを捨てる（待っているスレッドはいない前提）
+			if (stopRequested_) { break; }
+			Command command = std::move(commands_.front());
+			commands_.pop_front();
+			if (command.fenceValue != 0) {
+				fence_.Signal(command.fenceValue);
+				continue;
+			}
+			lock.unlock();
+			auto begin = std::chrono::steady_clock::now();
+			if (command.waitQueue) {
+				// 相手のシグナルは相手のスレッドが進めるので、止める要求も見ながら待つ
+				while (!command.waitQueue->fence_.Wait(command.waitValue, std::chrono::milliseconds(1)) && !stopRequested_.load()) {}
+				stallTime_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count(), std::memory_order_relaxed);
+				lock.lock();
+				continue;
+			}
+			if (command.function) {
+				command.function();
+				lock.lock();
+				continue;
+			}
+			std::this_thread::sleep_for(command.duration);
+			busyTime_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count(), std::memory_order_relaxed);
+			lock.lock();
+		}
+	}
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "GPUQueue.h"
+#include "TimelineFence.h"
+
+namespace Engine {
+
+	// 積んだ処理を専用のスレッドで順に「実行」する模擬GPU
+	// 処理の間はスレッドが眠るだけなのでCPUを使わず、D3D12がない環境でフレームの並行度や待ち時間を確かめられる
+	class SimulatedGPUQueue :
+		public GPUQueue {
+	public:
+		SimulatedGPUQueue();
+		~SimulatedGPUQueue();
+		SimulatedGPUQueue(const SimulatedGPUQueue&) = delete;
+		SimulatedGPUQueue& operator=(const SimulatedGPUQueue&) = delete;
+
+		/// <summary>
+		/// 処理を積む（GPUがdurationかけて実行する）
+		/// </summary>
+		void Submit(std::chrono::nanoseconds duration);
+		/// <summary>
+		/// 処理の代わりに関数を積む（積んだ順に、GPUのスレッドで呼ばれる）
+		/// </summary>
+		void Submit(std::function<void()> function);
+
+		uint64_t Signal() override;
+		uint64_t GetCompletedValue() override { return fence_.GetCompletedValue(); }
+		bool WaitForValue(uint64_t value) override;
+		uint64_t GetLastSignaledValue() const override { return lastSignaledValue_.load(std::memory_order_relaxed); }
+		bool WaitOnQueue(GPUQueue& queue, uint64_t value) override;
+		TimelineFence& GetTimelineFence() override { return fence_; }
+
+		// 処理を実行していた時間の合計
+		std::chrono::nanoseconds GetBusyTime() const { return std::chrono::nanoseconds(busyTime_.load(std::memory_order_relaxed)); }
+		// 他のキューを待って止まっていた時間の合計
+		std::chrono::nanoseconds GetStallTime() const { return std::chrono::nanoseconds(stallTime_.load(std::memory_order_relaxed)); }
+
+	private:
+		struct Command {
+			std::chrono::nanoseconds duration;
+			// 0でなければシグナル
+			uint64_t fenceValue;
+			// nullptrでなければ、このキューがwaitValueに届くまで待つ
+			SimulatedGPUQueue* waitQueue;
+			uint64_t waitValue;
+			std::function<void()> function;
+		};
+
+		void WorkerThread();
+
+		std::mutex mutex_;
+		std::condition_variable submitCondition_;
+		std::deque<Command> commands_;
+		// 他のキューを待っている間も見る
+		std::atomic<bool> stopRequested_{ false };
+
+		// GPUのスレッドが進める
+		SimulatedTimelineFence fence_;
+		std::atomic<uint64_t> lastSignaledValue_{ 0 };
+		std::atomic<int64_t> busyTime_{ 0 };
+		std::atomic<int64_t> stallTime_{ 0 };
+		std::thread thread_;
+	};
+
+}
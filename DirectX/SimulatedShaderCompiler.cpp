@@ -0,0 +1,57 @@
+#include "SimulatedShaderCompiler.h"
+
+#include <cstdio>
+#include <thread>
+
+namespace Engine {
+
+	std::atomic<uint64_t> SimulatedShaderCompiler::sTotalCompileCount_{ 0 };
+
+	namespace {
+		constexpr char kMagic[] = "SIMBC";
+
+		void Append(std::vector<uint8_t>& bytecode, const std::string& str) {
+			bytecode.insert(bytecode.end(), str.begin(), str.end());
+			bytecode.push_back(0);
+		}
+	}
+
+	bool SimulatedShaderCompiler::Compile(const ShaderCompileDesc& desc, std::vector<uint8_t>& bytecode, std::string& errors) {
+		++compileCount_;
+		sTotalCompileCount_.fetch_add(1, std::memory_order_relaxed);
+		bytecode.clear();
+		errors.clear();
+
+#ifdef _MSC_VER
+		FILE* file = nullptr;
+		if (fopen_s(&file, desc.fileName.c_str(), "rb") != 0) { file = nullptr; }
+#else
+		FILE* file = std::fopen(desc.fileName.c_str(), "rb");
+#endif // _MSC_VER
+		if (!file) {
+			errors = desc.fileName + ": cannot open file";
+			return false;
+		}
+		std::string source;
+		char buffer[4096];
+		size_t readSize = 0;
+		while ((readSize = std::fread(buffer, 1, sizeof(buffer), file)) != 0) {
+			source.append(buffer, readSize);
+		}
+		std::fclose(file);
+
+		if (compileTime_.count() > 0) {
+			std::this_thread::sleep_for(compileTime_);
+		}
+		// 引数とソースをそのまま並べる
+		bytecode.insert(bytecode.end(), kMagic, kMagic + sizeof(kMagic));
+		Append(bytecode, desc.entryPoint);
+		Append(bytecode, desc.profile);
+		for (const std::string& argument : desc.arguments) {
+			Append(bytecode, argument);
+		}
+		Append(bytecode, source);
+		return true;
+	}
+
+}
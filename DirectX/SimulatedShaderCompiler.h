@@ -0,0 +1,30 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+
+#include "ShaderCompilerBackend.h"
+
+namespace Engine {
+
+	// ファイルを読んで時間をかけるだけの模擬のコンパイラ（D3Dの無い環境でキャッシュやジョブを確かめる）
+	// バイトコードは引数とソースから決まるので、同じ入力なら同じ結果になる
+	class SimulatedShaderCompiler :
+		public ShaderCompilerBackend {
+	public:
+		explicit SimulatedShaderCompiler(std::chrono::nanoseconds compileTime = std::chrono::nanoseconds(0)) :
+			compileTime_(compileTime) {}
+
+		bool Compile(const ShaderCompileDesc& desc, std::vector<uint8_t>& bytecode, std::string& errors) override;
+
+		// Compileを呼んだ数（すべてのインスタンスの合計）
+		static uint64_t GetTotalCompileCount() { return sTotalCompileCount_.load(std::memory_order_relaxed); }
+		uint64_t GetCompileCount() const { return compileCount_; }
+
+	private:
+		static std::atomic<uint64_t> sTotalCompileCount_;
+
+		std::chrono::nanoseconds compileTime_;
+		uint64_t compileCount_{ 0 };
+	};
+
+}
@@ -1,6 +1,9 @@
 #include "Debug.h"
 
 namespace Debug {
+	void Log(const char* str) {
+		OutputDebugStringA(str);
+	}
 	void Log(const std::string& str) {
 		OutputDebugStringA(str.c_str());
 	}
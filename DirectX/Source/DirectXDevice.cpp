@@ -1,13 +1,14 @@
 #include "stdafx.h"
 #include "DirectXDevice.h"
 #include "Debug.h"
+#include "Profiler.h"
 
 using namespace DirectXHelper;
 
 void DirectXDevice::Initalize(HWND hwnd) {
 	assert(hwnd);
 	assert(!device_);
-	assert(!commandQueue_);
+	assert(!commandQueue_.Get());
 	hwnd_ = hwnd;
 	// ウィンドウ情報を取得
 	WINDOWINFO windowInfo{};
@@ -18,6 +19,7 @@ void DirectXDevice::Initalize(HWND hwnd) {
 	CreateDevice();
 	CreateCommands();
 	CreateDescriptorHeap();
+	CreateUploadBuffer();
 	CreateSwapChain();
 	CreateDepthStencilBuffer();
 	CreateImGui();
@@ -25,13 +27,30 @@ void DirectXDevice::Initalize(HWND hwnd) {
 
 void DirectXDevice::Finalize() {
 	WaitForGPU();
+	// 残っている後始末はすべて完了している
+	commandQueue_.GetTimelineFence().ProcessCompletionCallbacks();
+	computeQueue_.GetTimelineFence().ProcessCompletionCallbacks();
+	DirectXHelper::SetDeferredReleaseQueue(nullptr);
+	deferredReleaseQueue_.Flush();
+	commandListAllocator_.Finalize();
+	computeCommandListAllocator_.Finalize();
 	ImGui_ImplDX12_Shutdown();
 	ImGui_ImplWin32_Shutdown();
 	ImGui::DestroyContext();
-	CloseHandle(fenceEvent_);
 }
 
 void DirectXDevice::BeginFrame() {
+	// 前のフレームの記録を集めて統計を更新する（ここから次に呼ばれるまでを1フレームとする）
+	Engine::Profiler::GetInstance().EndFrame();
+	// GPUが通過したフレームの一時ディスクリプタ、アップロード領域、返したディスクリプタを戻す
+	uint64_t completedFenceValue = commandQueue_.GetCompletedValue();
+	transientDescriptorRing_.BeginFrame(completedFenceValue);
+	uploadBuffer_.BeginFrame(completedFenceValue);
+	commonHeap_.BeginFrame(completedFenceValue);
+	deferredReleaseQueue_.Process();
+	// GPUが通過した値に登録された後始末を呼ぶ
+	commandQueue_.GetTimelineFence().ProcessCompletionCallbacks();
+	computeQueue_.GetTimelineFence().ProcessCompletionCallbacks();
 	ImGui_ImplDX12_NewFrame();
 	ImGui_ImplWin32_NewFrame();
 	ImGui::NewFrame();
@@ -79,6 +98,7 @@ void DirectXDevice::StertScreenRendering() {
 }
 
 void DirectXDevice::FinishScreenRendering() {
+	PROFILE_SCOPE("FinishScreenRendering");
 	auto backBufferIndex = swapChain_->GetCurrentBackBufferIndex();
 
 	ImGui::Render();
@@ -92,27 +112,33 @@ void DirectXDevice::FinishScreenRendering() {
 		D3D12_RESOURCE_STATE_PRESENT);
 	commandList_->ResourceBarrier(1, &barrier);
 
-	WaitForGPU();
+	// GPUを待たずに積む（待つのは次のフレームのアロケータがまだ使われている場合だけ）
 	SubmitCommandList();
+	uint64_t fenceValue = frameScheduler_.EndFrame();
+	transientDescriptorRing_.EndFrame(fenceValue);
+	uploadBuffer_.EndFrame(fenceValue);
+	commonHeap_.EndFrame(fenceValue);
+	deferredReleaseQueue_.EndFrame(fenceValue);
 	GetSwapChain()->Present(1, 0);
 
-	auto nextBackBufferIndex = GetSwapChain()->GetCurrentBackBufferIndex();
-	ResetCommandList(nextBackBufferIndex);
+	uint32_t frameIndex = 0;
+	{
+		PROFILE_SCOPE("WaitForFrame");
+		frameIndex = frameScheduler_.BeginFrame();
+	}
+	ResetCommandList(frameIndex);
 }
 
 void DirectXDevice::SubmitCommandList() {
 	CHECK_HRESULT(commandList_->Close());
 	ID3D12CommandList* cmdList[] = { commandList_.Get() };
-	commandQueue_->ExecuteCommandLists(1, cmdList);
+	commandQueue_.ExecuteCommandLists(1, cmdList);
 }
 
 void DirectXDevice::WaitForGPU() {
-	++fenceValue_;
-	CHECK_HRESULT(commandQueue_->Signal(fence_.Get(), fenceValue_));
-	if (fence_->GetCompletedValue() < fenceValue_) {
-		CHECK_HRESULT(fence_->SetEventOnCompletion(fenceValue_, fenceEvent_));
-		WaitForSingleObject(fenceEvent_, INFINITE);
-	}
+	PROFILE_SCOPE("WaitForGPU");
+	frameScheduler_.WaitForIdle();
+	computeQueue_.WaitForIdle();
 }
 
 void DirectXDevice::ResetCommandList(uint32_t allocatorIndex) {
@@ -120,6 +146,24 @@ void DirectXDevice::ResetCommandList(uint32_t allocatorIndex) {
 	CHECK_HRESULT(commandList_->Reset(commandAllocator_[allocatorIndex].Get(), nullptr));
 }
 
+DirectXHelper::Descriptor DirectXDevice::AllocateTransientDescriptor(uint32_t count) {
+	uint32_t index = transientDescriptorRing_.Allocate(count);
+	if (index == Engine::TransientDescriptorRing::kInvalidIndex) {
+		assert(false);
+		return {};
+	}
+	return commonHeap_.GetDescriptor(index);
+}
+
+DirectXHelper::Descriptor DirectXDevice::AllocateTransientDescriptor(Engine::TransientDescriptorRing::ThreadBlock& threadBlock, uint32_t count) {
+	uint32_t index = threadBlock.Allocate(transientDescriptorRing_, count);
+	if (index == Engine::TransientDescriptorRing::kInvalidIndex) {
+		assert(false);
+		return {};
+	}
+	return commonHeap_.GetDescriptor(index);
+}
+
 void DirectXDevice::CreateDevice() {
 #ifdef _DEBUG	
 	// デバッグ時のみ
@@ -168,7 +212,7 @@ void DirectXDevice::CreateDevice() {
 		// 指定した機能レベルでデバイスが生成できたかを確認
 		if (SUCCEEDED(hr)) {
 			// 生成できたのでログ出力を行ってループを抜ける
-			Debug::Log(std::format("FeatureLevel : {}\n", featureLevelStrings[i]));
+			Debug::Log("FeatureLevel : {}\n", featureLevelStrings[i]);
 			break;
 		}
 	}
@@ -199,32 +243,53 @@ void DirectXDevice::CreateDevice() {
 		infoQueue->PushStorageFilter(&filter);
 	}
 #endif
+
+	resourceAllocator_.Initalize(device_.Get());
 }
 
 void DirectXDevice::CreateCommands() {
-	// コマンドキューを生成
-	D3D12_COMMAND_QUEUE_DESC commandQueueDesc{};
-	CHECK_HRESULT(device_->CreateCommandQueue(&commandQueueDesc, IID_PPV_ARGS(commandQueue_.GetAddressOf())));
+	// コマンドキューとフェンスを生成
+	commandQueue_.Initalize(device_.Get(), D3D12_COMMAND_LIST_TYPE_DIRECT);
 
 	// コマンドアロケータを生成
-	for (uint32_t i = 0; i < kSwapChainBufferCount; ++i) {
+	for (uint32_t i = 0; i < kFrameCount; ++i) {
 		CHECK_HRESULT(device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(commandAllocator_[i].GetAddressOf())));
 	}
 
 	// コマンドリストを生成
 	CHECK_HRESULT(device_->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator_[0].Get(), nullptr, IID_PPV_ARGS(commandList_.GetAddressOf())));
 
-	// フェンスを生成
-	CHECK_HRESULT(device_->CreateFence(fenceValue_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(fence_.GetAddressOf())));
+	// ワーカースレッドで記録するリストは使い回す
+	commandListAllocator_.Initalize(device_.Get(), &commandQueue_, D3D12_COMMAND_LIST_TYPE_DIRECT);
+
+	// パーティクルの更新はコンピュートキューで、次のフレームの分を描画と並行して行う
+	computeQueue_.Initalize(device_.Get(), D3D12_COMMAND_LIST_TYPE_COMPUTE);
+	computeCommandListAllocator_.Initalize(device_.Get(), &computeQueue_, D3D12_COMMAND_LIST_TYPE_COMPUTE);
 
-	fenceEvent_ = CreateEvent(NULL, FALSE, FALSE, NULL);
-	assert(fenceEvent_ != nullptr);
+	// 作り直したパイプラインやリソースは、どちらのキューで使っていてもよいように両方が通過してから解放する
+	deferredReleaseQueue_.Initalize({ &commandQueue_, &computeQueue_ }, kDeferredReleaseBudget);
+	DirectXHelper::SetDeferredReleaseQueue(&deferredReleaseQueue_);
+
+	// 最初のフレームはアロケータ0で記録を始める
+	frameScheduler_.Initalize(&commandQueue_, kFrameCount);
+	uint32_t frameIndex = frameScheduler_.BeginFrame();
+	assert(frameIndex == 0);
+	(void)frameIndex;
 }
 
 void DirectXDevice::CreateDescriptorHeap() {
 	rtvHeap_.Initalize(device_.Get(), kRTVDescriptorMaxCount, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, false, "RTV Descriptor Hrap");
 	dsvHeap_.Initalize(device_.Get(), kDSVDescriptorMaxCount, D3D12_DESCRIPTOR_HEAP_TYPE_DSV, false, "DSV Descriptor Hrap");
 	commonHeap_.Initalize(device_.Get(), kCommonDescriptorMaxCount, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, true, "Common Descriptor Hrap");
+
+	// 一時ディスクリプタ用の範囲は共通ヒープから連続で確保しておく
+	transientDescriptorRange_ = commonHeap_.Allocate(kTransientDescriptorCount);
+	transientDescriptorRing_.Initalize(commonHeap_.GetIndex(transientDescriptorRange_), kTransientDescriptorCount);
+}
+
+void DirectXDevice::CreateUploadBuffer() {
+	uploadBuffer_.Initalize(device_.Get(), kUploadBufferSize);
+	uploadBuffer_.Get()->SetName(L"UploadBuffer");
 }
 
 void DirectXDevice::CreateSwapChain() {
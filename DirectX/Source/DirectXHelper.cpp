@@ -2,6 +2,7 @@
 #include "StringUtils.h"
 #include "Debug.h"
 #include "VertexBuffer.h"
+#include "Logger.h"
 
 namespace DirectXHelper {
 
@@ -20,6 +21,16 @@ namespace DirectXHelper {
 		return buffer;
 	}
 
+	ComPtr<ID3D12Resource> CreateBuffer(ResourceAllocator& allocator, std::shared_ptr<ResourceAllocation>& allocation, uint64_t size, D3D12_RESOURCE_FLAGS flags, D3D12_RESOURCE_STATES initState, D3D12_HEAP_TYPE heapType) {
+		auto desc = CD3DX12_RESOURCE_DESC::Buffer(size, flags);
+
+		ComPtr<ID3D12Resource> buffer;
+		allocation = allocator.CreatePlacedResource(heapType, desc, initState, nullptr, buffer);
+		assert(allocation);
+
+		return buffer;
+	}
+
 	ComPtr<ID3D12Resource> CreateBufferUAV(ID3D12Device* device, uint64_t size, D3D12_RESOURCE_STATES initState) {
 		return CreateBuffer(device, size, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, initState, D3D12_HEAP_TYPE_DEFAULT);
 	}
@@ -39,6 +50,36 @@ namespace DirectXHelper {
 		return (value + alignment - 1) & ~(alignment - 1);
 	};
 
+	namespace {
+		Engine::DeferredReleaseQueue* deferredReleaseQueue = nullptr;
+
+		void ReleaseObject(void* object) {
+			static_cast<IUnknown*>(object)->Release();
+		}
+	}
+
+	void SetDeferredReleaseQueue(Engine::DeferredReleaseQueue* queue) {
+		deferredReleaseQueue = queue;
+	}
+
+	void DeferredRelease(IUnknown* object) {
+		if (!object) { return; }
+		if (!deferredReleaseQueue) {
+			object->Release();
+			return;
+		}
+		deferredReleaseQueue->Release(object, ReleaseObject);
+	}
+
+	void DeferredRelease(void* object, Engine::DeferredReleaseQueue::DestroyFunction destroy) {
+		if (!object) { return; }
+		if (!deferredReleaseQueue) {
+			destroy(object);
+			return;
+		}
+		deferredReleaseQueue->Release(object, destroy);
+	}
+
 #pragma region ディスクリプタヒープ
 	void DescriptorHeap::Initalize(ID3D12Device* device, uint32_t capacity, D3D12_DESCRIPTOR_HEAP_TYPE type, bool isShaderVisible, const std::string& name) {
 		assert(device);
@@ -57,43 +98,89 @@ namespace DirectXHelper {
 		};
 
 		CHECK_HRESULT(device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(heap_.ReleaseAndGetAddressOf())));
-		heap_->SetName(String::Convert(name).c_str());
+		heap_->SetName(String::ToWide(name).GetCString());
 
 		cpuStartHandle_ = heap_->GetCPUDescriptorHandleForHeapStart();
 		gpuStartHandle_ = isShaderVisible ? heap_->GetGPUDescriptorHandleForHeapStart() : D3D12_GPU_DESCRIPTOR_HANDLE{ 0 };
 		descriptorSize_ = device->GetDescriptorHandleIncrementSize(type);
 		capacity_ = capacity;
-		allocateIndex_ = 0;
+		allocator_.Initalize(capacity);
 		type_ = type;
 	}
 
-	Descriptor DescriptorHeap::Allocate() {
+	Descriptor DescriptorHeap::Allocate(uint32_t count) {
 		assert(heap_);
-		assert(allocateIndex_ < capacity_);
 
-		uint32_t offset = allocateIndex_ * descriptorSize_;
-		Descriptor result{};
-		result.cpu.ptr = cpuStartHandle_.ptr + offset;
-		if (IsShaderVisible()) {
-			result.gpu.ptr = gpuStartHandle_.ptr + offset;
+		uint32_t index = allocator_.Allocate(count);
+		if (index == Engine::DescriptorAllocator::kInvalidIndex) {
+			Logger::Error("DescriptorHeap::Allocate()");
+			assert(false);
+			return {};
 		}
+
+		Descriptor result = GetDescriptor(index);
 #ifdef _DEBUG
-		result.offset = offset;
+		result.offset = index * descriptorSize_;
 		result.container = this;
 #endif // _DEBUG
-		++allocateIndex_;
 		return result;
 	}
 
 	void DescriptorHeap::Deallocate(Descriptor& descriptorHandle) {
 		assert(descriptorHandle.IsEnabled());
-		assert(heap_ && allocateIndex_);
+		assert(heap_);
 		assert(descriptorHandle.container == this);
 		assert(descriptorHandle.cpu.ptr >= cpuStartHandle_.ptr);
 		assert((descriptorHandle.cpu.ptr - cpuStartHandle_.ptr) % descriptorSize_ == 0);
-		assert(descriptorHandle.offset < capacity_);
+		assert(descriptorHandle.offset / descriptorSize_ < capacity_);
 
+		uint32_t index = GetIndex(descriptorHandle);
 		descriptorHandle = {};
+		// 複数のフレームを並行して積むので、シェーダーから見えるヒープはGPUが通過するまで戻さない
+		// CPUだけのヒープ（RTV、DSVなど）はコマンドを積む時に読まれるので、すぐに戻してよい
+		if (IsShaderVisible()) {
+			frameRetiredIndices_.push_back(index);
+			return;
+		}
+		Free(index);
+	}
+
+	void DescriptorHeap::BeginFrame(uint64_t completedFenceValue) {
+		while (!retiredDescriptors_.empty() && retiredDescriptors_.front().fenceValue <= completedFenceValue) {
+			Free(retiredDescriptors_.front().index);
+			retiredDescriptors_.pop_front();
+		}
+	}
+
+	void DescriptorHeap::EndFrame(uint64_t fenceValue) {
+		for (uint32_t index : frameRetiredIndices_) {
+			retiredDescriptors_.push_back(RetiredDescriptor{ index, fenceValue });
+		}
+		frameRetiredIndices_.clear();
+	}
+
+	void DescriptorHeap::Free(uint32_t index) {
+		if (!allocator_.Deallocate(index)) {
+			Logger::Error("DescriptorHeap::Deallocate()");
+		}
+	}
+
+	Descriptor DescriptorHeap::GetDescriptor(uint32_t index) const {
+		assert(heap_);
+		assert(index < capacity_);
+
+		uint32_t offset = index * descriptorSize_;
+		Descriptor result{};
+		result.cpu.ptr = cpuStartHandle_.ptr + offset;
+		if (IsShaderVisible()) {
+			result.gpu.ptr = gpuStartHandle_.ptr + offset;
+		}
+		return result;
+	}
+
+	uint32_t DescriptorHeap::GetIndex(const Descriptor& descriptorHandle) const {
+		assert(descriptorHandle.cpu.ptr >= cpuStartHandle_.ptr);
+		return static_cast<uint32_t>((descriptorHandle.cpu.ptr - cpuStartHandle_.ptr) / descriptorSize_);
 	}
 #pragma endregion ディスクリプタヒープ
 
@@ -1,75 +1,201 @@
 #include "ShaderCompiler.h"
+
+#include <algorithm>
+#include <filesystem>
+
 #include "Debug.h"
+#include "StringUtils.h"
 
 template<class T>
 using ComPtr = DirectXHelper::ComPtr<T>;
 
-void ShaderCompiler::Initalize() {
-	ShaderCompiler::GetInstance()->InternalInitalize();
-}
-
-ComPtr<IDxcBlob> ShaderCompiler::Compile(const std::wstring& fileName, const std::wstring& entryPoint, const std::wstring& profile) {
-    return GetInstance()->InternalCompile(fileName, entryPoint, profile);
-}
-
-ShaderCompiler* ShaderCompiler::GetInstance() {
-    static ShaderCompiler instance;
-    return &instance;
-}
-
-void ShaderCompiler::InternalInitalize() {
+bool DxcShaderCompiler::Initalize() {
 	assert(!utils_);
 	assert(!compiler_);
 
-	CHECK_HRESULT(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&utils_)));
-	CHECK_HRESULT(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler_)));
-	CHECK_HRESULT(utils_->CreateDefaultIncludeHandler(&includeHandler_));
+	if (FAILED(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&utils_))) ||
+		FAILED(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler_))) ||
+		FAILED(utils_->CreateDefaultIncludeHandler(&includeHandler_))) {
+		assert(false);
+		return false;
+	}
+	return true;
 }
 
-ComPtr<IDxcBlob> ShaderCompiler::InternalCompile(const std::wstring& fileName, const std::wstring& entryPoint, const std::wstring& profile) {
+void DxcShaderCompiler::WritePDB(const Engine::ShaderCompileDesc& desc, IDxcResult* shaderResult) {
+	// -Fd はコマンドラインのdxcでしか書かれないので、PDBの出力を自分で書く
+	auto pdbDirectory = std::find(desc.arguments.begin(), desc.arguments.end(), "-Fd");
+	if (pdbDirectory == desc.arguments.end() || ++pdbDirectory == desc.arguments.end()) { return; }
+	ComPtr<IDxcBlob> pdb;
+	ComPtr<IDxcBlobUtf16> pdbName;
+	if (FAILED(shaderResult->GetOutput(DXC_OUT_PDB, IID_PPV_ARGS(&pdb), &pdbName)) || !pdb || !pdbName) { return; }
+
+	std::error_code error;
+	std::filesystem::path directory(*pdbDirectory);
+	std::filesystem::create_directories(directory, error);
+	std::filesystem::path path = directory / std::filesystem::path(pdbName->GetStringPointer()).filename();
+	FILE* file = nullptr;
+	if (_wfopen_s(&file, path.c_str(), L"wb") != 0 || !file) {
+		Debug::Log("Failed to write shader PDB\n");
+		return;
+	}
+	fwrite(pdb->GetBufferPointer(), 1, pdb->GetBufferSize(), file);
+	fclose(file);
+}
+
+bool DxcShaderCompiler::Compile(const Engine::ShaderCompileDesc& desc, std::vector<uint8_t>& bytecode, std::string& errors) {
 	assert(utils_);
 	assert(compiler_);
-	assert(!fileName.empty());
+	assert(!desc.fileName.empty());
 
-	Debug::Log(std::format(L"Begin CompileShader, path:{}, profile:{}\n", fileName, profile));
+	bytecode.clear();
+	errors.clear();
+
+	std::wstring fileName = String::Convert(desc.fileName);
+	std::wstring entryPoint = String::Convert(desc.entryPoint);
+	std::wstring profile = String::Convert(desc.profile);
 
 	ComPtr<IDxcBlobEncoding> shaderSource = nullptr;
-	CHECK_HRESULT(utils_->LoadFile(fileName.c_str(), nullptr, &shaderSource));
+	if (FAILED(utils_->LoadFile(fileName.c_str(), nullptr, &shaderSource))) {
+		errors = desc.fileName + ": cannot open file";
+		return false;
+	}
 
 	DxcBuffer shaderSourceBuffer{};
 	shaderSourceBuffer.Ptr = shaderSource->GetBufferPointer();
 	shaderSourceBuffer.Size = shaderSource->GetBufferSize();
 	shaderSourceBuffer.Encoding = DXC_CP_UTF8;
 
-	LPCWSTR arguments[] = {
+	// 引数の文字列はargumentsより長く持つ
+	std::vector<std::wstring> wideArguments;
+	wideArguments.reserve(desc.arguments.size() + desc.includeDirectories.size());
+	std::vector<LPCWSTR> arguments = {
 		fileName.c_str(),
 		L"-E", entryPoint.c_str(),
 		L"-T", profile.c_str(),
-		L"-Zi", L"-Qembed_debug",
-		L"-Od",
-		L"-Zpr"
 	};
+	for (const std::string& argument : desc.arguments) {
+		arguments.push_back(wideArguments.emplace_back(String::Convert(argument)).c_str());
+	}
+	for (const std::string& includeDirectory : desc.includeDirectories) {
+		arguments.push_back(L"-I");
+		arguments.push_back(wideArguments.emplace_back(String::Convert(includeDirectory)).c_str());
+	}
 
-	IDxcResult* shaderResult = nullptr;
-	CHECK_HRESULT(compiler_->Compile(
+	ComPtr<IDxcResult> shaderResult = nullptr;
+	if (FAILED(compiler_->Compile(
 		&shaderSourceBuffer,
-		arguments,
-		_countof(arguments),
+		arguments.data(),
+		static_cast<UINT32>(arguments.size()),
 		includeHandler_.Get(),
-		IID_PPV_ARGS(&shaderResult)));
+		IID_PPV_ARGS(&shaderResult)))) {
+		errors = desc.fileName + ": IDxcCompiler3::Compile() failed";
+		return false;
+	}
 
 	ComPtr<IDxcBlobUtf8> shaderError;
 	shaderResult->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&shaderError), nullptr);
-	if (shaderError&& shaderError->GetStringLength() != 0) {
-		Debug::Log(shaderError->GetStringPointer());
-		assert(false);
+	if (shaderError && shaderError->GetStringLength() != 0) {
+		errors.assign(shaderError->GetStringPointer(), shaderError->GetStringLength());
 	}
+	HRESULT status = S_OK;
+	shaderResult->GetStatus(&status);
+	if (FAILED(status)) { return false; }
 
 	ComPtr<IDxcBlob> shaderBlob = nullptr;
-	CHECK_HRESULT(shaderResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&shaderBlob), nullptr));
+	if (FAILED(shaderResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&shaderBlob), nullptr)) || !shaderBlob) {
+		return false;
+	}
+	const uint8_t* data = static_cast<const uint8_t*>(shaderBlob->GetBufferPointer());
+	bytecode.assign(data, data + shaderBlob->GetBufferSize());
+	WritePDB(desc, shaderResult.Get());
+	return true;
+}
 
-	Debug::Log(std::format(L"Compile Succeeded, path:{}, profile:{}\n", fileName, profile));
-	return shaderBlob;
+void ShaderCompiler::Initalize() {
+	ShaderCompiler::GetInstance()->InternalInitalize();
 }
 
+void ShaderCompiler::Finalize() {
+	ShaderCompiler* instance = GetInstance();
+	instance->queue_.Finalize();
+	// 覚えている結果がキャッシュのファイルを開いたままにするので忘れる
+	instance->queue_.ClearCompleted();
+}
 
+ComPtr<IDxcBlob> ShaderCompiler::Compile(const std::wstring& fileName, const std::wstring& entryPoint, const std::wstring& profile) {
+	return GetBlob(CompileAsync(fileName, entryPoint, profile));
+}
+
+Engine::ShaderCompileFuture ShaderCompiler::CompileAsync(const std::wstring& fileName, const std::wstring& entryPoint, const std::wstring& profile,
+	const Engine::ShaderPermutationSpace* permutationSpace, Engine::ShaderPermutationSpace::Key permutationKey) {
+	return GetInstance()->InternalCompileAsync(fileName, entryPoint, profile, permutationSpace, permutationKey);
+}
+
+void ShaderCompiler::SetOptions(const Engine::ShaderCompileOptions& options) {
+	GetInstance()->options_ = options;
+}
+
+ComPtr<IDxcBlob> ShaderCompiler::GetBlob(const Engine::ShaderCompileFuture& future) {
+	return GetInstance()->InternalGetBlob(future);
+}
+
+ShaderCompiler* ShaderCompiler::GetInstance() {
+    static ShaderCompiler instance;
+    return &instance;
+}
+
+void ShaderCompiler::InternalInitalize() {
+	assert(!utils_);
+
+	CHECK_HRESULT(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&utils_)));
+	// キャッシュが使えなくても毎回コンパイルするだけ
+	if (!cache_.Initalize(kCacheDirectory)) {
+		Debug::Log("Shader cache is disabled\n");
+	}
+	// DXCのインスタンスはワーカーごとに作る
+	queue_.Initalize([]() -> std::unique_ptr<Engine::ShaderCompilerBackend> {
+		auto compiler = std::make_unique<DxcShaderCompiler>();
+		if (!compiler->Initalize()) { return nullptr; }
+		return compiler;
+	}, 0, &cache_);
+}
+
+Engine::ShaderCompileFuture ShaderCompiler::InternalCompileAsync(const std::wstring& fileName, const std::wstring& entryPoint, const std::wstring& profile,
+	const Engine::ShaderPermutationSpace* permutationSpace, Engine::ShaderPermutationSpace::Key permutationKey) {
+	assert(utils_);
+	assert(!fileName.empty());
+
+	Debug::Log(std::format(L"Begin CompileShader, path:{}, profile:{}\n", fileName, profile));
+
+	Engine::ShaderCompileDesc desc;
+	desc.fileName = String::Convert(fileName);
+	desc.entryPoint = String::Convert(entryPoint);
+	desc.profile = String::Convert(profile);
+	options_.AppendArguments(desc.arguments);
+	if (permutationSpace) {
+		permutationSpace->AppendDefines(permutationKey, desc.arguments);
+	}
+	return queue_.Submit(desc);
+}
+
+ComPtr<IDxcBlob> ShaderCompiler::InternalGetBlob(const Engine::ShaderCompileFuture& future) {
+	const Engine::ShaderCompileResult& result = future.get();
+	if (!result.errors.empty()) {
+		Debug::Log(result.errors);
+	}
+	if (!result.IsSucceeded()) {
+		// 失敗した結果を覚えていると、ファイルを直して積み直しても同じ結果が返る
+		queue_.Forget(result.identity);
+		assert(false);
+		return nullptr;
+	}
+
+	// キャッシュから割り当てたファイルは閉じるので、Blobにコピーする
+	ComPtr<IDxcBlobEncoding> shaderBlob = nullptr;
+	CHECK_HRESULT(utils_->CreateBlob(result.bytecode->GetData(), static_cast<UINT32>(result.bytecode->GetSize()), DXC_CP_ACP, &shaderBlob));
+
+	// 成功した結果は同じものを積んだときに使うので残す（割り当てたファイルはFinalizeで閉じる）
+	Debug::Log("Compile Succeeded, path:{}, cached:{}\n", result.fileName, result.bytecode->IsMapped());
+	return shaderBlob;
+}
@@ -1,27 +1,382 @@
 #include "StringUtils.h"
 
-std::wstring String::Convert(const std::string& str) {
-	if (str.empty()) {
-		return std::wstring();
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#include "MathSIMD.h"
+
+namespace {
+
+	constexpr char32_t kReplacementCharacter = 0xFFFD;
+
+	// 先頭から続くASCIIをまとめてwchar_tなどに広げる
+	// 変換した文字数を返す
+	template<class WideChar>
+	size_t WidenAscii(const char* source, size_t size, WideChar* destination) {
+		size_t i = 0;
+#ifdef MATH_SIMD_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		for (; i + 16 <= size; i += 16) {
+			__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+			if (_mm_movemask_epi8(bytes) != 0) { break; }
+			__m128i low = _mm_unpacklo_epi8(bytes, zero);
+			__m128i high = _mm_unpackhi_epi8(bytes, zero);
+			__m128i* output = reinterpret_cast<__m128i*>(destination + i);
+			if constexpr (sizeof(WideChar) == 2) {
+				_mm_storeu_si128(output, low);
+				_mm_storeu_si128(output + 1, high);
+			}
+			else {
+				_mm_storeu_si128(output, _mm_unpacklo_epi16(low, zero));
+				_mm_storeu_si128(output + 1, _mm_unpackhi_epi16(low, zero));
+				_mm_storeu_si128(output + 2, _mm_unpacklo_epi16(high, zero));
+				_mm_storeu_si128(output + 3, _mm_unpackhi_epi16(high, zero));
+			}
+		}
+#endif // MATH_SIMD_SSE2
+		for (; i < size; ++i) {
+			unsigned char c = static_cast<unsigned char>(source[i]);
+			if (c >= 0x80) { break; }
+			destination[i] = static_cast<WideChar>(c);
+		}
+		return i;
+	}
+
+	// 先頭から続くASCIIをまとめてcharに詰める
+	template<class WideChar>
+	size_t NarrowAscii(const WideChar* source, size_t size, char* destination) {
+		size_t i = 0;
+#ifdef MATH_SIMD_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i* input = reinterpret_cast<const __m128i*>(source);
+		if constexpr (sizeof(WideChar) == 2) {
+			const __m128i nonAscii = _mm_set1_epi16(static_cast<short>(0xFF80));
+			for (; i + 16 <= size; i += 16, input += 2) {
+				__m128i low = _mm_loadu_si128(input);
+				__m128i high = _mm_loadu_si128(input + 1);
+				__m128i bits = _mm_and_si128(_mm_or_si128(low, high), nonAscii);
+				if (_mm_movemask_epi8(_mm_cmpeq_epi16(bits, zero)) != 0xFFFF) { break; }
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(low, high));
+			}
+		}
+		else {
+			const __m128i nonAscii = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+			for (; i + 16 <= size; i += 16, input += 4) {
+				__m128i a = _mm_loadu_si128(input);
+				__m128i b = _mm_loadu_si128(input + 1);
+				__m128i c = _mm_loadu_si128(input + 2);
+				__m128i d = _mm_loadu_si128(input + 3);
+				__m128i bits = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), nonAscii);
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(bits, zero)) != 0xFFFF) { break; }
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+			}
+		}
+#endif // MATH_SIMD_SSE2
+		for (; i < size; ++i) {
+			uint32_t c = static_cast<uint32_t>(source[i]);
+			if (c >= 0x80) { break; }
+			destination[i] = static_cast<char>(c);
+		}
+		return i;
+	}
+
+	// 先頭から続くASCIIの数
+	size_t CountAscii(const char* source, size_t size) {
+		size_t i = 0;
+#ifdef MATH_SIMD_SSE2
+		for (; i + 16 <= size; i += 16) {
+			int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i)));
+			if (mask != 0) { return i + static_cast<size_t>(std::countr_zero(static_cast<unsigned int>(mask))); }
+		}
+#endif // MATH_SIMD_SSE2
+		while (i < size && static_cast<unsigned char>(source[i]) < 0x80) { ++i; }
+		return i;
+	}
+
+	// UTF-8の1文字を読んでpositionを進める
+	// 不正な場合は正しく続いていた所までを1文字としてU+FFFDを返す
+	char32_t DecodeUtf8(const char* source, size_t size, size_t& position) {
+		unsigned char lead = static_cast<unsigned char>(source[position]);
+		if (lead < 0x80) {
+			++position;
+			return lead;
+		}
+		size_t length = 0;
+		char32_t codePoint = 0;
+		// 2バイト目の範囲（冗長な表現とサロゲートを除く）
+		unsigned char lower = 0x80, upper = 0xBF;
+		if (lead >= 0xC2 && lead <= 0xDF) {
+			length = 2;
+			codePoint = lead & 0x1F;
+		}
+		else if (lead >= 0xE0 && lead <= 0xEF) {
+			length = 3;
+			codePoint = lead & 0x0F;
+			if (lead == 0xE0) { lower = 0xA0; }
+			else if (lead == 0xED) { upper = 0x9F; }
+		}
+		else if (lead >= 0xF0 && lead <= 0xF4) {
+			length = 4;
+			codePoint = lead & 0x07;
+			if (lead == 0xF0) { lower = 0x90; }
+			else if (lead == 0xF4) { upper = 0x8F; }
+		}
+		else {
+			++position;
+			return kReplacementCharacter;
+		}
+		size_t i = 1;
+		for (; i < length && position + i < size; ++i) {
+			unsigned char c = static_cast<unsigned char>(source[position + i]);
+			if (c < lower || c > upper) { break; }
+			lower = 0x80;
+			upper = 0xBF;
+			codePoint = (codePoint << 6) | (c & 0x3F);
+		}
+		position += i;
+		return i == length ? codePoint : kReplacementCharacter;
+	}
+
+	// UTF-16（またはUTF-32）の1文字を読んでpositionを進める
+	template<class WideChar>
+	char32_t DecodeWide(const WideChar* source, size_t size, size_t& position) {
+		char32_t c = static_cast<char32_t>(source[position++]);
+		if constexpr (sizeof(WideChar) == 2) {
+			if (c >= 0xD800 && c <= 0xDBFF && position < size) {
+				char32_t low = static_cast<char32_t>(source[position]);
+				if (low >= 0xDC00 && low <= 0xDFFF) {
+					++position;
+					return 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+				}
+			}
+			if (c >= 0xD800 && c <= 0xDFFF) { return kReplacementCharacter; }
+			return c;
+		}
+		else {
+			if ((c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF) { return kReplacementCharacter; }
+			return c;
+		}
+	}
+
+	template<class WideChar>
+	constexpr size_t GetWideUnitCount(char32_t codePoint) {
+		return (sizeof(WideChar) == 2 && codePoint >= 0x10000) ? 2 : 1;
+	}
+
+	constexpr size_t GetUtf8UnitCount(char32_t codePoint) {
+		return codePoint < 0x80 ? 1 : codePoint < 0x800 ? 2 : codePoint < 0x10000 ? 3 : 4;
+	}
+
+	template<class WideChar>
+	WideChar* EncodeWide(char32_t codePoint, WideChar* destination) {
+		if (sizeof(WideChar) == 2 && codePoint >= 0x10000) {
+			codePoint -= 0x10000;
+			destination[0] = static_cast<WideChar>(0xD800 + (codePoint >> 10));
+			destination[1] = static_cast<WideChar>(0xDC00 + (codePoint & 0x3FF));
+			return destination + 2;
+		}
+		*destination = static_cast<WideChar>(codePoint);
+		return destination + 1;
+	}
+
+	char* EncodeUtf8(char32_t codePoint, char* destination) {
+		if (codePoint < 0x80) {
+			*destination++ = static_cast<char>(codePoint);
+		}
+		else if (codePoint < 0x800) {
+			*destination++ = static_cast<char>(0xC0 | (codePoint >> 6));
+			*destination++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+		else if (codePoint < 0x10000) {
+			*destination++ = static_cast<char>(0xE0 | (codePoint >> 12));
+			*destination++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			*destination++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+		else {
+			*destination++ = static_cast<char>(0xF0 | (codePoint >> 18));
+			*destination++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+			*destination++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			*destination++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+		return destination;
+	}
+
+	template<class WideChar>
+	size_t GetWideLengthImpl(std::string_view source) {
+		size_t length = 0;
+		size_t position = 0;
+		while (position < source.size()) {
+			size_t count = CountAscii(source.data() + position, source.size() - position);
+			position += count;
+			length += count;
+			if (position >= source.size()) { break; }
+			length += GetWideUnitCount<WideChar>(DecodeUtf8(source.data(), source.size(), position));
+		}
+		return length;
+	}
+
+	template<class WideChar>
+	size_t GetUtf8LengthImpl(std::basic_string_view<WideChar> source) {
+		size_t length = 0;
+		size_t position = 0;
+		while (position < source.size()) {
+			length += GetUtf8UnitCount(DecodeWide(source.data(), source.size(), position));
+		}
+		return length;
+	}
+
+	// destinationには変換後の長さ以上が必要
+	template<class WideChar>
+	size_t Utf8ToWide(std::string_view source, WideChar* destination) {
+		WideChar* output = destination;
+		size_t position = 0;
+		while (position < source.size()) {
+			size_t count = WidenAscii(source.data() + position, source.size() - position, output);
+			position += count;
+			output += count;
+			if (position >= source.size()) { break; }
+			output = EncodeWide(DecodeUtf8(source.data(), source.size(), position), output);
+		}
+		return static_cast<size_t>(output - destination);
+	}
+
+	template<class WideChar>
+	size_t WideToUtf8(std::basic_string_view<WideChar> source, char* destination) {
+		char* output = destination;
+		size_t position = 0;
+		while (position < source.size()) {
+			size_t count = NarrowAscii(source.data() + position, source.size() - position, output);
+			position += count;
+			output += count;
+			if (position >= source.size()) { break; }
+			output = EncodeUtf8(DecodeWide(source.data(), source.size(), position), output);
+		}
+		return static_cast<size_t>(output - destination);
+	}
+
+	template<class WideChar>
+	size_t ConvertToWideBuffer(std::string_view source, WideChar* buffer, size_t bufferSize) {
+		if (bufferSize == 0) { return GetWideLengthImpl<WideChar>(source); }
+		// UTF-8の1バイトは1文字以下になるので、収まると分かれば長さを数えずに変換する
+		size_t length = source.size() < bufferSize ? 0 : GetWideLengthImpl<WideChar>(source);
+		if (length < bufferSize) {
+			length = Utf8ToWide(source, buffer);
+			buffer[length] = 0;
+			return length;
+		}
+		// 収まる所まで1文字ずつ書く
+		WideChar* output = buffer;
+		WideChar* end = buffer + bufferSize - 1;
+		size_t position = 0;
+		while (position < source.size()) {
+			size_t next = position;
+			char32_t codePoint = DecodeUtf8(source.data(), source.size(), next);
+			if (static_cast<size_t>(end - output) < GetWideUnitCount<WideChar>(codePoint)) { break; }
+			output = EncodeWide(codePoint, output);
+			position = next;
+		}
+		*output = 0;
+		return length;
+	}
+
+	template<class WideChar>
+	size_t ConvertToUtf8Buffer(std::basic_string_view<WideChar> source, char* buffer, size_t bufferSize) {
+		if (bufferSize == 0) { return GetUtf8LengthImpl(source); }
+		// 1文字は3バイト（UTF-32は4バイト）以下
+		constexpr size_t kMaxExpansion = sizeof(WideChar) == 2 ? 3 : 4;
+		size_t length = source.size() * kMaxExpansion < bufferSize ? 0 : GetUtf8LengthImpl(source);
+		if (length < bufferSize) {
+			length = WideToUtf8(source, buffer);
+			buffer[length] = '\0';
+			return length;
+		}
+		char* output = buffer;
+		char* end = buffer + bufferSize - 1;
+		size_t position = 0;
+		while (position < source.size()) {
+			size_t next = position;
+			char32_t codePoint = DecodeWide(source.data(), source.size(), next);
+			if (static_cast<size_t>(end - output) < GetUtf8UnitCount(codePoint)) { break; }
+			output = EncodeUtf8(codePoint, output);
+			position = next;
+		}
+		*output = '\0';
+		return length;
 	}
-	int sizeNeeded = MultiByteToWideChar(CP_UTF8, 0, reinterpret_cast<const char*>(&str[0]), static_cast<int>(str.size()), NULL, 0);
-	if (sizeNeeded == 0) {
-		return std::wstring();
+
+	template<class WideChar>
+	void ConvertToWideString(std::string_view source, std::basic_string<WideChar>& result) {
+		// 上限の大きさで変換してから縮める（容量が足りていれば確保しない）
+		result.resize(source.size());
+		result.resize(Utf8ToWide(source, result.data()));
+	}
+
+	template<class WideChar>
+	void ConvertToUtf8String(std::basic_string_view<WideChar> source, std::string& result) {
+		constexpr size_t kMaxExpansion = sizeof(WideChar) == 2 ? 3 : 4;
+		result.resize(source.size() * kMaxExpansion);
+		result.resize(WideToUtf8(source, result.data()));
 	}
-	std::wstring result(sizeNeeded, 0);
-	MultiByteToWideChar(CP_UTF8, 0, reinterpret_cast<const char*>(&str[0]), static_cast<int>(str.size()), &result[0], sizeNeeded);
+
+}
+
+std::wstring String::Convert(const std::string& str) {
+	std::wstring result;
+	ConvertToWideString<wchar_t>(str, result);
 	return result;
 }
 
 std::string String::Convert(const std::wstring& str) {
-	if (str.empty()) {
-		return std::string();
-	}
-	int sizeNeeded = WideCharToMultiByte(CP_UTF8, 0, str.data(), static_cast<int>(str.size()), NULL, 0, NULL, NULL);
-	if (sizeNeeded == 0) {
-		return std::string();
-	}
-	std::string result(sizeNeeded, 0);
-	WideCharToMultiByte(CP_UTF8, 0, str.data(), static_cast<int>(str.size()), result.data(), sizeNeeded, NULL, NULL);
+	std::string result;
+	ConvertToUtf8String<wchar_t>(str, result);
 	return result;
 }
+
+size_t String::GetUtf16Length(std::string_view utf8) {
+	return GetWideLengthImpl<char16_t>(utf8);
+}
+
+size_t String::GetWideLength(std::string_view utf8) {
+	return GetWideLengthImpl<wchar_t>(utf8);
+}
+
+size_t String::GetUtf8Length(std::u16string_view utf16) {
+	return GetUtf8LengthImpl(utf16);
+}
+
+size_t String::GetUtf8Length(std::wstring_view wide) {
+	return GetUtf8LengthImpl(wide);
+}
+
+size_t String::Convert(std::string_view source, char16_t* buffer, size_t bufferSize) {
+	return ConvertToWideBuffer(source, buffer, bufferSize);
+}
+
+size_t String::Convert(std::string_view source, wchar_t* buffer, size_t bufferSize) {
+	return ConvertToWideBuffer(source, buffer, bufferSize);
+}
+
+size_t String::Convert(std::u16string_view source, char* buffer, size_t bufferSize) {
+	return ConvertToUtf8Buffer(source, buffer, bufferSize);
+}
+
+size_t String::Convert(std::wstring_view source, char* buffer, size_t bufferSize) {
+	return ConvertToUtf8Buffer(source, buffer, bufferSize);
+}
+
+void String::ConvertTo(std::string_view source, std::u16string& result) {
+	ConvertToWideString(source, result);
+}
+
+void String::ConvertTo(std::string_view source, std::wstring& result) {
+	ConvertToWideString(source, result);
+}
+
+void String::ConvertTo(std::u16string_view source, std::string& result) {
+	ConvertToUtf8String(source, result);
+}
+
+void String::ConvertTo(std::wstring_view source, std::string& result) {
+	ConvertToUtf8String(source, result);
+}
@@ -23,14 +23,14 @@ void Window::Create(const std::string& name, uint32_t clientWidth, uint32_t clie
 	clientHeight_ = clientHeight;
 
 	name_ = name;
-	auto wname = String::Convert(name_);
+	auto wname = String::ToWide(name_);
 
 	// ウィンドウクラスを生成
 	WNDCLASS wc{};
 	// ウィンドウプロシージャ
 	wc.lpfnWndProc = WindowProc;
 	// ウィンドウクラス名
-	wc.lpszClassName = wname.c_str();
+	wc.lpszClassName = wname.GetCString();
 	// インスタンスハンドル
 	wc.hInstance = GetModuleHandle(nullptr);
 	// カーソル
@@ -47,7 +47,7 @@ void Window::Create(const std::string& name, uint32_t clientWidth, uint32_t clie
 	// ウィンドウの生成
 	hwnd_ = CreateWindow(
 		wc.lpszClassName,		// 利用するクラス名
-		wname.c_str(),				// タイトルバーの文字
+		wname.GetCString(),				// タイトルバーの文字
 		WS_OVERLAPPEDWINDOW,	// よく見るウィンドウスタイル
 		CW_USEDEFAULT,			// 表示X座標（WindowsOSに任せる）
 		CW_USEDEFAULT,			// 表示Y座標（WindowsOSに任せる）
@@ -62,7 +62,7 @@ void Window::Create(const std::string& name, uint32_t clientWidth, uint32_t clie
 void Window::Show() {
 	ShowWindow(hwnd_, SW_SHOW);
 #ifdef _DEBUG
-	Debug::Log(std::format("Show {} Window\n", name_));
+	Debug::Log("Show {} Window\n", name_);
 #endif
 }
 
@@ -0,0 +1,171 @@
+#include "StringFormat.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace String {
+
+	namespace Internal {
+
+		namespace {
+
+			// 書き込み先（収まらない分は数えるだけ）
+			class Writer {
+			public:
+				Writer(char* buffer, size_t bufferSize) :
+					current_(buffer), end_(bufferSize > 0 ? buffer + bufferSize - 1 : buffer) {}
+
+				void Write(const char* data, size_t size) {
+					size_t writable = static_cast<size_t>(end_ - current_);
+					size_t count = size < writable ? size : writable;
+					std::memcpy(current_, data, count);
+					current_ += count;
+					length_ += size;
+				}
+				void Fill(char c, size_t count) {
+					size_t writable = static_cast<size_t>(end_ - current_);
+					size_t fillCount = count < writable ? count : writable;
+					std::memset(current_, c, fillCount);
+					current_ += fillCount;
+					length_ += count;
+				}
+				void Terminate(size_t bufferSize) {
+					if (bufferSize > 0) { *current_ = '\0'; }
+				}
+				size_t GetLength() const { return length_; }
+
+			private:
+				char* current_;
+				char* end_;
+				size_t length_{ 0 };
+			};
+
+			// 数値は右寄せ（0埋めの場合は符号の後ろを埋める）、文字列は左寄せ
+			void WritePadded(Writer& writer, const char* data, size_t size, const Spec& spec, bool isNumber) {
+				size_t padding = spec.width > size ? spec.width - size : 0;
+				if (padding == 0) {
+					writer.Write(data, size);
+				}
+				else if (!isNumber) {
+					writer.Write(data, size);
+					writer.Fill(' ', padding);
+				}
+				else if (spec.zeroPad) {
+					size_t signSize = (size > 0 && (data[0] == '-' || data[0] == '+')) ? 1 : 0;
+					writer.Write(data, signSize);
+					writer.Fill('0', padding);
+					writer.Write(data + signSize, size - signSize);
+				}
+				else {
+					writer.Fill(' ', padding);
+					writer.Write(data, size);
+				}
+			}
+
+			template<class T>
+			void WriteFloat(Writer& writer, T value, const Spec& spec) {
+				char digits[128];
+				std::to_chars_result result{};
+				if (spec.type == 0 && spec.precision < 0) {
+					// 元の値に戻せる最短の桁数
+					result = std::to_chars(digits, digits + sizeof(digits), value);
+				}
+				else {
+					std::chars_format format = spec.type == 'e' ? std::chars_format::scientific : spec.type == 'g' ? std::chars_format::general : std::chars_format::fixed;
+					result = std::to_chars(digits, digits + sizeof(digits), value, format, spec.precision < 0 ? 6 : spec.precision);
+				}
+				if (result.ec != std::errc()) {
+					// 桁が多すぎる（1e300を固定小数点で出すなど）場合は指数表記にする
+					result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::scientific);
+				}
+				WritePadded(writer, digits, static_cast<size_t>(result.ptr - digits), spec, true);
+			}
+
+			void WriteArgument(Writer& writer, const Argument& argument, const Spec& spec) {
+				char digits[32];
+				int base = (spec.type == 'x' || spec.type == 'X') ? 16 : 10;
+				switch (argument.type) {
+				case ArgumentType::SignedInteger:
+				case ArgumentType::UnsignedInteger:
+				{
+					std::to_chars_result result = argument.type == ArgumentType::SignedInteger ?
+						std::to_chars(digits, digits + sizeof(digits), argument.signedInteger, base) :
+						std::to_chars(digits, digits + sizeof(digits), argument.unsignedInteger, base);
+					if (spec.type == 'X') {
+						for (char* c = digits; c < result.ptr; ++c) {
+							if (*c >= 'a' && *c <= 'f') { *c = static_cast<char>(*c - 'a' + 'A'); }
+						}
+					}
+					WritePadded(writer, digits, static_cast<size_t>(result.ptr - digits), spec, true);
+					break;
+				}
+				case ArgumentType::Float:
+					WriteFloat(writer, argument.floatValue, spec);
+					break;
+				case ArgumentType::Double:
+					WriteFloat(writer, argument.doubleValue, spec);
+					break;
+				case ArgumentType::Bool:
+					if (argument.boolValue) {
+						WritePadded(writer, "true", 4, spec, false);
+					}
+					else {
+						WritePadded(writer, "false", 5, spec, false);
+					}
+					break;
+				case ArgumentType::Char:
+					WritePadded(writer, &argument.charValue, 1, spec, false);
+					break;
+				case ArgumentType::String:
+					WritePadded(writer, argument.string.data, argument.string.size, spec, false);
+					break;
+				case ArgumentType::Pointer:
+				{
+					digits[0] = '0';
+					digits[1] = 'x';
+					std::to_chars_result result = std::to_chars(digits + 2, digits + sizeof(digits), reinterpret_cast<uintptr_t>(argument.pointer), 16);
+					WritePadded(writer, digits, static_cast<size_t>(result.ptr - digits), spec, false);
+					break;
+				}
+				default:
+					break;
+				}
+			}
+
+		}
+
+		size_t FormatTo(char* buffer, size_t bufferSize, std::string_view format, const Argument* arguments, size_t argumentCount) {
+			Writer writer(buffer, bufferSize);
+			size_t argumentIndex = 0;
+			size_t position = 0;
+			while (position < format.size()) {
+				// 次の波かっこまではまとめて書く
+				size_t next = format.find_first_of("{}", position);
+				if (next == std::string_view::npos) {
+					writer.Write(format.data() + position, format.size() - position);
+					break;
+				}
+				writer.Write(format.data() + position, next - position);
+				position = next + 1;
+				// {{ と }} は一文字（書式はコンパイル時に確認済みなので、閉じていない波かっこは来ない）
+				if (format[next] == '}' || (position < format.size() && format[position] == '{')) {
+					writer.Write(format.data() + next, 1);
+					++position;
+					continue;
+				}
+				Spec spec;
+				if (!ParseSpec(format, position, spec) || argumentIndex >= argumentCount) { break; }
+				WriteArgument(writer, arguments[argumentIndex++], spec);
+			}
+			writer.Terminate(bufferSize);
+			return writer.GetLength();
+		}
+
+		char* GetThreadBuffer() {
+			thread_local char buffer[kThreadBufferSize];
+			return buffer;
+		}
+
+	}
+
+}
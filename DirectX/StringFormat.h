@@ -0,0 +1,301 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// std::formatと同じ{}の書式で、呼び出し側のバッファに書き込む（ヒープを使わない）
+// 書式はコンパイル時に引数の数と型を確認する
+//   {}      既定の形式（浮動小数点数は元の値に戻せる最短の桁数）
+//   {:8}    幅（数値は右寄せ、文字列は左寄せ）
+//   {:08}   0で埋める（数値のみ）
+//   {:x}    16進数（整数とポインタ、Xは大文字）
+//   {:.3}   小数点以下の桁数（浮動小数点数のみ、f、e、gで形式を指定できる）
+//   {{ }}   波かっこそのもの
+
+namespace String {
+
+	namespace Internal {
+
+		enum class ArgumentType : uint8_t {
+			SignedInteger,
+			UnsignedInteger,
+			Float,
+			Double,
+			Bool,
+			Char,
+			String,
+			Pointer,
+			Unsupported
+		};
+
+		template<class T>
+		constexpr ArgumentType GetArgumentType() {
+			using Type = std::remove_cvref_t<T>;
+			if constexpr (std::is_same_v<Type, bool>) { return ArgumentType::Bool; }
+			else if constexpr (std::is_same_v<Type, char>) { return ArgumentType::Char; }
+			else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) { return ArgumentType::SignedInteger; }
+			else if constexpr (std::is_integral_v<Type>) { return ArgumentType::UnsignedInteger; }
+			else if constexpr (std::is_enum_v<Type>) { return GetArgumentType<std::underlying_type_t<Type>>(); }
+			else if constexpr (std::is_same_v<Type, float>) { return ArgumentType::Float; }
+			else if constexpr (std::is_floating_point_v<Type>) { return ArgumentType::Double; }
+			else if constexpr (std::is_convertible_v<const Type&, std::string_view>) { return ArgumentType::String; }
+			else if constexpr (std::is_pointer_v<std::decay_t<Type>>) { return ArgumentType::Pointer; }
+			else { return ArgumentType::Unsupported; }
+		}
+
+		// 型を消した引数
+		struct Argument {
+			ArgumentType type;
+			union {
+				int64_t signedInteger;
+				uint64_t unsignedInteger;
+				float floatValue;
+				double doubleValue;
+				bool boolValue;
+				char charValue;
+				const void* pointer;
+				struct {
+					const char* data;
+					size_t size;
+				} string;
+			};
+		};
+
+		template<class T>
+		Argument MakeArgument(const T& value) {
+			using Type = std::remove_cvref_t<T>;
+			constexpr ArgumentType type = GetArgumentType<T>();
+			Argument argument{};
+			argument.type = type;
+			if constexpr (std::is_enum_v<Type>) { return MakeArgument(static_cast<std::underlying_type_t<Type>>(value)); }
+			else if constexpr (type == ArgumentType::SignedInteger) { argument.signedInteger = static_cast<int64_t>(value); }
+			else if constexpr (type == ArgumentType::UnsignedInteger) { argument.unsignedInteger = static_cast<uint64_t>(value); }
+			else if constexpr (type == ArgumentType::Float) { argument.floatValue = value; }
+			else if constexpr (type == ArgumentType::Double) { argument.doubleValue = static_cast<double>(value); }
+			else if constexpr (type == ArgumentType::Bool) { argument.boolValue = value; }
+			else if constexpr (type == ArgumentType::Char) { argument.charValue = value; }
+			else if constexpr (type == ArgumentType::String) {
+				std::string_view view(value);
+				argument.string.data = view.data();
+				argument.string.size = view.size();
+			}
+			else if constexpr (type == ArgumentType::Pointer) { argument.pointer = static_cast<const void*>(value); }
+			return argument;
+		}
+
+		// 定数式の中で呼ばれるとコンパイルエラーになる（エラーメッセージに関数名が出る）
+		inline void FormatStringError_InvalidFormat() {}
+		inline void FormatStringError_ArgumentCountMismatch() {}
+		inline void FormatStringError_SpecifierDoesNotMatchArgumentType() {}
+		inline void FormatStringError_UnsupportedArgumentType() {}
+
+		struct Spec {
+			// 0、x、X、f、e、g
+			char type{ 0 };
+			bool zeroPad{ false };
+			uint8_t width{ 0 };
+			// -1は指定なし
+			int8_t precision{ -1 };
+		};
+
+		// "{"の次から"}"までを読む。読めなければfalse
+		constexpr bool ParseSpec(std::string_view format, size_t& position, Spec& spec) {
+			if (position < format.size() && format[position] == ':') {
+				++position;
+				if (position < format.size() && format[position] == '0') {
+					spec.zeroPad = true;
+					++position;
+				}
+				int width = 0;
+				while (position < format.size() && format[position] >= '0' && format[position] <= '9') {
+					width = width * 10 + (format[position++] - '0');
+					if (width > 255) { return false; }
+				}
+				spec.width = static_cast<uint8_t>(width);
+				if (position < format.size() && format[position] == '.') {
+					++position;
+					int precision = 0;
+					bool hasDigit = false;
+					while (position < format.size() && format[position] >= '0' && format[position] <= '9') {
+						precision = precision * 10 + (format[position++] - '0');
+						hasDigit = true;
+						if (precision > 60) { return false; }
+					}
+					if (!hasDigit) { return false; }
+					spec.precision = static_cast<int8_t>(precision);
+				}
+				if (position < format.size() && format[position] != '}') {
+					char type = format[position++];
+					if (type != 'x' && type != 'X' && type != 'f' && type != 'e' && type != 'g') { return false; }
+					spec.type = type;
+				}
+			}
+			if (position >= format.size() || format[position] != '}') { return false; }
+			++position;
+			return true;
+		}
+
+		constexpr bool IsSpecValid(const Spec& spec, ArgumentType type) {
+			bool isInteger = type == ArgumentType::SignedInteger || type == ArgumentType::UnsignedInteger;
+			bool isFloat = type == ArgumentType::Float || type == ArgumentType::Double;
+			if ((spec.type == 'x' || spec.type == 'X') && !isInteger && type != ArgumentType::Pointer) { return false; }
+			if ((spec.type == 'f' || spec.type == 'e' || spec.type == 'g' || spec.precision >= 0) && !isFloat) { return false; }
+			if (spec.zeroPad && !isInteger && !isFloat) { return false; }
+			return true;
+		}
+
+		template<class... Args>
+		constexpr void ValidateFormat(std::string_view format) {
+			constexpr ArgumentType types[] = { GetArgumentType<Args>()..., ArgumentType::Unsupported };
+			for (size_t i = 0; i < sizeof...(Args); ++i) {
+				if (types[i] == ArgumentType::Unsupported) { FormatStringError_UnsupportedArgumentType(); }
+			}
+			size_t argumentIndex = 0;
+			for (size_t position = 0; position < format.size();) {
+				char c = format[position++];
+				if (c == '}') {
+					if (position < format.size() && format[position] == '}') { ++position; continue; }
+					FormatStringError_InvalidFormat();
+				}
+				if (c != '{') { continue; }
+				if (position < format.size() && format[position] == '{') { ++position; continue; }
+				Spec spec;
+				if (!ParseSpec(format, position, spec)) { FormatStringError_InvalidFormat(); }
+				if (argumentIndex >= sizeof...(Args)) { FormatStringError_ArgumentCountMismatch(); }
+				if (!IsSpecValid(spec, types[argumentIndex])) { FormatStringError_SpecifierDoesNotMatchArgumentType(); }
+				++argumentIndex;
+			}
+			if (argumentIndex != sizeof...(Args)) { FormatStringError_ArgumentCountMismatch(); }
+		}
+
+		/// <summary>
+		/// 型を消した引数で書式化する
+		/// </summary>
+		/// <returns>必要な文字数（終端を除く、bufferSizeを超えた分は書き込まない）</returns>
+		size_t FormatTo(char* buffer, size_t bufferSize, std::string_view format, const Argument* arguments, size_t argumentCount);
+
+		// スレッドごとのバッファ
+		char* GetThreadBuffer();
+		inline constexpr size_t kThreadBufferSize = 1024;
+
+	}
+
+	// コンパイル時に確認済みの書式（文字列リテラルから暗黙に作る）
+	template<class... Args>
+	class FormatString {
+	public:
+		template<class T>
+			requires std::is_convertible_v<const T&, std::string_view>
+		consteval FormatString(const T& format) : format_(format) {
+			Internal::ValidateFormat<Args...>(format_);
+		}
+
+		std::string_view Get() const { return format_; }
+
+	private:
+		std::string_view format_;
+	};
+
+	/// <summary>
+	/// バッファに書式化して書き込む（常に終端する、収まらない分は切り捨てる）
+	/// </summary>
+	/// <param name="buffer"></param>
+	/// <param name="bufferSize">終端を含むバイト数</param>
+	/// <param name="format"></param>
+	/// <param name="...args"></param>
+	/// <returns>必要な文字数（終端を除く、bufferSize以上なら切り捨てた）</returns>
+	template<class... Args>
+	size_t FormatTo(char* buffer, size_t bufferSize, FormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+		const Internal::Argument arguments[] = { Internal::MakeArgument(args)..., Internal::Argument{} };
+		return Internal::FormatTo(buffer, bufferSize, format.Get(), arguments, sizeof...(Args));
+	}
+	template<size_t N, class... Args>
+	size_t FormatTo(char(&buffer)[N], FormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+		const Internal::Argument arguments[] = { Internal::MakeArgument(args)..., Internal::Argument{} };
+		return Internal::FormatTo(buffer, N, format.Get(), arguments, sizeof...(Args));
+	}
+
+	/// <summary>
+	/// スレッドごとのバッファに書式化する（ヒープを使わない）
+	/// 同じスレッドで次に呼ぶまで有効で、終端している。収まらない分は切り捨てる
+	/// </summary>
+	/// <param name="format"></param>
+	/// <param name="...args"></param>
+	/// <returns></returns>
+	template<class... Args>
+	std::string_view FormatTemporary(FormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+		const Internal::Argument arguments[] = { Internal::MakeArgument(args)..., Internal::Argument{} };
+		char* buffer = Internal::GetThreadBuffer();
+		size_t length = Internal::FormatTo(buffer, Internal::kThreadBufferSize, format.Get(), arguments, sizeof...(Args));
+		return std::string_view(buffer, length < Internal::kThreadBufferSize ? length : Internal::kThreadBufferSize - 1);
+	}
+
+	/// <summary>
+	/// std::stringに書式化する（確保は結果の1回だけ）
+	/// </summary>
+	/// <param name="format"></param>
+	/// <param name="...args"></param>
+	/// <returns></returns>
+	template<class... Args>
+	std::string Format(FormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+		const Internal::Argument arguments[] = { Internal::MakeArgument(args)..., Internal::Argument{} };
+		char* buffer = Internal::GetThreadBuffer();
+		size_t length = Internal::FormatTo(buffer, Internal::kThreadBufferSize, format.Get(), arguments, sizeof...(Args));
+		if (length < Internal::kThreadBufferSize) {
+			return std::string(buffer, length);
+		}
+		// スレッドのバッファに収まらない場合は大きさが分かっているのでそのまま書く
+		std::string result(length, '\0');
+		Internal::FormatTo(result.data(), length + 1, format.Get(), arguments, sizeof...(Args));
+		return result;
+	}
+
+	// 固定長の文字列バッファ（スタックやメンバーに置いて使い回す）
+	template<size_t N>
+	class FixedString {
+	public:
+		static_assert(N > 0);
+
+		FixedString() = default;
+		template<class... Args>
+		explicit FixedString(FormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+			Append(format, args...);
+		}
+
+		/// <summary>
+		/// 後ろに書式化して追加する（収まらない分は切り捨てる）
+		/// </summary>
+		template<class... Args>
+		FixedString& Append(FormatString<std::type_identity_t<Args>...> format, const Args&... args) {
+			size_t required = FormatTo(data_ + length_, N - length_, format, args...);
+			if (length_ + required >= N) {
+				truncated_ = true;
+				length_ = N - 1;
+			}
+			else {
+				length_ += required;
+			}
+			return *this;
+		}
+		void Clear() {
+			length_ = 0;
+			truncated_ = false;
+			data_[0] = '\0';
+		}
+
+		const char* GetCString() const { return data_; }
+		std::string_view GetView() const { return std::string_view(data_, length_); }
+		operator std::string_view() const { return GetView(); }
+		size_t GetLength() const { return length_; }
+		static constexpr size_t GetCapacity() { return N - 1; }
+		bool IsTruncated() const { return truncated_; }
+
+	private:
+		char data_[N]{};
+		size_t length_{ 0 };
+		bool truncated_{ false };
+	};
+
+}
@@ -7,10 +7,7 @@ namespace DirectXHelper {
 	bool StructuredBuffer::Initalize(ID3D12Device5* device, size_t elementCount, size_t elementSize) {
 		assert(device);
 
-		if (mappedData_) {
-			resource_->Unmap(0, nullptr);
-			mappedData_ = nullptr;
-		}
+		UnmapData();
 
 		elementSize_ = static_cast<uint32_t>(elementSize);
 		elementCount_ = static_cast<uint32_t>(elementCount);
@@ -22,6 +19,33 @@ namespace DirectXHelper {
 			ResourceState::GenericRead)) {
 			return false;
 		}
+		return MapData();
+	}
+
+	bool StructuredBuffer::Initalize(ResourceAllocator& allocator, size_t elementCount, size_t elementSize) {
+		UnmapData();
+
+		elementSize_ = static_cast<uint32_t>(elementSize);
+		elementCount_ = static_cast<uint32_t>(elementCount);
+
+		if (!GPUResource::Initalize(
+			allocator,
+			D3D12_HEAP_TYPE_UPLOAD,
+			CD3DX12_RESOURCE_DESC::Buffer(static_cast<uint64_t>(BufferSize)),
+			ResourceState::GenericRead)) {
+			return false;
+		}
+		return MapData();
+	}
+
+	void StructuredBuffer::UnmapData() {
+		if (mappedData_) {
+			resource_->Unmap(0, nullptr);
+			mappedData_ = nullptr;
+		}
+	}
+
+	bool StructuredBuffer::MapData() {
 		if (FAILED(resource_->Map(0, nullptr, &mappedData_))) {
 			Logger::Error("ID3D12Resource::Map()");
 			assert(false);
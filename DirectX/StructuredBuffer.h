@@ -7,6 +7,14 @@ namespace DirectXHelper {
 		public GPUResource {
 	public:
 		bool Initalize(ID3D12Device5* device, size_t elementCount, size_t elementSize);
+		/// <summary>
+		/// ResourceAllocatorのヒープに配置して初期化（エフェクトごとに作る場合はこちら）
+		/// </summary>
+		/// <param name="allocator"></param>
+		/// <param name="elementCount"></param>
+		/// <param name="elementSize"></param>
+		/// <returns></returns>
+		bool Initalize(ResourceAllocator& allocator, size_t elementCount, size_t elementSize);
 
 		__declspec(property(get = GetMappedData)) void* MappedData;
 		void* GetMappedData() const { return mappedData_; }
@@ -21,6 +29,9 @@ namespace DirectXHelper {
 		uint32_t GetElementSize() const { return elementSize_; }
 
 	private:
+		void UnmapData();
+		bool MapData();
+
 		void* mappedData_{ nullptr };
 		uint32_t elementCount_{ 0 };
 		uint32_t elementSize_{ 0 };
@@ -0,0 +1,191 @@
+#include "TimelineFence.h"
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <Windows.h>
+#endif // _MSC_VER
+
+#include "Assert.h"
+
+namespace Engine {
+
+	FenceEvent::FenceEvent() {
+#ifdef _MSC_VER
+		// 自動でリセットするイベント
+		handle_ = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+		ASSERT_MSG(handle_, "CreateEvent failed");
+#endif // _MSC_VER
+	}
+
+	FenceEvent::~FenceEvent() {
+#ifdef _MSC_VER
+		if (handle_) { CloseHandle(static_cast<HANDLE>(handle_)); }
+#endif // _MSC_VER
+	}
+
+	void FenceEvent::Set() {
+#ifdef _MSC_VER
+		SetEvent(static_cast<HANDLE>(handle_));
+#else
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			isSet_ = true;
+		}
+		condition_.notify_all();
+#endif // _MSC_VER
+	}
+
+	bool FenceEvent::Wait(std::chrono::nanoseconds timeout) {
+#ifdef _MSC_VER
+		DWORD milliseconds = INFINITE;
+		if (timeout != TimelineFence::kInfinite) {
+			// 切り上げて、指定より早く時間切れにしない
+			milliseconds = static_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(timeout).count());
+		}
+		return WaitForSingleObject(static_cast<HANDLE>(handle_), milliseconds) == WAIT_OBJECT_0;
+#else
+		std::unique_lock<std::mutex> lock(mutex_);
+		if (timeout == TimelineFence::kInfinite) {
+			condition_.wait(lock, [&] { return isSet_; });
+		}
+		else if (!condition_.wait_for(lock, timeout, [&] { return isSet_; })) {
+			return false;
+		}
+		isSet_ = false;
+		return true;
+#endif // _MSC_VER
+	}
+
+	namespace {
+		// 待つスレッドごとに使い回す
+		FenceEvent& GetThreadEvent() {
+			thread_local FenceEvent event;
+			return event;
+		}
+
+		// 残り時間（無限はそのまま）
+		std::chrono::nanoseconds GetRemaining(std::chrono::steady_clock::time_point deadline, std::chrono::nanoseconds timeout) {
+			if (timeout == TimelineFence::kInfinite) { return timeout; }
+			return std::max(std::chrono::nanoseconds(0), std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()));
+		}
+
+		std::chrono::steady_clock::time_point GetDeadline(std::chrono::nanoseconds timeout) {
+			if (timeout == TimelineFence::kInfinite) { return std::chrono::steady_clock::time_point::max(); }
+			return std::chrono::steady_clock::now() + timeout;
+		}
+	}
+
+	bool TimelineFence::Wait(uint64_t value, std::chrono::nanoseconds timeout) {
+		WaitDesc wait{ this, value };
+		return WaitAny(&wait, 1, timeout) == 0;
+	}
+
+	int32_t TimelineFence::WaitAny(const WaitDesc* waits, uint32_t count, std::chrono::nanoseconds timeout) {
+		auto findCompleted = [&]() -> int32_t {
+			for (uint32_t i = 0; i < count; ++i) {
+				if (waits[i].fence->IsCompleted(waits[i].value)) { return static_cast<int32_t>(i); }
+			}
+			return -1;
+		};
+		int32_t completed = findCompleted();
+		if (completed >= 0 || timeout.count() <= 0) { return completed; }
+
+		auto deadline = GetDeadline(timeout);
+		FenceEvent& event = GetThreadEvent();
+		for (uint32_t i = 0; i < count; ++i) {
+			if (!waits[i].fence->SetEventOnCompletion(waits[i].value, event)) {
+				ASSERT_MSG(false, "SetEventOnCompletion failed");
+			}
+		}
+		for (;;) {
+			// 前の待ちで頼んだイベントが遅れてSetされることがあるので、起きたら値を確かめる
+			completed = findCompleted();
+			if (completed >= 0) { break; }
+			std::chrono::nanoseconds remaining = GetRemaining(deadline, timeout);
+			if (remaining.count() <= 0 || (!event.Wait(remaining) && GetRemaining(deadline, timeout).count() <= 0)) {
+				completed = findCompleted();
+				break;
+			}
+		}
+		for (uint32_t i = 0; i < count; ++i) {
+			waits[i].fence->CancelEventOnCompletion(event);
+		}
+		return completed;
+	}
+
+	bool TimelineFence::WaitAll(const WaitDesc* waits, uint32_t count, std::chrono::nanoseconds timeout) {
+		auto deadline = GetDeadline(timeout);
+		for (uint32_t i = 0; i < count; ++i) {
+			if (!waits[i].fence->Wait(waits[i].value, GetRemaining(deadline, timeout))) { return false; }
+		}
+		return true;
+	}
+
+	void TimelineFence::AddCompletionCallback(uint64_t value, std::function<void()> callback) {
+		std::lock_guard<std::mutex> lock(callbackMutex_);
+		// ほとんどは値の順に足されるので、後ろから挿す位置を探す
+		auto position = callbacks_.end();
+		while (position != callbacks_.begin() && std::prev(position)->value > value) { --position; }
+		callbacks_.insert(position, Callback{ value, std::move(callback) });
+	}
+
+	uint32_t TimelineFence::ProcessCompletionCallbacks() {
+		std::vector<Callback> ready;
+		{
+			std::lock_guard<std::mutex> lock(callbackMutex_);
+			if (callbacks_.empty()) { return 0; }
+			uint64_t completedValue = GetCompletedValue();
+			size_t readyCount = 0;
+			while (readyCount < callbacks_.size() && callbacks_[readyCount].value <= completedValue) { ++readyCount; }
+			if (readyCount == 0) { return 0; }
+			ready.assign(std::make_move_iterator(callbacks_.begin()), std::make_move_iterator(callbacks_.begin() + readyCount));
+			callbacks_.erase(callbacks_.begin(), callbacks_.begin() + readyCount);
+		}
+		// 関数の中から足せるように、ロックの外で呼ぶ
+		for (Callback& callback : ready) {
+			callback.function();
+		}
+		return static_cast<uint32_t>(ready.size());
+	}
+
+	uint32_t TimelineFence::GetPendingCallbackCount() const {
+		std::lock_guard<std::mutex> lock(callbackMutex_);
+		return static_cast<uint32_t>(callbacks_.size());
+	}
+
+	uint64_t SimulatedTimelineFence::GetCompletedValue() {
+		return completedValue_.load(std::memory_order_acquire);
+	}
+
+	bool SimulatedTimelineFence::SetEventOnCompletion(uint64_t value, FenceEvent& event) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (completedValue_.load(std::memory_order_relaxed) < value) {
+				eventWaits_.push_back(EventWait{ value, &event });
+				return true;
+			}
+		}
+		event.Set();
+		return true;
+	}
+
+	void SimulatedTimelineFence::CancelEventOnCompletion(FenceEvent& event) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		eventWaits_.erase(std::remove_if(eventWaits_.begin(), eventWaits_.end(), [&](const EventWait& wait) { return wait.event == &event; }), eventWaits_.end());
+	}
+
+	void SimulatedTimelineFence::Signal(uint64_t value) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (value <= completedValue_.load(std::memory_order_relaxed)) { return; }
+		completedValue_.store(value, std::memory_order_release);
+		// イベントは待っているスレッドが消すまで生きているので、ロックの中でSetしてよい
+		auto completed = std::remove_if(eventWaits_.begin(), eventWaits_.end(), [&](const EventWait& wait) {
+			if (wait.value > value) { return false; }
+			wait.event->Set();
+			return true;
+		});
+		eventWaits_.erase(completed, eventWaits_.end());
+	}
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Engine {
+
+	// フェンスの完了を知らせるイベント（WindowsではWin32のイベント、それ以外は条件変数）
+	// 一度Waitを抜けると元に戻る
+	class FenceEvent {
+	public:
+		FenceEvent();
+		~FenceEvent();
+		FenceEvent(const FenceEvent&) = delete;
+		FenceEvent& operator=(const FenceEvent&) = delete;
+
+		void Set();
+		/// <summary>
+		/// Setされるまで待つ
+		/// </summary>
+		/// <param name="timeout"></param>
+		/// <returns>時間切れならfalse</returns>
+		bool Wait(std::chrono::nanoseconds timeout);
+		// WindowsではHANDLE（ID3D12Fence::SetEventOnCompletionに渡す）
+		void* GetNativeHandle() const { return handle_; }
+
+	private:
+		void* handle_{ nullptr };
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		bool isSet_{ false };
+	};
+
+	// 値が増えていくフェンス（D3DではID3D12Fence、テストではSimulatedTimelineFence）
+	// 完了の問い合わせ、時間切れ付きの待機、値に届いたら呼ぶ関数を共通に扱う
+	class TimelineFence {
+	public:
+		static constexpr std::chrono::nanoseconds kInfinite = std::chrono::nanoseconds::max();
+
+		struct WaitDesc {
+			TimelineFence* fence;
+			uint64_t value;
+		};
+
+		virtual ~TimelineFence() = default;
+
+		/// <summary>
+		/// 届いた値
+		/// </summary>
+		virtual uint64_t GetCompletedValue() = 0;
+		/// <summary>
+		/// 値に届いたらイベントをSetする（届いていればすぐにSetする）
+		/// </summary>
+		virtual bool SetEventOnCompletion(uint64_t value, FenceEvent& event) = 0;
+		/// <summary>
+		/// SetEventOnCompletionで頼んだ分を取り消す（取り消せない実装ではイベントが後でSetされることがある）
+		/// </summary>
+		virtual void CancelEventOnCompletion(FenceEvent& event) { (void)event; }
+
+		bool IsCompleted(uint64_t value) { return GetCompletedValue() >= value; }
+		/// <summary>
+		/// 値に届くまで待つ
+		/// </summary>
+		/// <param name="value"></param>
+		/// <param name="timeout"></param>
+		/// <returns>時間切れならfalse</returns>
+		bool Wait(uint64_t value, std::chrono::nanoseconds timeout = kInfinite);
+		/// <summary>
+		/// どれか一つが届くまで待つ
+		/// </summary>
+		/// <returns>届いたものの添字、時間切れなら-1</returns>
+		static int32_t WaitAny(const WaitDesc* waits, uint32_t count, std::chrono::nanoseconds timeout = kInfinite);
+		/// <summary>
+		/// すべてが届くまで待つ
+		/// </summary>
+		/// <returns>時間切れならfalse</returns>
+		static bool WaitAll(const WaitDesc* waits, uint32_t count, std::chrono::nanoseconds timeout = kInfinite);
+
+		/// <summary>
+		/// 値に届いたら呼ぶ関数を足す（ProcessCompletionCallbacksを呼んだスレッドで、値の順に呼ばれる）
+		/// 複数のスレッドから呼べる
+		/// </summary>
+		void AddCompletionCallback(uint64_t value, std::function<void()> callback);
+		/// <summary>
+		/// 届いた値の関数を呼ぶ（待たない）
+		/// </summary>
+		/// <returns>呼んだ数</returns>
+		uint32_t ProcessCompletionCallbacks();
+		uint32_t GetPendingCallbackCount() const;
+
+	private:
+		struct Callback {
+			uint64_t value;
+			std::function<void()> function;
+		};
+
+		mutable std::mutex callbackMutex_;
+		// 値の順
+		std::vector<Callback> callbacks_;
+	};
+
+	// CPUから値を進める模擬のフェンス（D3Dの無い環境でのテスト用、SimulatedGPUQueueが使う）
+	class SimulatedTimelineFence :
+		public TimelineFence {
+	public:
+		uint64_t GetCompletedValue() override;
+		bool SetEventOnCompletion(uint64_t value, FenceEvent& event) override;
+		void CancelEventOnCompletion(FenceEvent& event) override;
+
+		/// <summary>
+		/// 値を進めて、届いた待ちのイベントをSetする（どのスレッドからでもよい）
+		/// </summary>
+		void Signal(uint64_t value);
+
+	private:
+		struct EventWait {
+			uint64_t value;
+			FenceEvent* event;
+		};
+
+		std::mutex mutex_;
+		std::atomic<uint64_t> completedValue_{ 0 };
+		std::vector<EventWait> eventWaits_;
+	};
+
+}
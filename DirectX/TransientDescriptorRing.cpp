@@ -0,0 +1,86 @@
+#include "TransientDescriptorRing.h"
+
+#include <algorithm>
+
+#include "Assert.h"
+
+namespace Engine {
+
+	uint32_t TransientDescriptorRing::ThreadBlock::Allocate(TransientDescriptorRing& ring, uint32_t count) {
+		ASSERT_MSG(count > 0, "Zero size allocation");
+		uint64_t frameSerial = ring.frameSerial_.load(std::memory_order_acquire);
+		if (frameSerial != frameSerial_ || end_ - current_ < count) {
+			// 塊より大きい要求はそのまま塊にする
+			uint32_t blockSize = std::max(count, ring.blockSize_);
+			uint32_t index = ring.Allocate(blockSize);
+			if (index == kInvalidIndex) {
+				current_ = end_ = 0;
+				return kInvalidIndex;
+			}
+			current_ = index;
+			end_ = index + blockSize;
+			frameSerial_ = frameSerial;
+		}
+		uint32_t result = current_;
+		current_ += count;
+		return result;
+	}
+
+	bool TransientDescriptorRing::Initalize(uint32_t baseIndex, uint32_t capacity, uint32_t blockSize) {
+		if (capacity == 0 || blockSize == 0 || blockSize > capacity) {
+			ASSERT_MSG(false, "Invalid capacity");
+			return false;
+		}
+		baseIndex_ = baseIndex;
+		capacity_ = capacity;
+		blockSize_ = blockSize;
+		head_.store(0, std::memory_order_relaxed);
+		tail_.store(0, std::memory_order_relaxed);
+		frameSerial_.fetch_add(1, std::memory_order_release);
+		frameBegin_ = 0;
+		frameCount_ = 0;
+		return true;
+	}
+
+	void TransientDescriptorRing::BeginFrame(uint64_t completedFenceValue) {
+		while (frameCount_ > 0 && frames_[frameBegin_].fenceValue <= completedFenceValue) {
+			tail_.store(frames_[frameBegin_].endPosition, std::memory_order_release);
+			frameBegin_ = (frameBegin_ + 1) % kMaxFrameCount;
+			--frameCount_;
+		}
+	}
+
+	void TransientDescriptorRing::EndFrame(uint64_t fenceValue) {
+		FrameMarker marker{ head_.load(std::memory_order_acquire), fenceValue };
+		if (frameCount_ < kMaxFrameCount) {
+			frames_[(frameBegin_ + frameCount_) % kMaxFrameCount] = marker;
+			++frameCount_;
+		}
+		else {
+			// GPUが止まって処理中のフレームが溜まった場合は最後のフレームにまとめる
+			// まとめたフレームは新しいフェンス値を通過するまで戻らないので安全側になる
+			frames_[(frameBegin_ + frameCount_ - 1) % kMaxFrameCount] = marker;
+		}
+		// 前のフレームで取ったThreadBlockの残りを使わせない
+		frameSerial_.fetch_add(1, std::memory_order_release);
+	}
+
+	uint32_t TransientDescriptorRing::Allocate(uint32_t count) {
+		ASSERT_MSG(count > 0, "Zero size allocation");
+		if (count == 0 || count > capacity_) { return kInvalidIndex; }
+		uint64_t head = head_.load(std::memory_order_relaxed);
+		for (;;) {
+			// 末尾をまたぐ場合は先頭まで飛ばす（ディスクリプタテーブルは連続している必要がある）
+			uint64_t offset = head % capacity_;
+			uint64_t start = offset + count > capacity_ ? head + (capacity_ - offset) : head;
+			uint64_t newHead = start + count;
+			if (newHead - tail_.load(std::memory_order_acquire) > capacity_) {
+				return kInvalidIndex;
+			}
+			if (head_.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+				return baseIndex_ + static_cast<uint32_t>(start % capacity_);
+			}
+		}
+	}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Engine {
+
+	// 1フレームだけ使うディスクリプタを確保するリングバッファ
+	// 確保した位置は先頭に進むだけで個別には解放せず、フレームの終わりに記録したフェンス値をGPUが通過したらフレーム単位でまとめて戻す
+	// 記録中のスレッドはThreadBlockで一定数をまとめて取ってから切り出すので、スレッド同士で取り合わない
+	// D3Dに依存しないので、実際のフェンス値は呼び出し側が渡す
+	class TransientDescriptorRing {
+	public:
+		// 確保できなかった場合の戻り値
+		static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+		// 個別に記録する処理中のフレーム数（超えた分は最後のフレームにまとめる）
+		static constexpr uint32_t kMaxFrameCount = 8;
+
+		// 記録するスレッドごとに持つ確保済みの塊
+		class ThreadBlock {
+		public:
+			/// <summary>
+			/// 塊から切り出す（足りなければリングから新しい塊を取る）
+			/// </summary>
+			/// <param name="ring"></param>
+			/// <param name="count">連続したディスクリプタの数</param>
+			/// <returns>ディスクリプタヒープの中の位置、確保できない場合はkInvalidIndex</returns>
+			uint32_t Allocate(TransientDescriptorRing& ring, uint32_t count = 1);
+
+		private:
+			uint32_t current_{ 0 };
+			uint32_t end_{ 0 };
+			// 塊を取ったフレーム（フレームが変わったら残りは使わない）
+			uint64_t frameSerial_{ 0 };
+		};
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="baseIndex">ディスクリプタヒープの中でリングが始まる位置</param>
+		/// <param name="capacity">リングのディスクリプタ数</param>
+		/// <param name="blockSize">ThreadBlockが一度に取る数</param>
+		/// <returns></returns>
+		bool Initalize(uint32_t baseIndex, uint32_t capacity, uint32_t blockSize = 64);
+		/// <summary>
+		/// フレームの開始
+		/// GPUが通過したフレームの領域を戻す
+		/// </summary>
+		/// <param name="completedFenceValue">GPUが完了したフェンス値</param>
+		void BeginFrame(uint64_t completedFenceValue);
+		/// <summary>
+		/// フレームの終了
+		/// このフレームで確保した領域をフェンス値と一緒に記録する
+		/// </summary>
+		/// <param name="fenceValue">このフレームのコマンドの後にシグナルしたフェンス値</param>
+		void EndFrame(uint64_t fenceValue);
+		/// <summary>
+		/// 連続したディスクリプタを確保（複数のスレッドから呼べる）
+		/// </summary>
+		/// <param name="count"></param>
+		/// <returns>ディスクリプタヒープの中の位置、確保できない場合はkInvalidIndex</returns>
+		uint32_t Allocate(uint32_t count = 1);
+
+		uint32_t GetBaseIndex() const { return baseIndex_; }
+		uint32_t GetCapacity() const { return capacity_; }
+		// まだ戻っていないディスクリプタ数（末尾で折り返すときに飛ばした分も含む）
+		uint32_t GetUsedCount() const { return static_cast<uint32_t>(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire)); }
+		// 処理中のフレーム数
+		uint32_t GetPendingFrameCount() const { return frameCount_; }
+
+	private:
+		struct FrameMarker {
+			uint64_t endPosition;
+			uint64_t fenceValue;
+		};
+
+		// [tail_, head_) が使用中（折り返さない通し番号で持ち、リング上の位置は容量で割った余り）
+		std::atomic<uint64_t> head_{ 0 };
+		std::atomic<uint64_t> tail_{ 0 };
+		std::atomic<uint64_t> frameSerial_{ 1 };
+		FrameMarker frames_[kMaxFrameCount]{};
+		uint32_t frameBegin_{ 0 };
+		uint32_t frameCount_{ 0 };
+		uint32_t baseIndex_{ 0 };
+		uint32_t capacity_{ 0 };
+		uint32_t blockSize_{ 0 };
+	};
+
+}
@@ -0,0 +1,71 @@
+#include "stdafx.h"
+#include "UploadBuffer.h"
+#include "Logger.h"
+
+namespace DirectXHelper {
+
+	UploadBuffer::~UploadBuffer() {
+		if (mappedData_) {
+			resource_->Unmap(0, nullptr);
+			mappedData_ = nullptr;
+		}
+	}
+
+	bool UploadBuffer::Initalize(ID3D12Device5* device, size_t bufferSize) {
+		assert(device);
+
+		if (mappedData_) {
+			resource_->Unmap(0, nullptr);
+			mappedData_ = nullptr;
+		}
+
+		uint64_t alignedSize = (static_cast<uint64_t>(bufferSize) + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1) & ~static_cast<uint64_t>(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1);
+		if (!ring_.Initalize(alignedSize)) {
+			Logger::Error("UploadRing::Initalize()");
+			assert(false);
+			return false;
+		}
+		if (!GPUResource::Initalize(
+			device,
+			CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+			CD3DX12_RESOURCE_DESC::Buffer(alignedSize),
+			ResourceState::GenericRead)) {
+			return false;
+		}
+		// アップロードヒープは常にマップしたままでよい
+		if (FAILED(resource_->Map(0, nullptr, &mappedData_))) {
+			Logger::Error("ID3D12Resource::Map()");
+			assert(false);
+			return false;
+		}
+		return true;
+	}
+
+	UploadBuffer::Allocation UploadBuffer::Allocate(size_t size, size_t alignment) {
+		assert(mappedData_);
+
+		uint64_t offset = ring_.Allocate(size, alignment);
+		if (offset == Engine::UploadRing::kInvalidOffset) {
+			Logger::Error("UploadBuffer::Allocate()");
+			assert(false);
+			return {};
+		}
+		Allocation allocation;
+		allocation.cpu = static_cast<uint8_t*>(mappedData_) + offset;
+		allocation.gpu = resource_->GetGPUVirtualAddress() + offset;
+		allocation.offset = offset;
+		allocation.size = size;
+		return allocation;
+	}
+
+	UploadBuffer::Allocation UploadBuffer::WriteData(const void* data, size_t size, size_t alignment) {
+		assert(data);
+
+		Allocation allocation = Allocate(size, alignment);
+		if (allocation.IsEnabled()) {
+			memcpy(allocation.cpu, data, size);
+		}
+		return allocation;
+	}
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "GPUResource.h"
+#include "UploadRing.h"
+
+namespace DirectXHelper {
+
+	// 一時的な定数バッファや構造化バッファのデータを書き込むアップロードバッファ
+	// 大きなバッファを一つだけ作って常にマップしておき、UploadRingで256バイト単位に切り出す
+	// 書き込んだ領域はGPUがそのフレームのフェンス値を通過するまで上書きされない
+	class UploadBuffer :
+		public GPUResource {
+	public:
+		// 切り出した領域
+		struct Allocation {
+			void* cpu{ nullptr };
+			D3D12_GPU_VIRTUAL_ADDRESS gpu{ 0 };
+			uint64_t offset{ 0 };
+			uint64_t size{ 0 };
+
+			bool IsEnabled() const { return cpu != nullptr; }
+		};
+
+		~UploadBuffer();
+
+		bool Initalize(ID3D12Device5* device, size_t bufferSize);
+
+		/// <summary>
+		/// フレームの開始（GPUが通過したフレームの領域を戻す）
+		/// </summary>
+		/// <param name="completedFenceValue"></param>
+		void BeginFrame(uint64_t completedFenceValue) { ring_.BeginFrame(completedFenceValue); }
+		/// <summary>
+		/// フレームの終了（このフレームの領域をフェンス値と一緒に記録する）
+		/// </summary>
+		/// <param name="fenceValue"></param>
+		void EndFrame(uint64_t fenceValue) { ring_.EndFrame(fenceValue); }
+
+		/// <summary>
+		/// 領域を切り出す
+		/// </summary>
+		/// <param name="size">バイト数</param>
+		/// <param name="alignment">定数バッファは256</param>
+		/// <returns>確保できない場合は無効な領域</returns>
+		Allocation Allocate(size_t size, size_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+		/// <summary>
+		/// 領域を切り出してデータを書き込む
+		/// </summary>
+		/// <param name="data"></param>
+		/// <param name="size">バイト数</param>
+		/// <param name="alignment">定数バッファは256</param>
+		/// <returns>確保できない場合は無効な領域</returns>
+		Allocation WriteData(const void* data, size_t size, size_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+		template<class T>
+		Allocation WriteData(const T& data) { return WriteData(&data, sizeof(T)); }
+
+		__declspec(property(get = GetBufferSize)) uint64_t BufferSize;
+		uint64_t GetBufferSize() const { return ring_.GetCapacity(); }
+
+		__declspec(property(get = GetUsedSize)) uint64_t UsedSize;
+		uint64_t GetUsedSize() const { return ring_.GetUsedSize(); }
+
+	private:
+		Engine::UploadRing ring_;
+		void* mappedData_{ nullptr };
+	};
+
+}
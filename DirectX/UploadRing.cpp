@@ -0,0 +1,63 @@
+#include "UploadRing.h"
+
+#include "Assert.h"
+
+namespace Engine {
+
+	bool UploadRing::Initalize(uint64_t capacity) {
+		// 容量がアライメントの倍数でないと折り返した先頭がずれる
+		if (capacity == 0 || capacity % kDefaultAlignment != 0) {
+			ASSERT_MSG(false, "Capacity must be a multiple of 256");
+			return false;
+		}
+		capacity_ = capacity;
+		head_.store(0, std::memory_order_relaxed);
+		tail_.store(0, std::memory_order_release);
+		frameBegin_ = 0;
+		frameCount_ = 0;
+		return true;
+	}
+
+	void UploadRing::BeginFrame(uint64_t completedFenceValue) {
+		while (frameCount_ > 0 && frames_[frameBegin_].fenceValue <= completedFenceValue) {
+			tail_.store(frames_[frameBegin_].endPosition, std::memory_order_release);
+			frameBegin_ = (frameBegin_ + 1) % kMaxFrameCount;
+			--frameCount_;
+		}
+	}
+
+	void UploadRing::EndFrame(uint64_t fenceValue) {
+		FrameMarker marker{ head_.load(std::memory_order_acquire), fenceValue };
+		if (frameCount_ < kMaxFrameCount) {
+			frames_[(frameBegin_ + frameCount_) % kMaxFrameCount] = marker;
+			++frameCount_;
+		}
+		else {
+			// GPUが止まって処理中のフレームが溜まった場合は最後のフレームにまとめる（戻るのが遅れるだけで安全）
+			frames_[(frameBegin_ + frameCount_ - 1) % kMaxFrameCount] = marker;
+		}
+	}
+
+	uint64_t UploadRing::Allocate(uint64_t size, uint64_t alignment) {
+		ASSERT_MSG(size > 0, "Zero size allocation");
+		ASSERT_MSG(alignment != 0 && (alignment & (alignment - 1)) == 0 && alignment <= kDefaultAlignment, "Invalid alignment");
+		if (size == 0 || size > capacity_) { return kInvalidOffset; }
+		uint64_t head = head_.load(std::memory_order_relaxed);
+		for (;;) {
+			uint64_t start = (head + alignment - 1) & ~(alignment - 1);
+			// 末尾をまたぐ場合は先頭まで飛ばす（容量はアライメントの倍数なので先頭も揃っている）
+			uint64_t offset = start % capacity_;
+			if (offset + size > capacity_) {
+				start += capacity_ - offset;
+			}
+			uint64_t newHead = start + size;
+			if (newHead - tail_.load(std::memory_order_acquire) > capacity_) {
+				return kInvalidOffset;
+			}
+			if (head_.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+				return start % capacity_;
+			}
+		}
+	}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Engine {
+
+	// 一つの大きなアップロードバッファを先頭から切り出して使うリングバッファの管理部分
+	// 毎フレーム書き換える定数バッファなどを、GPUが前のフレームの内容を読んでいる間に上書きしないようにする
+	// 切り出した領域は個別には解放せず、フレームの終わりに記録したフェンス値をGPUが通過したらまとめて戻す
+	// D3Dに依存しないので、バッファ本体はDirectXHelper::UploadBufferが持つ
+	class UploadRing {
+	public:
+		// 確保できなかった場合の戻り値
+		static constexpr uint64_t kInvalidOffset = UINT64_MAX;
+		// 定数バッファの配置に必要なアライメント（D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT）
+		static constexpr uint64_t kDefaultAlignment = 256;
+		// 個別に記録する処理中のフレーム数（超えた分は最後のフレームにまとめる）
+		static constexpr uint32_t kMaxFrameCount = 8;
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="capacity">バッファのバイト数</param>
+		/// <returns></returns>
+		bool Initalize(uint64_t capacity);
+		/// <summary>
+		/// フレームの開始
+		/// GPUが通過したフレームの領域を戻す
+		/// </summary>
+		/// <param name="completedFenceValue">GPUが完了したフェンス値</param>
+		void BeginFrame(uint64_t completedFenceValue);
+		/// <summary>
+		/// フレームの終了
+		/// このフレームで確保した領域をフェンス値と一緒に記録する
+		/// </summary>
+		/// <param name="fenceValue">このフレームのコマンドの後にシグナルしたフェンス値</param>
+		void EndFrame(uint64_t fenceValue);
+		/// <summary>
+		/// 領域を切り出す（複数のスレッドから呼べる）
+		/// </summary>
+		/// <param name="size">バイト数</param>
+		/// <param name="alignment">2のべき乗</param>
+		/// <returns>バッファの先頭からのオフセット、確保できない場合はkInvalidOffset</returns>
+		uint64_t Allocate(uint64_t size, uint64_t alignment = kDefaultAlignment);
+
+		uint64_t GetCapacity() const { return capacity_; }
+		// まだ戻っていないバイト数（アライメントや折り返しで飛ばした分も含む）
+		uint64_t GetUsedSize() const { return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire); }
+		// 処理中のフレーム数
+		uint32_t GetPendingFrameCount() const { return frameCount_; }
+
+	private:
+		struct FrameMarker {
+			uint64_t endPosition;
+			uint64_t fenceValue;
+		};
+
+		// [tail_, head_) が使用中（折り返さない通し番号で持ち、バッファ上の位置は容量で割った余り）
+		std::atomic<uint64_t> head_{ 0 };
+		std::atomic<uint64_t> tail_{ 0 };
+		FrameMarker frames_[kMaxFrameCount]{};
+		uint32_t frameBegin_{ 0 };
+		uint32_t frameCount_{ 0 };
+		uint64_t capacity_{ 0 };
+	};
+
+}
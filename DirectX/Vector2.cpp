@@ -1,4 +1,3 @@
-#include "stdafx.h"
 #include "Vector2.h"
 
 const Vector2 Vector2::unitX = { 1.0f,0.0f };
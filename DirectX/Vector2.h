@@ -1,4 +1,11 @@
 #pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "Property.h"
+
 class Vector3;
 
 class Vector2 {
@@ -38,17 +45,17 @@ public:
 	/// <summary>
 	/// 長さの二乗
 	/// </summary>
-	__declspec(property(get = LengthSquare)) float lengthSquare;
+	PROPERTY(float lengthSquare, get = LengthSquare);
 	inline float LengthSquare() const;
 	/// <summary>
 	/// 長さ
 	/// </summary>
-	__declspec(property(get = Length)) float length;
+	PROPERTY(float length, get = Length);
 	inline float Length() const;
 	/// <summary>
 	/// 正規化
 	/// </summary>
-	__declspec(property(get = Normalized)) Vector2 normalized;
+	PROPERTY(Vector2 normalized, get = Normalized);
 	inline Vector2 Normalized() const;
 
 	/// <summary>
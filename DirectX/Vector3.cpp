@@ -12,7 +12,7 @@ const Vector3 Vector3::down = { 0.0f, -1.0f, 0.0f };
 const Vector3 Vector3::forward = { 0.0f, 0.0f, 1.0f };
 const Vector3 Vector3::back = { 0.0f, 0.0f, -1.0f };
 
-inline Vector3 Vector3::Slerp(float t, const Vector3& start, const Vector3& end) {
+Vector3 Vector3::Slerp(float t, const Vector3& start, const Vector3& end) {
 	assert(start != zero);
 	assert(end != zero);
 	float lenStart = start.Length();
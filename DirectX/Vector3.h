@@ -1,4 +1,11 @@
 #pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "Property.h"
+
 class Vector2;
 
 class Vector3 {
@@ -37,30 +44,30 @@ public:
 	friend inline bool operator==(const Vector3& v1, const Vector3& v2);
 	friend inline bool operator!=(const Vector3& v1, const Vector3& v2);
 
-	__declspec(property(get = GetXY, put = SetXY)) Vector2 xy;
+	PROPERTY(Vector2 xy, get = GetXY, put = SetXY);
 	inline Vector3& SetXY(const Vector2& xy);
 	inline Vector2 GetXY() const;
-	__declspec(property(get = GetXZ, put = SetXZ)) Vector2 xz;
+	PROPERTY(Vector2 xz, get = GetXZ, put = SetXZ);
 	inline Vector3& SetXZ(const Vector2& xz);
 	inline Vector2 GetXZ() const;
-	__declspec(property(get = GetYZ, put = SetYZ)) Vector2 yz;
+	PROPERTY(Vector2 yz, get = GetYZ, put = SetYZ);
 	inline Vector3& SetYZ(const Vector2& yz);
 	inline Vector2 GetYZ() const;
 
 	/// <summary>
 	/// 長さの二乗
 	/// </summary>
-	__declspec(property(get = LengthSquare)) float lengthSquare;
+	PROPERTY(float lengthSquare, get = LengthSquare);
 	inline float LengthSquare() const;
 	/// <summary>
 	/// 長さ
 	/// </summary>
-	__declspec(property(get = Length)) float length;
+	PROPERTY(float length, get = Length);
 	inline float Length() const;
 	/// <summary>
 	/// 正規化
 	/// </summary>
-	__declspec(property(get = Normalized)) Vector3 normalized;
+	PROPERTY(Vector3 normalized, get = Normalized);
 	inline Vector3 Normalized() const;
 
 	/// <summary>
@@ -0,0 +1,37 @@
+#include "Vector3d.h"
+
+#include "MathSIMD.h"
+
+const Vector3d Vector3d::zero = { 0.0, 0.0, 0.0 };
+
+// RelativeToBatchは配列を連続したdouble/floatとして読み書きする
+static_assert(sizeof(Vector3d) == sizeof(double) * 3);
+static_assert(sizeof(Vector3) == sizeof(float) * 3);
+
+void Vector3d::RelativeToBatch(const Vector3d* positions, size_t count, const Vector3d& origin, Vector3* results) {
+	assert((positions && results) || count == 0);
+	size_t i = 0;
+#ifdef MATH_SIMD_SSE2
+	// 4つ分の12個のdoubleを2個ずつ引き、12個のfloatにまとめて書き込む
+	// 基準位置は (x,y), (z,x), (y,z) の繰り返しになる
+	__m128d originXY = _mm_setr_pd(origin.x, origin.y);
+	__m128d originZX = _mm_setr_pd(origin.z, origin.x);
+	__m128d originYZ = _mm_setr_pd(origin.y, origin.z);
+	for (; i + 4 <= count; i += 4) {
+		const double* src = &positions[i].x;
+		float* dst = &results[i].x;
+		__m128 p0 = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(src + 0), originXY));
+		__m128 p1 = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(src + 2), originZX));
+		__m128 p2 = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(src + 4), originYZ));
+		__m128 p3 = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(src + 6), originXY));
+		__m128 p4 = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(src + 8), originZX));
+		__m128 p5 = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(src + 10), originYZ));
+		_mm_storeu_ps(dst + 0, _mm_movelh_ps(p0, p1));
+		_mm_storeu_ps(dst + 4, _mm_movelh_ps(p2, p3));
+		_mm_storeu_ps(dst + 8, _mm_movelh_ps(p4, p5));
+	}
+#endif // MATH_SIMD_SSE2
+	for (; i < count; ++i) {
+		results[i] = positions[i].RelativeTo(origin);
+	}
+}
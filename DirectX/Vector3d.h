@@ -0,0 +1,96 @@
+#pragma once
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "Property.h"
+#include "Vector3.h"
+
+// 倍精度のワールド座標
+// 原点から離れた位置はこの型で持ち、描画の前にカメラからの相対位置（単精度）に変換する
+
+class Vector3d {
+public:
+	double x, y, z;
+
+	static const Vector3d zero;
+
+	inline Vector3d();
+	inline Vector3d(double x, double y, double z);
+	inline explicit Vector3d(const Vector3& v);
+
+	inline double& operator[](size_t i);
+	inline const double& operator[](size_t i) const;
+
+	friend inline Vector3d operator+(const Vector3d& v);
+	friend inline Vector3d operator-(const Vector3d& v);
+	friend inline Vector3d operator+(const Vector3d& v1, const Vector3d& v2);
+	friend inline Vector3d operator-(const Vector3d& v1, const Vector3d& v2);
+	friend inline Vector3d operator+(const Vector3d& v1, const Vector3& v2);
+	friend inline Vector3d operator-(const Vector3d& v1, const Vector3& v2);
+	friend inline Vector3d operator*(const Vector3d& v, double s);
+	friend inline Vector3d operator*(double s, const Vector3d& v);
+	friend inline Vector3d& operator+=(Vector3d& v1, const Vector3d& v2);
+	friend inline Vector3d& operator-=(Vector3d& v1, const Vector3d& v2);
+	friend inline Vector3d& operator+=(Vector3d& v1, const Vector3& v2);
+	friend inline Vector3d& operator-=(Vector3d& v1, const Vector3& v2);
+	friend inline Vector3d& operator*=(Vector3d& v, double s);
+	friend inline bool operator==(const Vector3d& v1, const Vector3d& v2);
+	friend inline bool operator!=(const Vector3d& v1, const Vector3d& v2);
+
+	/// <summary>
+	/// 長さの二乗
+	/// </summary>
+	PROPERTY(double lengthSquare, get = LengthSquare);
+	inline double LengthSquare() const;
+	/// <summary>
+	/// 長さ
+	/// </summary>
+	PROPERTY(double length, get = Length);
+	inline double Length() const;
+	/// <summary>
+	/// 単精度に変換（原点から遠い場合は精度が落ちる）
+	/// </summary>
+	/// <returns></returns>
+	inline Vector3 ToVector3() const;
+	/// <summary>
+	/// 原点からの相対位置を単精度で取得
+	/// 倍精度で引いてから変換するので原点の近くは精度が落ちない
+	/// </summary>
+	/// <param name="origin">カメラなどの基準位置</param>
+	/// <returns></returns>
+	inline Vector3 RelativeTo(const Vector3d& origin) const;
+
+	/// <summary>
+	/// 二つのベクトルの距離
+	/// </summary>
+	/// <param name="v1"></param>
+	/// <param name="v2"></param>
+	/// <returns></returns>
+	static inline double Distance(const Vector3d& v1, const Vector3d& v2);
+	/// <summary>
+	/// 内積
+	/// </summary>
+	/// <param name="lhs"></param>
+	/// <param name="rhs"></param>
+	/// <returns></returns>
+	static inline double Dot(const Vector3d& lhs, const Vector3d& rhs);
+	/// <summary>
+	/// 線形補間
+	/// </summary>
+	/// <param name="t"></param>
+	/// <param name="start"></param>
+	/// <param name="end"></param>
+	/// <returns></returns>
+	static inline Vector3d Lerp(double t, const Vector3d& start, const Vector3d& end);
+	/// <summary>
+	/// 配列をまとめて原点からの相対位置に変換
+	/// </summary>
+	/// <param name="positions"></param>
+	/// <param name="count"></param>
+	/// <param name="origin">カメラなどの基準位置</param>
+	/// <param name="results">count個の書き込み先</param>
+	static void RelativeToBatch(const Vector3d* positions, size_t count, const Vector3d& origin, Vector3* results);
+};
+
+#include "Vector3d_inline.h"
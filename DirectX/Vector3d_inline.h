@@ -0,0 +1,63 @@
+#pragma once
+#include "Vector3d.h"
+
+inline Vector3d::Vector3d() : x(0.0), y(0.0), z(0.0) {}
+inline Vector3d::Vector3d(double x, double y, double z) : x(x), y(y), z(z) {}
+inline Vector3d::Vector3d(const Vector3& v) : x(v.x), y(v.y), z(v.z) {}
+inline double& Vector3d::operator[](size_t i) {
+	assert(i < 3);
+	return (&x)[i];
+}
+inline const double& Vector3d::operator[](size_t i) const {
+	assert(i < 3);
+	return (&x)[i];
+}
+inline Vector3d operator+(const Vector3d& v) { return v; }
+inline Vector3d operator-(const Vector3d& v) { return { -v.x, -v.y, -v.z }; }
+inline Vector3d operator+(const Vector3d& v1, const Vector3d& v2) { return { v1.x + v2.x, v1.y + v2.y, v1.z + v2.z }; }
+inline Vector3d operator-(const Vector3d& v1, const Vector3d& v2) { return { v1.x - v2.x, v1.y - v2.y, v1.z - v2.z }; }
+inline Vector3d operator+(const Vector3d& v1, const Vector3& v2) { return { v1.x + v2.x, v1.y + v2.y, v1.z + v2.z }; }
+inline Vector3d operator-(const Vector3d& v1, const Vector3& v2) { return { v1.x - v2.x, v1.y - v2.y, v1.z - v2.z }; }
+inline Vector3d operator*(const Vector3d& v, double s) { return { v.x * s, v.y * s, v.z * s }; }
+inline Vector3d operator*(double s, const Vector3d& v) { return { s * v.x, s * v.y, s * v.z }; }
+inline Vector3d& operator+=(Vector3d& v1, const Vector3d& v2) {
+	v1.x += v2.x;
+	v1.y += v2.y;
+	v1.z += v2.z;
+	return v1;
+}
+inline Vector3d& operator-=(Vector3d& v1, const Vector3d& v2) {
+	v1.x -= v2.x;
+	v1.y -= v2.y;
+	v1.z -= v2.z;
+	return v1;
+}
+inline Vector3d& operator+=(Vector3d& v1, const Vector3& v2) {
+	v1.x += v2.x;
+	v1.y += v2.y;
+	v1.z += v2.z;
+	return v1;
+}
+inline Vector3d& operator-=(Vector3d& v1, const Vector3& v2) {
+	v1.x -= v2.x;
+	v1.y -= v2.y;
+	v1.z -= v2.z;
+	return v1;
+}
+inline Vector3d& operator*=(Vector3d& v, double s) {
+	v.x *= s;
+	v.y *= s;
+	v.z *= s;
+	return v;
+}
+inline bool operator==(const Vector3d& v1, const Vector3d& v2) { return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z; }
+inline bool operator!=(const Vector3d& v1, const Vector3d& v2) { return !(v1 == v2); }
+
+inline double Vector3d::LengthSquare() const { return x * x + y * y + z * z; }
+inline double Vector3d::Length() const { return std::sqrt(LengthSquare()); }
+inline Vector3 Vector3d::ToVector3() const { return { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) }; }
+inline Vector3 Vector3d::RelativeTo(const Vector3d& origin) const { return (*this - origin).ToVector3(); }
+
+inline double Vector3d::Distance(const Vector3d& v1, const Vector3d& v2) { return (v2 - v1).Length(); }
+inline double Vector3d::Dot(const Vector3d& lhs, const Vector3d& rhs) { return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z; }
+inline Vector3d Vector3d::Lerp(double t, const Vector3d& start, const Vector3d& end) { return start + t * (end - start); }
@@ -1,4 +1,10 @@
 #pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "Property.h"
 
 class Vector3;
 
@@ -31,24 +37,24 @@ public:
 	friend inline bool operator==(const Vector4& v1, const Vector4& v2);
 	friend inline bool operator!=(const Vector4& v1, const Vector4& v2);
 
-	__declspec(property(get = GetXYZ, put = SetXYZ)) Vector3 xyz;
+	PROPERTY(Vector3 xyz, get = GetXYZ, put = SetXYZ);
 	inline Vector4& SetXYZ(const Vector3& xyz);
 	inline Vector3 GetXYZ() const;
 
 	/// <summary>
 	/// 長さの二乗
 	/// </summary>
-	__declspec(property(get = LengthSquare)) float lengthSquare;
+	PROPERTY(float lengthSquare, get = LengthSquare);
 	inline float LengthSquare() const;
 	/// <summary>
 	/// 長さ
 	/// </summary>
-	__declspec(property(get = Length)) float length;
+	PROPERTY(float length, get = Length);
 	inline float Length() const;
 	/// <summary>
 	/// 正規化
 	/// </summary>
-	__declspec(property(get = Normalized)) Vector4 normalized;
+	PROPERTY(Vector4 normalized, get = Normalized);
 	inline Vector4 Normalized() const;
 
 	/// <summary>
@@ -28,6 +28,7 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 	static const uint32_t kParticleCount = 65536;
 	struct TargetCB {
 		Vector3 target;
+		uint32_t particleCount;
 	};
 	struct Particle {
 		Vector4 position;
@@ -48,6 +49,7 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 		directXDevice.GetDevice()->CreateUnorderedAccessView(particlesBuffer.Get(), nullptr, &uavDesc, particlesBufferView.cpu);
 
 		target.target = { 0.0f,0.0f,0.1f };
+		target.particleCount = kParticleCount;
 		targetCB.Create(directXDevice.GetDevice(), sizeof(TargetCB));
 		targetCB.WriteData(&target);
 	}
@@ -196,7 +198,7 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 				cmdList->SetPipelineState(cpso.Get());
 				cmdList->SetComputeRootDescriptorTable(0, particlesBufferView.gpu);
 				cmdList->SetComputeRootConstantBufferView(1, targetCB.GetGPUAddress());
-				cmdList->Dispatch(kParticleCount / 16, 1, 1);
+				cmdList->Dispatch(Engine::GetParticleUpdateDispatchCount(Engine::MakeParticleUpdatePermutationSpace(), 0, kParticleCount), 1, 1);
 				D3D12_RESOURCE_BARRIER barriers[] = {
 					CD3DX12_RESOURCE_BARRIER::UAV(particlesBuffer.Get()),
 					CD3DX12_RESOURCE_BARRIER::Transition(particlesBuffer.Get(),D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_GENERIC_READ) 
@@ -230,6 +232,7 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 		}
 	}
 
+	ShaderCompiler::Finalize();
 	directXDevice.Finalize();
 	window.Close();
 